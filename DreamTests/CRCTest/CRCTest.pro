@@ -0,0 +1,7 @@
+QT += testlib
+QT -= gui
+CONFIG += qt warn_on depend_includepath testcase
+TEMPLATE = app
+SOURCES += tst_crctest.cpp
+SOURCES += ../../src/util/CRC.cpp
+HEADERS += ../../src/util/CRC.h
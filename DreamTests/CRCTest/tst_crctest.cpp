@@ -0,0 +1,128 @@
+#include <QtTest>
+#include <cstdlib>
+#include <vector>
+
+#include "../../src/GlobalDefinitions.h"
+#include "../../src/util/CRC.h"
+
+/* Compares the table based byte-wise and block CRC functions with the
+   bit-wise reference (AddBit) for every degree used in DRM */
+class CRCTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void test_bytes_data();
+    void test_bytes();
+    void test_mixed_data();
+    void test_mixed();
+    void test_block();
+};
+
+static std::vector<_BYTE> RandomBytes(const size_t iLen)
+{
+    std::vector<_BYTE> vecbyData(iLen);
+    for (size_t i = 0; i < iLen; i++)
+        vecbyData[i] = _BYTE(rand());
+    return vecbyData;
+}
+
+static uint32_t BitwiseCRC(const int iDegree, const std::vector<_BYTE>& vecbyData)
+{
+    CCRC CRCObject;
+    CRCObject.Reset(iDegree);
+    for (size_t i = 0; i < vecbyData.size(); i++)
+        for (int j = SIZEOF__BYTE - 1; j >= 0; j--)
+            CRCObject.AddBit(_BINARY((vecbyData[i] >> j) & 1));
+    return CRCObject.GetCRC();
+}
+
+void CRCTest::test_bytes_data()
+{
+    QTest::addColumn<int>("degree");
+    const int iDegrees[] = {1, 2, 3, 5, 6, 8, 16};
+    for (int iDeg : iDegrees)
+        QTest::newRow(QByteArray::number(iDeg)) << iDeg;
+}
+
+void CRCTest::test_bytes()
+{
+    QFETCH(int, degree);
+    srand(uint(degree));
+
+    /* All lengths around the slice size, plus some larger blocks */
+    for (size_t iLen = 0; iLen < 600; iLen += (iLen < 3 * CRC_SLICES) ? 1 : 37)
+    {
+        const std::vector<_BYTE> vecbyData = RandomBytes(iLen);
+        const uint32_t iRef = BitwiseCRC(degree, vecbyData);
+
+        CCRC CRCBytewise;
+        CRCBytewise.Reset(degree);
+        for (size_t i = 0; i < iLen; i++)
+            CRCBytewise.AddByte(vecbyData[i]);
+        QCOMPARE(CRCBytewise.GetCRC(), iRef);
+
+        CCRC CRCBlock;
+        CRCBlock.Reset(degree);
+        CRCBlock.AddBytes(vecbyData.data(), iLen);
+        QCOMPARE(CRCBlock.GetCRC(), iRef);
+    }
+}
+
+void CRCTest::test_mixed_data()
+{
+    test_bytes_data();
+}
+
+void CRCTest::test_mixed()
+{
+    QFETCH(int, degree);
+    srand(uint(degree) + 100);
+
+    /* Bit-wise and byte-wise calls on the same object must give the same
+       result as the reference */
+    const std::vector<_BYTE> vecbyData = RandomBytes(64);
+    CCRC CRCObject;
+    CRCObject.Reset(degree);
+    for (size_t i = 0; i < vecbyData.size(); i++)
+    {
+        if (i % 3 == 0)
+        {
+            for (int j = SIZEOF__BYTE - 1; j >= 0; j--)
+                CRCObject.AddBit(_BINARY((vecbyData[i] >> j) & 1));
+        }
+        else if (i % 3 == 1)
+            CRCObject.AddByte(vecbyData[i]);
+        else
+            CRCObject.AddBytes(&vecbyData[i], 1);
+    }
+    QCOMPARE(CRCObject.GetCRC(), BitwiseCRC(degree, vecbyData));
+}
+
+void CRCTest::test_block()
+{
+    srand(16);
+
+    for (int iDegree = 8; iDegree <= 16; iDegree += 8)
+    {
+        const int iNumCRCBytes = iDegree / SIZEOF__BYTE;
+        std::vector<_BYTE> vecbyData = RandomBytes(100);
+        const std::vector<_BYTE> vecbyPayload(vecbyData.begin(),
+            vecbyData.end() - iNumCRCBytes);
+        const uint32_t iCRC = BitwiseCRC(iDegree, vecbyPayload);
+
+        for (int i = 0; i < iNumCRCBytes; i++)
+            vecbyData[vecbyData.size() - iNumCRCBytes + i] =
+                _BYTE(iCRC >> (SIZEOF__BYTE * (iNumCRCBytes - i - 1)));
+
+        CCRC CRCObject;
+        QVERIFY(CRCObject.CheckBlock(iDegree, vecbyData.data(), vecbyData.size()));
+
+        vecbyData[10] ^= 0x10;
+        QVERIFY(!CRCObject.CheckBlock(iDegree, vecbyData.data(), vecbyData.size()));
+    }
+}
+
+QTEST_APPLESS_MAIN(CRCTest)
+
+#include "tst_crctest.moc"
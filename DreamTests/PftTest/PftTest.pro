@@ -0,0 +1,11 @@
+QT += testlib
+QT -= gui
+CONFIG += qt warn_on depend_includepath testcase
+TEMPLATE = app
+SOURCES += tst_pfttest.cpp
+SOURCES += ../../src/MDI/Pft.cpp \
+    ../../src/util/CRC.cpp \
+    ../../src/util/Reassemble.cpp \
+    ../../src/util/ReedSolomon.cpp
+HEADERS += ../../src/MDI/Pft.h \
+    ../../src/util/ReedSolomon.h
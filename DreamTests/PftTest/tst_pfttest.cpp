@@ -0,0 +1,196 @@
+#include <QtTest>
+#include <cstdlib>
+#include <vector>
+
+#include "../../src/GlobalDefinitions.h"
+#include "../../src/MDI/Pft.h"
+#include "../../src/util/ReedSolomon.h"
+#include "../../src/util/CRC.h"
+
+/* Round trips AF packets through the PFT encoder and decoder, with and
+   without Reed-Solomon FEC, and checks the erasure and error correction of
+   the RS(255,207) code */
+class PftTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void test_rs_errors();
+    void test_rs_erasures();
+    void test_simple();
+    void test_fec_data();
+    void test_fec();
+    void test_fec_too_many_lost();
+};
+
+static std::vector<_BYTE> RandomBytes(const size_t iLen)
+{
+    std::vector<_BYTE> vecbyData(iLen);
+    for (size_t i = 0; i < iLen; i++)
+        vecbyData[i] = _BYTE(rand());
+    return vecbyData;
+}
+
+/* AF packet with random payload and a valid CRC */
+static std::vector<_BYTE> AFPacket(const size_t iPayloadLen)
+{
+    std::vector<_BYTE> vecbyAF;
+    vecbyAF.push_back('A');
+    vecbyAF.push_back('F');
+    for (int i = 3; i >= 0; i--)
+        vecbyAF.push_back(_BYTE(iPayloadLen >> (8 * i)));
+    vecbyAF.push_back(0);
+    vecbyAF.push_back(1);
+    vecbyAF.push_back(0x90); /* CRC used, version 1.0 */
+    vecbyAF.push_back('T');
+    const std::vector<_BYTE> vecbyPayload = RandomBytes(iPayloadLen);
+    vecbyAF.insert(vecbyAF.end(), vecbyPayload.begin(), vecbyPayload.end());
+
+    CCRC CRCObject;
+    CRCObject.Reset(16);
+    CRCObject.AddBytes(vecbyAF.data(), vecbyAF.size());
+    const uint32_t iCRC = CRCObject.GetCRC();
+    vecbyAF.push_back(_BYTE(iCRC >> 8));
+    vecbyAF.push_back(_BYTE(iCRC));
+    return vecbyAF;
+}
+
+static std::vector<_BYTE> CodeWord(const CReedSolomon& RS)
+{
+    std::vector<_BYTE> vecbyBlock = RandomBytes(RS_BLOCK_LEN);
+    RS.Encode(&vecbyBlock[0], &vecbyBlock[RS.GetDataLen()]);
+    return vecbyBlock;
+}
+
+void PftTest::test_rs_errors()
+{
+    srand(1);
+    CReedSolomon RS(48, 1);
+
+    for (int iNumErrors = 0; iNumErrors <= 24; iNumErrors++)
+    {
+        const std::vector<_BYTE> vecbyRef = CodeWord(RS);
+        std::vector<_BYTE> vecbyBlock = vecbyRef;
+        for (int i = 0; i < iNumErrors; i++)
+            vecbyBlock[(i * 37 + 5) % RS_BLOCK_LEN] ^= _BYTE(1 + i);
+
+        QCOMPARE(RS.Decode(&vecbyBlock[0]), iNumErrors);
+        QVERIFY(vecbyBlock == vecbyRef);
+    }
+}
+
+void PftTest::test_rs_erasures()
+{
+    srand(2);
+    CReedSolomon RS(48, 1);
+
+    /* Any mix of 2 * errors + erasures <= 48 */
+    for (int iNumErasures = 0; iNumErasures <= 48; iNumErasures += 4)
+    {
+        const int iNumErrors = (48 - iNumErasures) / 2;
+        const std::vector<_BYTE> vecbyRef = CodeWord(RS);
+        std::vector<_BYTE> vecbyBlock = vecbyRef;
+        std::vector<int> veciErasures;
+        for (int i = 0; i < iNumErasures + iNumErrors; i++)
+        {
+            const int iPos = (i * 53 + 11) % RS_BLOCK_LEN;
+            vecbyBlock[iPos] = _BYTE(~vecbyBlock[iPos]);
+            if (i < iNumErasures)
+                veciErasures.push_back(iPos);
+        }
+
+        QVERIFY(RS.Decode(&vecbyBlock[0], veciErasures.data(), iNumErasures) >= 0);
+        QVERIFY(vecbyBlock == vecbyRef);
+    }
+}
+
+void PftTest::test_simple()
+{
+    srand(3);
+    const std::vector<_BYTE> vecbyAF = AFPacket(3000);
+    std::vector<std::vector<_BYTE> > packets;
+    CPft::MakePFTPackets(vecbyAF, packets, 7, 800);
+    QVERIFY(packets.size() > 1);
+
+    CPft Pft;
+    std::vector<_BYTE> vecbyOut;
+    for (size_t i = 0; i < packets.size(); i++)
+        QCOMPARE(Pft.DecodePFTPacket(packets[i], vecbyOut), i == packets.size() - 1);
+    QVERIFY(vecbyOut == vecbyAF);
+}
+
+void PftTest::test_fec_data()
+{
+    QTest::addColumn<int>("length");
+    QTest::addColumn<int>("fragments");
+    QTest::newRow("small") << 100 << 1;
+    QTest::newRow("one chunk") << 195 << 2;
+    QTest::newRow("typical") << 3000 << 2;
+    QTest::newRow("large") << 9000 << 3;
+}
+
+void PftTest::test_fec()
+{
+    QFETCH(int, length);
+    QFETCH(int, fragments);
+    srand(uint(length));
+
+    const std::vector<_BYTE> vecbyAF = AFPacket(size_t(length));
+    std::vector<std::vector<_BYTE> > packets;
+    CPft::MakePFTPackets(vecbyAF, packets, 1234, 800, fragments);
+    QVERIFY(packets.size() > size_t(fragments));
+
+    /* Lose the first, a middle and the last fragments in turn */
+    for (size_t iStart = 0; iStart + fragments <= packets.size(); iStart += packets.size() / 2 + 1)
+    {
+        CPft Pft;
+        std::vector<_BYTE> vecbyOut;
+        bool bDecoded = false;
+        for (size_t i = 0; i < packets.size(); i++)
+        {
+            if ((i >= iStart) && (i < iStart + size_t(fragments)))
+                continue;
+            const bool bOk = Pft.DecodePFTPacket(packets[i], vecbyOut);
+            QVERIFY(!(bOk && bDecoded)); /* only once */
+            if (bOk)
+            {
+                bDecoded = true;
+                QVERIFY(vecbyOut == vecbyAF);
+            }
+        }
+        QVERIFY(bDecoded);
+    }
+
+    /* Corrupted payload of a fragment, without losses */
+    CPft Pft;
+    std::vector<_BYTE> vecbyOut;
+    bool bDecoded = false;
+    for (size_t i = 0; i < packets.size(); i++)
+    {
+        std::vector<_BYTE> vecbyPacket = packets[i];
+        if (i == 1)
+            vecbyPacket[vecbyPacket.size() - 1] ^= 0xFF;
+        if (Pft.DecodePFTPacket(vecbyPacket, vecbyOut))
+            bDecoded = true;
+    }
+    QVERIFY(bDecoded);
+    QVERIFY(vecbyOut == vecbyAF);
+}
+
+void PftTest::test_fec_too_many_lost()
+{
+    srand(4);
+    const std::vector<_BYTE> vecbyAF = AFPacket(3000);
+    std::vector<std::vector<_BYTE> > packets;
+    CPft::MakePFTPackets(vecbyAF, packets, 99, 800, 1);
+
+    /* Half of the fragments are far more than the parity can fill in */
+    CPft Pft;
+    std::vector<_BYTE> vecbyOut;
+    for (size_t i = 0; i < packets.size(); i += 2)
+        QVERIFY(!Pft.DecodePFTPacket(packets[i], vecbyOut));
+}
+
+QTEST_APPLESS_MAIN(PftTest)
+
+#include "tst_pfttest.moc"
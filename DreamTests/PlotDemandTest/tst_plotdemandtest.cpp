@@ -0,0 +1,219 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <cstdlib>
+
+#include "../../src/GlobalDefinitions.h"
+#include "../../src/DrmReceiver.h"
+#include "../../src/OFDM.h"
+#include "../../src/DataIO.h"
+#include "../../src/util/Settings.h"
+
+/* Runs the modules which keep data only for the plots for one DRM frame,
+   mode B at 48 kHz, once while a plot reads the data and once while nobody
+   does. The difference of the two rows is the work saved per frame when no
+   plot is shown */
+class PlotDemandTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    PlotDemandTest();
+
+private slots:
+    void initTestCase();
+    void test_demand();
+    void bench_ofdm_data();
+    void bench_ofdm();
+    void bench_audio_data();
+    void bench_audio();
+    void bench_histories_data();
+    void bench_histories();
+
+private:
+    bool Poll(const bool bShown);
+
+    CSettings Settings;
+    CParameter Parameter;
+    QElapsedTimer PollTimer;
+};
+
+/* Takes the audio, like a sound card with nothing connected */
+class CNullAudioOut : public CSoundOutInterface
+{
+public:
+    virtual bool Init(int, int, bool) {return false;}
+    virtual bool Write(CVector<short>&) {return false;}
+    virtual bool WriteAudio(CVector<_AUDIO>&) {return false;}
+    virtual void Close() {}
+    virtual std::string GetVersion() {return "null";}
+    virtual void Enumerate(std::vector<std::string>&, std::vector<std::string>&, std::string&) {}
+    virtual std::string GetDev() {return "null";}
+    virtual void SetDev(std::string) {}
+};
+
+/* A plot polls its data about every 400 ms */
+static const int PLOT_POLL_MS = 400;
+
+PlotDemandTest::PlotDemandTest()
+{
+    int argc = 1;
+    char chName[] = "PlotDemandTest";
+    char* argv[] = {chName, nullptr};
+    Settings.Load(argc, argv);
+}
+
+void PlotDemandTest::initTestCase()
+{
+    srand(1);
+    Parameter.InitCellMapTable(RM_ROBUSTNESS_MODE_B, SO_3);
+    PollTimer.start();
+}
+
+/* True if the plot is due to read its data now */
+bool PlotDemandTest::Poll(const bool bShown)
+{
+    if (!bShown || (PollTimer.elapsed() < PLOT_POLL_MS))
+        return false;
+    PollTimer.restart();
+    return true;
+}
+
+/* The averaged spectrum is only kept up to date once it was read */
+void PlotDemandTest::test_demand()
+{
+    const CCellMappingTable& Cells = Parameter.CellMappingTable;
+    COFDMDemodulation OFDMDemodulation;
+    CSingleBuffer<_COMPLEX> InputBuf(Cells.iFFTSizeN);
+    CSingleBuffer<_COMPLEX> OutputBuf(Cells.iNumCarrier);
+    OFDMDemodulation.SetInitFlag();
+
+    CVector<_REAL> vecrData, vecrScale;
+    for (int iPass = 0; iPass < 2; iPass++)
+    {
+        CVectorEx<_COMPLEX>* pvecInput = InputBuf.QueryWriteBuffer();
+        for (int i = 0; i < Cells.iFFTSizeN; i++)
+            (*pvecInput)[i] = _COMPLEX(_REAL(rand() % 200 - 100), _REAL(rand() % 200 - 100));
+        InputBuf.Put(Cells.iFFTSizeN);
+        QVERIFY(OFDMDemodulation.ProcessData(Parameter, InputBuf, OutputBuf));
+        OutputBuf.Clear();
+
+        /* Nothing but the floor of the plot before the first read */
+        OFDMDemodulation.GetPowDenSpec(vecrData, vecrScale);
+        QVERIFY(vecrData.Size() > 0);
+        _REAL rMax = vecrData[0];
+        for (int i = 1; i < vecrData.Size(); i++)
+            rMax = std::max(rMax, vecrData[i]);
+        if (iPass == 0)
+        {
+            QCOMPARE(rMax, vecrData[0]);
+        }
+        else
+        {
+            QVERIFY(rMax > vecrData[0]);
+        }
+    }
+}
+
+void PlotDemandTest::bench_ofdm_data()
+{
+    QTest::addColumn<bool>("shown");
+    QTest::newRow("shown") << true;
+    QTest::newRow("hidden") << false;
+}
+
+/* OFDM demodulation of the symbols of a frame, with the averaged power
+   spectrum of the evaluation dialog */
+void PlotDemandTest::bench_ofdm()
+{
+    QFETCH(bool, shown);
+
+    const CCellMappingTable& Cells = Parameter.CellMappingTable;
+    COFDMDemodulation OFDMDemodulation;
+    CSingleBuffer<_COMPLEX> InputBuf(Cells.iFFTSizeN);
+    CSingleBuffer<_COMPLEX> OutputBuf(Cells.iNumCarrier);
+    OFDMDemodulation.SetInitFlag();
+
+    CVectorEx<_COMPLEX>* pvecInput = InputBuf.QueryWriteBuffer();
+    for (int i = 0; i < Cells.iFFTSizeN; i++)
+        (*pvecInput)[i] = _COMPLEX(_REAL(rand() % 200 - 100), _REAL(rand() % 200 - 100));
+
+    CVector<_REAL> vecrData, vecrScale;
+    if (shown)
+        OFDMDemodulation.GetPowDenSpec(vecrData, vecrScale);
+    QBENCHMARK
+    {
+        for (int s = 0; s < Cells.iNumSymPerFrame; s++)
+        {
+            InputBuf.Put(Cells.iFFTSizeN);
+            OFDMDemodulation.ProcessData(Parameter, InputBuf, OutputBuf);
+            OutputBuf.Clear();
+        }
+        if (Poll(shown))
+            OFDMDemodulation.GetPowDenSpec(vecrData, vecrScale);
+    }
+}
+
+void PlotDemandTest::bench_audio_data()
+{
+    bench_ofdm_data();
+}
+
+/* The audio of a frame to the sound card, with the buffer of the audio
+   spectrum */
+void PlotDemandTest::bench_audio()
+{
+    QFETCH(bool, shown);
+
+    CWriteData WriteData;
+    WriteData.SetSoundInterface(new CNullAudioOut);
+    WriteData.SetInitFlag();
+
+    /* One frame of stereo audio */
+    const int iLen = Parameter.GetAudSampleRate() * 2 * 2 / 5;
+    CSingleBuffer<_AUDIO> AudioBuf(iLen);
+    CVectorEx<_AUDIO>* pvecAudio = AudioBuf.QueryWriteBuffer();
+    for (int i = 0; i < iLen; i++)
+        (*pvecAudio)[i] = _AUDIO(rand() % 2000 - 1000);
+
+    CVector<_REAL> vecrData, vecrScale;
+    if (shown)
+        WriteData.GetAudioSpec(vecrData, vecrScale);
+    QBENCHMARK
+    {
+        AudioBuf.Put(iLen);
+        WriteData.WriteData(Parameter, AudioBuf);
+        if (Poll(shown))
+            WriteData.GetAudioSpec(vecrData, vecrScale);
+    }
+}
+
+void PlotDemandTest::bench_histories_data()
+{
+    bench_ofdm_data();
+}
+
+/* The histories of the synchronisation and SNR plots, updated every symbol */
+void PlotDemandTest::bench_histories()
+{
+    QFETCH(bool, shown);
+
+    CDRMReceiver Receiver(&Settings);
+    Receiver.GetParameters()->InitCellMapTable(RM_ROBUSTNESS_MODE_B, SO_3);
+    CPlotManager& PlotManager = *Receiver.GetPlotManager();
+    const int iNumSymPerFrame = Receiver.GetParameters()->CellMappingTable.iNumSymPerFrame;
+
+    CVector<_REAL> vecrSNR, vecrCDAud, vecrScale;
+    if (shown)
+        PlotManager.GetSNRHist(vecrSNR, vecrCDAud, vecrScale);
+    QBENCHMARK
+    {
+        for (int s = 0; s < iNumSymPerFrame; s++)
+            PlotManager.UpdateParamHistories(RS_TRACKING);
+        if (Poll(shown))
+            PlotManager.GetSNRHist(vecrSNR, vecrCDAud, vecrScale);
+    }
+}
+
+QTEST_APPLESS_MAIN(PlotDemandTest)
+
+#include "tst_plotdemandtest.moc"
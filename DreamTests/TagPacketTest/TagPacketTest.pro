@@ -0,0 +1,6 @@
+QT += testlib
+QT -= gui
+CONFIG += qt warn_on depend_includepath testcase
+TEMPLATE = app
+SOURCES += tst_tagpackettest.cpp
+include(../receiver.pri)
@@ -0,0 +1,202 @@
+#include <QtTest>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../../src/GlobalDefinitions.h"
+#include "../../src/Parameter.h"
+#include "../../src/MDI/MDIRSCI.h"
+#include "../../src/MDI/PacketSocket.h"
+#include "../../src/util/CRC.h"
+
+/* Generates complete RSCI frames with CDownstreamDI, as the receiver does
+   for each DRM frame, checks the AF packets a subscriber gets for each
+   profile and measures the cost of generating them */
+class TagPacketTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void test_profiles_data();
+    void test_profiles();
+    void bench_frame_data();
+    void bench_frame();
+
+private:
+    void FillFrame();
+
+    CParameter Parameter;
+    CSingleBuffer<_BINARY> FACData;
+    CSingleBuffer<_BINARY> SDCData;
+    std::vector<CSingleBuffer<_BINARY> > vecMSCData;
+};
+
+/* Collects what arrives on the subscriber's port */
+class CCollector : public CPacketSink
+{
+public:
+    void SendPacket(const std::vector<_BYTE>& vecbydata, uint32_t, uint16_t)
+        {vecPackets.push_back(vecbydata);}
+    bool SetDestination(const std::string&) {return false;}
+    bool GetDestination(std::string&) {return false;}
+
+    std::vector<std::vector<_BYTE> > vecPackets;
+};
+
+/* Bytes of the MSC stream per frame, about 30 kbps */
+static const int MSC_STREAM_BYTES = 1500;
+/* Values in the rpsd tag, half of the RSI PSD block length */
+static const int PSD_VALUES = 128;
+static const int PIR_VALUES = 256;
+
+static const uint16_t TEST_PORT = 18431;
+
+void TagPacketTest::initTestCase()
+{
+    srand(1);
+    Parameter.InitCellMapTable(RM_ROBUSTNESS_MODE_B, SO_3);
+    Parameter.SetStreamLen(0, 0, MSC_STREAM_BYTES);
+    Parameter.ReceiveStatus.FAC.SetStatus(RX_OK);
+
+    Parameter.vecrPSD.Init(PSD_VALUES);
+    for (int i = 0; i < PSD_VALUES; i++)
+        Parameter.vecrPSD[i] = -_REAL(rand() % 100);
+    Parameter.vecrPIR.Init(PIR_VALUES);
+    for (int i = 0; i < PIR_VALUES; i++)
+        Parameter.vecrPIR[i] = -_REAL(rand() % 60);
+
+    /* Received pilots in the dimensions the rpil tag expects */
+    const CCellMappingTable& Cells = Parameter.CellMappingTable;
+    Parameter.matcReceivedPilotValues.Init(
+        Cells.iNumSymPerFrame / Cells.iScatPilTimeInt,
+        (Cells.iNumCarrier - 1) / Cells.iScatPilFreqInt + 1);
+    for (int r = 0; r < Parameter.matcReceivedPilotValues.NumRows(); r++)
+        for (int c = 0; c < Parameter.matcReceivedPilotValues.NumColumns(); c++)
+            Parameter.matcReceivedPilotValues[r][c] =
+                _COMPLEX(_REAL(rand() % 200 - 100), _REAL(rand() % 200 - 100));
+
+    FACData.Init(NUM_FAC_BITS_PER_BLOCK);
+    SDCData.Init(1);
+    vecMSCData.resize(MAX_NUM_STREAMS);
+    vecMSCData[0].Init(MSC_STREAM_BYTES * SIZEOF__BYTE);
+}
+
+/* New FAC and MSC data, as the decoder delivers it each frame */
+void TagPacketTest::FillFrame()
+{
+    CVectorEx<_BINARY>* pvecbiFAC = FACData.QueryWriteBuffer();
+    for (int i = 0; i < NUM_FAC_BITS_PER_BLOCK; i++)
+        (*pvecbiFAC)[i] = _BINARY(rand() & 1);
+    FACData.Put(NUM_FAC_BITS_PER_BLOCK);
+
+    CVectorEx<_BINARY>* pvecbiMSC = vecMSCData[0].QueryWriteBuffer();
+    for (int i = 0; i < MSC_STREAM_BYTES * SIZEOF__BYTE; i++)
+        (*pvecbiMSC)[i] = _BINARY(rand() & 1);
+    vecMSCData[0].Put(MSC_STREAM_BYTES * SIZEOF__BYTE);
+}
+
+void TagPacketTest::test_profiles_data()
+{
+    QTest::addColumn<char>("profile");
+    QTest::addColumn<bool>("streams"); /* str0 and rpil are in A and D only */
+    QTest::newRow("A") << 'A' << true;
+    QTest::newRow("B") << 'B' << false;
+    QTest::newRow("C") << 'C' << false;
+    QTest::newRow("D") << 'D' << true;
+}
+
+void TagPacketTest::test_profiles()
+{
+    QFETCH(char, profile);
+    QFETCH(bool, streams);
+
+    CCollector Collector;
+    CPacketSocketNative Socket;
+    QVERIFY(Socket.SetOrigin(QByteArray::number(TEST_PORT).toStdString()));
+    Socket.SetPacketSink(&Collector);
+    Socket.SetPollTimeout(1000);
+
+    CDownstreamDI DI;
+    QVERIFY(DI.AddSubscriber("127.0.0.1:" + QByteArray::number(TEST_PORT).toStdString(), profile));
+
+    for (int iFrame = 0; iFrame < 3; iFrame++)
+    {
+        FillFrame();
+        DI.SendLockedFrame(Parameter, FACData, SDCData, vecMSCData);
+        Socket.poll();
+    }
+    QCOMPARE(Collector.vecPackets.size(), size_t(3));
+
+    for (size_t p = 0; p < Collector.vecPackets.size(); p++)
+    {
+        const std::vector<_BYTE>& vecbyAF = Collector.vecPackets[p];
+        QVERIFY(vecbyAF.size() >= 12);
+        QCOMPARE(vecbyAF[0], _BYTE('A'));
+        QCOMPARE(vecbyAF[1], _BYTE('F'));
+        const size_t iLen = (size_t(vecbyAF[2]) << 24) | (size_t(vecbyAF[3]) << 16) |
+            (size_t(vecbyAF[4]) << 8) | vecbyAF[5];
+        QCOMPARE(iLen + 12, vecbyAF.size());
+        QCOMPARE(int((vecbyAF[6] << 8) | vecbyAF[7]), int(p));
+        QCOMPARE(vecbyAF[8], _BYTE(0x90));
+        QCOMPARE(vecbyAF[9], _BYTE('T'));
+
+        CCRC CRCObject;
+        CRCObject.Reset(16);
+        CRCObject.AddBytes(vecbyAF.data(), vecbyAF.size() - 2);
+        QCOMPARE(CRCObject.GetCRC(),
+            (uint32_t(vecbyAF[vecbyAF.size() - 2]) << 8) | vecbyAF.back());
+
+        /* The tag items fill the payload exactly */
+        std::map<std::string, size_t> mapTags;
+        size_t i = 10;
+        while (i < 10 + iLen)
+        {
+            QVERIFY(i + 8 <= 10 + iLen);
+            const std::string strName(vecbyAF.begin() + i, vecbyAF.begin() + i + 4);
+            const size_t iBits = (size_t(vecbyAF[i + 4]) << 24) | (size_t(vecbyAF[i + 5]) << 16) |
+                (size_t(vecbyAF[i + 6]) << 8) | vecbyAF[i + 7];
+            mapTags[strName] = iBits / SIZEOF__BYTE;
+            i += 8 + iBits / SIZEOF__BYTE;
+        }
+        QCOMPARE(i, 10 + iLen);
+
+        QCOMPARE(mapTags.count("rpro"), size_t(1));
+        QCOMPARE(mapTags.count("str0") == 1, streams);
+        if (streams)
+        {
+            QCOMPARE(mapTags["str0"], size_t(MSC_STREAM_BYTES));
+            QCOMPARE(mapTags["rpsd"], size_t(PSD_VALUES));
+            QCOMPARE(mapTags["rpir"], size_t(PIR_VALUES + 4));
+            QVERIFY(mapTags["rpil"] > 0);
+        }
+    }
+}
+
+void TagPacketTest::bench_frame_data()
+{
+    test_profiles_data();
+}
+
+/* Everything done for RSCI output per DRM frame: all tag items, the tag
+   packet and the AF packet of one subscriber */
+void TagPacketTest::bench_frame()
+{
+    QFETCH(char, profile);
+
+    CDownstreamDI DI;
+    QVERIFY(DI.AddSubscriber("127.0.0.1:" + QByteArray::number(TEST_PORT).toStdString(), profile));
+
+    FillFrame();
+    QBENCHMARK
+    {
+        vecMSCData[0].Put(MSC_STREAM_BYTES * SIZEOF__BYTE);
+        FACData.Put(NUM_FAC_BITS_PER_BLOCK);
+        DI.SendLockedFrame(Parameter, FACData, SDCData, vecMSCData);
+    }
+}
+
+QTEST_APPLESS_MAIN(TagPacketTest)
+
+#include "tst_tagpackettest.moc"
@@ -0,0 +1,135 @@
+# Receiver sources shared by the test projects
+INCLUDEPATH += /usr/local/include
+LIBS += -lfftw3 -lz -lspeexdsp
+LIBS += -L/usr/local/lib
+unix:SOURCES += $$PWD/../src/linux/Pacer.cpp
+win32:SOURCES += $$PWD/../src/windows/Pacer.cpp
+SOURCES += \
+    $$PWD/../src/AMDemodulation.cpp \
+    $$PWD/../src/AMSSDemodulation.cpp \
+    $$PWD/../src/AudioPlayout.cpp \
+    $$PWD/../src/chanest/ChanEstTime.cpp \
+    $$PWD/../src/chanest/ChannelEstimation.cpp \
+    $$PWD/../src/chanest/IdealChannelEstimation.cpp \
+    $$PWD/../src/chanest/TimeLinear.cpp \
+    $$PWD/../src/chanest/TimeWiener.cpp \
+    $$PWD/../src/datadecoding/DABMOT.cpp \
+    $$PWD/../src/datadecoding/DataDecoder.cpp \
+    $$PWD/../src/datadecoding/DataEncoder.cpp \
+    $$PWD/../src/datadecoding/epgutil.cpp \
+    $$PWD/../src/datadecoding/Experiment.cpp \
+    $$PWD/../src/datadecoding/Journaline.cpp \
+    $$PWD/../src/datadecoding/journaline/crc_8_16.c \
+    $$PWD/../src/datadecoding/journaline/dabdgdec_impl.c \
+    $$PWD/../src/datadecoding/journaline/log.c \
+    $$PWD/../src/datadecoding/journaline/newsobject.cpp \
+    $$PWD/../src/datadecoding/journaline/newssvcdec_impl.cpp \
+    $$PWD/../src/datadecoding/journaline/NML.cpp \
+    $$PWD/../src/datadecoding/journaline/Splitter.cpp \
+    $$PWD/../src/datadecoding/MOTSlideShow.cpp \
+    $$PWD/../src/DataIO.cpp \
+    $$PWD/../src/drmchannel/ChannelSimulation.cpp \
+    $$PWD/../src/DrmReceiver.cpp \
+    $$PWD/../src/DRMSignalIO.cpp \
+    $$PWD/../src/DrmSimulation.cpp \
+    $$PWD/../src/DrmTransmitter.cpp \
+    $$PWD/../src/FAC/FAC.cpp \
+    $$PWD/../src/FastStartCache.cpp \
+    $$PWD/../src/InputResample.cpp \
+    $$PWD/../src/interleaver/BlockInterleaver.cpp \
+    $$PWD/../src/interleaver/SymbolInterleaver.cpp \
+    $$PWD/../src/IQInputFilter.cpp \
+    $$PWD/../src/matlib/MatlibSigProToolbox.cpp \
+    $$PWD/../src/matlib/MatlibStdToolbox.cpp \
+    $$PWD/../src/MDI/AFPacketGenerator.cpp \
+    $$PWD/../src/MDI/MDIDecode.cpp \
+    $$PWD/../src/MDI/MDIInBuffer.cpp \
+    $$PWD/../src/MDI/MDIRSCI.cpp \
+    $$PWD/../src/MDI/MDITagItemDecoders.cpp \
+    $$PWD/../src/MDI/MDITagItems.cpp \
+    $$PWD/../src/MDI/PacketIngest.cpp \
+    $$PWD/../src/MDI/PacketSinkFile.cpp \
+    $$PWD/../src/MDI/PacketSocket.cpp \
+    $$PWD/../src/MDI/PacketSourceFile.cpp \
+    $$PWD/../src/MDI/Pft.cpp \
+    $$PWD/../src/MDI/RCITagItems.cpp \
+    $$PWD/../src/MDI/RSCITagItemDecoders.cpp \
+    $$PWD/../src/MDI/RSISubscriber.cpp \
+    $$PWD/../src/MDI/TagPacketDecoder.cpp \
+    $$PWD/../src/MDI/TagPacketDecoderMDI.cpp \
+    $$PWD/../src/MDI/TagPacketDecoderRSCIControl.cpp \
+    $$PWD/../src/MDI/TagPacketGenerator.cpp \
+    $$PWD/../src/mlc/BitInterleaver.cpp \
+    $$PWD/../src/mlc/ChannelCode.cpp \
+    $$PWD/../src/mlc/ConvEncoder.cpp \
+    $$PWD/../src/mlc/EnergyDispersal.cpp \
+    $$PWD/../src/mlc/Metric.cpp \
+    $$PWD/../src/mlc/MLC.cpp \
+    $$PWD/../src/mlc/QAMMapping.cpp \
+    $$PWD/../src/mlc/TrellisUpdateMMX.cpp \
+    $$PWD/../src/mlc/TrellisUpdateSSE2.cpp \
+    $$PWD/../src/mlc/ViterbiDecoder.cpp \
+    $$PWD/../src/MSCMultiplexer.cpp \
+    $$PWD/../src/ofdmcellmapping/CellMappingTable.cpp \
+    $$PWD/../src/ofdmcellmapping/OFDMCellMapping.cpp \
+    $$PWD/../src/OFDM.cpp \
+    $$PWD/../src/Parameter.cpp \
+    $$PWD/../src/PlotManager.cpp \
+    $$PWD/../src/ReceptLog.cpp \
+    $$PWD/../src/resample/Resample.cpp \
+    $$PWD/../src/resample/ResampleFilter.cpp \
+    $$PWD/../src/Scheduler.cpp \
+    $$PWD/../src/SDC/SDCReceive.cpp \
+    $$PWD/../src/SDC/SDCTransmit.cpp \
+    $$PWD/../src/SDC/audioparam.cpp \
+    $$PWD/../src/ServiceInformation.cpp \
+    $$PWD/../src/SimulationParameters.cpp \
+    $$PWD/../src/sound/audiofilein.cpp \
+    $$PWD/../src/sound/mmapfilein.cpp \
+    $$PWD/../src/sound/pipein.cpp \
+    $$PWD/../src/sound/pipeout.cpp \
+    $$PWD/../src/sound/sampleformat.cpp \
+    $$PWD/../src/sourcedecoders/aac_codec.cpp \
+    $$PWD/../src/sourcedecoders/AudioCodec.cpp \
+    $$PWD/../src/sourcedecoders/AudioSourceDecoder.cpp \
+    $$PWD/../src/sourcedecoders/AudioSourceEncoder.cpp \
+    $$PWD/../src/sourcedecoders/MultiServiceDecoder.cpp \
+    $$PWD/../src/sourcedecoders/null_codec.cpp \
+    $$PWD/../src/sourcedecoders/opus_codec.cpp \
+    $$PWD/../src/sync/FreqSyncAcq.cpp \
+    $$PWD/../src/sync/SyncUsingPil.cpp \
+    $$PWD/../src/sync/TimeSync.cpp \
+    $$PWD/../src/sync/TimeSyncFilter.cpp \
+    $$PWD/../src/sync/TimeSyncTrack.cpp \
+    $$PWD/../src/tables/TableCarMap.cpp \
+    $$PWD/../src/tables/TableFAC.cpp \
+    $$PWD/../src/tables/TableStations.cpp \
+    $$PWD/../src/TextMessage.cpp \
+    $$PWD/../src/util/CRC.cpp \
+    $$PWD/../src/util/FileTyper.cpp \
+    $$PWD/../src/util/IQFileWriter.cpp \
+    $$PWD/../src/util/LogPrint.cpp \
+    $$PWD/../src/util/MediaStore.cpp \
+    $$PWD/../src/util/Metrics.cpp \
+    $$PWD/../src/util/PcmSink.cpp \
+    $$PWD/../src/util/Reassemble.cpp \
+    $$PWD/../src/util/ReedSolomon.cpp \
+    $$PWD/../src/util/Settings.cpp \
+    $$PWD/../src/util/StatusBroadcast.cpp \
+    $$PWD/../src/util/Utilities.cpp \
+    $$PWD/../src/util/WorkerPool.cpp \
+    $$PWD/../src/Version.cpp \
+    $$PWD/../src/sound/soundnull.cpp \
+    $$PWD/../src/DrmTransceiver.cpp \
+    $$PWD/../src/sound/soundinterface.cpp \
+    $$PWD/../src/sound/selectioninterface.cpp \
+    $$PWD/../src/MSC/logicalframe.cpp \
+    $$PWD/../src/MSC/audiosuperframe.cpp \
+    $$PWD/../src/MSC/aacsuperframe.cpp \
+    $$PWD/../src/MSC/xheaacsuperframe.cpp \
+    $$PWD/../src/MSC/frameborderdescription.cpp \
+    $$PWD/../src/resample/speexresampler.cpp \
+    $$PWD/../src/resample/cspectrumresample.cpp \
+    $$PWD/../src/resample/caudioresample.cpp \
+    $$PWD/../src/sourcedecoders/reverb.cpp \
+    $$PWD/../src/sourcedecoders/caudioreverb.cpp
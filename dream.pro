@@ -467,6 +467,7 @@ HEADERS += \
     src/AM_AGC.h \
     src/AMDemodulation.h \
     src/AMSSDemodulation.h \
+    src/AudioPlayout.h \
     src/chanest/ChanEstTime.h \
     src/chanest/ChannelEstimation.h \
     src/chanest/IdealChannelEstimation.h \
@@ -498,6 +499,7 @@ HEADERS += \
     src/DrmTransceiver.h \
     src/DrmTransmitter.h \
     src/FAC/FAC.h \
+    src/FastStartCache.h \
     src/GlobalDefinitions.h \
     src/InputResample.h \
     src/interleaver/BlockInterleaver.h \
@@ -509,11 +511,13 @@ HEADERS += \
     src/MDI/AFPacketGenerator.h \
     src/MDI/MDIDecode.h \
     src/MDI/MDIDefinitions.h \
+    src/MDI/MDIHost.h \
     src/MDI/MDIInBuffer.h \
     src/MDI/MDIRSCI.h \
     src/MDI/MDITagItemDecoders.h \
     src/MDI/MDITagItems.h \
     src/MDI/PacketInOut.h \
+    src/MDI/PacketIngest.h \
     src/MDI/PacketSinkFile.h \
     src/MDI/PacketSocket.h \
     src/MDI/PacketSourceFile.h \
@@ -548,6 +552,10 @@ HEADERS += \
     src/SDC/audioparam.h \
     src/ServiceInformation.h \
     src/sound/audiofilein.h \
+    src/sound/mmapfilein.h \
+    src/sound/pipein.h \
+    src/sound/pipeout.h \
+    src/sound/sampleformat.h \
     src/sound/selectioninterface.h \
     src/sound/sound.h \
     src/sound/soundinterface.h \
@@ -556,6 +564,7 @@ HEADERS += \
     src/sourcedecoders/AudioCodec.h \
     src/sourcedecoders/AudioSourceDecoder.h \
     src/sourcedecoders/AudioSourceEncoder.h \
+    src/sourcedecoders/MultiServiceDecoder.h \
     src/sourcedecoders/null_codec.h \
     src/sourcedecoders/opus_codec.h \
     src/spectrumanalyser.h \
@@ -574,18 +583,27 @@ HEADERS += \
     src/TextMessage.h \
     src/UpsampleFilter.h \
     src/util/AudioFile.h \
+    src/util/BandScanner.h \
+    src/util/BatchDecoder.h \
+    src/util/BitStream.h \
     src/util/Buffer.h \
     src/util/CRC.h \
     src/util/FileTyper.h \
+    src/util/IQFileWriter.h \
     src/util/LibraryLoader.h \
     src/util/LogPrint.h \
+    src/util/MediaStore.h \
+    src/util/Metrics.h \
     src/util/Modul.h \
     src/util/Pacer.h \
+    src/util/PcmSink.h \
     src/util/Reassemble.h \
+    src/util/ReedSolomon.h \
     src/util/Settings.h \
     src/util/StatusBroadcast.h \
     src/util/Utilities.h \
     src/util/Vector.h \
+    src/util/WorkerPool.h \
     src/Version.h \
     src/MSC/logicalframe.h \
     src/MSC/audiosuperframe.h \
@@ -601,6 +619,7 @@ SOURCES += \
     src/AM_AGC.cpp \
     src/AMDemodulation.cpp \
     src/AMSSDemodulation.cpp \
+    src/AudioPlayout.cpp \
     src/chanest/ChanEstTime.cpp \
     src/chanest/ChannelEstimation.cpp \
     src/chanest/IdealChannelEstimation.cpp \
@@ -628,6 +647,7 @@ SOURCES += \
     src/DrmSimulation.cpp \
     src/DrmTransmitter.cpp \
     src/FAC/FAC.cpp \
+    src/FastStartCache.cpp \
     src/InputResample.cpp \
     src/interleaver/BlockInterleaver.cpp \
     src/interleaver/SymbolInterleaver.cpp \
@@ -636,10 +656,12 @@ SOURCES += \
     src/matlib/MatlibStdToolbox.cpp \
     src/MDI/AFPacketGenerator.cpp \
     src/MDI/MDIDecode.cpp \
+    src/MDI/MDIHost.cpp \
     src/MDI/MDIInBuffer.cpp \
     src/MDI/MDIRSCI.cpp \
     src/MDI/MDITagItemDecoders.cpp \
     src/MDI/MDITagItems.cpp \
+    src/MDI/PacketIngest.cpp \
     src/MDI/PacketSinkFile.cpp \
     src/MDI/PacketSocket.cpp \
     src/MDI/PacketSourceFile.cpp \
@@ -677,10 +699,15 @@ SOURCES += \
     src/ServiceInformation.cpp \
     src/SimulationParameters.cpp \
     src/sound/audiofilein.cpp \
+    src/sound/mmapfilein.cpp \
+    src/sound/pipein.cpp \
+    src/sound/pipeout.cpp \
+    src/sound/sampleformat.cpp \
     src/sourcedecoders/aac_codec.cpp \
     src/sourcedecoders/AudioCodec.cpp \
     src/sourcedecoders/AudioSourceDecoder.cpp \
     src/sourcedecoders/AudioSourceEncoder.cpp \
+    src/sourcedecoders/MultiServiceDecoder.cpp \
     src/sourcedecoders/null_codec.cpp \
     src/sourcedecoders/opus_codec.cpp \
     src/spectrumanalyser.cpp \
@@ -693,14 +720,22 @@ SOURCES += \
     src/tables/TableFAC.cpp \
     src/tables/TableStations.cpp \
     src/TextMessage.cpp \
+    src/util/BandScanner.cpp \
+    src/util/BatchDecoder.cpp \
     src/util/CRC.cpp \
     src/util/FileTyper.cpp \
     src/util/Fir.cpp \
+    src/util/IQFileWriter.cpp \
     src/util/LogPrint.cpp \
+    src/util/MediaStore.cpp \
+    src/util/Metrics.cpp \
+    src/util/PcmSink.cpp \
     src/util/Reassemble.cpp \
+    src/util/ReedSolomon.cpp \
     src/util/Settings.cpp \
     src/util/StatusBroadcast.cpp \
     src/util/Utilities.cpp \
+    src/util/WorkerPool.cpp \
     src/Version.cpp \
     src/sound/soundnull.cpp \
     src/DrmTransceiver.cpp \
@@ -167,7 +167,7 @@ void CAMDemodulation::ProcessDataInternal(CParameter& Parameters)
     /* Write mono signal in both channels (left and right) */
     for (i = 0; i < iResOutBlockSize; i++)
         (*pvecOutputData)[2 * i] = (*pvecOutputData)[2 * i + 1] =
-            Real2Sample(vecTempResBufOut[i]);
+            _AUDIO(vecTempResBufOut[i]);
 }
 
 void CAMDemodulation::InitInternal(CParameter& Parameters)
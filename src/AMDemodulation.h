@@ -219,7 +219,7 @@ protected:
 };
 
 /* AM demodulation module --------------------------------------------------- */
-class CAMDemodulation : public CReceiverModul<_REAL, _SAMPLE>
+class CAMDemodulation : public CReceiverModul<_REAL, _AUDIO>
 {
 public:
     CAMDemodulation();
@@ -0,0 +1,457 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Audio decoding and playout on a thread of its own, with a jitter buffer
+ *  and adaptive resampling
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "AudioPlayout.h"
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+
+/* CWriteData plays 400 ms blocks */
+static const int BLOCK_MS = 400;
+
+/* Frames the receiver may queue while the thread is busy, about 16 s */
+static const size_t MAX_QUEUED_ITEMS = 40;
+
+/* Sleep while there is nothing to play */
+static const int IDLE_WAIT_MS = 100;
+
+/* The input comes in bursts, so the control looks at a long term average
+   of the fill, about 8 s */
+static const _REAL FILL_AVERAGING = (_REAL) 0.05;
+
+/* Ratio change per relative fill error, and the largest change. 2000 ppm
+   are about 3.5 cent, not audible. A fill error settles within a few
+   minutes, much slower than the averaging */
+static const _REAL RATIO_GAIN = (_REAL) 0.01;
+static const _REAL MAX_RATIO_OFFSET = (_REAL) 0.002;
+
+/* More than this many targets in the buffer, e.g. after the host stalled,
+   is dropped down to the target */
+static const int MAX_FILL_TARGETS = 3;
+
+#ifdef HAVE_SPEEX
+/* Ratios are given as a fraction of this */
+static const spx_uint32_t RATIO_BASE = 1000000;
+static const int RESAMPLING_QUALITY = 5;
+#endif
+
+CAudioPlayout::CAudioPlayout(CAudioSourceDecoder& NewDecoder, CWriteData& NewWriteData)
+    : Decoder(NewDecoder), WriteData(NewWriteData), pParameters(nullptr),
+      Queue(), vecFree(), Mutex(), Cond(), PlayoutThread(), bRunning(false),
+      bStop(false), bResetPending(false), bInitPending(false), iTargetMs(800),
+      StreamBuf(), DecodedBuf(), OutputBuf(), vecfFifo(),
+      iSampleRate(0), iBlockFrames(0), iTargetFrames(0), bPlaying(false),
+      NextWrite(), WakeUp(), rAvFill(0), rRatio(1),
+#ifdef HAVE_SPEEX
+      pResampler(nullptr),
+#else
+      ResampleL(), ResampleR(),
+#endif
+      iLatencyMs(0), iRatioPPM(0), iUnderruns(0), iOverruns(0),
+      iNumCorDecAudio(0)
+{
+}
+
+CAudioPlayout::~CAudioPlayout()
+{
+    Stop();
+#ifdef HAVE_SPEEX
+    if (pResampler != nullptr)
+        speex_resampler_destroy(pResampler);
+#endif
+}
+
+void CAudioPlayout::Start(CParameter& Parameters)
+{
+    if (bRunning)
+        return;
+
+    pParameters = &Parameters;
+    bStop = false;
+    bResetPending = true;
+    bInitPending = false;
+    Decoder.SetInitFlag();
+    bRunning = true;
+    PlayoutThread = std::thread(&CAudioPlayout::PlayoutLoop, this);
+}
+
+void CAudioPlayout::Stop()
+{
+    if (!bRunning)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        bStop = true;
+    }
+    Cond.notify_all();
+    PlayoutThread.join();
+    bRunning = false;
+
+    /* The receiver decodes itself again */
+    Queue.clear();
+    Decoder.SetInitFlag();
+}
+
+bool CAudioPlayout::PushStream(CBuffer<_BINARY>& InputBuf)
+{
+    const int iLen = InputBuf.GetFillLevel();
+    if (iLen == 0)
+        return false;
+    CVectorEx<_BINARY>* pvecData = InputBuf.Get(iLen);
+
+    std::lock_guard<std::mutex> lock(Mutex);
+    if (Queue.size() >= MAX_QUEUED_ITEMS)
+    {
+        iOverruns++;
+        return false;
+    }
+    if (vecFree.empty())
+        vecFree.push_back(CItem());
+    CItem Item = std::move(vecFree.back());
+    vecFree.pop_back();
+
+    Item.bStream = true;
+    Item.vecbiStream.assign(&(*pvecData)[0], &(*pvecData)[0] + iLen);
+    Queue.push_back(std::move(Item));
+    Cond.notify_one();
+    return true;
+}
+
+bool CAudioPlayout::PushAudio(CBuffer<_AUDIO>& AudioBuf)
+{
+    const int iLen = AudioBuf.GetFillLevel();
+    if (iLen == 0)
+        return false;
+    CVectorEx<_AUDIO>* pvecData = AudioBuf.Get(iLen);
+
+    std::lock_guard<std::mutex> lock(Mutex);
+    if (Queue.size() >= MAX_QUEUED_ITEMS)
+    {
+        iOverruns++;
+        return false;
+    }
+    if (vecFree.empty())
+        vecFree.push_back(CItem());
+    CItem Item = std::move(vecFree.back());
+    vecFree.pop_back();
+
+    Item.bStream = false;
+    Item.vecfAudio.assign(&(*pvecData)[0], &(*pvecData)[0] + iLen);
+    Queue.push_back(std::move(Item));
+    Cond.notify_one();
+    return true;
+}
+
+void CAudioPlayout::RequestInit()
+{
+    if (!bRunning)
+    {
+        Decoder.SetInitFlag();
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(Mutex);
+    bInitPending = true;
+}
+
+void CAudioPlayout::Reset()
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+    while (!Queue.empty())
+    {
+        vecFree.push_back(std::move(Queue.front()));
+        Queue.pop_front();
+    }
+    bResetPending = true;
+    Cond.notify_one();
+}
+
+void CAudioPlayout::PlayoutLoop()
+{
+    std::deque<CItem> Items;
+    std::unique_lock<std::mutex> lock(Mutex);
+    while (!bStop)
+    {
+        if (Queue.empty() && !bResetPending)
+        {
+            /* Wake up in time for the next block */
+            if (bPlaying)
+                Cond.wait_until(lock, WakeUp);
+            else
+                Cond.wait_for(lock, std::chrono::milliseconds(IDLE_WAIT_MS));
+            if (bStop)
+                break;
+        }
+
+        const bool bReset = bResetPending;
+        const bool bInit = bInitPending;
+        bResetPending = false;
+        bInitPending = false;
+        Items.swap(Queue);
+        lock.unlock();
+
+        if (bReset)
+            Flush();
+        if (bInit)
+            Decoder.SetInitFlag();
+        for (size_t i = 0; i < Items.size(); i++)
+            DecodeItem(Items[i]);
+        Play();
+
+        lock.lock();
+        while (!Items.empty())
+        {
+            vecFree.push_back(std::move(Items.front()));
+            Items.pop_front();
+        }
+    }
+}
+
+void CAudioPlayout::Flush()
+{
+    vecfFifo.clear();
+    StreamBuf.Clear();
+    DecodedBuf.Clear();
+    OutputBuf.Clear();
+    bPlaying = false;
+    rAvFill = 0;
+    rRatio = 1;
+    iLatencyMs = 0;
+    iRatioPPM = 0;
+#ifdef HAVE_SPEEX
+    if (pResampler != nullptr)
+        speex_resampler_reset_mem(pResampler);
+#else
+    vecrResInL.Init(0);
+#endif
+}
+
+void CAudioPlayout::DecodeItem(CItem& Item)
+{
+    if (!Item.bStream)
+    {
+        AddAudio(&Item.vecfAudio[0], int(Item.vecfAudio.size() / 2));
+        return;
+    }
+
+    /* Same as the audio stream buffer of the receiver, one frame */
+    const int iLen = int(Item.vecbiStream.size());
+    if (StreamBuf.QueryWriteBuffer()->Size() < iLen)
+        StreamBuf.Init(iLen);
+    StreamBuf.Clear();
+    CVectorEx<_BINARY>& vecbiData = *StreamBuf.QueryWriteBuffer();
+    for (int i = 0; i < iLen; i++)
+        vecbiData[i] = Item.vecbiStream[size_t(i)];
+    StreamBuf.Put(iLen);
+
+    const bool bDecoded = Decoder.ProcessData(*pParameters, StreamBuf, DecodedBuf);
+
+    /* Only this thread may touch the decoder, the counter too */
+    iNumCorDecAudio += Decoder.GetNumCorDecAudio();
+
+    if (bDecoded)
+    {
+        const int iOut = DecodedBuf.GetFillLevel();
+        if (iOut > 0)
+            AddAudio(&(*DecodedBuf.Get(iOut))[0], iOut / 2);
+    }
+}
+
+void CAudioPlayout::AddAudio(const _AUDIO* pfData, const int iNumFrames)
+{
+    if (iNumFrames <= 0)
+        return;
+
+    /* A new sample rate starts from scratch */
+    pParameters->Lock();
+    const int iNewSampleRate = pParameters->GetAudSampleRate();
+    pParameters->Unlock();
+    if (iNewSampleRate != iSampleRate)
+    {
+        iSampleRate = iNewSampleRate;
+        iBlockFrames = int(_REAL(iSampleRate) * BLOCK_MS / 1000);
+        Flush();
+#ifdef HAVE_SPEEX
+        if (pResampler != nullptr)
+            speex_resampler_destroy(pResampler);
+        int iErr = RESAMPLER_ERR_SUCCESS;
+        pResampler = speex_resampler_init_frac(2, RATIO_BASE, RATIO_BASE, spx_uint32_t(iSampleRate),
+                                               spx_uint32_t(iSampleRate), RESAMPLING_QUALITY, &iErr);
+        if (pResampler == nullptr)
+            fprintf(stderr, "AudioPlayout: libspeexdsp error: %s\n", speex_resampler_strerror(iErr));
+        else
+            speex_resampler_skip_zeros(pResampler);
+#endif
+    }
+
+    const size_t iOldSize = vecfFifo.size();
+    const size_t iMaxOut = size_t(_REAL(iNumFrames) * (1 + MAX_RATIO_OFFSET)) + 16;
+
+#ifdef HAVE_SPEEX
+    if (pResampler != nullptr)
+    {
+        vecfFifo.resize(iOldSize + iMaxOut * 2);
+
+        spx_uint32_t iInLen = spx_uint32_t(iNumFrames);
+        spx_uint32_t iOutLen = spx_uint32_t(iMaxOut);
+        speex_resampler_process_interleaved_float(pResampler, pfData, &iInLen,
+                                                  &vecfFifo[iOldSize], &iOutLen);
+        vecfFifo.resize(iOldSize + size_t(iOutLen) * 2);
+    }
+    else
+    {
+        vecfFifo.insert(vecfFifo.end(), pfData, pfData + size_t(iNumFrames) * 2);
+    }
+#else
+    /* The resampler works on fixed size blocks, which the decoder output
+       is anyway */
+    if (vecrResInL.Size() != iNumFrames)
+    {
+        vecrResInL.Init(iNumFrames);
+        vecrResInR.Init(iNumFrames);
+        vecrResOutL.Init(int(iMaxOut));
+        vecrResOutR.Init(int(iMaxOut));
+        ResampleL.Init(iNumFrames);
+        ResampleR.Init(iNumFrames);
+    }
+    for (int i = 0; i < iNumFrames; i++)
+    {
+        vecrResInL[i] = pfData[2 * i];
+        vecrResInR[i] = pfData[2 * i + 1];
+    }
+    const int iOutLen = ResampleL.Resample(&vecrResInL, &vecrResOutL, rRatio);
+    ResampleR.Resample(&vecrResInR, &vecrResOutR, rRatio);
+    vecfFifo.resize(iOldSize + size_t(iOutLen) * 2);
+    for (int i = 0; i < iOutLen; i++)
+    {
+        vecfFifo[iOldSize + 2 * size_t(i)] = float(vecrResOutL[i]);
+        vecfFifo[iOldSize + 2 * size_t(i) + 1] = float(vecrResOutR[i]);
+    }
+#endif
+
+    /* The fill jumps by a block with each write, the time to the next write
+       makes up for it. In the steady state this is the target */
+    if (bPlaying)
+    {
+        const int64_t iToNextUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                                      NextWrite - std::chrono::steady_clock::now()).count();
+        UpdateRatio(int(vecfFifo.size() / 2) - iBlockFrames + int(iToNextUs * iSampleRate / 1000000));
+    }
+}
+
+void CAudioPlayout::UpdateRatio(const int iFillFrames)
+{
+    rAvFill += FILL_AVERAGING * (_REAL(iFillFrames) - rAvFill);
+    iLatencyMs = int(rAvFill * 1000 / _REAL(iSampleRate));
+
+    /* Too full: the input clock is faster, make fewer samples of it */
+    const _REAL rError = (rAvFill - _REAL(iTargetFrames)) / _REAL(iTargetFrames);
+    rRatio = 1 - std::max(-MAX_RATIO_OFFSET, std::min(MAX_RATIO_OFFSET, RATIO_GAIN * rError));
+    const int iNewPPM = int(std::lround((rRatio - 1) * 1e6));
+    if (iNewPPM == iRatioPPM)
+        return;
+    iRatioPPM = iNewPPM;
+
+#ifdef HAVE_SPEEX
+    if (pResampler != nullptr)
+    {
+        speex_resampler_set_rate_frac(pResampler, RATIO_BASE, spx_uint32_t(std::lround(RATIO_BASE * rRatio)),
+                                      spx_uint32_t(iSampleRate), spx_uint32_t(iSampleRate));
+    }
+#endif
+}
+
+void CAudioPlayout::Play()
+{
+    if (iBlockFrames == 0)
+        return;
+
+    int iFill = int(vecfFifo.size() / 2);
+    if (!bPlaying)
+    {
+        /* The first two blocks go to the sound card at once, see below */
+        iTargetFrames = std::max(iBlockFrames, int(_REAL(iSampleRate) * iTargetMs / 1000));
+        if (iFill < iTargetFrames + iBlockFrames)
+            return;
+
+        bPlaying = true;
+        rAvFill = _REAL(iTargetFrames);
+        NextWrite = std::chrono::steady_clock::now();
+    }
+
+    const std::chrono::microseconds BlockTime(int64_t(iBlockFrames) * 1000000 / iSampleRate);
+    const std::chrono::steady_clock::time_point Now = std::chrono::steady_clock::now();
+
+    /* After a stall of the host the blocks aren't made up for */
+    if (Now - NextWrite > 2 * BlockTime)
+        NextWrite = Now;
+
+    /* Blocks are written up to one block ahead of time, so the sound card
+       always has some audio */
+    while (NextWrite - Now <= BlockTime)
+    {
+        if (iFill < iBlockFrames)
+        {
+            /* The sound card still plays the last block, the next superframe
+               may come in time */
+            if (NextWrite > Now)
+            {
+                WakeUp = NextWrite;
+                return;
+            }
+
+            /* Nothing left to play, start again with a full buffer */
+            iUnderruns++;
+            bPlaying = false;
+            return;
+        }
+
+        if (iFill > MAX_FILL_TARGETS * iTargetFrames)
+        {
+            const size_t iDrop = size_t(iFill - iTargetFrames) * 2;
+            vecfFifo.erase(vecfFifo.begin(), vecfFifo.begin() + std::ptrdiff_t(iDrop));
+            iFill = iTargetFrames;
+            rAvFill = _REAL(iFill);
+            iOverruns++;
+        }
+
+        const int iLen = iBlockFrames * 2;
+        if (OutputBuf.QueryWriteBuffer()->Size() < iLen)
+            OutputBuf.Init(iLen);
+        OutputBuf.Clear();
+        std::copy(vecfFifo.begin(), vecfFifo.begin() + iLen, OutputBuf.QueryWriteBuffer()->begin());
+        OutputBuf.Put(iLen);
+        WriteData.WriteData(*pParameters, OutputBuf);
+
+        vecfFifo.erase(vecfFifo.begin(), vecfFifo.begin() + iLen);
+        iFill -= iBlockFrames;
+        NextWrite += BlockTime;
+    }
+    WakeUp = NextWrite - BlockTime;
+}
@@ -0,0 +1,181 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Audio decoding and playout on a thread of its own, with a jitter buffer
+ *  and adaptive resampling
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#ifndef AUDIO_PLAYOUT_H_INCLUDED
+#define AUDIO_PLAYOUT_H_INCLUDED
+
+#include "GlobalDefinitions.h"
+#include "DataIO.h"
+#include "sourcedecoders/AudioSourceDecoder.h"
+#include "util/Buffer.h"
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+
+#ifdef HAVE_SPEEX
+# include <speex/speex_resampler.h>
+#else
+# include "resample/Resample.h"
+#endif
+
+/**
+ * @brief Decodes the audio stream and feeds the sound card on its own
+ * thread
+ *
+ * Without it, the DSP loop decodes the audio frames of a superframe in one
+ * go and then writes the audio to the sound card. Here the receiver only
+ * queues the audio stream of each frame (or, for AM, FM and warm services,
+ * the audio itself) and goes on with the next symbols.
+ *
+ * The decoded audio goes into a jitter buffer which is played out in
+ * 400 ms blocks by the steady clock of the host. Playout starts once the
+ * buffer holds the target latency. The audio arrives at the pace of the
+ * input clock, so the two clocks are matched by resampling the audio
+ * slightly, steered by the average fill of the buffer, instead of
+ * dropping or repeating blocks. Only if the buffer runs empty (no signal)
+ * playout stops and starts again with a full buffer.
+ */
+class CAudioPlayout
+{
+public:
+    CAudioPlayout(CAudioSourceDecoder& NewDecoder, CWriteData& NewWriteData);
+    ~CAudioPlayout();
+
+    void Start(CParameter& Parameters);
+    void Stop();
+    bool IsRunning() const { return bRunning; }
+
+    /**
+     * @brief Audio kept in the jitter buffer, takes effect with the next
+     * start of playout
+     */
+    void SetTargetLatency(const int iNewMs) { iTargetMs = iNewMs; }
+    int GetTargetLatency() const { return iTargetMs; }
+
+    /**
+     * @brief Initialise the decoder before it decodes the next frame. While
+     * the thread runs, the decoder must only be touched by the thread
+     */
+    void RequestInit();
+
+    /**
+     * @brief Queue the audio stream of one frame for decoding, empties the
+     * buffer
+     * @return true if the frame was queued, false if there was none or the
+     * queue was full
+     */
+    bool PushStream(CBuffer<_BINARY>& StreamBuf);
+
+    /**
+     * @brief Queue decoded stereo audio, empties the buffer
+     * @return as PushStream()
+     */
+    bool PushAudio(CBuffer<_AUDIO>& AudioBuf);
+
+    /**
+     * @brief Drop everything queued and buffered, e.g. on a new receiver
+     * mode
+     */
+    void Reset();
+
+    /* Smoothed fill of the jitter buffer */
+    int GetLatency() const { return iLatencyMs.load(std::memory_order_relaxed); }
+    /* Current resampling ratio, in ppm off 1 */
+    int GetRatioPPM() const { return iRatioPPM.load(std::memory_order_relaxed); }
+    unsigned long GetUnderruns() const { return iUnderruns.load(std::memory_order_relaxed); }
+    unsigned long GetOverruns() const { return iOverruns.load(std::memory_order_relaxed); }
+    /* Correctly decoded audio blocks since the last call */
+    int GetNumCorDecAudio() { return iNumCorDecAudio.exchange(0, std::memory_order_relaxed); }
+
+protected:
+    struct CItem
+    {
+        bool                    bStream;
+        std::vector<_BINARY>    vecbiStream;
+        std::vector<_AUDIO>     vecfAudio;
+    };
+
+    void                PlayoutLoop();
+    void                DecodeItem(CItem& Item);
+    void                AddAudio(const _AUDIO* pfData, const int iNumFrames);
+    void                Play();
+    void                UpdateRatio(const int iFillFrames);
+    void                Flush();
+
+    CAudioSourceDecoder&    Decoder;
+    CWriteData&             WriteData;
+    CParameter*             pParameters;
+
+    /* Queue from the receiver, and item buffers ready for reuse */
+    std::deque<CItem>   Queue;
+    std::vector<CItem>  vecFree;
+    std::mutex          Mutex;
+    std::condition_variable Cond;
+    std::thread         PlayoutThread;
+    std::atomic<bool>   bRunning;
+    bool                bStop;
+    bool                bResetPending;
+    bool                bInitPending;
+    int                 iTargetMs;
+
+    /* Only used by the playout thread */
+    CSingleBuffer<_BINARY>  StreamBuf;
+    CSingleBuffer<_AUDIO>   DecodedBuf;
+    CSingleBuffer<_AUDIO>   OutputBuf;
+    std::vector<_AUDIO> vecfFifo;
+    int                 iSampleRate;
+    int                 iBlockFrames;
+    int                 iTargetFrames;
+    bool                bPlaying;
+    std::chrono::steady_clock::time_point NextWrite;
+    std::chrono::steady_clock::time_point WakeUp;
+    _REAL               rAvFill;
+    _REAL               rRatio;
+#ifdef HAVE_SPEEX
+    SpeexResamplerState*    pResampler;
+#else
+    CResample           ResampleL;
+    CResample           ResampleR;
+    CVector<_REAL>      vecrResInL;
+    CVector<_REAL>      vecrResInR;
+    CVector<_REAL>      vecrResOutL;
+    CVector<_REAL>      vecrResOutR;
+#endif
+
+    std::atomic<int>    iLatencyMs;
+    std::atomic<int>    iRatioPPM;
+    std::atomic<unsigned long> iUnderruns;
+    std::atomic<unsigned long> iOverruns;
+    std::atomic<int>    iNumCorDecAudio;
+};
+
+#endif // AUDIO_PLAYOUT_H_INCLUDED
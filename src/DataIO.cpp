@@ -35,6 +35,7 @@
 # include <QSet>
 #endif
 #include "sound/sound.h"
+#include "sound/pipeout.h"
 
 /* Implementation *************************************************************/
 /******************************************************************************\
@@ -172,9 +173,12 @@ CWriteData::CWriteData() :
     pAudioOutput(nullptr), pIODevice(nullptr),
 #endif
     pSound(nullptr), /* Sound interface */
-    bMuteAudio(false), bDoWriteWaveFile(false),
+    bMuteAudio(false), AudioWriter(), strRecordName(),
+    eRecordFormat(CIQFileWriter::IQ_WAV), bRotateHourly(false), bRotateOnService(false),
+    bDoWriteWaveFile(false), bRecordOpen(false), iRecordHour(-1),
+    iRecordServiceID(SERV_ID_NOT_USED), iRecordSampleRate(0), strRecordFile(), iRecordPart(0),
     bSoundBlocking(false), bNewSoundBlocking(false),
-    eOutChanSel(CS_BOTH_BOTH), rMixNormConst(MIX_OUT_CHAN_NORM_CONST),
+    eOutChanSel(CS_BOTH_BOTH), eOutputFormat(SMPFMT_S16), rMixNormConst(MIX_OUT_CHAN_NORM_CONST),
     iAudSampleRate(0), iNumSmpls4AudioSprectrum(0), iNumBlocksAvAudioSpec(0),
     iMaxAudioFrequency(MAX_SPEC_AUDIO_FREQUENCY)
 {
@@ -214,6 +218,24 @@ void CWriteData::Enumerate(std::vector<std::string>& names, std::vector<std::str
 void
 CWriteData::SetSoundInterface(string device)
 {
+    /* Headless outputs for a parent process, with and without sound cards */
+    if (CPipeOut::IsPipe(device))
+    {
+        CPipeOut* pPipeOut = new CPipeOut();
+        pPipeOut->SetDev(device);
+        pPipeOut->SetSampleFormat(eOutputFormat);
+#ifdef QT_MULTIMEDIA_LIB
+        if(pAudioOutput != nullptr) {
+            pAudioOutput->stop();
+            delete pAudioOutput;
+            pAudioOutput = nullptr;
+        }
+        pIODevice = nullptr;
+#endif
+        SetSoundInterface(pPipeOut);
+        return;
+    }
+
     soundDevice = device;
 #ifdef QT_MULTIMEDIA_LIB
     QAudioFormat format;
@@ -240,6 +262,11 @@ CWriteData::SetSoundInterface(string device)
     if(pAudioOutput == nullptr) {
         qDebug("Can't find audio output %s", device.c_str());
     }
+    if(pSound != nullptr) {
+        pSound->Close();
+        delete pSound;
+        pSound = nullptr;
+    }
 #else
     if(pSound != nullptr) {
         delete pSound;
@@ -250,6 +277,17 @@ CWriteData::SetSoundInterface(string device)
 #endif
 }
 
+void
+CWriteData::SetSoundInterface(CSoundOutInterface* pNewSound)
+{
+    if(pSound != nullptr) {
+        pSound->Close();
+        delete pSound;
+    }
+    pSound = pNewSound;
+    soundDevice = pSound->GetDev();
+}
+
 void CWriteData::ProcessDataInternal(CParameter& Parameters)
 {
     int i;
@@ -263,15 +301,15 @@ void CWriteData::ProcessDataInternal(CParameter& Parameters)
         /* left -> left, right -> right (vector sizes might not be the
            same -> use for-loop for copying) */
         for (i = 0; i < iInputBlockSize; i++)
-            vecsTmpAudData[i] = (*pvecInputData)[i]; /* Just copy data */
+            vecfTmpAudData[i] = (*pvecInputData)[i]; /* Just copy data */
         break;
 
     case CS_LEFT_LEFT:
         /* left -> left, right muted */
         for (i = 0; i < iHalfBlSi; i++)
         {
-            vecsTmpAudData[2 * i] = (*pvecInputData)[2 * i];
-            vecsTmpAudData[2 * i + 1] = 0; /* mute */
+            vecfTmpAudData[2 * i] = (*pvecInputData)[2 * i];
+            vecfTmpAudData[2 * i + 1] = 0; /* mute */
         }
         break;
 
@@ -279,8 +317,8 @@ void CWriteData::ProcessDataInternal(CParameter& Parameters)
         /* left muted, right -> right */
         for (i = 0; i < iHalfBlSi; i++)
         {
-            vecsTmpAudData[2 * i] = 0; /* mute */
-            vecsTmpAudData[2 * i + 1] = (*pvecInputData)[2 * i + 1];
+            vecfTmpAudData[2 * i] = 0; /* mute */
+            vecfTmpAudData[2 * i + 1] = (*pvecInputData)[2 * i + 1];
         }
         break;
 
@@ -288,15 +326,14 @@ void CWriteData::ProcessDataInternal(CParameter& Parameters)
         /* left -> mix, right muted */
         for (i = 0; i < iHalfBlSi; i++)
         {
-            /* Mix left and right channel together. Prevent overflow! First,
-               copy recorded data from "short" in "_REAL" type variables */
+            /* Mix left and right channel together */
             const _REAL rLeftChan = (*pvecInputData)[2 * i];
             const _REAL rRightChan = (*pvecInputData)[2 * i + 1];
 
-            vecsTmpAudData[2 * i] =
-                Real2Sample((rLeftChan + rRightChan) * rMixNormConst);
+            vecfTmpAudData[2 * i] =
+                _AUDIO((rLeftChan + rRightChan) * rMixNormConst);
 
-            vecsTmpAudData[2 * i + 1] = 0; /* mute */
+            vecfTmpAudData[2 * i + 1] = 0; /* mute */
         }
         break;
 
@@ -304,14 +341,13 @@ void CWriteData::ProcessDataInternal(CParameter& Parameters)
         /* left muted, right -> mix */
         for (i = 0; i < iHalfBlSi; i++)
         {
-            /* Mix left and right channel together. Prevent overflow! First,
-               copy recorded data from "short" in "_REAL" type variables */
+            /* Mix left and right channel together */
             const _REAL rLeftChan = (*pvecInputData)[2 * i];
             const _REAL rRightChan = (*pvecInputData)[2 * i + 1];
 
-            vecsTmpAudData[2 * i] = 0; /* mute */
-            vecsTmpAudData[2 * i + 1] =
-                Real2Sample((rLeftChan + rRightChan) * rMixNormConst);
+            vecfTmpAudData[2 * i] = 0; /* mute */
+            vecfTmpAudData[2 * i + 1] =
+                _AUDIO((rLeftChan + rRightChan) * rMixNormConst);
         }
         break;
     }
@@ -320,7 +356,7 @@ void CWriteData::ProcessDataInternal(CParameter& Parameters)
     {
         /* Clear both channels if muted */
         for (i = 0; i < iInputBlockSize; i++)
-            vecsTmpAudData[i] = 0;
+            vecfTmpAudData[i] = 0;
     }
 
     /* Put data to sound card interface. Show sound card state on GUI */
@@ -329,6 +365,7 @@ void CWriteData::ProcessDataInternal(CParameter& Parameters)
     bool bBad = true;
     if(pIODevice)
     {
+        Audio2Sample(vecfTmpAudData.data(), vecsTmpAudData.data(), vecfTmpAudData.Size());
         int n = 2*vecsTmpAudData.Size(); // bytes to write 2 = sizeof(_SAMPLE)
         char* buf = reinterpret_cast<char*>(&vecsTmpAudData[0]);
         while(n>0) {
@@ -345,8 +382,12 @@ void CWriteData::ProcessDataInternal(CParameter& Parameters)
         }
         bBad = false;
     }
+    else if (pSound != nullptr)
+    {
+        bBad = pSound->WriteAudio(vecfTmpAudData);
+    }
 #else
-    const bool bBad = pSound->Write(vecsTmpAudData);
+    const bool bBad = pSound->WriteAudio(vecfTmpAudData);
 #endif
     Parameters.Lock();
     Parameters.ReceiveStatus.InterfaceO.SetStatus(bBad ? DATA_ERROR : RX_OK); /* Yellow light */
@@ -354,27 +395,11 @@ void CWriteData::ProcessDataInternal(CParameter& Parameters)
 
     /* Write data as wave in file */
     if (bDoWriteWaveFile)
-    {
-        /* Write audio data to file only if it is not zero */
-        bool bDoNotWrite = true;
-        for (i = 0; i < iInputBlockSize; i++)
-        {
-            if ((*pvecInputData)[i] != 0)
-                bDoNotWrite = false;
-        }
-
-        if (bDoNotWrite == false)
-        {
-            for (i = 0; i < iInputBlockSize; i += 2)
-            {
-                WaveFileAudio.AddStereoSample((*pvecInputData)[i] /* left */,
-                                              (*pvecInputData)[i + 1] /* right */);
-            }
-        }
-    }
+        RecordAudio(Parameters);
 
     /* Store data in buffer for spectrum calculation */
-    vecsOutputData.AddEnd((*pvecInputData), iInputBlockSize);
+    if (ViewDemand.IsActive())
+        vecfOutputData.AddEnd((*pvecInputData), iInputBlockSize);
 }
 
 void CWriteData::InitInternal(CParameter& Parameters)
@@ -396,7 +421,7 @@ void CWriteData::InitInternal(CParameter& Parameters)
     iNumBlocksAvAudioSpec = int(ceil(_REAL(iAudSampleRate * TIME_AV_AUDIO_SPECT_MS) / 1000.0 / _REAL(iNumSmpls4AudioSprectrum)));
 
     /* Inits for audio spectrum plotting */
-    vecsOutputData.Init(iNumBlocksAvAudioSpec * iNumSmpls4AudioSprectrum * 2 /* stereo */, 0); /* Init with zeros */
+    vecfOutputData.Init(iNumBlocksAvAudioSpec * iNumSmpls4AudioSprectrum * 2 /* stereo */, 0); /* Init with zeros */
     FftPlan.Init(iNumSmpls4AudioSprectrum);
     veccFFTInput.Init(iNumSmpls4AudioSprectrum);
     veccFFTOutput.Init(iNumSmpls4AudioSprectrum);
@@ -426,12 +451,14 @@ void CWriteData::InitInternal(CParameter& Parameters)
 #endif
     if(pSound!=nullptr) pSound->Init(iAudSampleRate, iAudFrameSize * 2 /* stereo */, bSoundBlocking); // might be a sound file
 
-    /* Init intermediate buffer needed for different channel selections */
+    /* Init intermediate buffers needed for different channel selections
+       and the conversion to 16 bit */
+    vecfTmpAudData.Init(iAudFrameSize * 2 /* stereo */);
     vecsTmpAudData.Init(iAudFrameSize * 2 /* stereo */);
 
     /* Inits for audio spectrum plot */
     vecrAudioWindowFunction = Hann(iNumSmpls4AudioSprectrum);
-    vecsOutputData.Reset(0); /* Reset audio data storage vector */
+    vecfOutputData.Reset(0); /* Reset audio data storage vector */
 
     /* Define block-size for input (stereo input) */
     iInputBlockSize = iAudFrameSize * 2 /* stereo */;
@@ -439,27 +466,142 @@ void CWriteData::InitInternal(CParameter& Parameters)
 
 void CWriteData::StartWriteWaveFile(const string& strFileName)
 {
-    /* No Lock(), Unlock() needed here */
+    Lock();
+
+    /* The file is opened with the next block, when the sample rate is known */
     if (bDoWriteWaveFile == false)
     {
-        WaveFileAudio.Open(strFileName, iAudSampleRate);
+        strRecordName = strFileName;
+        strRecordFile.clear();
+        bRecordOpen = false;
         bDoWriteWaveFile = true;
     }
+
+    Unlock();
 }
 
 void CWriteData::StopWriteWaveFile()
 {
     Lock();
 
-    WaveFileAudio.Close();
+    AudioWriter.Close();
     bDoWriteWaveFile = false;
+    bRecordOpen = false;
 
     Unlock();
 }
 
+void CWriteData::SetRecordFormat(const string& strFormat)
+{
+    eRecordFormat = CIQFileWriter::FormatFromString(strFormat);
+    if ((eRecordFormat == CIQFileWriter::IQ_RAW) || !CIQFileWriter::IsSupported(eRecordFormat))
+    {
+        fprintf(stderr, "WriteData: %s recording not supported, writing wave files\n", strFormat.c_str());
+        eRecordFormat = CIQFileWriter::IQ_WAV;
+    }
+}
+
+void CWriteData::RecordAudio(CParameter& Parameters)
+{
+    time_t ltime;
+    time(&ltime);
+    struct tm* gmtCur = gmtime(&ltime);
+
+    Parameters.Lock();
+    const int iCurService = Parameters.GetCurSelAudioService();
+    const uint32_t iServiceID = ((iCurService >= 0) && (size_t(iCurService) < Parameters.Service.size())) ?
+                                Parameters.Service[size_t(iCurService)].iServiceID : SERV_ID_NOT_USED;
+    Parameters.Unlock();
+
+    /* Only a new service starts a new file, not losing the signal for a
+       while */
+    const bool bNewService = bRotateOnService && (iServiceID != SERV_ID_NOT_USED) &&
+                             (iServiceID != 0) && (iServiceID != iRecordServiceID);
+    if (!bRecordOpen || (iRecordSampleRate != iAudSampleRate) ||
+        (bRotateHourly && (gmtCur->tm_hour != iRecordHour)) || bNewService)
+    {
+        if ((iServiceID != SERV_ID_NOT_USED) && (iServiceID != 0))
+            iRecordServiceID = iServiceID;
+        iRecordHour = gmtCur->tm_hour;
+        iRecordSampleRate = iAudSampleRate;
+
+        /* Opus takes only some sample rates, the others are kept lossless */
+        CIQFileWriter::EFormat eFormat = eRecordFormat;
+        if (!CIQFileWriter::IsSupported(eFormat, iAudSampleRate))
+        {
+            eFormat = CIQFileWriter::IsSupported(CIQFileWriter::IQ_FLAC) ? CIQFileWriter::IQ_FLAC :
+                      CIQFileWriter::IQ_WAV;
+            fprintf(stderr, "WriteData: %s recording not supported at %d Hz, writing %s\n",
+                    CIQFileWriter::FormatToString(eRecordFormat).c_str(), iAudSampleRate,
+                    CIQFileWriter::FormatToString(eFormat).c_str());
+        }
+
+        /* A new file under the name of the last one, e.g. after a change of
+           the sample rate, gets a number so the recording so far is kept */
+        string strFile = RecordFileName(gmtCur, iRecordServiceID, eFormat);
+        iRecordPart = (strFile == strRecordFile) ? iRecordPart + 1 : 1;
+        strRecordFile = strFile;
+        if (iRecordPart > 1)
+        {
+            const size_t iDot = strFile.find_last_of('.');
+            const size_t iSlash = strFile.find_last_of("/\\");
+            const string strPart = "_" + to_string(iRecordPart);
+            if ((iDot != string::npos) && ((iSlash == string::npos) || (iDot > iSlash)))
+                strFile.insert(iDot, strPart);
+            else
+                strFile += strPart;
+        }
+
+        /* Ten seconds of stereo audio may wait for the disk */
+        AudioWriter.SetQueueSize(size_t(iAudSampleRate) * 2 * 10);
+        AudioWriter.SetSkipSilence(true);
+        AudioWriter.Open(strFile, iAudSampleRate, eFormat);
+        bRecordOpen = true;
+    }
+
+    /* The files are 16 bit. Only copied here, silence is left out by the
+       writer thread */
+    Audio2Sample(pvecInputData->data(), vecsTmpAudData.data(), iInputBlockSize);
+    AudioWriter.Write(&vecsTmpAudData[0], iInputBlockSize);
+}
+
+string CWriteData::RecordFileName(const struct tm* gmtCur, const uint32_t iServiceID,
+                                  const CIQFileWriter::EFormat eFormat) const
+{
+    const string strExt = CIQFileWriter::GetExtension(eFormat, iAudSampleRate);
+
+    /* The given name without extension */
+    string strBase = strRecordName;
+    const size_t iDot = strBase.find_last_of('.');
+    const size_t iSlash = strBase.find_last_of("/\\");
+    if ((iDot != string::npos) && ((iSlash == string::npos) || (iDot > iSlash)))
+        strBase.erase(iDot);
+
+    if (!bRotateHourly && !bRotateOnService)
+    {
+        /* The name as given, only the extension follows the format */
+        if (eFormat == CIQFileWriter::IQ_WAV)
+            return strRecordName;
+        return strBase + "." + strExt;
+    }
+
+    stringstream filename;
+    filename << strBase << "_";
+    filename << setw(4) << setfill('0') << gmtCur->tm_year + 1900 << "-" << setw(2) << setfill('0')<< gmtCur->tm_mon + 1;
+    filename << "-" << setw(2) << setfill('0')<< gmtCur->tm_mday << "_";
+    filename << setw(2) << setfill('0') << gmtCur->tm_hour << "-" << setw(2) << setfill('0')<< gmtCur->tm_min;
+    filename << "-" << setw(2) << setfill('0')<< gmtCur->tm_sec;
+    if (bRotateOnService && (iServiceID != SERV_ID_NOT_USED))
+        filename << "_" << hex << uppercase << iServiceID << dec;
+    filename << "." << strExt;
+    return filename.str();
+}
+
 void CWriteData::GetAudioSpec(CVector<_REAL>& vecrData,
                               CVector<_REAL>& vecrScale)
 {
+    ViewDemand.Request();
+
     if (iAudSampleRate == 0)
     {
         /* Init output vectors to zero data */
@@ -493,7 +635,7 @@ void CWriteData::GetAudioSpec(CVector<_REAL>& vecrData,
         for (j = 0; j < iNumSmpls4AudioSprectrum; j++)
         {
             int jj =  2*(iCurPosInStream + j);
-            veccFFTInput[j] = _REAL(vecsOutputData[jj] + vecsOutputData[jj + 1]) / 2;
+            veccFFTInput[j] = (_REAL(vecfOutputData[jj]) + vecfOutputData[jj + 1]) / 2;
         }
 
         /* Apply window function */
@@ -624,6 +766,10 @@ void CUtilizeSDCData::ProcessDataInternal(CParameter& Parameters)
     case CSDCReceive::SR_OK:
         Parameters.ReceiveStatus.SDC.SetStatus(RX_OK);
         //        bSDCOK = true;
+        vecbiLastBlockOK.Init(iInputBlockSize);
+        for (int i = 0; i < iInputBlockSize; i++)
+            vecbiLastBlockOK[i] = (*pvecInputData)[i];
+        iNumBlocksOK++;
         break;
 
     case CSDCReceive::SR_BAD_CRC:
@@ -650,6 +796,19 @@ void CUtilizeSDCData::ProcessDataInternal(CParameter& Parameters)
     bFirstBlock = false;
 }
 
+bool CUtilizeSDCData::ApplyBlock(CParameter& Parameters, CVector<_BINARY>& vecbiBlock)
+{
+    Parameters.Lock();
+    const int iNumBits = Parameters.iNumSDCBitsPerSFrame;
+    Parameters.Unlock();
+
+    /* The length of the block follows from the current SDC parameters */
+    if (vecbiBlock.Size() != iNumBits)
+        return false;
+
+    return SDCReceive.SDCParam(&vecbiBlock, Parameters) == CSDCReceive::SR_OK;
+}
+
 void CUtilizeSDCData::InitInternal(CParameter& Parameters)
 {
     /* Init "first block" flag */
@@ -662,14 +821,15 @@ void CUtilizeSDCData::InitInternal(CParameter& Parameters)
 
 /* CWriteIQFile : module for writing an IQ or IF file */
 
-CWriteIQFile::CWriteIQFile() : pFile(0), iFrequency(0), bIsRecording(false), bChangeReceived(false)
+CWriteIQFile::CWriteIQFile() : bFileOpen(false), tFileOpened(0),
+    eFormat(CIQFileWriter::IQ_RAW), iRotateMB(0), iRotateSeconds(0),
+    iBufferSeconds(5), iFrequency(0), bIsRecording(false), bChangeReceived(false)
 {
 }
 
 CWriteIQFile::~CWriteIQFile()
 {
-    if (pFile != 0)
-        fclose(pFile);
+    /* The writer flushes and closes the file when it is destroyed */
 }
 
 void CWriteIQFile::StartRecording(CParameter&)
@@ -678,6 +838,17 @@ void CWriteIQFile::StartRecording(CParameter&)
     bChangeReceived = true;
 }
 
+void CWriteIQFile::SetFormat(const string& strFormat)
+{
+    eFormat = CIQFileWriter::FormatFromString(strFormat);
+    /* Opus is lossy and has fixed sample rates, no use for signals */
+    if ((eFormat == CIQFileWriter::IQ_OPUS) || !CIQFileWriter::IsSupported(eFormat))
+    {
+        fprintf(stderr, "WriteIQFile: %s recording not supported, writing raw files\n", strFormat.c_str());
+        eFormat = CIQFileWriter::IQ_RAW;
+    }
+}
+
 void CWriteIQFile::OpenFile(CParameter& Parameters)
 {
     iFrequency = Parameters.GetFrequency();
@@ -687,6 +858,8 @@ void CWriteIQFile::OpenFile(CParameter& Parameters)
     time(&ltime);
     struct tm* gmtCur = gmtime(&ltime);
 
+    const int iSampleRate = Parameters.GetSigSampleRate();
+
     stringstream filename;
     filename << Parameters.GetDataDirectory();
     filename << Parameters.sReceiverID << "_";
@@ -694,10 +867,29 @@ void CWriteIQFile::OpenFile(CParameter& Parameters)
     filename << "-" << setw(2) << setfill('0')<< gmtCur->tm_mday << "_";
     filename << setw(2) << setfill('0') << gmtCur->tm_hour << "-" << setw(2) << setfill('0')<< gmtCur->tm_min;
     filename << "-" << setw(2) << setfill('0')<< gmtCur->tm_sec << "_";
-    filename << setw(8) << setfill('0') << (iFrequency*1000) << ".iq" << (Parameters.GetSigSampleRate()/1000);
+    filename << setw(8) << setfill('0') << (iFrequency*1000) << "." << CIQFileWriter::GetExtension(eFormat, iSampleRate);
 
-    pFile = fopen(filename.str().c_str(), "wb");
+    /* Two 16 bit samples per frame */
+    Writer.SetQueueSize(size_t(max(iBufferSeconds, 1)) * size_t(iSampleRate) * 2);
+    Writer.Open(filename.str(), iSampleRate, eFormat);
+    bFileOpen = true;
+    tFileOpened = ltime;
+}
 
+void CWriteIQFile::CloseFile()
+{
+    if (bFileOpen)
+        Writer.Close();
+    bFileOpen = false;
+}
+
+bool CWriteIQFile::RotationDue() const
+{
+    if ((iRotateMB > 0) && (Writer.GetFileBytes() >= (unsigned long long)iRotateMB << 20))
+        return true;
+    if ((iRotateSeconds > 0) && (time(nullptr) - tFileOpened >= iRotateSeconds))
+        return true;
+    return false;
 }
 
 void CWriteIQFile::StopRecording()
@@ -724,6 +916,9 @@ void CWriteIQFile::InitInternal(CParameter& Parameters)
     /* Init mixer */
     Mixer.Init(iSymbolBlockSize);
 
+    /* Interleaved I/Q for the writer */
+    vecsTmpAudData.Init(2 * iSymbolBlockSize);
+
     /* Inits for Hilbert and DC filter -------------------------------------- */
     /* Hilbert filter block length is the same as input block length */
     iHilFiltBlLen = iSymbolBlockSize;
@@ -781,21 +976,13 @@ void CWriteIQFile::ProcessDataInternal(CParameter& Parameters)
     if (bChangeReceived) // file is open but we want to start a new one
     {
         bChangeReceived = false;
-        if (pFile != nullptr)
-        {
-            fclose(pFile);
-        }
-        pFile = nullptr;
+        CloseFile();
     }
 
     // is recording switched on?
     if (!bIsRecording)
     {
-        if (pFile != nullptr)
-        {
-            fclose(pFile); // close file if currently open
-            pFile = nullptr;
-        }
+        CloseFile(); // close file if currently open
         return;
     }
 
@@ -807,14 +994,11 @@ void CWriteIQFile::ProcessDataInternal(CParameter& Parameters)
     {
         iFrequency = iNewFrequency;
         // If file is currently open, close it
-        if (pFile != nullptr)
-        {
-            fclose(pFile);
-            pFile = nullptr;
-        }
+        CloseFile();
     }
-    // Now open the file with correct name if it isn't currently open
-    if (!pFile)
+    // Now open the file with correct name if it isn't currently open,
+    // or continue in a new one if the current one is full
+    if (!bFileOpen || RotationDue())
     {
         OpenFile(Parameters);
     }
@@ -833,22 +1017,14 @@ void CWriteIQFile::ProcessDataInternal(CParameter& Parameters)
     Mixer.SetMixFreq(CReal(0.25));
     Mixer.Process(cvecHilbert);
 
-    /* Write to the file */
-
-    _SAMPLE re, im;
-    _BYTE bytes[4];
-
+    /* Hand over to the writer thread */
     CReal rScale = CReal(1.0);
     for (i=0; i<iInputBlockSize; i++)
     {
-        re = _SAMPLE(cvecHilbert[i].real() * rScale);
-        im = _SAMPLE(cvecHilbert[i].imag() * rScale);
-        bytes[0] = _BYTE(re & 0xFF);
-        bytes[1] = _BYTE((re>>8) & 0xFF);
-        bytes[2] = _BYTE(im & 0xFF);
-        bytes[3] = _BYTE((im>>8) & 0xFF);
-
-        fwrite(bytes, 4, sizeof(_BYTE), pFile);
+        vecsTmpAudData[2 * i] = _SAMPLE(cvecHilbert[i].real() * rScale);
+        vecsTmpAudData[2 * i + 1] = _SAMPLE(cvecHilbert[i].imag() * rScale);
     }
+
+    Writer.Write(&vecsTmpAudData[0], 2 * iInputBlockSize);
 }
 
@@ -33,6 +33,7 @@
 #define DATA_H__3B0BA660_CA63_4344_BB2B_23E7A0D31912__INCLUDED_
 
 #include "sound/soundinterface.h"
+#include "sound/sampleformat.h"
 #ifdef QT_MULTIMEDIA_LIB
 #include <QIODevice>
 #include <QAudioOutput>
@@ -44,6 +45,7 @@
 #include "TextMessage.h"
 #include "util/AudioFile.h"
 #include "util/Utilities.h"
+#include "util/IQFileWriter.h"
 #include "AMDemodulation.h" // For CMixer
 
 /* Definitions ****************************************************************/
@@ -102,17 +104,39 @@ protected:
     virtual void ProcessDataInternal(CParameter& TransmParam);
 };
 
-class CWriteData : public CReceiverModul<_SAMPLE, _SAMPLE>
+class CWriteData : public CReceiverModul<_AUDIO, _AUDIO>
 {
 public:
     CWriteData();
     virtual ~CWriteData() {}
 
+    /* The file is opened and written by a background thread, see
+       CIQFileWriter. With rotation, strFileName is the start of the names */
     void StartWriteWaveFile(const std::string& strFileName);
     bool GetIsWriteWaveFile() {
         return bDoWriteWaveFile;
     }
     void StopWriteWaveFile();
+    /* Settings for the next file, "wav", "flac" or "opus" */
+    void SetRecordFormat(const std::string& strFormat);
+    std::string GetRecordFormat() const {
+        return CIQFileWriter::FormatToString(eRecordFormat);
+    }
+    /* Start a new file at every full hour (UTC) and/or when another service
+       is selected */
+    void SetRecordRotation(const bool bHourly, const bool bOnService) {
+        bRotateHourly = bHourly;
+        bRotateOnService = bOnService;
+    }
+    bool GetRecordRotateHourly() const {
+        return bRotateHourly;
+    }
+    bool GetRecordRotateOnService() const {
+        return bRotateOnService;
+    }
+    unsigned long GetRecordDroppedBlocks() const {
+        return AudioWriter.GetDroppedBlocks();
+    }
 
     void MuteAudio(bool bNewMA) {
         bMuteAudio = bNewMA;
@@ -136,6 +160,16 @@ public:
         return eOutChanSel;
     }
     void SetSoundInterface(std::string);
+    /* Write to the given output instead of a sound card, takes ownership */
+    void SetSoundInterface(CSoundOutInterface* pNewSound);
+    /* Sample format of stdout, pipe and shared memory outputs (s16, f32),
+       applies to the next SetSoundInterface() */
+    void SetOutputFormat(const ESampleFormat eNewFormat) {
+        eOutputFormat = eNewFormat;
+    }
+    ESampleFormat GetOutputFormat() {
+        return eOutputFormat;
+    }
     std::string GetSoundInterface() {
         return soundDevice;
     }
@@ -159,15 +193,31 @@ protected:
     CSoundOutInterface* pSound;
     std::string                  soundDevice;
     bool bMuteAudio;
-    CWaveFile WaveFileAudio;
+    CIQFileWriter AudioWriter;
+    std::string strRecordName;
+    CIQFileWriter::EFormat eRecordFormat;
+    bool bRotateHourly;
+    bool bRotateOnService;
     bool bDoWriteWaveFile;
+    bool bRecordOpen;
+    int iRecordHour;
+    uint32_t iRecordServiceID;
+    int iRecordSampleRate;
+    std::string strRecordFile;
+    int iRecordPart;
     bool bSoundBlocking;
     bool bNewSoundBlocking;
+    /* The audio stays float up to the output, only outputs which need 16
+       bit get it converted (and clipped) */
+    CVector<_AUDIO> vecfTmpAudData;
     CVector<_SAMPLE> vecsTmpAudData;
     EOutChanSel eOutChanSel;
+    ESampleFormat eOutputFormat;
     _REAL rMixNormConst;
 
-    CShiftRegister<_SAMPLE> vecsOutputData;
+    /* Recent audio for the spectrum, only kept while it is shown */
+    CShiftRegister<_AUDIO> vecfOutputData;
+    CViewDemand ViewDemand;
     CFftPlans FftPlan;
     CComplexVector veccFFTInput;
     CComplexVector veccFFTOutput;
@@ -179,6 +229,9 @@ protected:
 
     virtual void InitInternal(CParameter& Parameters);
     virtual void ProcessDataInternal(CParameter& Parameters);
+    void RecordAudio(CParameter& Parameters);
+    std::string RecordFileName(const struct tm* gmtCur, const uint32_t iServiceID,
+                               const CIQFileWriter::EFormat eFormat) const;
 };
 
 
@@ -239,16 +292,31 @@ protected:
 class CUtilizeSDCData : public CReceiverModul<_BINARY, _BINARY>
 {
 public:
-    CUtilizeSDCData() {}
+    CUtilizeSDCData() : iNumBlocksOK(0) {}
     virtual ~CUtilizeSDCData() {}
 
     CSDCReceive* GetSDCReceive() {
         return &SDCReceive;
     }
 
+    /* Last block received with a good CRC and the number of such blocks so
+       far, e.g. for keeping the SDC of a frequency */
+    const CVector<_BINARY>& GetLastBlockOK() const {
+        return vecbiLastBlockOK;
+    }
+    unsigned long GetNumBlocksOK() const {
+        return iNumBlocksOK;
+    }
+
+    /* Evaluate an SDC block which was not received, e.g. a cached one. The
+       SDC status is left alone */
+    bool ApplyBlock(CParameter& Parameters, CVector<_BINARY>& vecbiBlock);
+
 protected:
     CSDCReceive SDCReceive;
     bool bFirstBlock;
+    CVector<_BINARY> vecbiLastBlockOK;
+    unsigned long iNumBlocksOK;
 
     virtual void InitInternal(CParameter& Parameters);
     virtual void ProcessDataInternal(CParameter& Parameters);
@@ -310,13 +378,48 @@ public:
         return bIsRecording;
     }
 
+    /* Settings for the next file, "raw", "wav" or "flac" */
+    void SetFormat(const std::string& strFormat);
+    std::string GetFormat() const {
+        return CIQFileWriter::FormatToString(eFormat);
+    }
+    /* Start a new file after iMB megabytes or iSeconds, 0 = never */
+    void SetRotation(const int iMB, const int iSeconds) {
+        iRotateMB = iMB;
+        iRotateSeconds = iSeconds;
+    }
+    int GetRotationSize() const {
+        return iRotateMB;
+    }
+    int GetRotationTime() const {
+        return iRotateSeconds;
+    }
+    /* Seconds of signal the writer thread may lag behind */
+    void SetBufferSeconds(const int iSeconds) {
+        iBufferSeconds = iSeconds;
+    }
+    int GetBufferSeconds() const {
+        return iBufferSeconds;
+    }
+    unsigned long GetDroppedBlocks() const {
+        return Writer.GetDroppedBlocks();
+    }
+
 protected:
-    FILE * pFile;
+    CIQFileWriter Writer;
+    bool bFileOpen;
+    time_t tFileOpened;
+    CIQFileWriter::EFormat eFormat;
+    int iRotateMB;
+    int iRotateSeconds;
+    int iBufferSeconds;
     CVector<_SAMPLE> vecsTmpAudData;
 
     virtual void InitInternal(CParameter& Parameters);
     virtual void ProcessDataInternal(CParameter& Parameters);
     void  OpenFile(CParameter& Parameters);
+    void  CloseFile();
+    bool  RotationDue() const;
 
     /* For doing the IF to IQ conversion (stolen from AM demod) */
     CRealVector rvecInpTmp;
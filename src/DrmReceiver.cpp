@@ -36,10 +36,13 @@
 #include "util/Settings.h"
 #include "util/Utilities.h"
 #include "util/FileTyper.h"
+#include "util/StatusBroadcast.h"
 
 #include "sound/sound.h"
 #include "sound/soundnull.h"
 #include "sound/audiofilein.h"
+#include "sound/pipein.h"
+#include "sound/pipeout.h"
 #ifdef QT_MULTIMEDIA_LIB
 # include <QAudioDeviceInfo>
 #endif
@@ -54,6 +57,10 @@
 const int
 CDRMReceiver::MAX_UNLOCKED_COUNT = 2;
 
+/* Frequency acquisition search window of a fast start, around the DC carrier
+   of the cached entry [Hz] */
+static const _REAL FAST_START_SEARCH_WIN_SIZE = (_REAL) 500.0;
+
 /* Implementation *************************************************************/
 CDRMReceiver::CDRMReceiver(CSettings* nPsettings) : CDRMTransceiver(),
     ReceiveData(), WriteData(),
@@ -74,6 +81,13 @@ CDRMReceiver::CDRMReceiver(CSettings* nPsettings) : CDRMTransceiver(),
 #ifdef HAVE_LIBHAMLIB
     pRig(nullptr),
 #endif
+    bParallelDecode(false), bMultiService(false), bWarmServices(false),
+    bWarmAudioActive(false), bAudioThread(false), MultiServiceDecoder(),
+    AudioPlayout(AudioSourceDecoder, WriteData), DecodePool(), Metrics(),
+    FastStartCache(), FastStartEntry(), FastStartLive(), FastStartConfig(),
+    bRetuned(false), bFastStartSeeded(false), bFastStartApplied(false),
+    iFastStartFreq(0), iFastStartFailedFreq(0), iSDCBlocksOK(0),
+    rFreqAcqWinCenter(-1.0), rFreqAcqWinSize(-1.0),
     PlotManager(), iPrevSigSampleRate(0),Parameters(*(new CParameter())), pSettings(nPsettings)
 {
     Parameters.SetReceiver(this);
@@ -167,9 +181,9 @@ CDRMReceiver::SetInputDevice(string s)
     }
     string device = s;
 
-    // Special handling for stdin input
-    if (device == "-") {
-        ReceiveData.SetSoundInterface("-");
+    // Special handling for stdin and named pipe input
+    if (CPipeIn::IsPipe(device)) {
+        ReceiveData.SetSoundInterface(device);
         return;
     }
 
@@ -208,6 +222,7 @@ CDRMReceiver::SetInputDevice(string s)
     case FileTyper::file_framing:
     case FileTyper::raw_af:
     case FileTyper::raw_pft:
+        pUpstreamRSCI->SetReplay(strRSIReplay);
         pUpstreamRSCI->SetOrigin(device);
     }
 }
@@ -300,6 +315,48 @@ CDRMReceiver::DemodulateDRM(bool& bEnoughData)
 void
 CDRMReceiver::DecodeDRM(bool& bEnoughData, bool& bFrameToSend)
 {
+    if (bParallelDecode && DecodePool.IsRunning())
+    {
+        /* After cell demapping FAC, SDC and MSC do not share any state
+           until they are utilized, so the three channels are decoded as
+           separate tasks. MSC part A and part B cannot be split: on each
+           MLC level both parts form one convolutional code word */
+        bool bFACData = false, bFACFrame = false, bSDCData = false, bMSCData = false;
+        std::vector<std::function<void()> > vecTasks;
+
+        vecTasks.push_back([&]() {
+            /* MSC first since it is by far the largest task */
+            if (SymbDeinterleaver.ProcessData(Parameters, MSCCarDemapBuf, DeintlBuf))
+                bMSCData = true;
+            if (MSCMLCDecoder.ProcessData(Parameters, DeintlBuf, MSCMLCDecBuf))
+                bMSCData = true;
+        });
+        vecTasks.push_back([&]() {
+            if (FACMLCDecoder.ProcessData(Parameters, FACCarDemapBuf, FACDecBuf))
+            {
+                bFACData = true;
+                bFACFrame = true;
+            }
+        });
+        vecTasks.push_back([&]() {
+            if (SDCMLCDecoder.ProcessData(Parameters, SDCCarDemapBuf, SDCDecBuf))
+                bSDCData = true;
+        });
+
+        /* Join before MSC demultiplexing */
+        DecodePool.RunAll(vecTasks);
+
+        if (bFACData || bSDCData || bMSCData)
+            bEnoughData = true;
+        if (bFACFrame)
+            bFrameToSend = true;
+
+        if (MSCDemultiplexer.ProcessData(Parameters, MSCMLCDecBuf, MSCDecBuf))
+            bEnoughData = true;
+
+        return;
+    }
+
     /* FAC ------------------------------------------------------ */
     if (FACMLCDecoder.ProcessData(Parameters, FACCarDemapBuf, FACDecBuf))
     {
@@ -344,6 +401,8 @@ CDRMReceiver::UtilizeDRM(bool& bEnoughData)
         /* Use information of FAC CRC for detecting the acquisition
            requirement */
         DetectAcquiFAC();
+
+        FastStartFAC();
     }
 #if 0
     saveSDCtoFile();
@@ -353,43 +412,97 @@ CDRMReceiver::UtilizeDRM(bool& bEnoughData)
     {
         bEnoughData = true;
     }
+    FastStartSDC();
+
+    bool bDataDecoded = false, bAudioDecoded = false, bAudioPlayout = false;
+    std::vector<std::function<void()> > vecTasks;
+    const bool bMultiDecode = bMultiService || bWarmServices;
+
+    /* Decoders for all services of the multiplex. None of the decoders
+       share any state, so they all run in parallel */
+    if (bMultiDecode)
+        MultiServiceDecoder.AddTasks(Parameters, vecTasks);
+
+    /* Warm services: the audio of the selected service comes from its
+       already running decoder, the main audio decoder is idle */
+    const int iCurAudioService = Parameters.GetCurSelAudioService();
+    const bool bWarmAudio = bWarmServices && MultiServiceDecoder.HasServiceAudio(iCurAudioService);
+    if (bWarmAudioActive && !bWarmAudio)
+        AudioPlayout.RequestInit();
+    bWarmAudioActive = bWarmAudio;
 
     /* Data decoding */
     if (iDataStreamID != STREAM_ID_NOT_USED)
     {
-        if (DataDecoder.WriteData(Parameters, MSCUseBuf[iDataStreamID]))
-            bEnoughData = true;
+        vecTasks.push_back([&]() {
+            bDataDecoded = DataDecoder.WriteData(Parameters, MSCUseBuf[iDataStreamID]);
+        });
     }
     /* Source decoding (audio) */
-    if (iAudioStreamID != STREAM_ID_NOT_USED)
+    if (bWarmAudio)
+    {
+        if (iAudioStreamID != STREAM_ID_NOT_USED)
+            MSCUseBuf[iAudioStreamID].Clear();
+    }
+    else if (AudioPlayout.IsRunning())
+    {
+        /* Decoded on the playout thread */
+        bAudioPlayout = true;
+        const int iStream = (iAudioStreamID != STREAM_ID_NOT_USED) ? iAudioStreamID :
+                            (iDataStreamID == STREAM_ID_NOT_USED) ? 0 : STREAM_ID_NOT_USED;
+        if (iStream != STREAM_ID_NOT_USED)
+            bAudioDecoded = AudioPlayout.PushStream(MSCUseBuf[iStream]);
+    }
+    else if (iAudioStreamID != STREAM_ID_NOT_USED)
     {
         //cerr << "audio processing" << endl;
-        if (AudioSourceDecoder.ProcessData(Parameters,
-                                           MSCUseBuf[iAudioStreamID],
-                                           AudSoDecBuf))
-        {
+        vecTasks.push_back([&]() {
+            bAudioDecoded = AudioSourceDecoder.ProcessData(Parameters,
+                                                           MSCUseBuf[iAudioStreamID],
+                                                           AudSoDecBuf);
+        });
+    }
+    else if (iDataStreamID == STREAM_ID_NOT_USED) // try and decode stream 0 as audio anyway
+    {
+        vecTasks.push_back([&]() {
+            bAudioDecoded = AudioSourceDecoder.ProcessData(Parameters,
+                                                           MSCUseBuf[0],
+                                                           AudSoDecBuf);
+        });
+    }
+
+    if (bMultiDecode)
+    {
+        DecodePool.RunAll(vecTasks);
+
+        if (MultiServiceDecoder.GetEnoughData())
             bEnoughData = true;
 
-            /* Store the number of correctly decoded audio blocks for
-             *                            the history */
-            PlotManager.SetCurrentCDAud(AudioSourceDecoder.GetNumCorDecAudio());
+        if (bWarmAudio && MultiServiceDecoder.GetServiceAudio(iCurAudioService, AudSoDecBuf))
+        {
+            bEnoughData = true;
+            PlotManager.SetCurrentCDAud(MultiServiceDecoder.GetNumCorDecAudio(iCurAudioService));
         }
     }
-    if( (iDataStreamID == STREAM_ID_NOT_USED)
-            &&
-            (iAudioStreamID == STREAM_ID_NOT_USED)
-      ) // try and decode stream 0 as audio anyway
+    else
     {
-        if (AudioSourceDecoder.ProcessData(Parameters,
-                                           MSCUseBuf[0],
-                                           AudSoDecBuf))
-        {
-            bEnoughData = true;
+        for (size_t i = 0; i < vecTasks.size(); i++)
+            vecTasks[i]();
+    }
+
+    if (bDataDecoded)
+        bEnoughData = true;
 
-            /* Store the number of correctly decoded audio blocks for
-             *                            the history */
+    if (bAudioDecoded)
+    {
+        bEnoughData = true;
+
+        /* Store the number of correctly decoded audio blocks for
+         *                            the history */
+        if (bAudioPlayout)
+            PlotManager.SetCurrentCDAud(AudioPlayout.GetNumCorDecAudio());
+        else
             PlotManager.SetCurrentCDAud(AudioSourceDecoder.GetNumCorDecAudio());
-        }
     }
 }
 
@@ -524,6 +637,94 @@ CDRMReceiver::DetectAcquiFAC()
     }
 }
 
+void
+CDRMReceiver::FastStartFAC()
+{
+    if (!bFastStartSeeded || !UtilizeFACData.GetCRCOk())
+        return;
+
+    switch (CFastStartCache::CompareFAC(FastStartEntry, Parameters))
+    {
+    case CFastStartCache::FM_UNKNOWN:
+        return;
+
+    case CFastStartCache::FM_MISMATCH:
+        /* Another signal now, the live SDC will replace the entry */
+        bFastStartSeeded = false;
+        Metrics.AddFastStart(CReceiverMetrics::FS_MISMATCH);
+        fprintf(stderr, "DRMReceiver: %d kHz does not match its cached signal\n", iFastStartFreq);
+        return;
+
+    case CFastStartCache::FM_MATCH:
+        break;
+    }
+
+    /* The SDC decoder is set up for the FAC of the frame before, wait until
+       the cached blocks fit */
+    Parameters.Lock();
+    const int iSDCBits = Parameters.iNumSDCBitsPerSFrame;
+    Parameters.Unlock();
+    if (iSDCBits != FastStartEntry.iSDCBits)
+        return;
+
+    /* Same signal: set the multiplex up from the cached SDC, the MSC and
+       the audio decoders get initialised as if it was received */
+    bFastStartSeeded = false;
+    for (size_t i = 0; i < FastStartEntry.vecvecbiSDC.size(); i++)
+    {
+        if (UtilizeSDCData.ApplyBlock(Parameters, FastStartEntry.vecvecbiSDC[i]))
+            bFastStartApplied = true;
+    }
+    if (bFastStartApplied)
+        FastStartConfig.Take(Parameters);
+}
+
+void
+CDRMReceiver::FastStartSDC()
+{
+    if (!FastStartCache.IsEnabled() || (UtilizeSDCData.GetNumBlocksOK() == iSDCBlocksOK))
+        return;
+    iSDCBlocksOK = UtilizeSDCData.GetNumBlocksOK();
+    if ((eReceiverMode != RM_DRM) || pUpstreamRSCI->GetInEnabled())
+        return;
+
+    /* Validate the cached SDC: if the live one changes anything, the
+       cached one was outdated (and the receiver re-initialised as needed) */
+    bFastStartSeeded = false;
+    if (bFastStartApplied)
+    {
+        bFastStartApplied = false;
+        CFastStartCache::CConfig LiveConfig;
+        LiveConfig.Take(Parameters);
+        if (LiveConfig == FastStartConfig)
+            Metrics.AddFastStart(CReceiverMetrics::FS_HIT);
+        else
+        {
+            Metrics.AddFastStart(CReceiverMetrics::FS_STALE);
+            fprintf(stderr, "DRMReceiver: cached SDC of %d kHz was outdated\n", iFastStartFreq);
+        }
+    }
+
+    /* Keep the first few distinct blocks of the acquisition, the multiplex
+       description may be spread over several of them. Blocks which only
+       differ in e.g. the time are not worth more writes of the file */
+    const CVector<_BINARY>& vecbiBlock = UtilizeSDCData.GetLastBlockOK();
+    std::vector<CVector<_BINARY> > vecvecbiSDC = FastStartLive.vecvecbiSDC;
+    if (int(vecvecbiSDC.size()) >= CFastStartCache::MAX_SDC_BLOCKS)
+        return;
+    for (size_t i = 0; i < vecvecbiSDC.size(); i++)
+    {
+        if (static_cast<const std::vector<_BINARY>&>(vecvecbiSDC[i]) ==
+            static_cast<const std::vector<_BINARY>&>(vecbiBlock))
+            return;
+    }
+    vecvecbiSDC.push_back(vecbiBlock);
+
+    CFastStartCache::FromParameters(FastStartLive, Parameters);
+    FastStartLive.vecvecbiSDC = vecvecbiSDC;
+    FastStartCache.Update(iFastStartFreq, FastStartLive);
+}
+
 void
 CDRMReceiver::InitReceiverMode()
 {
@@ -675,6 +876,7 @@ CDRMReceiver::InitReceiverMode()
 void
 CDRMReceiver::CloseSoundInterfaces()
 {
+    AudioPlayout.Stop();
     ReceiveData.Stop();
     WriteData.Stop();
 }
@@ -696,18 +898,52 @@ CDRMReceiver::SetInStartMode()
 {
     iUnlockedCount = MAX_UNLOCKED_COUNT;
 
+    /* Fast start: take what was received on this frequency before. If that
+       did not lead to the signal, the next start on the frequency is a cold
+       one */
+    const int iFrequency = Parameters.GetFrequency();
+    if (iFrequency != iFastStartFreq)
+        iFastStartFailedFreq = 0;
+    else if (bFastStartSeeded)
+    {
+        Metrics.AddFastStart(CReceiverMetrics::FS_FAILED);
+        iFastStartFailedFreq = iFrequency;
+    }
+    bFastStartSeeded = false;
+    bFastStartApplied = false;
+    iFastStartFreq = iFrequency;
+    FastStartLive = CFastStartCache::CEntry();
+    iSDCBlocksOK = UtilizeSDCData.GetNumBlocksOK();
+    if (FastStartCache.IsEnabled() && (eReceiverMode == RM_DRM) && !pUpstreamRSCI->GetInEnabled())
+    {
+        bFastStartSeeded = (iFrequency != iFastStartFailedFreq) &&
+            FastStartCache.Find(iFrequency, FastStartEntry);
+        if (!bFastStartSeeded)
+            Metrics.AddFastStart(CReceiverMetrics::FS_COLD);
+    }
+
     Parameters.Lock();
     /* Load start parameters for all modules */
 
     /* Define with which parameters the receiver should try to decode the
        signal. If we are correct with our assumptions, the receiver does not
        need to reinitialize */
-    Parameters.InitCellMapTable(RM_ROBUSTNESS_MODE_B, SO_3);
+    if (bFastStartSeeded)
+    {
+        Parameters.InitCellMapTable(FastStartEntry.eRobMode, FastStartEntry.eSpecOcc);
+        Parameters.SetInterleaverDepth(FastStartEntry.eInterleaver);
+        Parameters.SetMSCCodingScheme(FastStartEntry.eMSCCoding);
+        Parameters.SetSDCCodingScheme(FastStartEntry.eSDCCoding);
+    }
+    else
+    {
+        Parameters.InitCellMapTable(RM_ROBUSTNESS_MODE_B, SO_3);
 
-    /* Set initial MLC parameters */
-    Parameters.SetInterleaverDepth(CParameter::SI_LONG);
-    Parameters.SetMSCCodingScheme(CS_3_SM);
-    Parameters.SetSDCCodingScheme(CS_2_SM);
+        /* Set initial MLC parameters */
+        Parameters.SetInterleaverDepth(CParameter::SI_LONG);
+        Parameters.SetMSCCodingScheme(CS_3_SM);
+        Parameters.SetSDCCodingScheme(CS_2_SM);
+    }
 
     /* Select the service we want to decode. Always zero, because we do not
        know how many services are transmitted in the signal we want to
@@ -739,9 +975,17 @@ CDRMReceiver::SetInStartMode()
     Parameters.rFreqOffsetAcqui = (_REAL) 0.0;
     Parameters.rFreqOffsetTrack = (_REAL) 0.0;
     Parameters.iTimingOffsTrack = 0;
+    if (bFastStartSeeded)
+        Parameters.rResampleOffset = FastStartEntry.rResampleOffset;
 
     Parameters.Unlock();
 
+    /* The DC carrier is searched for close to where it was last time */
+    if (bFastStartSeeded)
+        FreqSyncAcq.SetSearchWindow(FastStartEntry.rDCFrequency, FAST_START_SEARCH_WIN_SIZE);
+    else
+        FreqSyncAcq.SetSearchWindow(rFreqAcqWinCenter, rFreqAcqWinSize);
+
     /* Initialization of the modules */
     InitsForAllModules();
 
@@ -782,8 +1026,11 @@ CDRMReceiver::SetInStartMode()
     /* Clear audio decoder string */
     Parameters.audiodecoder = "";
 
+    const unsigned long iAudioOK = Parameters.ReceiveStatus.SLAudio.GetTotalOK();
     Parameters.Unlock();
 
+    Metrics.AcquisitionStarted(iAudioOK, bFastStartSeeded);
+
     /* In case upstreamRSCI is enabled, go directly to tracking mode, do not activate the
        synchronization units */
     if (pUpstreamRSCI->GetInEnabled())
@@ -848,6 +1095,14 @@ CDRMReceiver::process()
     bool bFrameToSend = false;
     bool bEnoughData = true;
 
+    /* CPU time of the modules for the metrics */
+    uint64_t iModuleStart = CReceiverMetrics::ThreadCpuNs();
+
+    /* Tuned to another frequency, acquire its signal right away (fast start
+       only, the receiver otherwise finds out by losing the signal) */
+    if (bRetuned.exchange(false) && (eReceiverMode == RM_DRM) && !pUpstreamRSCI->GetInEnabled())
+        SetInStartMode();
+
     /* Input - from upstream RSCI or input and demodulation from sound card / file */
     if (pUpstreamRSCI->GetInEnabled())
     {
@@ -856,8 +1111,10 @@ CDRMReceiver::process()
         if (RSIPacketBuf.GetFillLevel() > 0)
         {
             time_keeper = time(nullptr);
+            iModuleStart = Metrics.AddModuleTime(CReceiverMetrics::MOD_INPUT, iModuleStart);
             DecodeRSIMDI.ProcessData(Parameters, RSIPacketBuf, FACDecBuf, SDCDecBuf, MSCDecBuf);
             PlotManager.UpdateParamHistoriesRSIIn();
+            iModuleStart = Metrics.AddModuleTime(CReceiverMetrics::MOD_DECODING, iModuleStart);
             bFrameToSend = true;
         }
         else
@@ -877,6 +1134,7 @@ CDRMReceiver::process()
     }
     else
     {
+        const int iDemodFill = DemodDataBuf.GetFillLevel();
 
         if (WriteIQFile.IsRecording())
         {
@@ -894,24 +1152,41 @@ CDRMReceiver::process()
             /* No I/Q recording then receive data directly in DemodDataBuf */
             ReceiveData.ReadData(Parameters, DemodDataBuf);
         }
+        if (DemodDataBuf.GetFillLevel() > iDemodFill)
+        {
+            Metrics.AddInputSamples(unsigned(DemodDataBuf.GetFillLevel() - iDemodFill),
+                                    Parameters.GetSigSampleRate());
+        }
+        iModuleStart = Metrics.AddModuleTime(CReceiverMetrics::MOD_INPUT, iModuleStart);
 
         switch (eReceiverMode)
         {
         case RM_DRM:
             DemodulateDRM(bEnoughData);
+            iModuleStart = Metrics.AddModuleTime(CReceiverMetrics::MOD_DEMODULATION, iModuleStart);
             DecodeDRM(bEnoughData, bFrameToSend);
             break;
         case RM_AM:
             DemodulateAM(bEnoughData);
+            iModuleStart = Metrics.AddModuleTime(CReceiverMetrics::MOD_DEMODULATION, iModuleStart);
             DecodeAM(bEnoughData);
             break;
         case RM_FM:
             DemodulateFM(bEnoughData);
+            iModuleStart = Metrics.AddModuleTime(CReceiverMetrics::MOD_DEMODULATION, iModuleStart);
             DecodeFM(bEnoughData);
             break;
         case RM_NONE:
             break;
         }
+        iModuleStart = Metrics.AddModuleTime(CReceiverMetrics::MOD_DECODING, iModuleStart);
+    }
+
+    /* New frame: FAC, SDC, text message and data objects may have changed */
+    if (bFrameToSend)
+    {
+        Metrics.FrameDecoded(Parameters);
+        CStatusBroadcast::Notify();
     }
 
     /* Split the data for downstream RSCI and local processing. TODO make this conditional */
@@ -928,7 +1203,11 @@ CDRMReceiver::process()
 
         for (int i = 0; i < int(MSCDecBuf.size()); i++)
         {
-            SplitMSC[i].ProcessData(Parameters, MSCDecBuf[i], MSCUseBuf[i], MSCSendBuf[i]);
+            if (bMultiService || bWarmServices)
+                SplitMSC[i].ProcessData(Parameters, MSCDecBuf[i], MSCUseBuf[i], MSCSendBuf[i],
+                                        MultiServiceDecoder.GetStreamBuffer(i));
+            else
+                SplitMSC[i].ProcessData(Parameters, MSCDecBuf[i], MSCUseBuf[i], MSCSendBuf[i]);
         }
         break;
     case RM_AM:
@@ -972,6 +1251,8 @@ CDRMReceiver::process()
         }
     }
 
+    iModuleStart = Metrics.AddModuleTime(CReceiverMetrics::MOD_UTILIZATION, iModuleStart);
+
     /* Output to downstream RSCI */
     if (downstreamRSCI.GetOutEnabled())
     {
@@ -1018,13 +1299,30 @@ CDRMReceiver::process()
     }
 
     /* Play and/or save the audio */
-    if (iAudioStreamID != STREAM_ID_NOT_USED || (eReceiverMode == RM_AM) || (eReceiverMode == RM_FM))
+    if (AudioPlayout.IsRunning())
+    {
+        /* Warm services, AM and FM, the playout thread decoded the rest */
+        if (AudioPlayout.PushAudio(AudSoDecBuf))
+            bEnoughData = true;
+    }
+    else if (iAudioStreamID != STREAM_ID_NOT_USED || (eReceiverMode == RM_AM) || (eReceiverMode == RM_FM))
     {
         if (WriteData.WriteData(Parameters, AudSoDecBuf))
         {
             bEnoughData = true;
         }
     }
+    Metrics.AddModuleTime(CReceiverMetrics::MOD_OUTPUT, iModuleStart);
+
+    /* Time to the first audio since the start of the acquisition */
+    bool bCachedStart = false;
+    const double rTimeToAudio =
+        Metrics.FirstAudio(Parameters.ReceiveStatus.SLAudio.GetTotalOK(), bCachedStart);
+    if ((rTimeToAudio >= 0.0) && FastStartCache.IsEnabled())
+    {
+        fprintf(stderr, "DRMReceiver: first audio on %d kHz after %.2f s of signal (%s start)\n",
+                iFastStartFreq, rTimeToAudio, bCachedStart ? "fast" : "cold");
+    }
 }
 
 void CDRMReceiver::updatePosition()
@@ -1111,7 +1409,7 @@ CDRMReceiver::InitsForAllModules()
     MSCMLCDecoder.SetInitFlag();
     DecodeRSIMDI.SetInitFlag();
     MSCDemultiplexer.SetInitFlag();
-    AudioSourceDecoder.SetInitFlag();
+    AudioPlayout.RequestInit();
     DataDecoder.SetInitFlag();
     WriteData.SetInitFlag();
 
@@ -1162,6 +1460,7 @@ CDRMReceiver::InitsForAllModules()
     AudSoDecBuf.Clear();
     AMAudioBuf.Clear();
     AMSoEncBuf.Clear();
+    AudioPlayout.Reset();
 }
 
 /* -----------------------------------------------------------------------------
@@ -1302,7 +1601,8 @@ CDRMReceiver::InitsForAudParam()
     int a = Parameters.GetCurSelAudioService();
     iAudioStreamID = Parameters.GetAudioParam(a).iStreamID;
     Parameters.SetNumAudioDecoderBits(Parameters.GetStreamLen(iAudioStreamID) * SIZEOF__BYTE);
-    AudioSourceDecoder.SetInitFlag();
+    AudioPlayout.RequestInit();
+    MultiServiceDecoder.SetInitFlag();
 }
 
 void
@@ -1317,11 +1617,14 @@ CDRMReceiver::InitsForDataParam()
                                      GetStreamLen(iDataStreamID) *
                                      SIZEOF__BYTE);
     DataDecoder.SetInitFlag();
+    MultiServiceDecoder.SetInitFlag();
 }
 
 void CDRMReceiver::SetFrequency(int iNewFreqkHz)
 {
     Parameters.Lock();
+    if (FastStartCache.IsEnabled() && (iNewFreqkHz != Parameters.GetFrequency()))
+        bRetuned = true;
     Parameters.SetFrequency(iNewFreqkHz);
     /* clear out AMSS data and re-initialise AMSS acquisition */
     if (Parameters.eReceiverMode == RM_AM)
@@ -1381,6 +1684,90 @@ CDRMReceiver::SetRSIRecording(bool bOn, const char cProfile)
     downstreamRSCI.SetRSIRecording(Parameters, bOn, cProfile);
 }
 
+void
+CDRMReceiver::SetParallelDecode(bool bOn)
+{
+    bParallelDecode = bOn;
+    UpdateDecodePool();
+}
+
+void
+CDRMReceiver::SetAudioThread(bool bOn)
+{
+    bAudioThread = bOn;
+    if (bOn)
+        AudioPlayout.Start(Parameters);
+    else
+        AudioPlayout.Stop();
+}
+
+void
+CDRMReceiver::SetSearchWindow(_REAL rCenter, _REAL rSize)
+{
+    rFreqAcqWinCenter = rCenter;
+    rFreqAcqWinSize = rSize;
+    FreqSyncAcq.SetSearchWindow(rCenter, rSize);
+}
+
+void
+CDRMReceiver::SetFastStart(bool bOn)
+{
+    FastStartCache.Load(bOn ? Parameters.GetDataDirectory() + "faststart.ini" : string());
+}
+
+void
+CDRMReceiver::SetMultiService(bool bOn)
+{
+    if (bMultiService == bOn)
+        return;
+
+    bMultiService = bOn;
+    UpdateMultiService();
+}
+
+void
+CDRMReceiver::SetWarmServices(bool bOn)
+{
+    if (bWarmServices == bOn)
+        return;
+
+    bWarmServices = bOn;
+    UpdateMultiService();
+}
+
+void
+CDRMReceiver::UpdateMultiService()
+{
+    /* The MSC split gets a third output */
+    for (size_t i = 0; i < MSCDecBuf.size(); i++)
+        SplitMSC[i].SetInitFlag();
+    MultiServiceDecoder.Clear();
+    MultiServiceDecoder.SetMode(bMultiService, bWarmServices);
+    MultiServiceDecoder.SetInitFlag();
+
+    UpdateDecodePool();
+}
+
+void
+CDRMReceiver::UpdateDecodePool()
+{
+    /* Parallel decoding: three tasks per frame. All services: the two main
+       decoders and one decoder per stream. The calling thread runs one of
+       the tasks */
+    unsigned iNumThreads = 0;
+    if (bMultiService || bWarmServices)
+        iNumThreads = MAX_NUM_STREAMS + 1;
+    else if (bParallelDecode)
+        iNumThreads = 2;
+
+    if (DecodePool.GetNumThreads() == iNumThreads)
+        return;
+
+    DecodePool.Stop();
+    if (iNumThreads > 0)
+        DecodePool.Start(iNumThreads);
+}
+
 /* TEST store information about alternative frequency transmitted in SDC */
 void
 CDRMReceiver::saveSDCtoFile()
@@ -1453,6 +1840,24 @@ CDRMReceiver::LoadSettings()
     /* if 0 then only measure PSD when RSCI in use otherwise always measure it */
     Parameters.bMeasurePSDAlways = s.Get("Receiver", "measurepsdalways", 0);
 
+    /* Sample format of raw input files */
+    ReceiveData.SetInputFormat(CSampleFormat::FromString(s.Get("Receiver", "inputformat", string("auto"))));
+
+    /* Start position of input files */
+    ReceiveData.SetInputSeek(s.Get("command", "inputseek", _REAL(0.0)));
+
+    /* Read-ahead of stdin/pipe input */
+    ReceiveData.SetPipeBuffering(s.Get("Receiver", "inputbuffer", _REAL(2.0)),
+                                 s.Get("Receiver", "inputdropoldest", false));
+
+    /* Pacing of recorded RSCI input */
+    strRSIReplay = s.Get("command", "rsiinreplay", string());
+    if (!pUpstreamRSCI->SetReplay(strRSIReplay))
+    {
+        cerr << "unknown RSCI replay mode " << strRSIReplay << ", using recorded" << endl;
+        strRSIReplay = "";
+    }
+
     /* Upstream RSCI if any */
     string str = s.Get("command", "rsiin");
     if (str == "") {
@@ -1518,6 +1923,9 @@ CDRMReceiver::LoadSettings()
     /* Load user's saved filter bandwidth and demodulation type */
     SetAMDemodType(eDemodType);
 
+    /* Sample format of stdout, pipe and shared memory audio output */
+    WriteData.SetOutputFormat(CSampleFormat::FromString(s.Get("Receiver", "outputformat", string("s16"))));
+
     /* Sound Out device */
     str = s.Get("Receiver", "snddevout", string());
     if(str == "") {
@@ -1567,6 +1975,10 @@ CDRMReceiver::LoadSettings()
         downstreamRSCI.SetRSIRecording(Parameters, true, str[0], s2);
 
     /* IQ File Recording */
+    WriteIQFile.SetFormat(s.Get("Receiver", "iqrecordformat", string("raw")));
+    WriteIQFile.SetRotation(s.Get("Receiver", "iqrecordmaxsize", 0),
+                            s.Get("Receiver", "iqrecordmaxtime", 0));
+    WriteIQFile.SetBufferSeconds(s.Get("Receiver", "iqrecordbuffer", 5));
     if (s.Get("command", "recordiq", false))
         WriteIQFile.StartRecording(Parameters);
 
@@ -1575,11 +1987,11 @@ CDRMReceiver::LoadSettings()
 
     /* Output to File */
     str = s.Get("command", "writewav");
+    WriteData.SetRecordFormat(s.Get("Receiver", "audiorecordformat", string("wav")));
+    WriteData.SetRecordRotation(s.Get("Receiver", "audiorecordhourly", false),
+                                s.Get("Receiver", "audiorecordservice", false));
     if (str != "")
-    {
-        WriteData.Init(Parameters); /* Needed for iAudSampleRate initialization */
         WriteData.StartWriteWaveFile(str);
-    }
 
     /* Reverberation flag */
     AudioSourceDecoder.SetReverbEffect(s.Get("Receiver", "reverb", true));
@@ -1591,9 +2003,7 @@ CDRMReceiver::LoadSettings()
     FreqSyncAcq.SetRecFilter(s.Get("Receiver", "filter", false));
 
     /* Set parameters for frequency acquisition search window */
-    const _REAL rFreqAcSeWinCenter = s.Get("command", "fracwincent", -1);
-    const _REAL rFreqAcSeWinSize = s.Get("command", "fracwinsize", -1);
-    FreqSyncAcq.SetSearchWindow(rFreqAcSeWinCenter, rFreqAcSeWinSize);
+    SetSearchWindow(s.Get("command", "fracwincent", -1), s.Get("command", "fracwinsize", -1));
 
     /* Modified metrics flag */
     ChannelEstimation.SetIntCons(s.Get("Receiver", "modmetric", false));
@@ -1601,6 +2011,19 @@ CDRMReceiver::LoadSettings()
     /* Number of iterations for MLC setting */
     MSCMLCDecoder.SetNumIterations(s.Get("Receiver", "mlciter", 1));
 
+    /* Concurrent FAC/SDC/MSC decoding */
+    SetParallelDecode(s.Get("Receiver", "paralleldecode", false));
+    SetAudioLatency(s.Get("Receiver", "audiolatency", 800));
+    SetAudioThread(s.Get("Receiver", "audiothread", false));
+
+    /* Decoding of all services */
+    MultiServiceDecoder.SetOutputPattern(s.Get("Receiver", "allservicesout", string()));
+    SetMultiService(s.Get("Receiver", "allservices", false));
+    SetWarmServices(s.Get("Receiver", "warmservices", false));
+
+    /* Fast start from the cached configuration of the frequency */
+    SetFastStart(s.Get("Receiver", "faststart", false));
+
     /* Receiver mode (DRM, AM, FM) */
     SetReceiverMode(ERecMode(s.Get("Receiver", "mode", int(0))));
 
@@ -1694,12 +2117,30 @@ CDRMReceiver::SaveSettings()
     /* Input channel selection */
     s.Put("Receiver", "inchansel", ReceiveData.GetInChanSel());
 
+    /* Sample format of raw input files */
+    s.Put("Receiver", "inputformat", CSampleFormat::ToString(ReceiveData.GetInputFormat()));
+
+    /* Read-ahead of stdin/pipe input */
+    s.Put("Receiver", "inputbuffer", ReceiveData.GetPipeBufferSeconds());
+    s.Put("Receiver", "inputdropoldest", ReceiveData.GetPipeDropOldest());
+
+    /* I/Q recording */
+    s.Put("Receiver", "iqrecordformat", WriteIQFile.GetFormat());
+    s.Put("Receiver", "iqrecordmaxsize", WriteIQFile.GetRotationSize());
+    s.Put("Receiver", "iqrecordmaxtime", WriteIQFile.GetRotationTime());
+    s.Put("Receiver", "iqrecordbuffer", WriteIQFile.GetBufferSeconds());
+
     /* Output channel selection */
     s.Put("Receiver", "outchansel",  WriteData.GetOutChanSel());
 
     /* Mute audio flag */
     s.Put("Receiver", "muteaudio", WriteData.GetMuteAudio());
 
+    /* Audio recording */
+    s.Put("Receiver", "audiorecordformat", WriteData.GetRecordFormat());
+    s.Put("Receiver", "audiorecordhourly", WriteData.GetRecordRotateHourly());
+    s.Put("Receiver", "audiorecordservice", WriteData.GetRecordRotateOnService());
+
     /* Reverberation */
     s.Put("Receiver", "reverb", AudioSourceDecoder.GetReverbEffect());
 
@@ -1716,11 +2157,24 @@ CDRMReceiver::SaveSettings()
         s.Put("Receiver", "snddevin", indev);
     }
 
-    /* Sound Out device */
-    s.Put("Receiver", "snddevout", WriteData.GetSoundInterface());
+    /* Sound Out device - don't save pipes, only devices */
+    if (!CPipeOut::IsPipe(WriteData.GetSoundInterface()))
+        s.Put("Receiver", "snddevout", WriteData.GetSoundInterface());
+    s.Put("Receiver", "outputformat", CSampleFormat::ToString(WriteData.GetOutputFormat()));
     /* Number of iterations for MLC setting */
     s.Put("Receiver", "mlciter", MSCMLCDecoder.GetInitNumIterations());
 
+    /* Concurrent FAC/SDC/MSC decoding */
+    s.Put("Receiver", "paralleldecode", bParallelDecode);
+    s.Put("Receiver", "audiothread", GetAudioThread());
+    s.Put("Receiver", "audiolatency", GetAudioLatency());
+
+    /* Decoding of all services */
+    s.Put("Receiver", "allservices", bMultiService);
+    s.Put("Receiver", "allservicesout", MultiServiceDecoder.GetOutputPattern());
+    s.Put("Receiver", "warmservices", bWarmServices);
+    s.Put("Receiver", "faststart", GetFastStart());
+
     /* Tuned Frequency */
     s.Put("Receiver", "frequency", Parameters.GetFrequency());
 
@@ -1794,7 +2248,7 @@ void CConvertAudio::ProcessDataInternal(CParameter& Parameters)
     (void)Parameters;
     for (int i = 0; i < this->iInputBlockSize; i++)
     {
-        (*this->pvecOutputData)[2*i] = _SAMPLE((*this->pvecInputData)[i]);
-        (*this->pvecOutputData)[2*i+1] = _SAMPLE((*this->pvecInputData)[i]);
+        (*this->pvecOutputData)[2*i] = _AUDIO((*this->pvecInputData)[i]);
+        (*this->pvecOutputData)[2*i+1] = _AUDIO((*this->pvecInputData)[i]);
     }
 }
@@ -39,7 +39,11 @@
 #include "Parameter.h"
 #include "util/Buffer.h"
 #include "util/Utilities.h"
+#include "util/WorkerPool.h"
+#include "util/Metrics.h"
 #include "DataIO.h"
+#include "AudioPlayout.h"
+#include "FastStartCache.h"
 #include "OFDM.h"
 #include "creceivedata.h"
 #include "MSCMultiplexer.h"
@@ -47,6 +51,7 @@
 #include "datadecoding/DataDecoder.h"
 #include "sourcedecoders/AudioSourceEncoder.h"
 #include "sourcedecoders/AudioSourceDecoder.h"
+#include "sourcedecoders/MultiServiceDecoder.h"
 #include "mlc/MLC.h"
 #include "interleaver/SymbolInterleaver.h"
 #include "ofdmcellmapping/OFDMCellMapping.h"
@@ -113,7 +118,7 @@ protected:
     int iStreamID;
 };
 
-class CSplitAudio : public CSplitModul<_SAMPLE>
+class CSplitAudio : public CSplitModul<_AUDIO>
 {
 protected:
     void SetInputBlockSize(CParameter& p)
@@ -122,7 +127,7 @@ protected:
     }
 };
 
-class CConvertAudio : public CReceiverModul<_REAL,_SAMPLE>
+class CConvertAudio : public CReceiverModul<_REAL,_AUDIO>
 {
 protected:
     virtual void InitInternal(CParameter&);
@@ -187,6 +192,13 @@ public:
     void					SetAMDemodType(EDemodType);
     void					SetAMFilterBW(int iBw);
     void					SetAMDemodAcq(_REAL rNewNorCen);
+
+    /* Where the frequency acquisition searches for the DC carrier [Hz], -1:
+       whole band */
+    void					SetSearchWindow(_REAL rCenter, _REAL rSize);
+    _REAL					GetSearchWindowCenter() const {
+        return rFreqAcqWinCenter;
+    }
 #ifdef HAVE_LIBHAMLIB
     void	 				SetRig(CRig* n) {
         pRig=n;
@@ -199,6 +211,58 @@ public:
     void					SetIQRecording(bool);
     void					SetRSIRecording(bool, const char);
 
+    /* Decode FAC, SDC and MSC of a frame concurrently */
+    void					SetParallelDecode(bool);
+    bool					GetParallelDecode() const {
+        return bParallelDecode;
+    }
+
+    /* Decode all services of the multiplex, each audio service to its own
+       output */
+    void					SetMultiService(bool);
+    bool					GetMultiService() const {
+        return bMultiService;
+    }
+    void					SetMultiServiceOutput(const std::string& strPattern) {
+        MultiServiceDecoder.SetOutputPattern(strPattern);
+    }
+    std::string				GetMultiServiceOutput() const {
+        return MultiServiceDecoder.GetOutputPattern();
+    }
+    CMultiServiceDecoder*	GetMultiServiceDecoder() {
+        return &MultiServiceDecoder;
+    }
+
+    /* Keep the audio decoders of all services running for instant service
+       switching */
+    void					SetWarmServices(bool);
+    bool					GetWarmServices() const {
+        return bWarmServices;
+    }
+
+    /* Start the acquisition with what was received on the frequency
+       before, kept in a cache file in the data directory */
+    void					SetFastStart(bool);
+    bool					GetFastStart() const {
+        return FastStartCache.IsEnabled();
+    }
+
+    /* Decode and play the audio on a thread of its own, with a jitter
+       buffer of the given latency */
+    void					SetAudioThread(bool);
+    bool					GetAudioThread() const {
+        return bAudioThread;
+    }
+    void					SetAudioLatency(const int iMs) {
+        AudioPlayout.SetTargetLatency(iMs);
+    }
+    int						GetAudioLatency() const {
+        return AudioPlayout.GetTargetLatency();
+    }
+    CAudioPlayout*			GetAudioPlayout() {
+        return &AudioPlayout;
+    }
+
     /* Channel Estimation */
     void SetFreqInt(ETypeIntFreq eNewTy)
     {
@@ -281,9 +345,15 @@ public:
     CWriteData*				GetWriteData() {
         return &WriteData;
     }
+    CWriteIQFile*			GetWriteIQFile() {
+        return &WriteIQFile;
+    }
     CDataDecoder*			GetDataDecoder() {
         return &DataDecoder;
     }
+    CReceiverMetrics&		GetMetrics() {
+        return Metrics;
+    }
     CAMDemodulation*		GetAMDemod() {
         return &AMDemodulation;
     }
@@ -346,6 +416,10 @@ protected:
     void					DetectAcquiFAC();
     void					DetectAcquiSymbol();
     void					saveSDCtoFile();
+    void					FastStartFAC();
+    void					FastStartSDC();
+    void					UpdateDecodePool();
+    void					UpdateMultiService();
 
     /* Modules */
     CReceiveData			ReceiveData;
@@ -381,6 +455,7 @@ protected:
     CAMSSDecode				AMSSDecode;
 
     CUpstreamDI*			pUpstreamRSCI;
+    std::string				strRSIReplay; /* pacing of recorded RSCI input */
     CDecodeRSIMDI			DecodeRSIMDI;
     CDownstreamDI			downstreamRSCI;
 
@@ -417,9 +492,9 @@ protected:
     std::vector<CSingleBuffer<_BINARY> >	MSCUseBuf;
     std::vector<CSingleBuffer<_BINARY> >	MSCSendBuf;
     CSingleBuffer<_BINARY>			EncAMAudioBuf;
-    CCyclicBuffer<_SAMPLE>			AudSoDecBuf;
-    CCyclicBuffer<_SAMPLE>			AMAudioBuf;
-    CCyclicBuffer<_SAMPLE>			AMSoEncBuf; // For encoding
+    CCyclicBuffer<_AUDIO>			AudSoDecBuf;
+    CCyclicBuffer<_AUDIO>			AMAudioBuf;
+    CCyclicBuffer<_AUDIO>			AMSoEncBuf; // For encoding
 
     int						iAcquRestartCnt;
     int						iAcquDetecCnt;
@@ -451,6 +526,32 @@ protected:
     CRig*					pRig;
 #endif
 
+    bool					bParallelDecode;
+    bool					bMultiService;
+    bool					bWarmServices;
+    bool					bWarmAudioActive;
+    bool					bAudioThread;
+    CMultiServiceDecoder	MultiServiceDecoder;
+    CAudioPlayout			AudioPlayout;
+    CWorkerPool				DecodePool;
+    CReceiverMetrics		Metrics;
+
+    /* Fast start. The acquisition is seeded from the entry of the frequency
+       until the FAC confirms it, then the cached SDC is applied until the
+       live SDC is received */
+    CFastStartCache			FastStartCache;
+    CFastStartCache::CEntry	FastStartEntry;
+    CFastStartCache::CEntry	FastStartLive;
+    CFastStartCache::CConfig	FastStartConfig;
+    std::atomic<bool>		bRetuned;
+    bool					bFastStartSeeded;
+    bool					bFastStartApplied;
+    int						iFastStartFreq;
+    int						iFastStartFailedFreq;
+    unsigned long			iSDCBlocksOK;
+    _REAL					rFreqAcqWinCenter;
+    _REAL					rFreqAcqWinSize;
+
     CPlotManager			PlotManager;
     std::string					rsiOrigin;
     int						iPrevSigSampleRate; /* sample rate before sound file */
@@ -0,0 +1,306 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Per frequency cache of the signal and multiplex configuration, for a fast
+ *  start of the receiver after tuning
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "FastStartCache.h"
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <sstream>
+
+const int CFastStartCache::MAX_SDC_BLOCKS = 4;
+
+static int GetInt(const std::string& strValue, const int iDefault)
+{
+    if (strValue.empty())
+        return iDefault;
+    return int(strtol(strValue.c_str(), nullptr, 10));
+}
+
+static _REAL GetReal(const std::string& strValue, const _REAL rDefault)
+{
+    if (strValue.empty())
+        return rDefault;
+    return _REAL(strtod(strValue.c_str(), nullptr));
+}
+
+static std::string ToString(const _REAL rValue)
+{
+    std::ostringstream s;
+    s.precision(8);
+    s << rValue;
+    return s.str();
+}
+
+CFastStartCache::CEntry::CEntry() : eRobMode(RM_NO_MODE_DETECTED), eSpecOcc(SO_3),
+    eInterleaver(CParameter::SI_LONG), eMSCCoding(CS_3_SM), eSDCCoding(CS_2_SM),
+    iNumAudioServices(0), iNumDataServices(0), veciServiceID(),
+    rDCFrequency(0.0), rResampleOffset(0.0), iSDCBits(0), vecvecbiSDC()
+{
+}
+
+void CFastStartCache::CConfig::Take(CParameter& Parameters)
+{
+    Parameters.Lock();
+    iPartA = Parameters.MSCPrLe.iPartA;
+    iPartB = Parameters.MSCPrLe.iPartB;
+    iHierarch = Parameters.MSCPrLe.iHierarch;
+    veciStreamLen.resize(MAX_NUM_STREAMS);
+    for (int i = 0; i < MAX_NUM_STREAMS; i++)
+        veciStreamLen[size_t(i)] = Parameters.GetStreamLen(i);
+    vecServices = Parameters.Service;
+    Parameters.Unlock();
+}
+
+bool CFastStartCache::CConfig::operator==(const CConfig& c) const
+{
+    if ((iPartA != c.iPartA) || (iPartB != c.iPartB) || (iHierarch != c.iHierarch) ||
+        (veciStreamLen != c.veciStreamLen) || (vecServices.size() != c.vecServices.size()))
+        return false;
+    for (size_t i = 0; i < vecServices.size(); i++)
+    {
+        /* The comparison operators of the parameters are not const */
+        CService a = vecServices[i];
+        const CService& b = c.vecServices[i];
+        if ((a.IsActive() != b.IsActive()) || (a.eAudDataFlag != b.eAudDataFlag) ||
+            (a.AudioParam != b.AudioParam) || (a.DataParam != b.DataParam))
+            return false;
+    }
+    return true;
+}
+
+CFastStartCache::CFastStartCache() : CIniFile(), strFileName()
+{
+}
+
+void CFastStartCache::Load(const std::string& strNewFileName)
+{
+    strFileName = strNewFileName;
+    if (!strFileName.empty())
+        (void)LoadIni(strFileName.c_str());
+}
+
+bool CFastStartCache::Find(const int iFrequency, CEntry& Entry) const
+{
+    if (!IsEnabled() || iFrequency <= 0)
+        return false;
+
+    const std::string strSection = std::to_string(iFrequency);
+    const int iMode = GetInt(GetIniSetting(strSection, "mode"), -1);
+    if ((iMode < int(RM_ROBUSTNESS_MODE_A)) || (iMode > int(RM_ROBUSTNESS_MODE_D)))
+        return false;
+
+    /* The SDC is either 4- or 16-QAM */
+    const int iInterleaver = GetInt(GetIniSetting(strSection, "interleaver"), int(CParameter::SI_LONG));
+    const int iMSCCoding = GetInt(GetIniSetting(strSection, "msccoding"), int(CS_3_SM));
+    const int iSDCCoding = GetInt(GetIniSetting(strSection, "sdccoding"), int(CS_2_SM));
+    if ((iInterleaver < int(CParameter::SI_LONG)) || (iInterleaver > int(CParameter::SI_SHORT)) ||
+        (iMSCCoding < int(CS_1_SM)) || (iMSCCoding > int(CS_3_HMMIX)) ||
+        (iSDCCoding < int(CS_1_SM)) || (iSDCCoding > int(CS_2_SM)))
+        return false;
+
+    Entry = CEntry();
+    Entry.eRobMode = ERobMode(iMode);
+    Entry.eSpecOcc = ESpecOcc(GetInt(GetIniSetting(strSection, "occupancy"), int(SO_3)));
+    Entry.eInterleaver = CParameter::ESymIntMod(iInterleaver);
+    Entry.eMSCCoding = ECodScheme(iMSCCoding);
+    Entry.eSDCCoding = ECodScheme(iSDCCoding);
+    Entry.iNumAudioServices = GetInt(GetIniSetting(strSection, "audioservices"), 0);
+    Entry.iNumDataServices = GetInt(GetIniSetting(strSection, "dataservices"), 0);
+    if ((Entry.eSpecOcc < SO_0) || (Entry.eSpecOcc > SO_5) ||
+        (Entry.iNumAudioServices < 0) || (Entry.iNumDataServices < 0) ||
+        (Entry.iNumAudioServices + Entry.iNumDataServices > MAX_NUM_SERVICES))
+        return false;
+
+    /* Comma separated hex, "-" for a service whose ID was not known */
+    std::istringstream Ids(GetIniSetting(strSection, "serviceids"));
+    std::string strId;
+    while (std::getline(Ids, strId, ','))
+    {
+        if (strId.empty() || strId == "-")
+            Entry.veciServiceID.push_back(SERV_ID_NOT_USED);
+        else
+            Entry.veciServiceID.push_back(uint32_t(strtoul(strId.c_str(), nullptr, 16)));
+    }
+
+    Entry.rDCFrequency = GetReal(GetIniSetting(strSection, "dcfrequency"), 0.0);
+    Entry.rResampleOffset = GetReal(GetIniSetting(strSection, "resampleoffset"), 0.0);
+
+    Entry.iSDCBits = GetInt(GetIniSetting(strSection, "sdcbits"), 0);
+    for (int i = 0; (i < MAX_SDC_BLOCKS) && (Entry.iSDCBits > 0); i++)
+    {
+        CVector<_BINARY> vecbiBlock;
+        if (!HexToBits(GetIniSetting(strSection, "sdc" + std::to_string(i)),
+                       Entry.iSDCBits, vecbiBlock))
+            break;
+        Entry.vecvecbiSDC.push_back(vecbiBlock);
+    }
+    return true;
+}
+
+void CFastStartCache::Update(const int iFrequency, const CEntry& Entry)
+{
+    if (!IsEnabled() || iFrequency <= 0)
+        return;
+
+    const std::string strSection = std::to_string(iFrequency);
+
+    /* Replace the whole section, fewer SDC blocks than before must not
+       leave old ones behind */
+    Mutex.Lock();
+    ini.erase(strSection);
+    Mutex.Unlock();
+
+    PutIniSetting(strSection, "mode", std::to_string(int(Entry.eRobMode)));
+    PutIniSetting(strSection, "occupancy", std::to_string(int(Entry.eSpecOcc)));
+    PutIniSetting(strSection, "interleaver", std::to_string(int(Entry.eInterleaver)));
+    PutIniSetting(strSection, "msccoding", std::to_string(int(Entry.eMSCCoding)));
+    PutIniSetting(strSection, "sdccoding", std::to_string(int(Entry.eSDCCoding)));
+    PutIniSetting(strSection, "audioservices", std::to_string(Entry.iNumAudioServices));
+    PutIniSetting(strSection, "dataservices", std::to_string(Entry.iNumDataServices));
+
+    std::string strIds;
+    for (size_t i = 0; i < Entry.veciServiceID.size(); i++)
+    {
+        char cId[16];
+        if (Entry.veciServiceID[i] == SERV_ID_NOT_USED)
+            snprintf(cId, sizeof(cId), "-");
+        else
+            snprintf(cId, sizeof(cId), "%X", unsigned(Entry.veciServiceID[i]));
+        if (i > 0)
+            strIds += ",";
+        strIds += cId;
+    }
+    PutIniSetting(strSection, "serviceids", strIds);
+
+    PutIniSetting(strSection, "dcfrequency", ToString(Entry.rDCFrequency));
+    PutIniSetting(strSection, "resampleoffset", ToString(Entry.rResampleOffset));
+
+    PutIniSetting(strSection, "sdcbits", std::to_string(Entry.iSDCBits));
+    for (size_t i = 0; (i < Entry.vecvecbiSDC.size()) && (int(i) < MAX_SDC_BLOCKS); i++)
+        PutIniSetting(strSection, "sdc" + std::to_string(i), BitsToHex(Entry.vecvecbiSDC[i]));
+
+    PutIniSetting(strSection, "updated", std::to_string((long long)time(nullptr)));
+
+    SaveIni(strFileName.c_str());
+}
+
+void CFastStartCache::FromParameters(CEntry& Entry, CParameter& Parameters)
+{
+    Parameters.Lock();
+    Entry.eRobMode = Parameters.GetWaveMode();
+    Entry.eSpecOcc = Parameters.GetSpectrumOccup();
+    Entry.eInterleaver = Parameters.eSymbolInterlMode;
+    Entry.eMSCCoding = Parameters.eMSCCodingScheme;
+    Entry.eSDCCoding = Parameters.eSDCCodingScheme;
+    Entry.iNumAudioServices = int(Parameters.iNumAudioService);
+    Entry.iNumDataServices = int(Parameters.iNumDataService);
+    Entry.veciServiceID.clear();
+    const size_t iNumServices = Parameters.iNumAudioService + Parameters.iNumDataService;
+    for (size_t i = 0; (i < iNumServices) && (i < Parameters.Service.size()); i++)
+        Entry.veciServiceID.push_back(Parameters.Service[i].iServiceID);
+    Entry.rDCFrequency = Parameters.GetDCFrequency();
+    Entry.rResampleOffset = Parameters.rResampleOffset;
+    Entry.iSDCBits = Parameters.iNumSDCBitsPerSFrame;
+    Entry.vecvecbiSDC.clear();
+    Parameters.Unlock();
+}
+
+CFastStartCache::EFACMatch CFastStartCache::CompareFAC(const CEntry& Entry, CParameter& Parameters)
+{
+    Parameters.Lock();
+    const bool bSameConfig = (Entry.eRobMode == Parameters.GetWaveMode()) &&
+        (Entry.eSpecOcc == Parameters.GetSpectrumOccup()) &&
+        (Entry.eInterleaver == Parameters.eSymbolInterlMode) &&
+        (Entry.eMSCCoding == Parameters.eMSCCodingScheme) &&
+        (Entry.eSDCCoding == Parameters.eSDCCodingScheme) &&
+        (Entry.iNumAudioServices == int(Parameters.iNumAudioService)) &&
+        (Entry.iNumDataServices == int(Parameters.iNumDataService));
+
+    /* The FAC carries one service per frame, the configuration alone could
+       be any station. At least one service ID must be known and match */
+    int iKnown = 0;
+    bool bSameIds = true;
+    for (size_t i = 0; (i < Entry.veciServiceID.size()) && (i < Parameters.Service.size()); i++)
+    {
+        const uint32_t iId = Parameters.Service[i].iServiceID;
+        if ((iId == SERV_ID_NOT_USED) || (Entry.veciServiceID[i] == SERV_ID_NOT_USED))
+            continue;
+        iKnown++;
+        if (iId != Entry.veciServiceID[i])
+            bSameIds = false;
+    }
+    Parameters.Unlock();
+
+    if (!bSameConfig || !bSameIds)
+        return FM_MISMATCH;
+    return (iKnown > 0) ? FM_MATCH : FM_UNKNOWN;
+}
+
+std::string CFastStartCache::BitsToHex(const CVector<_BINARY>& vecbiData)
+{
+    static const char cHex[] = "0123456789ABCDEF";
+    const int iNumBits = vecbiData.Size();
+    std::string strHex;
+    strHex.reserve(size_t((iNumBits + 3) / 4));
+    for (int i = 0; i < iNumBits; i += 4)
+    {
+        int iNibble = 0;
+        for (int j = 0; j < 4; j++)
+        {
+            iNibble <<= 1;
+            if ((i + j < iNumBits) && (vecbiData[i + j] != 0))
+                iNibble |= 1;
+        }
+        strHex += cHex[iNibble];
+    }
+    return strHex;
+}
+
+bool CFastStartCache::HexToBits(const std::string& strHex, const int iNumBits,
+                                CVector<_BINARY>& vecbiData)
+{
+    if (int(strHex.size()) != (iNumBits + 3) / 4)
+        return false;
+
+    vecbiData.Init(iNumBits);
+    for (int i = 0; i < iNumBits; i++)
+    {
+        const char c = strHex[size_t(i / 4)];
+        int iNibble;
+        if ((c >= '0') && (c <= '9'))
+            iNibble = c - '0';
+        else if ((c >= 'A') && (c <= 'F'))
+            iNibble = c - 'A' + 10;
+        else if ((c >= 'a') && (c <= 'f'))
+            iNibble = c - 'a' + 10;
+        else
+            return false;
+        vecbiData[i] = _BINARY((iNibble >> (3 - i % 4)) & 1);
+    }
+    return true;
+}
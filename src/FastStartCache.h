@@ -0,0 +1,136 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Per frequency cache of the signal and multiplex configuration, for a fast
+ *  start of the receiver after tuning
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#ifndef FAST_START_CACHE_H_INCLUDED
+#define FAST_START_CACHE_H_INCLUDED
+
+#include "GlobalDefinitions.h"
+#include "Parameter.h"
+#include "util/Settings.h"
+#include "util/Vector.h"
+#include <string>
+#include <vector>
+
+/**
+ * @brief What the receiver learned about the signal on a frequency
+ *
+ * A cold start has to find everything on its own: the DC carrier in the
+ * whole band, the robustness mode, the FAC and then the SDC, which only
+ * comes once per superframe and must be received with a good CRC before any
+ * audio can be decoded. An entry holds all of that for the frequency, so
+ * the acquisition can start with the right mode and a narrow frequency
+ * search window, and the MSC and audio decoders can be set up from the
+ * cached SDC as soon as the FAC confirms the signal is the cached one.
+ *
+ * Entries are written by the receiver from the live signal and stored in
+ * an ini file, one section per frequency in kHz.
+ */
+class CFastStartCache : protected CIniFile
+{
+public:
+    /* SDC blocks of an entry at most, the multiplex description may be
+       spread over several blocks */
+    static const int MAX_SDC_BLOCKS;
+
+    struct CEntry
+    {
+        CEntry();
+
+        /* From the FAC and the mode detection */
+        ERobMode                eRobMode;
+        ESpecOcc                eSpecOcc;
+        CParameter::ESymIntMod  eInterleaver;
+        ECodScheme              eMSCCoding;
+        ECodScheme              eSDCCoding;
+        int                     iNumAudioServices;
+        int                     iNumDataServices;
+        std::vector<uint32_t>   veciServiceID;  // SERV_ID_NOT_USED if not known
+
+        /* Synchronisation */
+        _REAL                   rDCFrequency;   // Hz
+        _REAL                   rResampleOffset;
+
+        /* SDC blocks with a good CRC, in the order received */
+        int                     iSDCBits;
+        std::vector<CVector<_BINARY> > vecvecbiSDC;
+    };
+
+    /**
+     * @brief Signal configuration which a new SDC block could change,
+     * compared to validate a cached SDC against the live one
+     */
+    struct CConfig
+    {
+        void Take(CParameter& Parameters);
+        bool operator==(const CConfig& c) const;
+        bool operator!=(const CConfig& c) const { return !(*this == c); }
+
+        int                     iPartA, iPartB, iHierarch;
+        std::vector<int>        veciStreamLen;
+        std::vector<CService>   vecServices;
+    };
+
+    enum EFACMatch { FM_UNKNOWN, FM_MATCH, FM_MISMATCH };
+
+    CFastStartCache();
+
+    /**
+     * @brief Read the cache file, creates it with the first entry if it
+     * does not exist
+     */
+    void Load(const std::string& strNewFileName);
+    bool IsEnabled() const { return !strFileName.empty(); }
+
+    bool Find(const int iFrequency, CEntry& Entry) const;
+
+    /**
+     * @brief Store an entry and write the file
+     */
+    void Update(const int iFrequency, const CEntry& Entry);
+
+    /**
+     * @brief Entry with the FAC configuration, service IDs and offsets of
+     * the parameters, no SDC
+     */
+    static void FromParameters(CEntry& Entry, CParameter& Parameters);
+
+    /**
+     * @brief Compare the configuration signalled in the FAC with an entry
+     * @return FM_UNKNOWN as long as no service ID of the FAC is known
+     */
+    static EFACMatch CompareFAC(const CEntry& Entry, CParameter& Parameters);
+
+protected:
+    static std::string BitsToHex(const CVector<_BINARY>& vecbiData);
+    static bool HexToBits(const std::string& strHex, const int iNumBits,
+                          CVector<_BINARY>& vecbiData);
+
+    std::string             strFileName;
+};
+
+#endif // FAST_START_CACHE_H_INCLUDED
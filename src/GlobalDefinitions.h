@@ -103,6 +103,9 @@
 typedef	double							_REAL;
 typedef	std::complex<_REAL>				_COMPLEX;
 typedef short							_SAMPLE;
+/* Decoded audio, in the range of _SAMPLE but neither clipped nor quantised
+   until it gets to an output which needs _SAMPLE */
+typedef float							_AUDIO;
 typedef unsigned char					_BYTE;
 
 // bool seems not to work with linux TODO: Fix Me!
@@ -331,5 +334,18 @@ inline _SAMPLE Real2Sample(const _REAL rInput)
     return (_SAMPLE) rInput;
 }
 
+/* Converting a block of _AUDIO to _SAMPLE, same result as Real2Sample. No
+   branches, so the compiler can vectorise the loop */
+inline void Audio2Sample(const _AUDIO* pInput, _SAMPLE* pOutput, const int iLen)
+{
+    for (int i = 0; i < iLen; i++)
+    {
+        _AUDIO rSample = pInput[i];
+        rSample = rSample < _AUDIO(-_MAXSHORT) ? _AUDIO(-_MAXSHORT) : rSample;
+        rSample = rSample > _AUDIO(_MAXSHORT) ? _AUDIO(_MAXSHORT) : rSample;
+        pOutput[i] = (_SAMPLE) rSample;
+    }
+}
+
 
 #endif // !defined(DEF_H__3B0BA660_CA63_4344_BB2B_23E7A0D31912__INCLUDED_)
@@ -37,36 +37,35 @@
 #include "AFPacketGenerator.h"
 #include "TagPacketGenerator.h"
 #include <iostream>
+#include <cstring>
 
 #include "../util/LogPrint.h"
 // CAFPacketGenerator
 
-CVector<_BYTE> CAFPacketGenerator::GenAFPacket(const bool bUseAFCRC, CTagPacketGenerator& TagPacketGenerator)
+void CAFPacketGenerator::GenAFPacket(const bool bUseAFCRC, CTagPacketGenerator& TagPacketGenerator,
+	std::vector<_BYTE>& vecbyPacket)
 {
 /*
 	The AF layer encapsulates a single TAG Packet. Mandatory TAG items:
 	*ptr, dlfc, fac_, sdc_, sdci, robm, str0-3
 */
-	CVector<_BINARY>	vecbiAFPkt;
-
 	/* Payload length in bytes */
-// TODO: check if padding bits are needed to get byte alignment!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-	int iPayloadLenBytes = TagPacketGenerator.GetTagPacketLength();
-		
-	/* 10 bytes AF header, 2 bytes CRC, payload */
-	const int iAFPktLenBits =
-		iPayloadLenBytes * SIZEOF__BYTE + 12 * SIZEOF__BYTE;
+	const int iPayloadLenBytes = TagPacketGenerator.GetTagPacketLength();
 
-	/* Init vector length */
-	vecbiAFPkt.Init(iAFPktLenBits);
-	vecbiAFPkt.ResetBitAccess();
+	/* 10 bytes AF header, 2 bytes CRC, payload. The buffer keeps its
+	   capacity, so usually nothing is allocated here */
+	vecbyPacket.resize(size_t(iPayloadLenBytes) + 12);
+	_BYTE* p = &vecbyPacket[0];
 
 	/* SYNC: two-byte ASCII representation of "AF" */
-	vecbiAFPkt.Enqueue((uint32_t) 'A', SIZEOF__BYTE);
-	vecbiAFPkt.Enqueue((uint32_t) 'F', SIZEOF__BYTE);
+	*p++ = 'A';
+	*p++ = 'F';
 
 	/* LEN: length of the payload, in bytes (4 bytes long -> 32 bits) */
-	vecbiAFPkt.Enqueue((uint32_t) iPayloadLenBytes, 32);
+	*p++ = _BYTE(iPayloadLenBytes >> 24);
+	*p++ = _BYTE(iPayloadLenBytes >> 16);
+	*p++ = _BYTE(iPayloadLenBytes >> 8);
+	*p++ = _BYTE(iPayloadLenBytes);
 
 	/* SEQ: sequence number. Each AF Packet shall increment the sequence number
 	   by one for each packet sent, regardless of content. There shall be no
@@ -74,7 +73,8 @@ CVector<_BYTE> CAFPacketGenerator::GenAFPacket(const bool bUseAFCRC, CTagPacketG
 	   The counter shall wrap from FFFF_[16] to 0000_[16], thus the value shall
 	   count, FFFE_[16], FFFF_[16], 0000_[16], 0001_[16], etc.
 	   (2 bytes long -> 16 bits) */
-	vecbiAFPkt.Enqueue((uint32_t) iSeqNumber, 16);
+	*p++ = _BYTE(iSeqNumber >> 8);
+	*p++ = _BYTE(iSeqNumber);
 
 	iSeqNumber++;
 	if (iSeqNumber > 0xFFFF)
@@ -84,67 +84,35 @@ CVector<_BYTE> CAFPacketGenerator::GenAFPacket(const bool bUseAFCRC, CTagPacketG
 	   a field combining the CF, MAJ and MIN fields */
 	/* CF: CRC Flag, 0 if the CRC field is not used (CRC value shall be
 	   0000_[16]) or 1 if the CRC field contains a valid CRC (1 bit long) */
-	if (bUseAFCRC)
-		vecbiAFPkt.Enqueue((uint32_t) 1, 1);
-	else
-		vecbiAFPkt.Enqueue((uint32_t) 0, 1);
-
 	/* MAJ: major revision of the AF protocol in use (3 bits long) */
-	vecbiAFPkt.Enqueue((uint32_t) AF_MAJOR_REVISION, 3);
-
 	/* MIN: minor revision of the AF protocol in use (4 bits long) */
-	vecbiAFPkt.Enqueue((uint32_t) AF_MINOR_REVISION, 4);
+	*p++ = _BYTE((bUseAFCRC ? 0x80 : 0) | ((AF_MAJOR_REVISION & 7) << 4) |
+		(AF_MINOR_REVISION & 15));
 
 	/* Protocol Type (PT): single byte encoding the protocol of the data carried
 	   in the payload. For TAG Packets, the value shall be the ASCII
 	   representation of "T" */
-	vecbiAFPkt.Enqueue((uint32_t) 'T', SIZEOF__BYTE);
+	*p++ = 'T';
 
 
 	/* Payload -------------------------------------------------------------- */
 
-// TODO: copy data byte wise -> check if possible to do that...
-
-	TagPacketGenerator.PutTagPacketData(vecbiAFPkt);
+	/* Tag items are byte aligned, each is copied straight into the packet */
+	p = TagPacketGenerator.PutTagPacketData(p);
 
 	/* CRC: CRC calculated as described in annex A if the CF field is 1,
 	   otherwise 0000_[16] */
+	uint32_t iCRC = 0;
 	if (bUseAFCRC)
 	{
 		CCRC CRCObject;
 
 		/* CRC -------------------------------------------------------------- */
-		/* Calculate the CRC and put at the end of the stream */
+		/* Calculate the CRC over header and payload and put at the end */
 		CRCObject.Reset(16);
-
-		vecbiAFPkt.ResetBitAccess();
-
-		/* 2 bytes CRC -> "- 2" */
-		for (int i = 0; i < iAFPktLenBits / SIZEOF__BYTE - 2; i++)
-			CRCObject.AddByte((_BYTE) vecbiAFPkt.Separate(SIZEOF__BYTE));
-
-		/* Now, pointer in "enqueue"-function is back at the same place, 
-		   add CRC */
-		vecbiAFPkt.Enqueue(CRCObject.GetCRC(), 16);
-	}
-	else
-		vecbiAFPkt.Enqueue((uint32_t) 0, 16);
-
-	return PackBytes(vecbiAFPkt);
-}
-
-CVector<_BYTE> CAFPacketGenerator::PackBytes(CVector<_BINARY> &vecbiPacket)
-{
-	/* Convert to bytes and return */
-	CVector<_BYTE> vecbyPacket;
-	vecbiPacket.ResetBitAccess();
-	size_t bits = vecbiPacket.Size();
-	size_t bytes = bits / SIZEOF__BYTE;
-	vecbyPacket.reserve(bytes);
-	for(size_t i=0; i<bytes; i++)
-	{
-	 	_BYTE byte = (_BYTE)vecbiPacket.Separate(SIZEOF__BYTE);
-		vecbyPacket.push_back(byte);
+		CRCObject.AddBytes(&vecbyPacket[0], size_t(p - &vecbyPacket[0]));
+		iCRC = CRCObject.GetCRC();
 	}
-	return vecbyPacket;
+	*p++ = _BYTE(iCRC >> 8);
+	*p++ = _BYTE(iCRC);
 }
@@ -41,10 +41,12 @@ class CAFPacketGenerator
 public:
 	CAFPacketGenerator() : iSeqNumber(0) {}
 
-	CVector<_BYTE> GenAFPacket(const bool bUseAFCRC, CTagPacketGenerator& TagPacketGenerator);
+	/* Writes the AF packet to vecbyPacket, which is resized to fit. Reusing the
+	   same vector for each packet avoids allocations */
+	void GenAFPacket(const bool bUseAFCRC, CTagPacketGenerator& TagPacketGenerator,
+		std::vector<_BYTE>& vecbyPacket);
 
 private:
-	CVector<_BYTE> PackBytes(CVector<_BINARY> &vecbiPacket);
 	int							iSeqNumber;
 };
 
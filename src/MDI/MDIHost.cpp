@@ -0,0 +1,319 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Decoding of many MDI/RSCI inputs in one process
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "MDIHost.h"
+#include "../util/Settings.h"
+#include "../util/StatusBroadcast.h"
+#include <cstdio>
+#include <thread>
+#include <chrono>
+#include <functional>
+
+#ifndef _WIN32
+# include <csignal>
+# include <pthread.h>
+#endif
+
+/* Frames a stream decodes per turn at most, so a stream with a backlog
+   doesn't hold up the others for long */
+static const int MAX_FRAMES_PER_TURN = 4;
+
+/* Sleep between turns in which no input had a frame */
+static const int IDLE_SLEEP_MS = 20;
+
+/* Seconds without a frame before the status of a stream is cleared */
+static const time_t INPUT_TIMEOUT_S = 2;
+
+/* Creating audio decoders initialises the shared codec list, which is not
+   meant for concurrent access */
+static std::mutex SetupMutex;
+
+#ifndef _WIN32
+static sigset_t StopSignals;
+#endif
+
+CMDIStream::CMDIStream(int iNewId, CSettings& Settings, const std::string& strOutputPattern)
+    : iId(iNewId), strOrigin(), Mutex(), Parameters(), Upstream(), DecodeRSIMDI(),
+      UtilizeFACData(), UtilizeSDCData(), MultiServiceDecoder(),
+      RSIPacketBuf(), FACDecBuf(), SDCDecBuf(),
+      iLastSDCBits(-1), veciLastStreamLen(MAX_NUM_STREAMS, -1),
+      vecLastServices(MAX_NUM_SERVICES), iNumFrames(0), LastFrame(0), Metrics()
+{
+    Parameters.SetDataDirectory(Settings.Get("Receiver", "datafilesdirectory",
+                                             Parameters.GetDataDirectory()));
+    Parameters.SetNewAudSampleRate(Settings.Get("Receiver", "samplerateaud",
+                                                int(DEFAULT_SOUNDCRD_SAMPLE_RATE)));
+    Parameters.FetchNewSampleRate();
+
+    /* Like a receiver with RSCI input: DRM, always tracking */
+    Parameters.Lock();
+    Parameters.eReceiverMode = RM_DRM;
+    Parameters.eAcquiState = AS_WITH_SIGNAL;
+    Parameters.ResetServicesStreams();
+    Parameters.ResetCurSelAudDatServ();
+    Parameters.Unlock();
+    UtilizeSDCData.GetSDCReceive()->SetSDCType(CSDCReceive::SDC_DRM);
+
+    /* The host polls all streams in turns */
+    Upstream.SetBlocking(false);
+
+    std::string strPattern = strOutputPattern;
+    if (!strPattern.empty())
+    {
+        size_t iPos;
+        bool bReplaced = false;
+        while ((iPos = strPattern.find("%n")) != std::string::npos)
+        {
+            strPattern.replace(iPos, 2, std::to_string(iId));
+            bReplaced = true;
+        }
+        if (!bReplaced)
+            strPattern += "_" + std::to_string(iId);
+    }
+    MultiServiceDecoder.SetStandalone(true);
+    MultiServiceDecoder.SetMode(true, false);
+    MultiServiceDecoder.SetOutputPattern(strPattern);
+}
+
+bool CMDIStream::SetOrigin(const std::string& strNewOrigin)
+{
+    strOrigin = strNewOrigin;
+    return Upstream.SetOrigin(strNewOrigin);
+}
+
+int CMDIStream::Process()
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    int iFrames = 0;
+    while (iFrames < MAX_FRAMES_PER_TURN)
+    {
+        RSIPacketBuf.Clear();
+        Upstream.ReadData(Parameters, RSIPacketBuf);
+        if (RSIPacketBuf.GetFillLevel() == 0)
+            break;
+
+        DecodeFrame();
+        iFrames++;
+    }
+
+    const time_t Now = time(nullptr);
+    if (iFrames > 0)
+    {
+        LastFrame = Now;
+        CStatusBroadcast::Notify();
+    }
+    else if ((LastFrame != 0) && (Now - LastFrame > INPUT_TIMEOUT_S))
+    {
+        /* Same as the receiver when its RSCI input stops */
+        Parameters.Lock();
+        Parameters.ReceiveStatus.InterfaceI.SetStatus(NOT_PRESENT);
+        Parameters.ReceiveStatus.InterfaceO.SetStatus(NOT_PRESENT);
+        Parameters.ReceiveStatus.TSync.SetStatus(NOT_PRESENT);
+        Parameters.ReceiveStatus.FSync.SetStatus(NOT_PRESENT);
+        Parameters.ReceiveStatus.FAC.SetStatus(NOT_PRESENT);
+        Parameters.ReceiveStatus.SDC.SetStatus(NOT_PRESENT);
+        Parameters.ReceiveStatus.SLAudio.SetStatus(NOT_PRESENT);
+        Parameters.Unlock();
+        LastFrame = 0;
+    }
+
+    return iFrames;
+}
+
+void CMDIStream::DecodeFrame()
+{
+    uint64_t iModuleStart = CReceiverMetrics::ThreadCpuNs();
+
+    DecodeRSIMDI.ProcessData(Parameters, RSIPacketBuf, FACDecBuf, SDCDecBuf,
+                             MultiServiceDecoder.GetStreamBuffers());
+
+    /* The SDC length comes with the SDC itself, take it before using it */
+    if (Parameters.iNumSDCBitsPerSFrame != iLastSDCBits)
+    {
+        iLastSDCBits = Parameters.iNumSDCBitsPerSFrame;
+        UtilizeSDCData.SetInitFlag();
+    }
+
+    UtilizeFACData.WriteData(Parameters, FACDecBuf);
+
+    /* Only whole SDC blocks, the SDC is only sent once per superframe */
+    if (SDCDecBuf.GetFillLevel() == Parameters.iNumSDCBitsPerSFrame)
+        UtilizeSDCData.WriteData(Parameters, SDCDecBuf);
+    SDCDecBuf.Clear();
+
+    CheckConfiguration();
+    iModuleStart = Metrics.AddModuleTime(CReceiverMetrics::MOD_DECODING, iModuleStart);
+
+    std::vector<std::function<void()> > vecTasks;
+    {
+        std::lock_guard<std::mutex> Lock(SetupMutex);
+        MultiServiceDecoder.AddTasks(Parameters, vecTasks);
+    }
+    for (size_t i = 0; i < vecTasks.size(); i++)
+        vecTasks[i]();
+    Metrics.AddModuleTime(CReceiverMetrics::MOD_UTILIZATION, iModuleStart);
+
+    Metrics.FrameDecoded(Parameters);
+    iNumFrames++;
+}
+
+void CMDIStream::CheckConfiguration()
+{
+    bool bStreams = false;
+    bool bServices = false;
+
+    Parameters.Lock();
+    for (int i = 0; i < MAX_NUM_STREAMS; i++)
+    {
+        const int iLen = Parameters.GetStreamLen(i);
+        if (iLen != veciLastStreamLen[size_t(i)])
+        {
+            veciLastStreamLen[size_t(i)] = iLen;
+            bStreams = true;
+        }
+    }
+    for (size_t i = 0; i < vecLastServices.size() && i < Parameters.Service.size(); i++)
+    {
+        CService& Last = vecLastServices[i];
+        const CService& Service = Parameters.Service[i];
+        if ((Last.IsActive() != Service.IsActive()) ||
+            (Last.eAudDataFlag != Service.eAudDataFlag) ||
+            (Last.AudioParam != Service.AudioParam) ||
+            (Last.DataParam != Service.DataParam))
+        {
+            Last = Service;
+            bServices = true;
+        }
+    }
+    Parameters.Unlock();
+
+    if (bStreams)
+        DecodeRSIMDI.SetInitFlag();
+    if (bStreams || bServices)
+        MultiServiceDecoder.SetInitFlag();
+}
+
+CMDIHost::CMDIHost(CSettings* pNewSettings) : pSettings(pNewSettings), vecStreams(), Pool()
+{
+}
+
+CMDIHost::~CMDIHost()
+{
+    Pool.Stop();
+}
+
+bool CMDIHost::Open()
+{
+    CSettings& s = *pSettings;
+    const std::string strInputs = s.Get("command", "mdihost", std::string());
+    const std::string strPattern = s.Get("command", "mdihostout", std::string());
+
+#ifndef _WIN32
+    /* Handled by polling in Run(). Blocked before any thread is started,
+       the threads inherit the mask. Opening a network input already starts
+       the packet ingest thread */
+    sigemptyset(&StopSignals);
+    sigaddset(&StopSignals, SIGINT);
+    sigaddset(&StopSignals, SIGHUP);
+    sigaddset(&StopSignals, SIGTERM);
+    sigaddset(&StopSignals, SIGQUIT);
+    pthread_sigmask(SIG_BLOCK, &StopSignals, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+#endif
+
+    size_t iStart = 0;
+    while (iStart <= strInputs.size())
+    {
+        size_t iEnd = strInputs.find(',', iStart);
+        if (iEnd == std::string::npos)
+            iEnd = strInputs.size();
+        const std::string strInput = strInputs.substr(iStart, iEnd - iStart);
+        iStart = iEnd + 1;
+        if (strInput.empty())
+            continue;
+
+        std::unique_ptr<CMDIStream> pStream(new CMDIStream(int(vecStreams.size()), s, strPattern));
+        if (!pStream->SetOrigin(strInput))
+        {
+            fprintf(stderr, "MDIHost: can't open input %s\n", strInput.c_str());
+            continue;
+        }
+        fprintf(stderr, "MDIHost: stream %d <- %s\n", pStream->GetId(), strInput.c_str());
+        vecStreams.push_back(std::move(pStream));
+    }
+
+    if (vecStreams.empty())
+    {
+        fprintf(stderr, "MDIHost: no input\n");
+        return false;
+    }
+
+    Pool.Start(unsigned(s.Get("command", "mdihostthreads", 0)));
+    fprintf(stderr, "MDIHost: %zu streams on %u threads\n", vecStreams.size(),
+            Pool.GetNumThreads() + 1);
+    return true;
+}
+
+bool CMDIHost::StopRequested()
+{
+#ifndef _WIN32
+    sigset_t Pending;
+    if (sigpending(&Pending) == 0)
+    {
+        return sigismember(&Pending, SIGINT) || sigismember(&Pending, SIGHUP) ||
+               sigismember(&Pending, SIGTERM) || sigismember(&Pending, SIGQUIT);
+    }
+#endif
+    return false;
+}
+
+void CMDIHost::Run()
+{
+    std::vector<int> veciFrames(vecStreams.size(), 0);
+    std::vector<std::function<void()> > vecTasks;
+    for (size_t i = 0; i < vecStreams.size(); i++)
+    {
+        CMDIStream* pStream = vecStreams[i].get();
+        int* piFrames = &veciFrames[i];
+        vecTasks.push_back([pStream, piFrames]() {
+            *piFrames = pStream->Process();
+        });
+    }
+
+    while (!StopRequested())
+    {
+        Pool.RunAll(vecTasks);
+
+        bool bAny = false;
+        for (size_t i = 0; i < veciFrames.size(); i++)
+            bAny = bAny || (veciFrames[i] > 0);
+        if (!bAny)
+            std::this_thread::sleep_for(std::chrono::milliseconds(IDLE_SLEEP_MS));
+    }
+    fprintf(stderr, "MDIHost: stopped\n");
+}
@@ -0,0 +1,169 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Decoding of many MDI/RSCI inputs in one process
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#ifndef MDI_HOST_H_INCLUDED
+#define MDI_HOST_H_INCLUDED
+
+#include "../GlobalDefinitions.h"
+#include "../Parameter.h"
+#include "../DataIO.h"
+#include "../util/Buffer.h"
+#include "../util/WorkerPool.h"
+#include "../util/Metrics.h"
+#include "../sourcedecoders/MultiServiceDecoder.h"
+#include "MDIRSCI.h"
+#include "MDIDecode.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <ctime>
+
+class CSettings;
+class CDataDecoder;
+
+/**
+ * @brief Receiver context of one MDI/RSCI input of the host
+ *
+ * Only what decoding MDI needs: the upstream input, the tag packet decoder,
+ * FAC and SDC evaluation and one decoder per stream of the multiplex. There
+ * is no DSP front-end, no sound card and no CDRMReceiver.
+ *
+ * The receiver learns about a new multiplex configuration through the
+ * CParameter callbacks into CDRMReceiver. A context has no receiver, it
+ * compares the configuration after each frame instead and re-initialises
+ * the modules which depend on it.
+ */
+class CMDIStream
+{
+public:
+    /**
+     * @param iNewId Number of the input, used in the output names
+     * @param strOutputPattern Audio output pattern, see CMultiServiceDecoder.
+     * "%n" is replaced by iNewId, without it "_<iNewId>" is appended
+     */
+    CMDIStream(int iNewId, CSettings& Settings, const std::string& strOutputPattern);
+
+    /**
+     * @brief Open the input, same syntax as --rsiin
+     */
+    bool SetOrigin(const std::string& strNewOrigin);
+
+    /**
+     * @brief Decode the frames which arrived since the last call, never
+     * waits for input
+     * @return Number of frames decoded
+     */
+    int Process();
+
+    int GetId() const { return iId; }
+    std::string GetOrigin() const { return strOrigin; }
+    unsigned long GetNumFrames() const { return iNumFrames; }
+    bool GetInputStats(CPacketIngestStats& Stats) const { return Upstream.GetInputStats(Stats); }
+    CReceiverMetrics& GetMetrics() { return Metrics; }
+
+    /**
+     * @brief Lock to hold while reading the parameters or using the
+     * decoders from another thread
+     */
+    std::mutex& GetMutex() { return Mutex; }
+    CParameter& GetParameters() { return Parameters; }
+    CDataDecoder* GetDataDecoder(const int iService)
+        { return MultiServiceDecoder.GetDataDecoder(iService); }
+    void GetOutputStatus(std::vector<CMultiServiceDecoder::COutputStatus>& vecStatus) const
+        { MultiServiceDecoder.GetOutputStatus(vecStatus); }
+
+protected:
+    void DecodeFrame();
+    void CheckConfiguration();
+
+    const int                   iId;
+    std::string                 strOrigin;
+    std::mutex                  Mutex;
+
+    CParameter                  Parameters;
+    CUpstreamDI                 Upstream;
+    CDecodeRSIMDI               DecodeRSIMDI;
+    CUtilizeFACData             UtilizeFACData;
+    CUtilizeSDCData             UtilizeSDCData;
+    CMultiServiceDecoder        MultiServiceDecoder;
+
+    CSingleBuffer<_BINARY>      RSIPacketBuf;
+    CSingleBuffer<_BINARY>      FACDecBuf;
+    CSingleBuffer<_BINARY>      SDCDecBuf;
+
+    /* Multiplex configuration the modules were set up for */
+    int                         iLastSDCBits;
+    std::vector<int>            veciLastStreamLen;
+    std::vector<CService>       vecLastServices;
+
+    std::atomic<unsigned long>  iNumFrames;
+    time_t                      LastFrame;
+    CReceiverMetrics            Metrics;
+};
+
+/**
+ * @brief Decodes many MDI/RSCI inputs, one CMDIStream each, on a pool of
+ * threads
+ *
+ * All streams are polled in turns. A turn hands each stream to the pool as
+ * one task, which decodes everything the stream received since its last
+ * turn, so the streams are decoded in parallel and a stream is never
+ * decoded by two threads at the same time. If nothing arrived on any
+ * input, the host sleeps a little before the next turn.
+ */
+class CMDIHost
+{
+public:
+    CMDIHost(CSettings* pNewSettings);
+    ~CMDIHost();
+
+    /**
+     * @brief Open the inputs of the settings (--mdi-host) and start the
+     * threads
+     * @return false if no input could be opened
+     */
+    bool Open();
+
+    /**
+     * @brief Decode until SIGINT, SIGTERM, SIGHUP or SIGQUIT
+     */
+    void Run();
+
+    size_t GetNumStreams() const { return vecStreams.size(); }
+    CMDIStream& GetStream(const size_t i) { return *vecStreams[i]; }
+
+protected:
+    bool StopRequested();
+
+    CSettings*                  pSettings;
+    std::vector<std::unique_ptr<CMDIStream> > vecStreams;
+    CWorkerPool                 Pool;
+};
+
+#endif // MDI_HOST_H_INCLUDED
@@ -48,12 +48,12 @@ CMDIInBuffer::Put(const vector<_BYTE>& data)
  * Its possible signals could get lost :(
  */
 void
-CMDIInBuffer::Get(vector<_BYTE>& data)
+CMDIInBuffer::Get(vector<_BYTE>& data, unsigned long iTimeout)
 {
 	guard.Lock();
 	if(buffer.empty())
 	{
-		if(blocker.Wait(&guard, 1000))
+		if(iTimeout > 0 && blocker.Wait(&guard, iTimeout))
 		{
 			if(buffer.empty())
 				data.clear();
@@ -40,7 +40,8 @@ public:
 	{}
 
 	void Put(const std::vector<_BYTE>& data);
-	void Get(std::vector<_BYTE>& data);
+	/* Waits up to iTimeout ms for a packet, returns an empty one if none came */
+	void Get(std::vector<_BYTE>& data, unsigned long iTimeout = 1000);
 
 protected:
     std::queue< std::vector<_BYTE> > buffer;
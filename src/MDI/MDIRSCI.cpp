@@ -54,6 +54,7 @@ CDownstreamDI::CDownstreamDI() : iLogFraCnt(0), pDrmReceiver(nullptr),
 	bMDIOutEnabled(false), bMDIInEnabled(false),bIsRecording(false),
 	iFrequency(0), strRecordType(),
 	vecTagItemGeneratorStr(MAX_NUM_STREAMS), vecTagItemGeneratorRBP(MAX_NUM_STREAMS),
+	mapFanOut(), pFanOut(new CPacketFanOut),
 	RSISubscribers(),pRSISubscriberFile(new CRSISubscriberFile)
 {
 	/* Initialise all the generators for strx and rbpx tags */
@@ -82,6 +83,7 @@ CDownstreamDI::~CDownstreamDI()
 	{
 		delete *i;
 	}
+	delete pFanOut;
 }
 
 /******************************************************************************\
@@ -315,13 +317,39 @@ void CDownstreamDI::GenDIPacket()
 
 	/*return TagPacketGenerator.GenAFPacket(bUseAFCRC);*/
 
-	/* transmit a packet to each subscriber */
+	/* transmit a packet to each subscriber. The AF packet and its PFT
+	   fragments are made only once for all subscribers with the same framing,
+	   plain UDP subscribers are then all served by one fan out socket */
 	for(vector<CRSISubscriber*>::iterator s = RSISubscribers.begin();
 			s!=RSISubscribers.end(); s++)
 	{
-		// re-generate the profile tag for each subscriber
-		TagItemGeneratorProfile.GenTag((*s)->GetProfile());
-		(*s)->TransmitPacket(TagPacketGenerator);
+		if (!(*s)->IsActive())
+			continue;
+		const CRSIFraming Framing = (*s)->GetFraming();
+		CFanOutGroup& Group = mapFanOut[Framing];
+		if (!Group.bFramed)
+		{
+			// re-generate the profile tag for each profile
+			TagItemGeneratorProfile.GenTag(Framing.cProfile);
+			Group.Framer.Frame(TagPacketGenerator, Framing);
+			Group.bFramed = true;
+		}
+		uint32_t addr;
+		uint16_t port;
+		if ((*s)->GetFanOutDestination(addr, port))
+			Group.vecDestinations.push_back(make_pair(addr, port));
+		else
+			(*s)->SendFramed(Group.Framer.GetPackets());
+	}
+	for(map<CRSIFraming, CFanOutGroup>::iterator g = mapFanOut.begin();
+			g!=mapFanOut.end(); g++)
+	{
+		if (!g->second.vecDestinations.empty())
+		{
+			pFanOut->Send(g->second.Framer.GetPackets(), g->second.vecDestinations);
+			g->second.vecDestinations.clear();
+		}
+		g->second.bFramed = false;
 	}
 }
 
@@ -535,7 +563,7 @@ void CDownstreamDI::poll()
 /******************************************************************************\
 * DI receive status, send control                                             *
 \******************************************************************************/
-CUpstreamDI::CUpstreamDI() : source(nullptr), sink(), bUseAFCRC(true), bMDIOutEnabled(true)
+CUpstreamDI::CUpstreamDI() : source(nullptr), pSocket(nullptr), pFile(nullptr), sink(), bUseAFCRC(true), bBlocking(true), bMDIOutEnabled(true)
 {
 	/* Init constant tag */
 	TagItemGeneratorProTyRSCI.GenTag();
@@ -555,19 +583,30 @@ bool CUpstreamDI::SetOrigin(const string& str)
 		delete source;
 		source = nullptr;
 	}
+	pSocket = nullptr;
+	pFile = nullptr;
 
 	strOrigin = str;
 
 	// try a file
-	source = new CPacketSourceFile;
+	CPacketSourceFile* file = new CPacketSourceFile;
+	file->SetReplay(strReplay);
+	source = file;
 	bool bOK = source->SetOrigin(str);
 
-	if(!bOK)
+	if(bOK)
+		pFile = file;
+	else
 	{
 		// try a socket
 		delete source;
-		source = new CPacketSocketNative;
+		CPacketSocketNative* socket = new CPacketSocketNative;
+		/* wait for the next packet in poll() rather than in the queue */
+		socket->SetPollTimeout(bBlocking ? 1000 : 0);
+		source = socket;
 		bOK = source->SetOrigin(str);
+		if (bOK)
+			pSocket = socket;
 	}
 	if (bOK)
 	{
@@ -577,6 +616,27 @@ bool CUpstreamDI::SetOrigin(const string& str)
 	return false;
 }
 
+bool CUpstreamDI::GetInputStats(CPacketIngestStats& Stats) const
+{
+	return pSocket != nullptr && pSocket->GetStats(Stats);
+}
+
+bool CUpstreamDI::SetReplay(const string& strNewReplay)
+{
+	CPacketSourceFile Check;
+	if (!Check.SetReplay(strNewReplay))
+		return false;
+	strReplay = strNewReplay;
+	if (pFile != nullptr)
+		pFile->SetReplay(strReplay);
+	return true;
+}
+
+bool CUpstreamDI::GetInputFinished() const
+{
+	return pFile != nullptr && pFile->Finished();
+}
+
 bool CUpstreamDI::SetDestination(const string& str)
 {
 
@@ -639,7 +699,7 @@ void CUpstreamDI::ProcessDataInternal(CParameter&)
 {
 	vector<_BYTE> vecbydata;
 	source->poll();
-	queue.Get(vecbydata);
+	queue.Get(vecbydata, bBlocking ? 1000 : 0);
 	size_t bytes = vecbydata.size();
 	iOutputBlockSize = bytes*SIZEOF__BYTE;
 	pvecOutputData->Init(iOutputBlockSize);
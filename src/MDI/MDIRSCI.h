@@ -45,6 +45,13 @@
 #include "TagPacketGenerator.h"
 #include "RSISubscriber.h"
 #include <vector>
+#include <map>
+#include <utility>
+
+class CPacketSocketNative;
+class CPacketFanOut;
+class CPacketSourceFile;
+struct CPacketIngestStats;
 
 /* Classes ********************************************************************/
 class CUpstreamDI : public CReceiverModul<_BINARY, _BINARY> , public CPacketSink
@@ -56,6 +63,15 @@ public:
 	/* CRSIMDIInInterface */
 	bool SetOrigin(const std::string& strAddr);
 	bool GetInEnabled() {return source != nullptr;}
+	/* Received datagrams, only for UDP input */
+	bool GetInputStats(CPacketIngestStats& Stats) const;
+	/* Pacing of pcap and file framing input, see CPacketSourceFile */
+	bool SetReplay(const std::string& strNewReplay);
+	/* True when a file input has delivered its last frame */
+	bool GetInputFinished() const;
+	/* Wait up to a second for the next packet (default) or return an
+	   empty block right away. Set before SetOrigin() */
+	void SetBlocking(const bool bNewBlocking) {bBlocking = bNewBlocking;}
 
 	/* CRCIOutInterface */
 	bool SetDestination(const std::string& strArgument);
@@ -79,10 +95,14 @@ protected:
 	std::string						strDestination;
 	CMDIInBuffer	  			queue;
 	CPacketSource*				source;
+	CPacketSocketNative*		pSocket; /* source, if it is a socket */
+	CPacketSourceFile*			pFile; /* source, if it is a file */
+	std::string					strReplay;
 	CRSISubscriberSocket		sink;
 	CPft						Pft;
 
 	bool						bUseAFCRC;
+	bool						bBlocking;
 
 	CSingleBuffer<_BINARY>		MDIInBuffer;
 	bool						bMDIOutEnabled;
@@ -196,6 +216,17 @@ protected:
 	/* TAG Packet generator */
 	CTagPacketGeneratorWithProfiles TagPacketGenerator;
 
+	/* Subscribers with the same framing share the packets of each frame */
+	struct CFanOutGroup
+	{
+		CFanOutGroup() : Framer(), bFramed(false), vecDestinations() {}
+		CRSIFramer		Framer;
+		bool			bFramed;
+		std::vector< std::pair<uint32_t, uint16_t> > vecDestinations;
+	};
+	std::map<CRSIFraming, CFanOutGroup>	mapFanOut;
+	CPacketFanOut*					pFanOut;
+
 	std::vector< CRSISubscriber *>		RSISubscribers;
 	CRSISubscriberFile*				pRSISubscriberFile;
 	CPacketSource*					source;
@@ -41,6 +41,7 @@
 #include "MDITagItems.h"
 #include <iostream>
 #include <fstream>
+#include <cstring>
 using namespace std;
 
 #include "../util/LogPrint.h"
@@ -184,12 +185,9 @@ CTagItemGeneratorFAC::GenTag(CParameter & Parameter, CSingleBuffer < _BINARY > &
 		PrepareTag(NUM_FAC_BITS_PER_BLOCK);
 		CVectorEx < _BINARY > *pvecbiFACData = FACData.Get(NUM_FAC_BITS_PER_BLOCK);
 
-		/* Channel parameters, service parameters, CRC */
-		pvecbiFACData->ResetBitAccess();
-
-		/* FAC data is always 72 bits long which is 9 bytes, copy data byte-wise */
-		for (int i = 0; i < NUM_FAC_BITS_PER_BLOCK / SIZEOF__BYTE; i++)
-			Enqueue(pvecbiFACData->Separate(SIZEOF__BYTE), SIZEOF__BYTE);
+		/* Channel parameters, service parameters, CRC. FAC data is always
+		   72 bits long which is 9 bytes */
+		EnqueueBits(*pvecbiFACData, NUM_FAC_BITS_PER_BLOCK);
 	}
 }
 
@@ -232,14 +230,11 @@ CTagItemGeneratorSDC::GenTag(CParameter & Parameter, CSingleBuffer < _BINARY > &
 	CVectorEx < _BINARY > *pvecbiSDCData = SDCData.Get(Parameter.iNumSDCBitsPerSFrame);
 
 	/* Service Description Channel Block */
-	pvecbiSDCData->ResetBitAccess();
-
 	Enqueue((uint32_t) 0, 4);	/* Rfu */
 
-	/* We have to copy bits instead of bytes since the length of SDC data is
-	   usually not a multiple of 8 */
-	for (int i = 0; i < iLenSDCDataBits; i++)
-		Enqueue(pvecbiSDCData->Separate(1), 1);
+	/* The length of SDC data is usually not a multiple of 8, the remaining
+	   bits are packed individually */
+	EnqueueBits(*pvecbiSDCData, iLenSDCDataBits);
 }
 
 string
@@ -420,12 +415,8 @@ CTagItemGeneratorStr::GenTag(CParameter & Parameter, CSingleBuffer < _BINARY > &
 
 	PrepareTag(iLenStrData);
 
-	pvecbiStrData->ResetBitAccess();
-	/* Data is always a multiple of 8 -> copy bytes */
-	for (int i = 0; i < iLenStrData / SIZEOF__BYTE; i++)
-	{
-		Enqueue(pvecbiStrData->Separate(SIZEOF__BYTE), SIZEOF__BYTE);
-	}
+	/* Data is always a multiple of 8 -> pack bytes */
+	EnqueueBits(*pvecbiStrData, iLenStrData);
 }
 
 string
@@ -948,18 +939,20 @@ CTagItemGeneratorRBP::GetProfiles()
 }
 
 // Call this to write the binary data (header + payload) to the vector
-void
-CTagItemGenerator::PutTagItemData(CVector < _BINARY > &vecbiDestination)
+_BYTE*
+CTagItemGenerator::PutTagItemData(_BYTE* pbyDest) const
 {
-	vecbiTagData.ResetBitAccess();
-	for (int i = 0; i < vecbiTagData.Size(); i++)
-		vecbiDestination.Enqueue(vecbiTagData.Separate(1), 1);
+	/* Tag items are always a whole number of bytes -> memcpy */
+	const size_t iNumBytes = size_t(TagData.Size() / SIZEOF__BYTE);
+	if (iNumBytes > 0)
+		memcpy(pbyDest, TagData.Data(), iNumBytes);
+	return pbyDest + iNumBytes;
 }
 
 void
 CTagItemGenerator::Reset()	// Resets bit vector to zero length (i.e. no header)
 {
-	vecbiTagData.Init(0);
+	TagData.Init(0);
 }
 
 void
@@ -975,15 +968,14 @@ CTagItemGenerator::PrepareTag(int iLenDataBits)
 	string strTagName = GetTagName();
 	/* Init vector length. 4 bytes for tag name and 4 bytes for data length
 	   plus the length of the actual data */
-	vecbiTagData.Init(8 * SIZEOF__BYTE + iLenDataBits);
-	vecbiTagData.ResetBitAccess();
+	TagData.Init(8 * SIZEOF__BYTE + iLenDataBits);
 
 	/* Set tag name (always four bytes long) */
 	for (int i = 0; i < 4; i++)
-		vecbiTagData.Enqueue((uint32_t) strTagName[i], SIZEOF__BYTE);
+		TagData.Enqueue((uint32_t) strTagName[i], SIZEOF__BYTE);
 
 	/* Set tag data length */
-	vecbiTagData.Enqueue((uint32_t) iLenDataBits, 32);
+	TagData.Enqueue((uint32_t) iLenDataBits, 32);
 
 }
 
@@ -991,7 +983,14 @@ CTagItemGenerator::PrepareTag(int iLenDataBits)
 void
 CTagItemGenerator::Enqueue(uint32_t iInformation, int iNumOfBits)
 {
-	vecbiTagData.Enqueue(iInformation, iNumOfBits);
+	TagData.Enqueue(iInformation, iNumOfBits);
+}
+
+void
+CTagItemGenerator::EnqueueBits(CVector < _BINARY > &vecbiData, int iNumOfBits)
+{
+	if (iNumOfBits > 0)
+		TagData.EnqueueBits(&vecbiData[0], iNumOfBits);
 }
 
 /* TODO: there are still some RSCI tags left to implement */
@@ -1159,13 +1158,12 @@ CTagItemGeneratorGPS::GetProfiles()
 void
 CTagItemGeneratorPowerSpectralDensity::GenTag(CParameter & Parameter)
 {
-	PrepareTag(Parameter.vecrPSD.Size() * SIZEOF__BYTE);
+	const int iSize = Parameter.vecrPSD.Size();
+	PrepareTag(iSize * SIZEOF__BYTE);
 
-	for (int i = 0; i < Parameter.vecrPSD.Size(); i++)
-	{
-		uint32_t p = uint8_t(Parameter.vecrPSD[i] * _REAL(-2.0));
-		Enqueue((uint32_t) p, SIZEOF__BYTE);
-	}
+	_BYTE* pbyDest = ReserveBytes(iSize);
+	for (int i = 0; i < iSize; i++)
+		pbyDest[i] = uint8_t(Parameter.vecrPSD[i] * _REAL(-2.0));
 
 }
 
@@ -1192,11 +1190,9 @@ CTagItemGeneratorPowerImpulseResponse::GenTag(CParameter & Parameter)
 
 		Enqueue(uint32_t(int(Parameter.rPIRStart * _REAL(256.0))), 2*SIZEOF__BYTE);
 		Enqueue(uint32_t(int(Parameter.rPIREnd * _REAL(256.0))), 2*SIZEOF__BYTE);
+		_BYTE* pbyDest = ReserveBytes(samples);
 		for (int i = 0; i < samples; i++)
-		{
-			uint32_t p = uint8_t((Parameter.vecrPIR[i]+rOffset) * _REAL(-2.0));
-			Enqueue((uint32_t) p, SIZEOF__BYTE);
-		}
+			pbyDest[i] = uint8_t((Parameter.vecrPIR[i]+rOffset) * _REAL(-2.0));
 	} // else generate empty tag
 }
 
@@ -1439,12 +1435,8 @@ CTagItemGeneratorAMAudio::GenTag(CParameter & Parameter, CSingleBuffer < _BINARY
 	Enqueue(0, 8);
 
 	// Now send the stream data
-	pvecbiStrData->ResetBitAccess();
-	// Data is always a multiple of 8 -> copy bytes
-	for (int i = 0; i < iLenStrData / SIZEOF__BYTE; i++)
-	{
-		Enqueue(pvecbiStrData->Separate(SIZEOF__BYTE), SIZEOF__BYTE);
-	}
+	// Data is always a multiple of 8 -> pack bytes
+	EnqueueBits(*pvecbiStrData, iLenStrData);
 }
 
 string
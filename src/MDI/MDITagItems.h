@@ -33,13 +33,15 @@
 #include "MDIDefinitions.h"
 #include "../Parameter.h"
 #include "../util/Buffer.h"
+#include "../util/BitStream.h"
 
 /* Base class for all of the tag item generators. Handles some of the functions common to all tag items */
 class CTagItemGenerator
 {
 public:
-	void PutTagItemData(CVector<_BINARY> &vecbiDestination); // Call this to write the binary data (header + payload) to the std::vector
-    int GetTotalLength() { return vecbiTagData.Size();} // returns the length in bits
+	// Write the binary data (header + payload) to pbyDest, returns the end of the written bytes
+	_BYTE* PutTagItemData(_BYTE* pbyDest) const;
+    int GetTotalLength() { return TagData.Size();} // returns the length in bits
 	void Reset(); // Resets bit std::vector to zero length (i.e. no header)
 	void GenEmptyTag(); // Generates valid tag item with zero payload length
 	virtual ~CTagItemGenerator() {}
@@ -54,8 +56,14 @@ protected:
 
 	void Enqueue(uint32_t iInformation, int iNumOfBits);
 
+	// Byte aligned payload: pointer for writing iNumBytes bytes directly, nullptr if not aligned
+	_BYTE* ReserveBytes(int iNumBytes) { return TagData.ReserveBytes(iNumBytes); }
+
+	// Pack bit vector data (one bit per element) into the tag payload
+	void EnqueueBits(CVector<_BINARY>& vecbiData, int iNumOfBits);
+
 private:
-	CVector<_BINARY> vecbiTagData; // Stores the generated data
+	CBitStream TagData; // Stores the generated data, packed
 };
 
 /* Base class for tag items for applications with different profiles */
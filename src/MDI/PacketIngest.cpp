@@ -0,0 +1,370 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Batched UDP reception on an I/O thread (epoll + recvmmsg)
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "PacketIngest.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#ifdef __linux__
+# include <sys/epoll.h>
+# include <sys/eventfd.h>
+# include <sys/socket.h>
+# include <netinet/in.h>
+# include <unistd.h>
+#endif
+
+/* Datagrams per recvmmsg call */
+static const size_t BATCH_SIZE = 32;
+
+/* Batches read from one socket before looking at the others again */
+static const int MAX_BATCHES_PER_EVENT = 8;
+
+static const int EPOLL_TIMEOUT_MS = 250;
+
+
+/* CIngestEndpoint ------------------------------------------------------------*/
+
+CIngestEndpoint::CIngestEndpoint(int iNewSocket, size_t iNewNumSlots, size_t iNewSlotSize)
+    : iSocket(iNewSocket), iNumSlots(iNewNumSlots), iSlotSize(iNewSlotSize),
+      vecbySlab(iNewNumSlots * iNewSlotSize), veciLength(iNewNumSlots, 0),
+      veciAddr(iNewNumSlots, 0), veciPort(iNewNumSlots, 0),
+      iHead(0), iTail(0), bWaiting(false),
+      iPackets(0), iBytes(0), iDropped(0), iSyscalls(0), rPacketRate(0.0),
+      iPacketsAtRate(0)
+{
+}
+
+bool CIngestEndpoint::Empty() const
+{
+    return iTail.load(std::memory_order_relaxed) == iHead.load(std::memory_order_acquire);
+}
+
+bool CIngestEndpoint::Receive(std::vector<_BYTE>& vecbyData, uint32_t& iAddr, uint16_t& iPort)
+{
+    const size_t iPos = iTail.load(std::memory_order_relaxed);
+    if (iPos == iHead.load(std::memory_order_acquire))
+        return false;
+
+    const size_t iSlot = iPos % iNumSlots;
+    const _BYTE* pData = &vecbySlab[iSlot * iSlotSize];
+    /* assign() keeps the capacity, so the consumer's vector doesn't grow
+       again after the first few packets */
+    vecbyData.assign(pData, pData + veciLength[iSlot]);
+    iAddr = veciAddr[iSlot];
+    iPort = veciPort[iSlot];
+
+    iTail.store(iPos + 1, std::memory_order_release);
+    return true;
+}
+
+bool CIngestEndpoint::Wait(int iMilliseconds)
+{
+    std::unique_lock<std::mutex> lock(WaitMutex);
+    bWaiting.store(true);
+    const bool bData = WaitCond.wait_for(lock, std::chrono::milliseconds(iMilliseconds),
+                                         [this] { return !Empty(); });
+    bWaiting.store(false);
+    return bData;
+}
+
+void CIngestEndpoint::GetStats(CPacketIngestStats& Stats) const
+{
+    Stats.iPackets = iPackets.load(std::memory_order_relaxed);
+    Stats.iBytes = iBytes.load(std::memory_order_relaxed);
+    Stats.iDropped = iDropped.load(std::memory_order_relaxed);
+    Stats.iSyscalls = iSyscalls.load(std::memory_order_relaxed);
+    Stats.rPacketRate = rPacketRate.load(std::memory_order_relaxed);
+}
+
+void CIngestEndpoint::Publish(size_t iNum)
+{
+    /* Sequentially consistent, so either the consumer sees the packets
+       before it sleeps or we see it waiting */
+    iHead.store(iHead.load(std::memory_order_relaxed) + iNum);
+    if (bWaiting.load())
+    {
+        std::lock_guard<std::mutex> lock(WaitMutex);
+        WaitCond.notify_one();
+    }
+}
+
+void CIngestEndpoint::UpdateRate(_REAL rSeconds)
+{
+    const unsigned long long iNow = iPackets.load(std::memory_order_relaxed);
+    rPacketRate.store(_REAL(iNow - iPacketsAtRate) / rSeconds, std::memory_order_relaxed);
+    iPacketsAtRate = iNow;
+}
+
+#ifdef __linux__
+
+void CIngestEndpoint::Drain()
+{
+    mmsghdr msgs[BATCH_SIZE];
+    iovec iov[BATCH_SIZE];
+    sockaddr_in addrs[BATCH_SIZE];
+
+    /* Read into when the ring is full */
+    static thread_local std::vector<_BYTE> vecbyScratch;
+
+    for (int iBatch = 0; iBatch < MAX_BATCHES_PER_EVENT; iBatch++)
+    {
+        const size_t iHeadPos = iHead.load(std::memory_order_relaxed);
+        const size_t iFree = iNumSlots - (iHeadPos - iTail.load(std::memory_order_acquire));
+        const bool bFull = (iFree == 0);
+        const size_t iNum = bFull ? BATCH_SIZE : std::min(iFree, BATCH_SIZE);
+
+        if (bFull && vecbyScratch.size() < BATCH_SIZE * iSlotSize)
+            vecbyScratch.resize(BATCH_SIZE * iSlotSize);
+
+        memset(msgs, 0, sizeof(mmsghdr) * iNum);
+        for (size_t i = 0; i < iNum; i++)
+        {
+            _BYTE* pBuf = bFull ? &vecbyScratch[i * iSlotSize]
+                          : &vecbySlab[((iHeadPos + i) % iNumSlots) * iSlotSize];
+            iov[i].iov_base = pBuf;
+            iov[i].iov_len = iSlotSize;
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_name = &addrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        }
+
+        const int iRead = recvmmsg(iSocket, msgs, unsigned(iNum), MSG_DONTWAIT, nullptr);
+        if (iRead <= 0)
+        {
+            if ((iRead < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR))
+                fprintf(stderr, "PacketIngest: recvmmsg failed: %s\n", strerror(errno));
+            return;
+        }
+
+        iSyscalls.fetch_add(1, std::memory_order_relaxed);
+        iPackets.fetch_add(unsigned(iRead), std::memory_order_relaxed);
+
+        if (bFull)
+        {
+            iDropped.fetch_add(unsigned(iRead), std::memory_order_relaxed);
+            continue;
+        }
+
+        unsigned long long iReadBytes = 0;
+        for (int i = 0; i < iRead; i++)
+        {
+            const size_t iSlot = (iHeadPos + size_t(i)) % iNumSlots;
+            /* A truncated packet fails its CRC anyway, pass it on empty */
+            if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC)
+            {
+                iDropped.fetch_add(1, std::memory_order_relaxed);
+                veciLength[iSlot] = 0;
+            }
+            else
+            {
+                veciLength[iSlot] = msgs[i].msg_len;
+            }
+            veciAddr[iSlot] = addrs[i].sin_addr.s_addr;
+            veciPort[iSlot] = addrs[i].sin_port;
+            iReadBytes += msgs[i].msg_len;
+        }
+        iBytes.fetch_add(iReadBytes, std::memory_order_relaxed);
+        Publish(size_t(iRead));
+
+        if (size_t(iRead) < iNum)
+            return; /* socket is empty */
+    }
+}
+
+
+/* CPacketIngest --------------------------------------------------------------*/
+
+CPacketIngest* CPacketIngest::Instance()
+{
+    static CPacketIngest Ingest;
+    static const bool bStarted = Ingest.Start();
+    return bStarted ? &Ingest : nullptr;
+}
+
+CPacketIngest::CPacketIngest()
+    : iEpoll(-1), iWakeup(-1), IOThread(), bRunning(false), mapEndpoints(), iNextId(1)
+{
+}
+
+CPacketIngest::~CPacketIngest()
+{
+    if (IOThread.joinable())
+    {
+        bRunning = false;
+        const uint64_t iOne = 1;
+        if (write(iWakeup, &iOne, sizeof(iOne)) < 0)
+            perror("PacketIngest: wakeup");
+        IOThread.join();
+    }
+    for (std::map<uint64_t, CIngestEndpoint*>::iterator it = mapEndpoints.begin();
+         it != mapEndpoints.end(); ++it)
+        delete it->second;
+    if (iWakeup >= 0)
+        close(iWakeup);
+    if (iEpoll >= 0)
+        close(iEpoll);
+}
+
+bool CPacketIngest::Start()
+{
+    iEpoll = epoll_create1(EPOLL_CLOEXEC);
+    iWakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if ((iEpoll < 0) || (iWakeup < 0))
+    {
+        fprintf(stderr, "PacketIngest: epoll not available: %s\n", strerror(errno));
+        return false;
+    }
+
+    epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u64 = 0; /* the wakeup, endpoints start at 1 */
+    if (epoll_ctl(iEpoll, EPOLL_CTL_ADD, iWakeup, &ev) < 0)
+        return false;
+
+    bRunning = true;
+    IOThread = std::thread(&CPacketIngest::Run, this);
+    return true;
+}
+
+CIngestEndpoint* CPacketIngest::Add(int iSocket, size_t iNumSlots, size_t iSlotSize)
+{
+    CIngestEndpoint* pEndpoint = new CIngestEndpoint(iSocket, iNumSlots, iSlotSize);
+
+    std::lock_guard<std::mutex> lock(Mutex);
+    const uint64_t iId = iNextId++;
+
+    epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u64 = iId;
+    if (epoll_ctl(iEpoll, EPOLL_CTL_ADD, iSocket, &ev) < 0)
+    {
+        fprintf(stderr, "PacketIngest: can't watch socket: %s\n", strerror(errno));
+        delete pEndpoint;
+        return nullptr;
+    }
+    mapEndpoints[iId] = pEndpoint;
+    return pEndpoint;
+}
+
+void CPacketIngest::Remove(CIngestEndpoint* pEndpoint)
+{
+    if (pEndpoint == nullptr)
+        return;
+
+    std::lock_guard<std::mutex> lock(Mutex);
+    for (std::map<uint64_t, CIngestEndpoint*>::iterator it = mapEndpoints.begin();
+         it != mapEndpoints.end(); ++it)
+    {
+        if (it->second == pEndpoint)
+        {
+            (void)epoll_ctl(iEpoll, EPOLL_CTL_DEL, pEndpoint->iSocket, nullptr);
+            mapEndpoints.erase(it);
+            break;
+        }
+    }
+    delete pEndpoint;
+}
+
+void CPacketIngest::Run()
+{
+    epoll_event events[16];
+    std::chrono::steady_clock::time_point tRate = std::chrono::steady_clock::now();
+
+    while (bRunning)
+    {
+        const int iNum = epoll_wait(iEpoll, events, 16, EPOLL_TIMEOUT_MS);
+        if ((iNum < 0) && (errno != EINTR))
+        {
+            fprintf(stderr, "PacketIngest: epoll_wait failed: %s\n", strerror(errno));
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(Mutex);
+        for (int i = 0; i < iNum; i++)
+        {
+            /* Removed since epoll_wait returned? */
+            std::map<uint64_t, CIngestEndpoint*>::iterator it = mapEndpoints.find(events[i].data.u64);
+            if (it != mapEndpoints.end())
+                it->second->Drain();
+        }
+
+        const std::chrono::steady_clock::time_point tNow = std::chrono::steady_clock::now();
+        const _REAL rSeconds = std::chrono::duration<_REAL>(tNow - tRate).count();
+        if (rSeconds >= 1.0)
+        {
+            for (std::map<uint64_t, CIngestEndpoint*>::iterator it = mapEndpoints.begin();
+                 it != mapEndpoints.end(); ++it)
+                it->second->UpdateRate(rSeconds);
+            tRate = tNow;
+        }
+    }
+}
+
+#else /* !__linux__ */
+
+void CIngestEndpoint::Drain()
+{
+}
+
+CPacketIngest* CPacketIngest::Instance()
+{
+    return nullptr;
+}
+
+CPacketIngest::CPacketIngest()
+    : iEpoll(-1), iWakeup(-1), IOThread(), bRunning(false), mapEndpoints(), iNextId(1)
+{
+}
+
+CPacketIngest::~CPacketIngest()
+{
+}
+
+bool CPacketIngest::Start()
+{
+    return false;
+}
+
+CIngestEndpoint* CPacketIngest::Add(int, size_t, size_t)
+{
+    return nullptr;
+}
+
+void CPacketIngest::Remove(CIngestEndpoint* pEndpoint)
+{
+    delete pEndpoint;
+}
+
+void CPacketIngest::Run()
+{
+}
+
+#endif
@@ -0,0 +1,154 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Batched UDP reception on an I/O thread (epoll + recvmmsg)
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#ifndef PACKET_INGEST_H_INCLUDED
+#define PACKET_INGEST_H_INCLUDED
+
+#include "../GlobalDefinitions.h"
+#include <vector>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+struct CPacketIngestStats
+{
+    CPacketIngestStats() : iPackets(0), iBytes(0), iDropped(0), iSyscalls(0), rPacketRate(0.0) {}
+    unsigned long long  iPackets;   /* datagrams received */
+    unsigned long long  iBytes;
+    unsigned long long  iDropped;   /* queue full or datagram too long */
+    unsigned long long  iSyscalls;  /* recvmmsg calls which returned data */
+    _REAL               rPacketRate; /* datagrams per second, last second */
+};
+
+/**
+ * @brief Datagrams of one socket, received by the I/O thread
+ *
+ * Single producer (the I/O thread), single consumer (whoever polls the
+ * socket) ring of fixed size slots in one preallocated slab. The producer
+ * receives directly into the free slots, nothing is allocated or locked on
+ * the way from the kernel to the consumer.
+ */
+class CIngestEndpoint
+{
+public:
+    CIngestEndpoint(int iNewSocket, size_t iNewNumSlots, size_t iNewSlotSize);
+
+    /**
+     * @brief Take the oldest datagram, non-blocking
+     * @return false if there is none
+     */
+    bool Receive(std::vector<_BYTE>& vecbyData, uint32_t& iAddr, uint16_t& iPort);
+
+    bool Empty() const;
+
+    /**
+     * @brief Wait up to iMilliseconds for a datagram
+     */
+    bool Wait(int iMilliseconds);
+
+    void GetStats(CPacketIngestStats& Stats) const;
+
+protected:
+    friend class CPacketIngest;
+
+    /* I/O thread */
+    void        Drain();
+    void        Publish(size_t iNum);
+    void        UpdateRate(_REAL rSeconds);
+
+    const int           iSocket;
+    const size_t        iNumSlots;
+    const size_t        iSlotSize;
+    std::vector<_BYTE>  vecbySlab;
+    std::vector<size_t> veciLength;
+    std::vector<uint32_t> veciAddr;
+    std::vector<uint16_t> veciPort;
+    std::atomic<size_t> iHead; /* written by the producer */
+    std::atomic<size_t> iTail; /* written by the consumer */
+
+    /* Only used to sleep in Wait(), the producer takes the mutex only if
+       the consumer is actually waiting */
+    std::mutex              WaitMutex;
+    std::condition_variable WaitCond;
+    std::atomic<bool>       bWaiting;
+
+    std::atomic<unsigned long long> iPackets;
+    std::atomic<unsigned long long> iBytes;
+    std::atomic<unsigned long long> iDropped;
+    std::atomic<unsigned long long> iSyscalls;
+    std::atomic<_REAL>      rPacketRate;
+    unsigned long long      iPacketsAtRate;
+};
+
+/**
+ * @brief One thread receiving the datagrams of all registered sockets
+ *
+ * The thread waits in epoll_wait on all sockets and reads as many datagrams
+ * per recvmmsg call as the endpoint ring has room for. Datagrams which
+ * arrive while a ring is full are read anyway, so the kernel buffer doesn't
+ * overflow unnoticed, and counted as dropped.
+ *
+ * Only available on Linux, Instance() returns nullptr elsewhere and the
+ * sockets are read directly by their consumer as before.
+ */
+class CPacketIngest
+{
+public:
+    static CPacketIngest* Instance();
+    ~CPacketIngest();
+
+    /**
+     * @brief Start receiving on a non-blocking UDP socket
+     * @param iNumSlots Datagrams the endpoint can hold
+     * @param iSlotSize Longest datagram accepted
+     * @return nullptr if the socket can't be watched
+     */
+    CIngestEndpoint* Add(int iSocket, size_t iNumSlots, size_t iSlotSize);
+
+    /**
+     * @brief Stop receiving, deletes the endpoint but doesn't close the
+     * socket
+     */
+    void Remove(CIngestEndpoint* pEndpoint);
+
+protected:
+    CPacketIngest();
+    bool        Start();
+    void        Run();
+
+    int                 iEpoll;
+    int                 iWakeup;
+    std::thread         IOThread;
+    std::atomic<bool>   bRunning;
+    std::mutex          Mutex; /* held while the thread uses an endpoint */
+    std::map<uint64_t, CIngestEndpoint*> mapEndpoints;
+    uint64_t            iNextId;
+};
+
+#endif
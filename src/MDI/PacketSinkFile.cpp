@@ -28,6 +28,7 @@
 \******************************************************************************/
 
 #include "PacketSinkFile.h"
+#include <chrono>
 
 /* include this here mostly for htonl */
 #ifdef _WIN32
@@ -195,13 +196,25 @@ CPacketSinkFileFraming::close()
 void
 CPacketSinkFileFraming::write(const vector<_BYTE>& vecbydata)
 {
+	/* Time of reception, used to pace the replay */
+	const chrono::nanoseconds now =
+		chrono::duration_cast<chrono::nanoseconds>(chrono::system_clock::now().time_since_epoch());
+	const uint32_t t[2] = {
+		htonl(uint32_t(now.count() / 1000000000)),
+		htonl(uint32_t(now.count() % 1000000000))
+	};
 	uint32_t p, n;
-	n = 4+4+vecbydata.size(); // afpf
+	n = 4+4+sizeof(t) + 4+4+vecbydata.size(); // time, afpf
 	// Tag Item fio_
 	fwrite("fio_",4,1,pFile);
 	p = htonl(8*n);
     fwrite(&p,4,1,pFile);
 	// nested tag packets
+	// Tag Item time
+	fwrite("time",4,1,pFile);
+	p = htonl(8*sizeof(t));
+	fwrite(&p,4,1,pFile);
+	fwrite(t,sizeof(t),1,pFile);
 	// Tag Item afpf
 	fwrite("afpf",4,1,pFile);
 	n = vecbydata.size();
@@ -266,10 +279,10 @@ CPacketSinkPcapFile::write(const vector<_BYTE>& vecbydata)
     out.push_back(0); out.push_back(0); // TODO UDP Header CRC
 	out.insert(out.end(), vecbydata.begin(), vecbydata.end());
     pcap_pkthdr hdr;
-	time_t t;
-	time(&t);
-    hdr.ts.tv_sec = t;
-    hdr.ts.tv_usec = 0; /* TODO more precise timestamps */
+	const chrono::microseconds now =
+		chrono::duration_cast<chrono::microseconds>(chrono::system_clock::now().time_since_epoch());
+    hdr.ts.tv_sec = now.count() / 1000000;
+    hdr.ts.tv_usec = now.count() % 1000000;
 	hdr.caplen = c;
 	hdr.len = c;
     pcap_dump((u_char*)pFile, &hdr, (u_char*)&out[0]);
@@ -59,16 +59,25 @@ inline int inet_aton(const char*s, void * a) {
 # include <sys/socket.h>
 # include <unistd.h>
 # include <fcntl.h>
+# include <sys/uio.h>
 # define SOCKET_ERROR				(-1)
 # define INVALID_SOCKET				(-1)
 #endif
 
+/* Datagrams queued between the I/O thread and poll(). A DRM frame is one
+   MDI packet every 400 ms, or a few more with PFT fragmentation */
+#define INGEST_QUEUE_PACKETS		128
+
+/* Datagrams handed to one sendmmsg call by CPacketFanOut */
+#define FANOUT_BATCH				64
+
 using namespace std;
 
 CPacketSocketNative::CPacketSocketNative():
         pPacketSink(nullptr), HostAddrOut(),
-        writeBuf(),udp(true),
-        s(INVALID_SOCKET), origin(""), dest("")
+        writeBuf(),udp(true), bInterface(false),
+        s(INVALID_SOCKET), origin(""), dest(""),
+        pIngest(nullptr), vecbyIngest(), iPollTimeout(0)
 {
 	memset(&sourceAddr, 0, sizeof(sourceAddr));
 	memset(&destAddr, 0, sizeof(destAddr));
@@ -77,6 +86,16 @@ CPacketSocketNative::CPacketSocketNative():
 
 CPacketSocketNative::~CPacketSocketNative()
 {
+    if (pIngest != nullptr)
+        CPacketIngest::Instance()->Remove(pIngest);
+    if (s != INVALID_SOCKET)
+    {
+#ifdef _WIN32
+        closesocket(s);
+#else
+        close(s);
+#endif
+    }
 }
 
 // Set the sink which will receive the packets
@@ -101,9 +120,6 @@ CPacketSocketNative::SendPacket(const vector < _BYTE > &vecbydata, uint32_t, uin
         return;
     if (udp)
     {
-        string ss;
-        GetDestination(ss);
-        cerr << "send packet " << ss << endl;
         int n = sendto(s, (char*)&vecbydata[0], vecbydata.size(), 0, (sockaddr*)&HostAddrOut, sizeof(HostAddrOut));
 		if(n==SOCKET_ERROR) {
 #ifdef _WIN32
@@ -180,7 +196,8 @@ CPacketSocketNative::SetDestination(const string & strNewAddr)
 
         if (setsockopt(s, IPPROTO_IP, IP_TTL, (char*)&ttl, sizeof(ttl))==SOCKET_ERROR)
             bAddressOK = false;
-        if (AddrInterface.s_addr != htonl(INADDR_ANY))
+        bInterface = AddrInterface.s_addr != htonl(INADDR_ANY);
+        if (bInterface)
         {
             if (setsockopt(s, IPPROTO_IP, IP_MULTICAST_IF,
                            (char *) &AddrInterface, sizeof(AddrInterface)) == SOCKET_ERROR)
@@ -352,13 +369,23 @@ CPacketSocketNative::SetOrigin(const string & strNewAddr)
 #else
     fcntl(s, F_SETFL, O_NONBLOCK);  // set to non-blocking
 #endif
+
+    /* Hand the socket to the I/O thread, if there is one */
+    if (pIngest == nullptr)
+    {
+        CPacketIngest* pPacketIngest = CPacketIngest::Instance();
+        if (pPacketIngest != nullptr)
+            pIngest = pPacketIngest->Add(s, INGEST_QUEUE_PACKETS, MAX_SIZE_BYTES_NETW_BUF);
+    }
     return true;
 }
 
 void
 CPacketSocketNative::poll()
 {
-    if (udp)
+    if (udp && pIngest != nullptr)
+        pollIngest();
+    else if (udp)
         pollDatagram();
     else
         pollStream();
@@ -382,6 +409,47 @@ CPacketSocketNative::pollStream()
     }
 }
 
+bool
+CPacketSocketNative::GetStats(CPacketIngestStats& Stats) const
+{
+    if (pIngest == nullptr)
+        return false;
+    pIngest->GetStats(Stats);
+    return true;
+}
+
+bool
+CPacketSocketNative::GetFanOutDestination(uint32_t& addr, uint16_t& port) const
+{
+    if (!udp || bInterface || s == INVALID_SOCKET || sourceAddr.sin_family != 0)
+        return false;
+    addr = HostAddrOut.sin_addr.s_addr;
+    port = HostAddrOut.sin_port;
+    return true;
+}
+
+void
+CPacketSocketNative::deliver(const vector<_BYTE>& vecbydata, uint32_t addr, uint16_t port)
+{
+    if (pPacketSink == nullptr || vecbydata.empty())
+        return;
+    // optionally filter on source address
+    if (sourceAddr.sin_addr.s_addr == htonl(INADDR_ANY) || sourceAddr.sin_addr.s_addr == addr)
+        pPacketSink->SendPacket(vecbydata, addr, port);
+}
+
+void
+CPacketSocketNative::pollIngest()
+{
+    if (iPollTimeout > 0 && pIngest->Empty())
+        (void)pIngest->Wait(iPollTimeout);
+
+    uint32_t addr;
+    uint16_t port;
+    while (pIngest->Receive(vecbyIngest, addr, port))
+        deliver(vecbyIngest, addr, port);
+}
+
 void
 CPacketSocketNative::pollDatagram()
 {
@@ -413,17 +481,116 @@ CPacketSocketNative::pollDatagram()
 				//qDebug(s.str().c_str());
 			}
             vecbydata.resize(readBytes);
-            if (sourceAddr.sin_addr.s_addr == htonl(INADDR_ANY))
+            deliver(vecbydata, sender.sin_addr.s_addr, sender.sin_port);
+            vecbydata.resize(MAX_SIZE_BYTES_NETW_BUF);
+        }
+    } while (readBytes>0);
+}
+
+CPacketFanOut::CPacketFanOut() : s(INVALID_SOCKET), vecAddr(),
+    iDatagrams(0), iSyscalls(0)
+{
+}
+
+CPacketFanOut::~CPacketFanOut()
+{
+    if (s != INVALID_SOCKET)
+    {
+#ifdef _WIN32
+        closesocket(s);
+#else
+        close(s);
+#endif
+    }
+}
+
+bool
+CPacketFanOut::Open()
+{
+    if (s != INVALID_SOCKET)
+        return true;
+    s = socket(AF_INET, SOCK_DGRAM, 0);
+    if (s == INVALID_SOCKET)
+    {
+        cerr << "can't create fan out socket" << endl;
+        return false;
+    }
+    /* same as CPacketSocketNative::SetDestination() */
+    int ttl = 127;
+    (void)setsockopt(s, IPPROTO_IP, IP_TTL, (char*)&ttl, sizeof(ttl));
+    return true;
+}
+
+void
+CPacketFanOut::Send(const vector< vector<_BYTE> >& packets,
+                    const vector< pair<uint32_t, uint16_t> >& destinations)
+{
+    if (packets.empty() || destinations.empty() || !Open())
+        return;
+
+    vecAddr.resize(destinations.size());
+    for (size_t d = 0; d < destinations.size(); d++)
+    {
+        memset(&vecAddr[d], 0, sizeof(sockaddr_in));
+        vecAddr[d].sin_family = AF_INET;
+        vecAddr[d].sin_addr.s_addr = destinations[d].first;
+        vecAddr[d].sin_port = destinations[d].second;
+    }
+
+#ifdef __linux__
+    /* Every destination gets all packets in order. The messages only point
+       at the packets, nothing is copied before the kernel does it */
+    mmsghdr msgs[FANOUT_BATCH];
+    iovec iov[FANOUT_BATCH];
+    size_t d = 0, p = 0;
+    while (d < destinations.size())
+    {
+        unsigned n = 0;
+        for (; (n < FANOUT_BATCH) && (d < destinations.size()); n++)
+        {
+            iov[n].iov_base = const_cast<_BYTE*>(packets[p].data());
+            iov[n].iov_len = packets[p].size();
+            memset(&msgs[n], 0, sizeof(mmsghdr));
+            msgs[n].msg_hdr.msg_name = &vecAddr[d];
+            msgs[n].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            msgs[n].msg_hdr.msg_iov = &iov[n];
+            msgs[n].msg_hdr.msg_iovlen = 1;
+            if (++p == packets.size())
             {
-                pPacketSink->SendPacket(vecbydata, sender.sin_addr.s_addr, sender.sin_port);
+                p = 0;
+                d++;
             }
-            else
+        }
+
+        unsigned iSent = 0;
+        while (iSent < n)
+        {
+            const int r = sendmmsg(s, &msgs[iSent], n - iSent, 0);
+            iSyscalls++;
+            if (r > 0)
             {
-                if (sourceAddr.sin_addr.s_addr == sender.sin_addr.s_addr) // optionally filter on source address
-                {
-                    pPacketSink->SendPacket(vecbydata, sender.sin_addr.s_addr, sender.sin_port);
-                }
+                iSent += unsigned(r);
+                iDatagrams += unsigned(r);
+            }
+            else if (errno != EINTR)
+            {
+                /* only the first message failed, skip it and carry on with
+                   the other destinations */
+                iSent++;
             }
         }
-    } while (readBytes>0);
+    }
+#else
+    for (size_t d = 0; d < destinations.size(); d++)
+    {
+        for (size_t p = 0; p < packets.size(); p++)
+        {
+            int n = sendto(s, (char*)&packets[p][0], packets[p].size(), 0,
+                           (sockaddr*)&vecAddr[d], sizeof(sockaddr_in));
+            iSyscalls++;
+            if (n != SOCKET_ERROR)
+                iDatagrams++;
+        }
+    }
+#endif
 }
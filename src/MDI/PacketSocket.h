@@ -44,6 +44,8 @@
 #define MAX_SIZE_BYTES_NETW_BUF		10000
 
 #include "PacketInOut.h"
+#include "PacketIngest.h"
+#include <utility>
 
 class CPacketSocketNative :
 	public CPacketSocket
@@ -67,9 +69,22 @@ public:
 
 	void poll();
 
+	/* Let poll() wait up to iMilliseconds for a datagram, 0 = don't wait */
+	void SetPollTimeout(int iMilliseconds) {iPollTimeout = iMilliseconds;}
+
+	/* Statistics of the I/O thread, false if the socket is read directly */
+	bool GetStats(CPacketIngestStats& Stats) const;
+
+	/* UDP destination (network byte order), if the packets could just as well
+	   be sent from any other socket: no multicast interface and no origin,
+	   which the other side might reply to */
+	bool GetFanOutDestination(uint32_t& addr, uint16_t& port) const;
+
 private:
 	void pollStream();
 	void pollDatagram();
+	void pollIngest();
+	void deliver(const std::vector<_BYTE>& vecbydata, uint32_t addr, uint16_t port);
 
     std::vector<std::string> parseDest(const std::string & strNewAddr);
 	CPacketSink *pPacketSink;
@@ -78,7 +93,39 @@ private:
 	sockaddr_in HostAddrOut;
 	std::vector<_BYTE>	writeBuf;
 	bool udp;
+	bool bInterface;
 	SOCKET s;
 	std::string origin, dest;
+
+	/* UDP datagrams received by the I/O thread, if available */
+	CIngestEndpoint* pIngest;
+	std::vector<_BYTE> vecbyIngest;
+	int iPollTimeout;
+};
+
+/* One UDP socket sending the same packets to many destinations. On Linux
+   all datagrams go out with as few sendmmsg calls as possible, each one
+   pointing at the same packet buffers, so the cost per destination is a
+   message header and not a copy and a system call per packet */
+class CPacketFanOut
+{
+public:
+	CPacketFanOut();
+	virtual ~CPacketFanOut();
+
+	/* Destinations are address and port in network byte order */
+	void Send(const std::vector< std::vector<_BYTE> >& packets,
+			  const std::vector< std::pair<uint32_t, uint16_t> >& destinations);
+
+	unsigned long long GetDatagrams() const {return iDatagrams;}
+	unsigned long long GetSyscalls() const {return iSyscalls;}
+
+private:
+	bool Open();
+
+	SOCKET s;
+	std::vector<sockaddr_in> vecAddr;
+	unsigned long long iDatagrams;
+	unsigned long long iSyscalls;
 };
 #endif
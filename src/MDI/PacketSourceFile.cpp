@@ -32,6 +32,7 @@
 #include <iostream>
 #include <cstdlib>
 #include <cerrno>
+#include <thread>
 
 #ifdef _WIN32
 /* Always include winsock2.h before windows.h */
@@ -48,8 +49,6 @@ typedef int SOCKET;
 # define INVALID_SOCKET				(-1)
 #endif
 
-#include "../util/Pacer.h"
-
 #ifdef HAVE_LIBPCAP
 # include <pcap.h>
 #endif
@@ -59,42 +58,166 @@ using namespace std;
 const size_t iMaxPacketSize = 4096;
 const size_t iAFHeaderLen = 10;
 const size_t iAFCRCLen = 2;
+const size_t iPFTMinHeaderLen = 14;
+
+/* Frame spacing of files without timestamps */
+const int64_t iFrameInterval = 400000;
+/* Gaps in the recording longer than this are replayed as one frame interval */
+const int64_t iMaxGap = 10000000;
+/* How far replay may fall behind before it stops catching up */
+const int64_t iMaxLate = 1000000;
+/* stdio buffer of the input file */
+const size_t iFileBufferSize = 256 * 1024;
+
+static inline bool IsPFT(const vector<_BYTE>& vecbydata)
+{
+    return vecbydata.size() >= iPFTMinHeaderLen && vecbydata[0] == 'P' && vecbydata[1] == 'F';
+}
+
+static inline int Pseq(const vector<_BYTE>& vecbydata)
+{
+    return (vecbydata[2] << 8) | vecbydata[3];
+}
 
 CPacketSourceFile::CPacketSourceFile():pPacketSink(nullptr),
-    last_packet_time(0),pacer(nullptr),
-    pF(nullptr), wanted_dest_port(-1), eFileType(pcap)
+    pF(nullptr), wanted_dest_port(-1), eFileType(pcap),
+    eReplayMode(RP_RECORDED), rSpeed(1.0),
+    vecbyNext(), iNextTime(0), bHaveNext(false),
+    iNominalTime(0), iLastPseq(-1),
+    tLastDue(), iLastTime(0), bStarted(false)
 {
-    pacer = new CPacer(400000000ULL);
 }
 
-void CPacketSourceFile::poll()
+bool CPacketSourceFile::SetReplay(const string& strReplay)
 {
-    pacer->wait();
-    vector<_BYTE> vecbydata (iMaxPacketSize);
-    int interval;
-    if(pF)
+    if (strReplay == "" || strReplay == "recorded")
     {
-        vecbydata.resize(0); // in case we don't find anything
-        switch(eFileType)
-        {
-        case pcap:
-            readPcap(vecbydata, interval);
-            break;
-        case ff:
-            readFF(vecbydata, interval);
-            break;
-        case af:
-            readRawAF(vecbydata, interval);
-            break;
-        case pf:
-            readRawPFT(vecbydata, interval);
-            break;
-        }
+        SetReplay(RP_RECORDED);
+        return true;
+    }
+    if (strReplay == "max")
+    {
+        SetReplay(RP_MAX_SPEED);
+        return true;
+    }
+    char* end = nullptr;
+    const double speed = strtod(strReplay.c_str(), &end);
+    if (end == strReplay.c_str() || *end != '\0' || speed <= 0.0)
+        return false;
+    SetReplay(RP_SCALED, speed);
+    return true;
+}
 
-        /* Decode the incoming packet */
+void CPacketSourceFile::SetReplay(EReplayMode eNewMode, _REAL rNewSpeed)
+{
+    eReplayMode = eNewMode;
+    rSpeed = (eNewMode == RP_SCALED && rNewSpeed > 0.0) ? rNewSpeed : 1.0;
+    bStarted = false;
+}
+
+void CPacketSourceFile::poll()
+{
+    if (!bHaveNext)
+        bHaveNext = readPacket(vecbyNext, iNextTime);
+    if (!bHaveNext)
+        return;
+
+    waitUntilDue(iNextTime);
+
+    /* The fragments of a PFT sequence belong to one frame, hand them over
+       together so the decoder doesn't wait for the rest of the frame */
+    const bool bPFT = IsPFT(vecbyNext);
+    const int iSeq = bPFT ? Pseq(vecbyNext) : -1;
+    do
+    {
         if (pPacketSink != nullptr)
-            pPacketSink->SendPacket(vecbydata);
+            pPacketSink->SendPacket(vecbyNext);
+        bHaveNext = readPacket(vecbyNext, iNextTime);
+    }
+    while (bPFT && bHaveNext && IsPFT(vecbyNext) && Pseq(vecbyNext) == iSeq);
+}
+
+void CPacketSourceFile::waitUntilDue(int64_t time)
+{
+    if (eReplayMode == RP_MAX_SPEED)
+        return;
+
+    const clock::time_point now = clock::now();
+    if (!bStarted)
+    {
+        /* The first frame is due now */
+        tLastDue = now;
+        iLastTime = time;
+        bStarted = true;
+        return;
+    }
+
+    int64_t delta = time - iLastTime;
+    if (delta < 0 || delta > iMaxGap)
+    {
+        /* Wrapped or restarted capture, or a long pause in the recording */
+        delta = iFrameInterval;
+    }
+    iLastTime = time;
+
+    tLastDue += chrono::microseconds(int64_t(_REAL(delta) / rSpeed));
+    if (now - tLastDue > chrono::microseconds(iMaxLate))
+    {
+        /* The decoder couldn't keep up, continue from here rather than
+           delivering a burst of frames */
+        tLastDue = now;
+        return;
+    }
+    this_thread::sleep_until(tLastDue);
+}
+
+int64_t CPacketSourceFile::nominalTime(const vector<_BYTE>& vecbydata)
+{
+    if (IsPFT(vecbydata))
+    {
+        const int iSeq = Pseq(vecbydata);
+        if (iSeq != iLastPseq)
+            iNominalTime += iFrameInterval;
+        iLastPseq = iSeq;
     }
+    else
+    {
+        iNominalTime += iFrameInterval;
+        iLastPseq = -1;
+    }
+    return iNominalTime;
+}
+
+bool CPacketSourceFile::readPacket(vector<_BYTE>& vecbydata, int64_t& time)
+{
+    if (pF == nullptr)
+        return false;
+
+    bool bOK = false;
+    bool bTimed = false;
+    switch(eFileType)
+    {
+    case pcap:
+        bOK = bTimed = readPcap(vecbydata, time);
+        break;
+    case ff:
+        bOK = readFF(vecbydata, time, bTimed);
+        break;
+    case af:
+        bOK = readRawAF(vecbydata);
+        break;
+    case pf:
+        bOK = readRawPFT(vecbydata);
+        break;
+    }
+    if (!bOK)
+    {
+        closeFile();
+        return false;
+    }
+    if (!bTimed)
+        time = nominalTime(vecbydata);
+    return true;
 }
 
 bool
@@ -107,7 +230,7 @@ CPacketSourceFile::SetOrigin(const string& origin)
         wanted_dest_port = atoi(str.substr(p+1).c_str());
         str = str.substr(0, p);
     }
-    if(str.rfind(".pcap") == str.length()-5)
+    if(str.length() >= 5 && str.rfind(".pcap") == str.length()-5)
     {
 #ifdef HAVE_LIBPCAP
         char errbuf[PCAP_ERRBUF_SIZE];
@@ -120,6 +243,10 @@ CPacketSourceFile::SetOrigin(const string& origin)
         pF = fopen(str.c_str(), "rb");
         if ( pF != nullptr)
         {
+            /* Read ahead in big blocks, the packets are only a few hundred
+               bytes each */
+            setvbuf((FILE *) pF, nullptr, _IOFBF, iFileBufferSize);
+
             char c;
             size_t n = fread(&c, sizeof(c), 1, (FILE *) pF);
             (void)n;
@@ -142,10 +269,14 @@ CPacketSourceFile::SetOrigin(const string& origin)
             }
         }
     }
+    bHaveNext = false;
+    bStarted = false;
+    iNominalTime = 0;
+    iLastPseq = -1;
     return pF != nullptr;
 }
 
-CPacketSourceFile::~CPacketSourceFile()
+void CPacketSourceFile::closeFile()
 {
     if(eFileType != pcap && pF)
         fclose((FILE*)pF);
@@ -155,7 +286,12 @@ CPacketSourceFile::~CPacketSourceFile()
         pcap_close((pcap_t*)pF);
 #endif
     }
-    pF = 0;
+    pF = nullptr;
+}
+
+CPacketSourceFile::~CPacketSourceFile()
+{
+    closeFile();
 }
 
 // Set the sink which will receive the packets
@@ -172,47 +308,40 @@ CPacketSourceFile::ResetPacketSink()
     pPacketSink = nullptr;
 }
 
-void
+bool
 CPacketSourceFile::readTagPacketHeader(string& tag, uint32_t& len)
 {
+    char name[4];
     uint32_t bytes;
-    size_t n;
 
-    tag = "";
-    for(int i=0; i<4; i++)
-    {
-        char c;
-        n = fread(&c, sizeof(char), 1, (FILE *) pF);
-        tag += c;
-    }
+    if (fread(name, sizeof(name), 1, (FILE *) pF) != 1
+            || fread(&bytes, sizeof(bytes), 1, (FILE *) pF) != 1)
+        return false;
 
-    n = fread(&bytes, sizeof(bytes), 1, (FILE *) pF);
+    tag.assign(name, sizeof(name));
     len = ntohl(bytes)/8;
-
-    (void)n;
+    return true;
 }
 
-void
-CPacketSourceFile::readFF(vector<_BYTE>& vecbydata, int& interval)
+bool
+CPacketSourceFile::readFF(vector<_BYTE>& vecbydata, int64_t& time, bool& bTimed)
 {
-
     string tag;
     uint32_t fflen,len;
-    readTagPacketHeader(tag, fflen);
 
-    interval = 400;
+    bTimed = false;
+    if(!readTagPacketHeader(tag, fflen))
+        return false;
 
     if(tag != "fio_")
-    {
-        fclose((FILE *) pF);
-        pF = 0;
-        return;
-    }
+        return false;
 
+    bool bGotPacket = false;
     long remaining = fflen; // use a signed number here to help loop exit
     while(remaining>0)
     {
-        readTagPacketHeader(tag, len);
+        if(!readTagPacketHeader(tag, len))
+            return false;
         remaining -= 8; // 4 bytes tag, 4 bytes length;
         remaining -= len;
 
@@ -221,27 +350,23 @@ CPacketSourceFile::readFF(vector<_BYTE>& vecbydata, int& interval)
             if(len != 8)
             {
                 cout << "weird length in FF " << int(len) << " expected 8" << endl;
-                fclose((FILE *) pF);
-                pF = 0;
-                return;
+                return false;
             }
-            // read the time tag packet payload
-            uint32_t s,ns;
-            size_t n = fread(&s, sizeof(s), 1, (FILE *) pF);
-            n = fread(&ns, sizeof(ns), 1, (FILE *) pF);
-            (void)n;
-            //TODO update last packet and interval times
-            readTagPacketHeader(tag, len);
-            remaining -= 8; // 4 bytes tag, 4 bytes length;
-            remaining -= len;
+            // TI_SEC and TI_NSEC
+            uint32_t t[2];
+            if(fread(t, sizeof(t), 1, (FILE *) pF) != 1)
+                return false;
+            time = int64_t(ntohl(t[0]))*1000000 + ntohl(t[1])/1000;
+            bTimed = true;
         }
-
-        if(tag=="afpf")
+        else if(tag=="afpf")
         {
-            uint32_t l = readRawAF(vecbydata, interval);
-            if(l!=len) {
-                qDebug("why not");
-            }
+            if(len > iMaxPacketSize)
+                return false;
+            vecbydata.resize(len);
+            if(len > 0 && fread(&vecbydata[0], 1, len, (FILE *) pF) != len)
+                return false;
+            bGotPacket = true;
         }
         else
         {
@@ -249,91 +374,65 @@ CPacketSourceFile::readFF(vector<_BYTE>& vecbydata, int& interval)
             fseek((FILE*)pF, len, SEEK_CUR);
         }
     }
+    return bGotPacket;
 }
 
-int
-CPacketSourceFile::readRawAF(vector<_BYTE>& vecbydata, int& interval)
+bool
+CPacketSourceFile::readRawAF(vector<_BYTE>& vecbydata)
 {
-    char sync[2];
-    uint32_t bytes;
+    vecbydata.resize(iAFHeaderLen);
+    if (fread(&vecbydata[0], 1, iAFHeaderLen, (FILE *) pF) != iAFHeaderLen)
+        return false;
 
-    interval = 400;
+    if (vecbydata[0] != 'A' || vecbydata[1] != 'F')
+        return false;
 
-    size_t n = fread(sync, 2, 1, (FILE *) pF);
-    n = fread(&bytes, 4, 1, (FILE *) pF);
-    fseek((FILE*)pF, -6, SEEK_CUR);
-
-    if (sync[0] != 'A' || sync[1] != 'F')
-    {
-        // throw?
-        fclose((FILE *) pF);
-        pF = 0;
-        return 0;
-    }
     // get the length
-    size_t iAFPacketLen = iAFHeaderLen + ntohl(bytes) + iAFCRCLen;
+    const size_t iPayloadLen = (size_t(vecbydata[2]) << 24) | (size_t(vecbydata[3]) << 16)
+                               | (size_t(vecbydata[4]) << 8) | size_t(vecbydata[5]);
+    const size_t iAFPacketLen = iAFHeaderLen + iPayloadLen + iAFCRCLen;
 
     if (iAFPacketLen > iMaxPacketSize)
-    {
-        // throw?
-        fclose((FILE *) pF);
-        pF = 0;
-        return 0;
-    }
+        return false;
 
-    // initialise the output vector
     vecbydata.resize(iAFPacketLen);
-
-    n = fread(&vecbydata[0], 1, iAFPacketLen, (FILE *)pF);
-
-    last_packet_time += interval;
-
-    return n;
+    const size_t iRest = iAFPacketLen - iAFHeaderLen;
+    return fread(&vecbydata[iAFHeaderLen], 1, iRest, (FILE *) pF) == iRest;
 }
 
-// not robust against the sync characters appearing in the payload!!!!
-void
-CPacketSourceFile::readRawPFT(vector<_BYTE>& vecbydata, int& interval)
+/* The fragment length follows from the header, so sync characters in the
+   payload don't matter */
+bool
+CPacketSourceFile::readRawPFT(vector<_BYTE>& vecbydata)
 {
-    char sync[2];
-
-    interval = 400;
-
-    size_t n = fread(sync, 2, 1, (FILE *) pF);
-    if (sync[0] != 'P' || sync[1] != 'F')
-    {
-        // throw?
-        fclose((FILE *) pF);
-        pF = 0;
-        return;
-    }
-    vecbydata.resize(0);
-    vecbydata.push_back(sync[0]);
-    vecbydata.push_back(sync[1]);
-    char prev = '\0';;
-    while(true)
-    {
-        char c;
-        n = fread(&c, 1, 1, (FILE *) pF);
-        if(prev == 'P' && c == 'F')
-        {
-            fseek((FILE*)pF, -2, SEEK_CUR);
-            vecbydata.pop_back();
-            break;
-        }
-        prev = c;
-        vecbydata.push_back(c);
-    }
-
-    (void)n;
+    /* Sync, Pseq, Findex, Fcount, FEC/Addr/Plen */
+    const size_t iFixedLen = 12;
+    vecbydata.resize(iFixedLen);
+    if (fread(&vecbydata[0], 1, iFixedLen, (FILE *) pF) != iFixedLen)
+        return false;
+
+    if (vecbydata[0] != 'P' || vecbydata[1] != 'F')
+        return false;
+
+    const bool bFEC = (vecbydata[10] & 0x80) != 0;
+    const bool bAddr = (vecbydata[10] & 0x40) != 0;
+    const size_t iPlen = ((vecbydata[10] & 0x3f) << 8) | vecbydata[11];
+    const size_t iHeaderLen = iPFTMinHeaderLen + (bFEC ? 2 : 0) + (bAddr ? 4 : 0);
+    const size_t iFragmentLen = iHeaderLen + iPlen;
+
+    if (iFragmentLen > iMaxPacketSize)
+        return false;
+
+    vecbydata.resize(iFragmentLen);
+    const size_t iRest = iFragmentLen - iFixedLen;
+    return fread(&vecbydata[iFixedLen], 1, iRest, (FILE *) pF) == iRest;
 }
 
-void
-CPacketSourceFile::readPcap(vector<_BYTE>& vecbydata, int& interval)
+bool
+CPacketSourceFile::readPcap(vector<_BYTE>& vecbydata, int64_t& time)
 {
     int link_len = 0;
     const _BYTE* pkt_data = nullptr;
-    timeval packet_time = { 0, 0 };
     while(true)
     {
 #ifdef HAVE_LIBPCAP
@@ -342,11 +441,7 @@ CPacketSourceFile::readPcap(vector<_BYTE>& vecbydata, int& interval)
         const u_char* data;
         /* Retrieve the packet from the file */
         if((res = pcap_next_ex( (pcap_t*)pF, &header, &data)) != 1)
-        {
-            pcap_close((pcap_t*)pF);
-            pF = nullptr;
-            return;
-        }
+            return false;
         int lt = pcap_datalink((pcap_t*)pF);
         pkt_data = (_BYTE*)data;
         /* 14 bytes ethernet header */
@@ -366,12 +461,13 @@ CPacketSourceFile::readPcap(vector<_BYTE>& vecbydata, int& interval)
         {
             link_len=0;
         }
-        //packet_time = header->ts; try this for BSD
-		packet_time.tv_sec = header->ts.tv_sec;
-		packet_time.tv_usec = header->ts.tv_usec;
+        /* capture time, as recorded */
+        time = int64_t(header->ts.tv_sec)*1000000 + int64_t(header->ts.tv_usec);
+#else
+        (void)time;
 #endif
         if(pkt_data == nullptr)
-            return;
+            return false;
 
         /* 4n bytes IP header, 8 bytes UDP header */
         uint8_t proto = pkt_data[link_len+9];
@@ -383,21 +479,10 @@ CPacketSourceFile::readPcap(vector<_BYTE>& vecbydata, int& interval)
             if((wanted_dest_port==-1) || (dest_port == wanted_dest_port)) // wanted port
             {
                 int data_len = ip_packet_len - udp_ip_hdr_len;
-                vecbydata.resize (data_len);
-                for(int i=0; i<data_len; i++)
-                    vecbydata[i] = pkt_data[link_len+udp_ip_hdr_len+i];
-                break;
+                vecbydata.assign(pkt_data+link_len+udp_ip_hdr_len,
+                                 pkt_data+link_len+udp_ip_hdr_len+data_len);
+                return true;
             }
         }
     }
-    if(last_packet_time == 0)
-    {
-        last_packet_time = 1000*uint64_t(packet_time.tv_sec);
-        last_packet_time += uint64_t(packet_time.tv_usec)/1000;
-    }
-    uint64_t pt;
-    pt = 1000*uint64_t(packet_time.tv_sec);
-    pt += uint64_t(packet_time.tv_usec)/1000;
-    interval = pt - last_packet_time;
-    last_packet_time = pt;
 }
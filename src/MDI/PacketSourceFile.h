@@ -33,12 +33,14 @@
 #include "../util/Vector.h"
 #include "../util/Buffer.h"
 #include "PacketInOut.h"
-
-class CPacer;
+#include <chrono>
 
 class CPacketSourceFile : public CPacketSource
 {
 public:
+	/* How recorded frames are paced on replay */
+	enum EReplayMode {RP_RECORDED, RP_SCALED, RP_MAX_SPEED};
+
 	CPacketSourceFile();
 	~CPacketSourceFile();
 	// Set the sink which will receive the packets
@@ -47,23 +49,50 @@ public:
 	void ResetPacketSink(void);
 	bool SetOrigin(const std::string& str);
 	bool GetOrigin(std::string& str) { (void)str; return false; }
+	// Deliver the next frame (an AF packet or all PFT fragments of it)
 	void poll();
 
+	/* "recorded" (default), "max" or a speed factor like "10" */
+	bool SetReplay(const std::string& strReplay);
+	void SetReplay(EReplayMode eNewMode, _REAL rNewSpeed = 1.0);
+	EReplayMode GetReplayMode() const { return eReplayMode; }
+	// True once the last frame of the file was delivered
+	bool Finished() const { return pF == nullptr && !bHaveNext; }
+
 private:
+	typedef std::chrono::steady_clock clock;
+
+	bool readPacket(std::vector<_BYTE>& vecbydata, int64_t& time);
+	bool readRawAF(std::vector<_BYTE>& vecbydata);
+	bool readRawPFT(std::vector<_BYTE>& vecbydata);
+	bool readFF(std::vector<_BYTE>& vecbydata, int64_t& time, bool& bTimed);
+	bool readPcap(std::vector<_BYTE>& vecbydata, int64_t& time);
+	bool readTagPacketHeader(std::string& tag, uint32_t& len);
+	int64_t nominalTime(const std::vector<_BYTE>& vecbydata);
+	void waitUntilDue(int64_t time);
+	void closeFile();
+
+	CPacketSink		*pPacketSink;
+	void*			pF;
+	int 			wanted_dest_port;
+	enum {pcap,ff,af,pf}	eFileType;
+
+	EReplayMode		eReplayMode;
+	_REAL			rSpeed;
 
-    int readRawAF(std::vector<_BYTE>& vecbydata, int& interval);
-    void readRawPFT(std::vector<_BYTE>& vecbydata, int& interval);
-    void readFF(std::vector<_BYTE>& vecbydata, int& interval);
+	/* One packet look ahead, to find the end of a PFT fragment sequence */
+	std::vector<_BYTE>	vecbyNext;
+	int64_t			iNextTime; /* microseconds, recorded timeline */
+	bool			bHaveNext;
 
-    void readPcap(std::vector<_BYTE>& vecbydata, int& interval);
-    void readTagPacketHeader(std::string& tag, uint32_t& len);
+	/* Timeline of files without timestamps, 400 ms per frame */
+	int64_t			iNominalTime;
+	int			iLastPseq;
 
-    CPacketSink		*pPacketSink;
-    uint64_t		last_packet_time;
-    CPacer*		pacer;
-    void*		pF;
-    int 		wanted_dest_port;
-    enum {pcap,ff,af,pf}    eFileType;
+	/* Wall clock time the last frame was due and its recorded time */
+	clock::time_point	tLastDue;
+	int64_t			iLastTime;
+	bool			bStarted;
 };
 
 #endif
@@ -9,8 +9,11 @@
  *	Implements the PFT (Protection, Fragmentation and Transport) layer of the
  *	Communications Protocol (DCP) as described in ETSI TS 102 821.
  *
- *  TODO: support RS FEC and any other missing features
- *  In this version, only in-order delivery is supported.
+ *	Fragments may arrive in any order and are reassembled per packet
+ *	sequence number, keeping up to PFT_MAX_PENDING packets open at a time.
+ *	With RS FEC the missing fragments of a packet are recovered as
+ *	erasures as soon as enough of them have arrived. Packets are made with
+ *	or without RS FEC.
  *
  ******************************************************************************
  *
@@ -36,10 +39,35 @@
 
 using namespace std;
 
+/* The code of ETSI TS 102 821 section 7.2.2 */
+static const CReedSolomon& PftRS()
+{
+	static const CReedSolomon RS(PFT_RS_PARITY, 1);
+	return RS;
+}
+
+/* Drop the packet which is furthest behind the current sequence number, so
+   packets which never complete don't pile up */
+template<class T>
+static void ForgetOldest(map<int, T>& mapPackets, int iSeq)
+{
+	if (mapPackets.size() <= PFT_MAX_PENDING)
+		return;
+	typename map<int, T>::iterator oldest = mapPackets.begin();
+	for (typename map<int, T>::iterator it = mapPackets.begin(); it != mapPackets.end(); ++it)
+	{
+		if (((iSeq - it->first) & 0xFFFF) > ((iSeq - oldest->first) & 0xFFFF))
+			oldest = it;
+	}
+	mapPackets.erase(oldest);
+}
+
 CPft::CPft(int isrc, int idst):
 iSource(isrc),
 iDest(idst),
-mapFragments()
+mapFragments(), mapFecPackets(), deqDone(),
+iHeaderLen(0), iPseq(0), iFindex(0), iFcount(0), iFEC(0), iAddr(0),
+iPlen(0), iRSk(0), iRSz(0)
 {
 }
 
@@ -49,7 +77,7 @@ bool CPft::DecodePFTPacket(const vector < _BYTE > &vecIn,
 	/* SYNC: two-byte ASCII representation of "PF" (2 bytes) */
 
 	/* Check if string is correct */
-	if ((vecIn[0] != 'P') && (vecIn[1] != 'F'))
+	if ((vecIn.size() < 14) || (vecIn[0] != 'P') || (vecIn[1] != 'F'))
 	{
 		cerr << "PF not found" << endl;
 		return false;
@@ -67,13 +95,14 @@ bool CPft::DecodePFTPacket(const vector < _BYTE > &vecIn,
 	iAddr = (n & 0x4000) ? 1 : 0;
 	iPlen = n & 0x3FFF;
 
-//	int iRSk, iRSz;
 	if (iFEC == 1)
 	{
-//		iRSk = (int) vecIn[12];
-//		iRSz = (int) vecIn[13];
+		iRSk = (int) vecIn[12];
+		iRSz = (int) vecIn[13];
 		iHeaderLen += 2;
 	}
+	if (vecIn.size() < size_t(iHeaderLen + (iAddr ? 4 : 0)))
+		return false;
 
 	int iPktSource = 0, iPktDest = 0;
 	if (iAddr == 1)
@@ -90,10 +119,7 @@ bool CPft::DecodePFTPacket(const vector < _BYTE > &vecIn,
 	/* CRC check ------------------------------------------------------------ */
 	CCRC CRCObject;
 	CRCObject.Reset(16);
-
-	int i;
-	for (i = 0; i < iHeaderLen - 2; i++)
-		CRCObject.AddByte(vecIn[i]);
+	CRCObject.AddBytes(&vecIn[0], size_t(iHeaderLen - 2));
 	const bool
 		bCRCOk = CRCObject.CheckCRC(iHCRC);
 	if (!bCRCOk)
@@ -131,45 +157,224 @@ bool CPft::DecodeSimplePFTPacket(const vector < _BYTE > &vecIn,
 	if (mapFragments[iPseq].Ready())
 	{
 		vecOut = mapFragments[iPseq].vecData;
+		mapFragments.erase(iPseq);
 		return true;
 	}
+	ForgetOldest(mapFragments, iPseq);
+
+	return false;
+}
 
+bool CPft::IsDone(int iSeq) const
+{
+	for (size_t i = 0; i < deqDone.size(); i++)
+		if (deqDone[i] == iSeq)
+			return true;
 	return false;
 }
 
-bool CPft::DecodePFTPacketWithFEC(const vector < _BYTE > &,
-								  vector < _BYTE > &)
+void CPft::SetDone(int iSeq)
+{
+	deqDone.push_back(iSeq);
+	if (deqDone.size() > PFT_MAX_PENDING)
+		deqDone.pop_front();
+}
+
+/* The fragments carry the RS block interleaved: byte j of fragment i is byte
+   j * Fcount + i of the block. The block holds the c chunks of RSk data bytes
+   (the last one padded with RSz zeros) followed by the 48 parity bytes of
+   each chunk. The packet is decoded as soon as the missing fragments can be
+   treated as erasures, the remaining fragments are ignored */
+bool CPft::DecodePFTPacketWithFEC(const vector < _BYTE > &vecIn,
+								  vector < _BYTE > &vecOut)
 {
-	cerr << "sorry, PFT/FEC not implemented yet" << endl;
+	if ((iFcount <= 0) || (iFindex >= iFcount) || (iRSk == 0) || (iRSk > PFT_RS_K))
+		return false;
+	if (IsDone(iPseq))
+		return false;
+
+	CFecPacket& Packet = mapFecPackets[iPseq];
+	if (Packet.iFcount == 0)
+	{
+		Packet.iFcount = iFcount;
+		Packet.iPlen = iPlen;
+		Packet.iRSk = iRSk;
+		Packet.iRSz = iRSz;
+		Packet.vecbyBlock.assign(size_t(iFcount) * size_t(iPlen), 0);
+		Packet.vecbHave.assign(size_t(iFcount), false);
+	}
+	else if ((Packet.iFcount != iFcount) || (Packet.iPlen != iPlen))
+	{
+		/* all fragments of a packet have the same size */
+		return false;
+	}
+
+	if (Packet.vecbHave[iFindex])
+		return false;
+	Packet.vecbHave[iFindex] = true;
+	Packet.iReceived++;
+
+	const size_t iLen = min(vecIn.size(), size_t(iPlen));
+	for (size_t j = 0; j < iLen; j++)
+		Packet.vecbyBlock[j * size_t(iFcount) + size_t(iFindex)] = vecIn[j];
+
+	if (DecodeFecBlock(Packet, vecOut))
+	{
+		mapFecPackets.erase(iPseq);
+		SetDone(iPseq);
+		return true;
+	}
+	ForgetOldest(mapFecPackets, iPseq);
 	return false;
 }
 
+bool CPft::DecodeFecBlock(const CFecPacket& Packet, vector < _BYTE > &vecOut) const
+{
+	const CReedSolomon& RS = PftRS();
+	const int f = Packet.iFcount;
+	const int k = Packet.iRSk;
+	const int n = k + PFT_RS_PARITY;
+
+	/* Number of chunks, the rest of the last fragments is padding */
+	const int c = int(Packet.vecbyBlock.size() / size_t(n));
+	const int l = c * k - Packet.iRSz;
+	if ((c == 0) || (l <= 0))
+		return false;
+
+	/* Check that no chunk has more erasures than can be filled in, before
+	   doing any decoding */
+	vector<int> veciErasures(size_t(c), 0);
+	if (Packet.iReceived < f)
+	{
+		for (int b = 0; b < c; b++)
+		{
+			for (int i = 0; i < n; i++)
+			{
+				const int ix = (i < k) ? b * k + i : c * k + b * PFT_RS_PARITY + (i - k);
+				if (!Packet.vecbHave[ix % f])
+					veciErasures[b]++;
+			}
+			if (veciErasures[b] > PFT_RS_PARITY)
+				return false;
+		}
+	}
+
+	vecOut.resize(size_t(c * k));
+	_BYTE byCodeWord[RS_BLOCK_LEN];
+	int iErasPos[PFT_RS_PARITY];
+	const int iPad = PFT_RS_K - k;
+	for (int b = 0; b < c; b++)
+	{
+		/* Shorter chunks are padded with zeros at the end of the data */
+		int iNumEras = 0;
+		for (int i = 0; i < n; i++)
+		{
+			const int ix = (i < k) ? b * k + i : c * k + b * PFT_RS_PARITY + (i - k);
+			const int iPos = (i < k) ? i : i + iPad;
+			byCodeWord[iPos] = Packet.vecbyBlock[ix];
+			if ((veciErasures[b] > 0) && !Packet.vecbHave[ix % f])
+				iErasPos[iNumEras++] = iPos;
+		}
+		for (int i = k; i < PFT_RS_K; i++)
+			byCodeWord[i] = 0;
+
+		if (RS.Decode(byCodeWord, iErasPos, iNumEras) < 0)
+		{
+			/* more fragments may still come */
+			if (Packet.iReceived == f)
+				cerr << "PFT: uncorrectable RS chunk" << endl;
+			return false;
+		}
+		for (int i = 0; i < k; i++)
+			vecOut[size_t(b * k + i)] = byCodeWord[i];
+	}
+	vecOut.resize(size_t(l));
+
+	/* If the parity was used up for erasures, a corrupted fragment goes
+	   unnoticed by the RS code. The AF CRC tells, then wait for more */
+	if ((l > 10) && (vecOut[0] == 'A') && (vecOut[1] == 'F') && (vecOut[8] & 0x80))
+	{
+		CCRC CRCObject;
+		if (!CRCObject.CheckBlock(16, &vecOut[0], vecOut.size()))
+			return false;
+	}
+	return true;
+}
+
 void
 CPft::MakePFTPackets(const vector < _BYTE > &vecbydata, vector < vector < _BYTE > >&packets,
-	uint16_t sequence_counter, size_t fragment_size)
+	uint16_t sequence_counter, size_t fragment_size, int iFecFragments)
 {
 	uint32_t num_packets, data_size = vecbydata.size();
 	size_t header_bytesize, payload_bytesize;
-	header_bytesize = 14;		// no addressing or FEC
-	if ((fragment_size > 0) && (fragment_size < (data_size + header_bytesize)))
+	const bool bFec = (iFecFragments > 0) && (data_size > 0);
+	int rs_k = 0, rs_z = 0;
+
+	/* With FEC the fragments are cut from the interleaved RS block instead of
+	   the AF packet itself (ETSI TS 102 821 section 7.2.2) */
+	vector<_BYTE> rs_block;
+	const vector<_BYTE>* pSource = &vecbydata;
+	if (bFec)
 	{
-		payload_bytesize = fragment_size - header_bytesize;
-		num_packets = data_size / payload_bytesize;
-		if (num_packets * payload_bytesize < data_size)
-			num_packets++;
-		payload_bytesize = data_size / num_packets;
-		if (num_packets * payload_bytesize < data_size)
-			payload_bytesize++;
+		const CReedSolomon& RS = PftRS();
+		rs_k = PFT_RS_K;
+		const size_t c = (data_size + rs_k - 1) / rs_k;
+		rs_z = int(c * rs_k - data_size);
+		rs_block.assign(c * (rs_k + PFT_RS_PARITY), 0);
+		copy(vecbydata.begin(), vecbydata.end(), rs_block.begin());
+		for (size_t b = 0; b < c; b++)
+			RS.Encode(&rs_block[b * rs_k], &rs_block[c * rs_k + b * PFT_RS_PARITY]);
+
+		header_bytesize = 16;
+		const size_t total = rs_block.size();
+		size_t max_payload = max(size_t(1), c * PFT_RS_PARITY / size_t(iFecFragments + 1));
+		if ((fragment_size > header_bytesize) && (fragment_size - header_bytesize < max_payload))
+			max_payload = fragment_size - header_bytesize;
+		/* Less fragments than bytes per chunk, so the padding is shorter
+		   than a chunk and the receiver can tell the number of chunks */
+		max_payload = max(max_payload, c);
+		num_packets = uint32_t((total + max_payload - 1) / max_payload);
+		payload_bytesize = (total + num_packets - 1) / num_packets;
+
+		/* Interleave */
+		vector<_BYTE> interleaved(num_packets * payload_bytesize, 0);
+		for (uint32_t i = 0; i < num_packets; i++)
+			for (size_t j = 0; j < payload_bytesize; j++)
+			{
+				const size_t ix = j * num_packets + i;
+				if (ix < total)
+					interleaved[i * payload_bytesize + j] = rs_block[ix];
+			}
+		rs_block.swap(interleaved);
+		pSource = &rs_block;
+		data_size = uint32_t(rs_block.size());
 	}
 	else
 	{
-		num_packets = 1;
-		payload_bytesize = data_size;
+		header_bytesize = 14;		// no addressing or FEC
+		if ((fragment_size > 0) && (fragment_size < (data_size + header_bytesize)))
+		{
+			payload_bytesize = fragment_size - header_bytesize;
+			num_packets = data_size / payload_bytesize;
+			if (num_packets * payload_bytesize < data_size)
+				num_packets++;
+			payload_bytesize = data_size / num_packets;
+			if (num_packets * payload_bytesize < data_size)
+				payload_bytesize++;
+		}
+		else
+		{
+			num_packets = 1;
+			payload_bytesize = data_size;
+		}
 	}
 	size_t bytes_remaining = data_size;
-	packets.clear();
+	/* Keep the fragment buffers of the previous packet, they are usually
+	   the same size again */
 	packets.resize(num_packets);
-	vector<_BYTE>::const_iterator p = vecbydata.begin();
+	for (uint32_t n = 0; n < num_packets; n++)
+		packets[n].clear();
+	vector<_BYTE>::const_iterator p = pSource->begin();
 	for (uint32_t n = 0; n < num_packets; n++)
 	{
 		if (bytes_remaining < payload_bytesize)
@@ -179,6 +384,7 @@ CPft::MakePFTPackets(const vector < _BYTE > &vecbydata, vector < vector < _BYTE
 		CRCObject.Reset(16);
 
 		// write PFT Packet Header
+		packets[n].reserve(header_bytesize + payload_bytesize);
 		uint8_t c;
 		c='P'; CRCObject.AddByte(c); packets[n].push_back(c);
 		c='F'; CRCObject.AddByte(c); packets[n].push_back(c);
@@ -190,8 +396,13 @@ CPft::MakePFTPackets(const vector < _BYTE > &vecbydata, vector < vector < _BYTE
 		c=num_packets >> 16; CRCObject.AddByte(c); packets[n].push_back(c);
 		c=(num_packets >> 8) & 0xff; CRCObject.AddByte(c); packets[n].push_back(c);
 		c=num_packets & 0xff; CRCObject.AddByte(c); packets[n].push_back(c);
-		c=payload_bytesize >> 8; CRCObject.AddByte(c); packets[n].push_back(c);
+		c=((payload_bytesize >> 8) & 0x3f) | (bFec ? 0x80 : 0); CRCObject.AddByte(c); packets[n].push_back(c);
 		c=payload_bytesize & 0xff; CRCObject.AddByte(c); packets[n].push_back(c);
+		if (bFec)
+		{
+			c=uint8_t(rs_k); CRCObject.AddByte(c); packets[n].push_back(c);
+			c=uint8_t(rs_z); CRCObject.AddByte(c); packets[n].push_back(c);
+		}
 		// CRC
 		uint16_t crc_val = uint16_t(CRCObject.GetCRC());
 		c=crc_val >> 8; CRCObject.AddByte(c); packets[n].push_back(c);
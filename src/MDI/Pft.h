@@ -30,7 +30,18 @@
 #define PFT_H_INCLUDED
 
 #include "../util/Reassemble.h"
+#include "../util/ReedSolomon.h"
 #include <map>
+#include <deque>
+
+/* Parity bytes per Reed-Solomon chunk, RS(255,207) */
+#define PFT_RS_PARITY				48
+
+/* Data bytes per chunk used when sending */
+#define PFT_RS_K					207
+
+/* AF packets which are reassembled at the same time */
+#define PFT_MAX_PENDING				8
 
 class CPft
 {
@@ -38,17 +49,39 @@ public:
 	CPft(int isrc=-1, int idst=-1);
 
 	bool DecodePFTPacket(const std::vector<_BYTE>& vecIn, std::vector<_BYTE>& vecOut);
+
+	/* iFecFragments > 0 adds Reed-Solomon protection, so that any
+	   iFecFragments of the fragments of a packet can be lost */
 	static void MakePFTPackets(const std::vector < _BYTE > &vecbydata,
 					 std::vector < std::vector < _BYTE > >&packets, 
-					uint16_t sequence_counter, size_t fragment_size);
+					uint16_t sequence_counter, size_t fragment_size,
+					int iFecFragments = 0);
 
 protected:
 
+	/* Fragments of a FEC protected AF packet, in the interleaved order */
+	struct CFecPacket
+	{
+		CFecPacket() : iFcount(0), iPlen(0), iRSk(0), iRSz(0), iReceived(0) {}
+		int					iFcount;
+		int					iPlen;
+		int					iRSk;
+		int					iRSz;
+		int					iReceived;
+		std::vector<_BYTE>	vecbyBlock;
+		std::vector<bool>	vecbHave;
+	};
+
 	bool DecodeSimplePFTPacket(const std::vector<_BYTE>& vecIn, std::vector<_BYTE>& vecOut);
 	bool DecodePFTPacketWithFEC(const std::vector<_BYTE>& vecIn, std::vector<_BYTE>& vecOut);
+	bool DecodeFecBlock(const CFecPacket& Packet, std::vector<_BYTE>& vecOut) const;
+	bool IsDone(int iSeq) const;
+	void SetDone(int iSeq);
 
 	int iSource, iDest;
     std::map<int,CReassemblerN> mapFragments;
+	std::map<int,CFecPacket> mapFecPackets;
+	std::deque<int> deqDone; /* recently completed, late fragments are ignored */
 	int iHeaderLen;
 	int iPseq;
 	int iFindex;
@@ -56,6 +89,8 @@ protected:
 	int iFEC;
 	int iAddr;
 	int iPlen;
+	int iRSk;
+	int iRSz;
 };
 
 #endif
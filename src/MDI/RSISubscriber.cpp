@@ -35,10 +35,42 @@
 #include "../DrmReceiver.h"
 #include "TagPacketGenerator.h"
 
+/* Lost fragments per packet which can be recovered with 'f' destinations */
+#define PFT_FEC_FRAGMENTS			2
+
+
+bool CRSIFraming::operator<(const CRSIFraming& f) const
+{
+	if (cProfile != f.cProfile)
+		return cProfile < f.cProfile;
+	if (bUseAFCRC != f.bUseAFCRC)
+		return bUseAFCRC < f.bUseAFCRC;
+	if (iFragmentSize != f.iFragmentSize)
+		return iFragmentSize < f.iFragmentSize;
+	return iPftFec < f.iPftFec;
+}
+
+void CRSIFramer::Frame(CTagPacketGenerator& Generator, const CRSIFraming& Framing)
+{
+	Generator.SetProfile(Framing.cProfile);
+	if (Framing.iFragmentSize > 0)
+	{
+		AFPacketGenerator.GenAFPacket(Framing.bUseAFCRC, Generator, vecbyAF);
+		CPft::MakePFTPackets(vecbyAF, vecPackets, sequence_counter,
+			Framing.iFragmentSize, Framing.iPftFec);
+		sequence_counter++;
+	}
+	else
+	{
+		/* The AF packet is the only packet */
+		vecPackets.resize(1);
+		AFPacketGenerator.GenAFPacket(Framing.bUseAFCRC, Generator, vecPackets[0]);
+	}
+}
 
 CRSISubscriber::CRSISubscriber(CPacketSink *pSink) : pPacketSink(pSink),
-	cProfile(0), bNeedPft(false), fragment_size(0), pDRMReceiver(0),
-	bUseAFCRC(true), sequence_counter(0)
+	cProfile(0), bNeedPft(false), fragment_size(0), iPftFec(0), pDRMReceiver(0),
+	Framer(), bUseAFCRC(true)
 {
 	TagPacketDecoderRSCIControl.SetSubscriber(this);
 }
@@ -69,21 +101,32 @@ void CRSISubscriber::TransmitPacket(CTagPacketGenerator& Generator)
 {
     if (pPacketSink != nullptr)
 	{
-	 	Generator.SetProfile(cProfile);
-		vector<_BYTE> packet = AFPacketGenerator.GenAFPacket(bUseAFCRC, Generator);
-		if(bNeedPft)
-		{
-			vector< vector<_BYTE> > packets;
-			CPft::MakePFTPackets(packet, packets, sequence_counter, fragment_size);
-			sequence_counter++;
-			for(size_t i=0; i<packets.size(); i++)
-				pPacketSink->SendPacket(packets[i]);
-		}
-		else
-			pPacketSink->SendPacket(packet);
+		Framer.Frame(Generator, GetFraming());
+		SendFramed(Framer.GetPackets());
 	}
 }
 
+CRSIFraming CRSISubscriber::GetFraming() const
+{
+	CRSIFraming f;
+	f.cProfile = cProfile;
+	f.bUseAFCRC = bUseAFCRC;
+	if (bNeedPft)
+	{
+		f.iFragmentSize = fragment_size;
+		f.iPftFec = iPftFec;
+	}
+	return f;
+}
+
+void CRSISubscriber::SendFramed(const vector< vector<_BYTE> >& packets)
+{
+	if (pPacketSink == nullptr)
+		return;
+	for(size_t i=0; i<packets.size(); i++)
+		pPacketSink->SendPacket(packets[i]);
+}
+
 
 /* implementation of function from CPacketSink interface - process incoming RCI commands */
 void CRSISubscriber::SendPacket(const vector<_BYTE>& vecbydata, uint32_t, uint16_t)
@@ -123,6 +166,13 @@ bool CRSISubscriberSocket::SetDestination(const string& dest)
 		SetPFTFragmentSize(800);
 		d.erase(0, 1);
 	}
+	else if(d[0] == 'F' || d[0] == 'f')
+	{
+		/* PFT with Reed-Solomon FEC */
+		SetPFTFragmentSize(800);
+		SetPFTFec(PFT_FEC_FRAGMENTS);
+		d.erase(0, 1);
+	}
 	bool bOk = pSocket->SetDestination(d);
 	if(bOk)
 		pSocket->SetPacketSink(this);
@@ -164,6 +214,13 @@ bool CRSISubscriberSocket::GetOrigin(string& str)
 	return pSocket->GetOrigin(str);
 }
 
+bool CRSISubscriberSocket::GetFanOutDestination(uint32_t& addr, uint16_t& port) const
+{
+	if(pSocket==nullptr)
+		return false;
+	return pSocket->GetFanOutDestination(addr, port);
+}
+
 /* poll for incoming packets */
 void CRSISubscriberSocket::poll()
 {
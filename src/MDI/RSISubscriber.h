@@ -37,9 +37,42 @@
 #include "AFPacketGenerator.h"
 
 class CPacketSink;
+class CPacketSocketNative;
 class CDRMReceiver;
 class CTagPacketGenerator;
 
+/* Everything the AF/PFT framing of a packet depends on. Subscribers with the
+   same framing can be sent the very same packets */
+struct CRSIFraming
+{
+	CRSIFraming() : cProfile(0), bUseAFCRC(true), iFragmentSize(0), iPftFec(0) {}
+
+	bool operator<(const CRSIFraming& f) const;
+
+	char	cProfile;
+	bool	bUseAFCRC;
+	size_t	iFragmentSize; /* 0: no PFT */
+	int		iPftFec;
+};
+
+/* Turns a tag packet into AF packets, PFT fragmented if required, and keeps
+   the sequence counters of one stream of packets */
+class CRSIFramer
+{
+public:
+	CRSIFramer() : AFPacketGenerator(), sequence_counter(0), vecbyAF(), vecPackets() {}
+
+	void Frame(CTagPacketGenerator& Generator, const CRSIFraming& Framing);
+	const std::vector< std::vector<_BYTE> >& GetPackets() const {return vecPackets;}
+
+private:
+	CAFPacketGenerator AFPacketGenerator;
+	uint16_t sequence_counter;
+	/* All buffers are kept from frame to frame */
+	std::vector<_BYTE> vecbyAF;
+	std::vector< std::vector<_BYTE> > vecPackets;
+};
+
 class CRSISubscriber : public CPacketSocket
 {
 public:
@@ -56,10 +89,23 @@ public:
 	char GetProfile(void) const {return cProfile;}
 
 	void SetPFTFragmentSize(const int iFrag=-1);
+	/* Number of lost PFT fragments per packet the receiver can recover */
+	void SetPFTFec(const int iFragments) {iPftFec = iFragments;}
 
 	/* Generate and send a packet */
 	void TransmitPacket(CTagPacketGenerator& Generator);
 
+	/* Framing of the packets for this subscriber, for sharing them with others */
+	CRSIFraming GetFraming() const;
+	/* Send packets which were framed for GetFraming() */
+	void SendFramed(const std::vector< std::vector<_BYTE> >& packets);
+	/* false if there is nowhere to send packets to at the moment */
+	bool IsActive() const {return pPacketSink != nullptr;}
+	/* Plain UDP destination (network byte order) which can be served from a
+	   shared socket. false if packets must go through this subscriber */
+	virtual bool GetFanOutDestination(uint32_t& addr, uint16_t& port) const
+		{ (void)addr; (void)port; return false; }
+
 	void SetAFPktCRC(const bool bNAFPktCRC) {bUseAFCRC = bNAFPktCRC;}
 
 
@@ -74,13 +120,13 @@ protected:
 	char cProfile;
 	bool bNeedPft;
     size_t fragment_size;
+	int iPftFec;
 	CTagPacketDecoderRSCIControl TagPacketDecoderRSCIControl;
 private:
 	CDRMReceiver *pDRMReceiver;
-	CAFPacketGenerator AFPacketGenerator;
+	CRSIFramer Framer;
 
 	bool bUseAFCRC;
-	uint16_t sequence_counter;
 };
 
 
@@ -98,8 +144,10 @@ public:
 	void ResetPacketSink() {}
 	void poll();
 
+	bool GetFanOutDestination(uint32_t& addr, uint16_t& port) const;
+
 private:
-	CPacketSocket* pSocket;
+	CPacketSocketNative* pSocket;
 	std::string strDestination;
 };
 
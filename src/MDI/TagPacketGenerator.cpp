@@ -49,12 +49,13 @@ CTagPacketGenerator::CTagPacketGenerator() : vecTagItemGenerators(0)
 {
 }
 
-void CTagPacketGenerator::PutTagPacketData(CVector<_BINARY> &vecbiDestination)
+_BYTE* CTagPacketGenerator::PutTagPacketData(_BYTE* pbyDest)
 {
 	for (size_t i=0; i<vecTagItemGenerators.size(); i++)
 	{
-		vecTagItemGenerators[i]->PutTagItemData(vecbiDestination);
+		pbyDest = vecTagItemGenerators[i]->PutTagItemData(pbyDest);
 	}
+	return pbyDest;
 }
 
 int CTagPacketGenerator::GetTagPacketLength()
@@ -86,13 +87,14 @@ void CTagPacketGeneratorWithProfiles::SetProfile(char cProf)
 }
 
 
-void CTagPacketGeneratorWithProfiles::PutTagPacketData(CVector<_BINARY> &vecbiDestination)
+_BYTE* CTagPacketGeneratorWithProfiles::PutTagPacketData(_BYTE* pbyDest)
 {
 	for (size_t i=0; i<vecTagItemGenerators.size(); i++)
 	{
 		if (vecTagItemGenerators[i]->IsInProfile(cProfile))
-			vecTagItemGenerators[i]->PutTagItemData(vecbiDestination);
+			pbyDest = vecTagItemGenerators[i]->PutTagItemData(pbyDest);
 	}
+	return pbyDest;
 }
 
 int CTagPacketGeneratorWithProfiles::GetTagPacketLength()
@@ -46,7 +46,7 @@ public:
 	virtual ~CTagPacketGenerator(){}
 	void Reset() {vecTagItemGenerators.clear();}
 	void AddTagItem(CTagItemGenerator *pGenerator);
-	virtual void PutTagPacketData(CVector<_BINARY> &vecbiDestination); // Call this to write the tag packet (i.e. all the tag items) to the std::vector
+	virtual _BYTE* PutTagPacketData(_BYTE* pbyDest); // Call this to write the tag packet (i.e. all the tag items) to GetTagPacketLength() bytes at pbyDest
 	virtual int GetTagPacketLength();
 	virtual void SetProfile(const char /*cProfile*/) {}
 protected:
@@ -60,7 +60,7 @@ public:
 	CTagPacketGeneratorWithProfiles(const char cProfile = '\0');
 	virtual ~CTagPacketGeneratorWithProfiles(){}
 	/* The following functions are overridden to check the profile for each tag item */
-	virtual void PutTagPacketData(CVector<_BINARY> &vecbiDestination); // Call this to write the tag packet (i.e. all the tag items) to the std::vector
+	virtual _BYTE* PutTagPacketData(_BYTE* pbyDest); // Call this to write the tag packet (i.e. all the tag items) to GetTagPacketLength() bytes at pbyDest
 	virtual int GetTagPacketLength(void);
 	virtual void SetProfile(const char cProfile);
 private:
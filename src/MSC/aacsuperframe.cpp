@@ -1,4 +1,5 @@
 #include "aacsuperframe.h"
+#include <stdexcept>
 
 AACSuperFrame::AACSuperFrame():AudioSuperFrame (),
     lengthPartA(0), lengthPartB(0), superFrameDurationMilliseconds(0), headerBytes(0), aacCRC()
@@ -76,7 +77,7 @@ void AACSuperFrame::dump()
     cerr << " sum=" << sumOfFrameLengths << "(" << audioPayloadLength << ")" << endl;
 }
 
-bool AACSuperFrame::header(CVectorEx<_BINARY>& header)
+bool AACSuperFrame::header(CBitStream& header)
 {
     bool ok = true;
     unsigned numFrames = audioFrame.size();
@@ -131,7 +132,7 @@ bool AACSuperFrame::header(CVectorEx<_BINARY>& header)
     return false;
 }
 
-bool AACSuperFrame::parse(CVectorEx<_BINARY>& asf)
+bool AACSuperFrame::parse(CBitStream& asf)
 {
     unsigned numFrames = audioFrame.size();
     if (numFrames == 0 || !header(asf)) return false;
@@ -148,11 +149,12 @@ bool AACSuperFrame::parse(CVectorEx<_BINARY>& asf)
     try {
 
         protectedPart = HPP;
+        b = 0;
         for (f=0; f < numFrames; f++) {
-            for (b = 0; b < higherProtectedBytes; b++) {
-                audioFrame[f].at(b) = asf.Separate(8);
-            }
-            aacCRC[f] = asf.Separate(8);    // NB: for EEP all CRC is located together after the header (higherProtectedBytes = 0)
+            if (audioFrame[f].size() < higherProtectedBytes)
+                throw std::out_of_range("higher protected part exceeds audio frame");
+            asf.SeparateBytes(audioFrame[f].data(), int(higherProtectedBytes));
+            aacCRC[f] = uint8_t(asf.Separate(8));    // NB: for EEP all CRC is located together after the header (higherProtectedBytes = 0)
         }
 
         // lower protected part
@@ -160,15 +162,13 @@ bool AACSuperFrame::parse(CVectorEx<_BINARY>& asf)
         for (f=0; f < numFrames; f++) {
             lowerProtectedBytes = audioFrame[f].size() - higherProtectedBytes;
             //cerr << "frame " << f << " of " << numFrames << " size " << audioFrame[f].size() << " lower " << lowerProtectedBytes << endl;
-            for (b = 0; b < lowerProtectedBytes; b++) {
-                audioFrame[f].at(higherProtectedBytes+b) = asf.Separate(8);
-            }
+            asf.SeparateBytes(audioFrame[f].data() + higherProtectedBytes, int(lowerProtectedBytes));
         }
 
     } catch(std::exception& e) {
         cerr << "DRM AAC parse EXCEPTION " << ((protectedPart == HPP)? "HPP" : "LPP")
              << " " << e.what() << endl;
-        cerr << "DRM AAC f=" << f << " b=" << b << " asf=" << asf.size()
+        cerr << "DRM AAC f=" << f << " b=" << b << " asf=" << asf.Size()
              << " higherProtectedBytes=" << higherProtectedBytes
              << " lowerProtectedBytes=" << lowerProtectedBytes << endl;
         dump();
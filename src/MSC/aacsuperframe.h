@@ -8,7 +8,7 @@ class AACSuperFrame: public AudioSuperFrame
 public:
     AACSuperFrame();
     void init(const CAudioParam& audioParam,  ERobMode eRobMode, unsigned lengthPartA, unsigned lengthPartB);
-    virtual bool parse(CVectorEx<_BINARY>& asf);
+    virtual bool parse(CBitStream& asf);
     virtual unsigned getNumFrames() { return unsigned(audioFrame.size()); }
     virtual unsigned getSuperFrameDurationMilliseconds() { return superFrameDurationMilliseconds; }
     virtual void getFrame(std::vector<uint8_t>& frame, uint8_t& crc, unsigned i) { frame = audioFrame[i]; crc = aacCRC[i]; }
@@ -16,7 +16,7 @@ private:
     unsigned lengthPartA, lengthPartB, superFrameDurationMilliseconds;
     unsigned headerBytes;
     std::vector<uint8_t> aacCRC;
-    bool header(CVectorEx<_BINARY>&);
+    bool header(CBitStream&);
     void dump();
     size_t lastFrameLength;
 };
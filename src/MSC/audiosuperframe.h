@@ -2,13 +2,14 @@
 #define AUDIOSUPERFRAME_H
 
 #include "../Parameter.h"
+#include "../util/BitStream.h"
 
 class AudioSuperFrame
 {
 public:
     AudioSuperFrame();
     virtual ~AudioSuperFrame();
-    virtual bool parse(CVectorEx<_BINARY>& asf)=0;
+    virtual bool parse(CBitStream& asf)=0;
     virtual unsigned getNumFrames()=0;
     virtual unsigned getSuperFrameDurationMilliseconds()=0;
     virtual void getFrame(std::vector<uint8_t>& , uint8_t& crc, unsigned i)=0;
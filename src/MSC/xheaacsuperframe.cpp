@@ -56,7 +56,7 @@ unsigned XHEAACSuperFrame::getSuperFrameDurationMilliseconds()
     The following definitions apply:
     4 bits. 4 bits. 8 bits
     * */
-bool XHEAACSuperFrame::parse(CVectorEx<_BINARY>& asf)
+bool XHEAACSuperFrame::parse(CBitStream& asf)
 {
     bool ok = true;
     unsigned frameBorderCount = asf.Separate(4);
@@ -79,12 +79,15 @@ bool XHEAACSuperFrame::parse(CVectorEx<_BINARY>& asf)
     //cerr << "payload start " << start << " bit reservoir level " << bitReservoirLevel << " bitResLevel " << bitResLevel << " superframe size " << superFrameSize << " directory offset " << 8*directory_offset << " bits " << directory_offset << " bytes" << endl;
 
     // get the payload
-    for (size_t i=2; i < directory_offset; i++) {
-        if (asf.Size() == 0) {
+    if (directory_offset > 2) {
+        const int payloadBytes = int(directory_offset - 2);
+        if (asf.BitsLeft() < 8*payloadBytes) {
             cerr << "DRM xHE-AAC asf UNDERRUN 1" << endl;
             return false;
         }
-        payload.push_back(asf.Separate(8));
+        vector<uint8_t> bytes(static_cast<size_t>(payloadBytes));
+        asf.SeparateBytes(bytes.data(), payloadBytes);
+        payload.insert(payload.end(), bytes.begin(), bytes.end());
     }
     borders.resize(frameBorderCount);
     frameSize.resize(frameBorderCount);
@@ -94,7 +97,7 @@ bool XHEAACSuperFrame::parse(CVectorEx<_BINARY>& asf)
     if (frameBorderCount > 0) {
         // get the directory
         for (int i = int(frameBorderCount-1); i >= 0; i--) {
-            if (asf.Size() == 0) {
+            if (asf.BitsLeft() < 16) {
                 cerr << "DRM xHE-AAC asf UNDERRUN 2" << endl;
                 return false;
             }
@@ -10,7 +10,7 @@ class XHEAACSuperFrame: public AudioSuperFrame
 public:
     XHEAACSuperFrame();
     void init(const CAudioParam& audioParam, unsigned frameSize);
-    virtual bool parse(CVectorEx<_BINARY>& asf);
+    virtual bool parse(CBitStream& asf);
     virtual unsigned getNumFrames() { return borders.size(); }
     virtual unsigned getSuperFrameDurationMilliseconds();
     virtual void getFrame(std::vector<uint8_t>& frame, uint8_t& crc, unsigned i);
@@ -49,6 +49,7 @@
 \******************************************************************************/
 
 #include "MSCMultiplexer.h"
+#include <cstring>
 
 
 /* Implementation *************************************************************/
@@ -75,15 +76,18 @@ void CMSCDemultiplexer::ExtractData(CVectorEx<_BINARY>& vecIn,
                                     CVectorEx<_BINARY>& vecOut,
                                     SStreamPos& StrPos)
 {
-    int i;
+    /* Both parts are contiguous runs in the multiplex frame, copy them as
+       blocks instead of element by element */
 
     /* Higher protected part */
-    for (i = 0; i < StrPos.iLenHigh; i++)
-        vecOut[i] = vecIn[i + StrPos.iOffsetHigh];
+    if (StrPos.iLenHigh > 0)
+        memcpy(&vecOut[0], &vecIn[StrPos.iOffsetHigh],
+               size_t(StrPos.iLenHigh) * sizeof(_BINARY));
 
     /* Lower protected part */
-    for (i = 0; i < StrPos.iLenLow; i++)
-        vecOut[i + StrPos.iLenHigh] = vecIn[i + StrPos.iOffsetLow];
+    if (StrPos.iLenLow > 0)
+        memcpy(&vecOut[StrPos.iLenHigh], &vecIn[StrPos.iOffsetLow],
+               size_t(StrPos.iLenLow) * sizeof(_BINARY));
 }
 
 CMSCDemultiplexer::SStreamPos CMSCDemultiplexer::GetStreamPos(CParameter& Param,
@@ -155,8 +155,11 @@ void COFDMDemodulation::ProcessDataInternal(CParameter&)
 
     /* Save averaged spectrum for plotting ---------------------------------- */
     /* Average power (using power of this tap) (first order IIR filter) */
-    for (i = 0; i < iLenPowSpec; i++)
-        IIR1(vecrPowSpec[i], SqMag(veccFFTOutput[i]), rLamPSD);
+    if (ViewDemand.IsActive())
+    {
+        for (i = 0; i < iLenPowSpec; i++)
+            IIR1(vecrPowSpec[i], SqMag(veccFFTOutput[i]), rLamPSD);
+    }
 }
 
 void COFDMDemodulation::InitInternal(CParameter& Parameters)
@@ -191,6 +194,8 @@ void COFDMDemodulation::InitInternal(CParameter& Parameters)
 void COFDMDemodulation::GetPowDenSpec(CVector<_REAL>& vecrData,
                                       CVector<_REAL>& vecrScale)
 {
+    ViewDemand.Request();
+
     /* Init output vectors */
     vecrData.Init(iLenPowSpec, (_REAL) 0.0);
     vecrScale.Init(iLenPowSpec, (_REAL) 0.0);
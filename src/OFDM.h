@@ -32,6 +32,7 @@
 #include "Parameter.h"
 #include "util/Modul.h"
 #include "matlib/MatlibSigProToolbox.h"
+#include "util/Utilities.h"
 
 
 /* Definitions ****************************************************************/
@@ -85,7 +86,9 @@ protected:
     CComplexVector			veccFFTInput;
     CComplexVector			veccFFTOutput;
 
+    /* Averaged spectrum for the plot, only updated while it is shown */
     CVector<_REAL>			vecrPowSpec;
+    CViewDemand				ViewDemand;
     int						iSampleRate;
     int						iLenPowSpec;
 
@@ -1095,7 +1095,12 @@ void CRxStatus::SetStatus(const ETypeRxStatus OK)
     status = OK;
     iNum++;
     if (OK==RX_OK)
+    {
         iNumOK++;
+        iTotalOK.fetch_add(1, std::memory_order_relaxed);
+    }
+    else if (OK!=NOT_PRESENT)
+        iTotalFailed.fetch_add(1, std::memory_order_relaxed);
 }
 
 void CParameter::GenerateReceiverID()
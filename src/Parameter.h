@@ -46,6 +46,7 @@
 #include "ServiceInformation.h"
 #include <map>
 #include <iostream>
+#include <atomic>
 #ifdef HAVE_LIBGPS
 # include <gps.h>
 #else
@@ -692,13 +693,16 @@ public:
 class CRxStatus
 {
 public:
-    CRxStatus():status(NOT_PRESENT),iNum(0),iNumOK(0) {}
-    CRxStatus(const CRxStatus& s):status(s.status),iNum(s.iNum),iNumOK(s.iNumOK) {}
+    CRxStatus():status(NOT_PRESENT),iNum(0),iNumOK(0),iTotalOK(0),iTotalFailed(0) {}
+    CRxStatus(const CRxStatus& s):status(s.status),iNum(s.iNum),iNumOK(s.iNumOK),
+        iTotalOK(s.iTotalOK.load()),iTotalFailed(s.iTotalFailed.load()) {}
     CRxStatus& operator=(const CRxStatus& s)
     {
         status = s.status;
         iNum = s.iNum;
         iNumOK = s.iNumOK;
+        iTotalOK = s.iTotalOK.load();
+        iTotalFailed = s.iTotalFailed.load();
         return *this;
     }
     void SetStatus(const ETypeRxStatus);
@@ -715,9 +719,17 @@ public:
         iNum=0;
         iNumOK = 0;
     }
+    /* Since start, not reset, safe to read from other threads */
+    unsigned long GetTotalOK() const {
+        return iTotalOK.load(std::memory_order_relaxed);
+    }
+    unsigned long GetTotalFailed() const {
+        return iTotalFailed.load(std::memory_order_relaxed);
+    }
 private:
     ETypeRxStatus status;
     int iNum, iNumOK;
+    std::atomic<unsigned long> iTotalOK, iTotalFailed;
 };
 
 class CReceiveStatus
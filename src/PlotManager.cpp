@@ -41,7 +41,8 @@ CPlotManager::CPlotManager() :
         vecrDopplerHist(LEN_HIST_PLOT_SYNC_PARMS),
         vecrSNRHist(LEN_HIST_PLOT_SYNC_PARMS),
         veciCDAudHist(LEN_HIST_PLOT_SYNC_PARMS), iSymbolCount(0),
-        rSumDopplerHist((_REAL) 0.0), rSumSNRHist((_REAL) 0.0), iCurrentCDAud(0)
+        rSumDopplerHist((_REAL) 0.0), rSumSNRHist((_REAL) 0.0), iCurrentCDAud(0),
+        MutexHist(), ViewDemand(), bHistPaused(false)
 {
 }
 
@@ -54,9 +55,39 @@ void CPlotManager::Init()
     rSumSNRHist = (_REAL) 0.0;
 }
 
+bool
+CPlotManager::KeepHistories()
+{
+    if (!ViewDemand.IsActive())
+    {
+        bHistPaused = true;
+        return false;
+    }
+
+    if (bHistPaused)
+    {
+        MutexHist.Lock();
+        vecrFreqSyncValHist.Reset((_REAL) 0.0);
+        vecrSamOffsValHist.Reset((_REAL) 0.0);
+        vecrLenIRHist.Reset((_REAL) 0.0);
+        vecrDopplerHist.Reset((_REAL) 0.0);
+        vecrSNRHist.Reset((_REAL) 0.0);
+        veciCDAudHist.Reset(0);
+        iSymbolCount = 0;
+        rSumDopplerHist = (_REAL) 0.0;
+        rSumSNRHist = (_REAL) 0.0;
+        MutexHist.Unlock();
+        bHistPaused = false;
+    }
+    return true;
+}
+
 void
 CPlotManager::UpdateParamHistories(ERecState eReceiverState)
 {
+    if (!KeepHistories())
+        return;
+
     CParameter& Parameters = *pReceiver->GetParameters();
 
     /* TODO: do not use the shift register class, build a new
@@ -122,6 +153,8 @@ void
 CPlotManager::UpdateParamHistoriesRSIIn()
 {
     /* This function is only called once per RSI frame, so process every time */
+    if (!KeepHistories())
+        return;
 
     CParameter& Parameters = *pReceiver->GetParameters();
 
@@ -159,6 +192,8 @@ CPlotManager::GetFreqSamOffsHist(CVector < _REAL > &vecrFreqOffs,
                                  CVector < _REAL > &vecrScale,
                                  _REAL & rFreqAquVal)
 {
+    ViewDemand.Request();
+
     CParameter& Parameters = *pReceiver->GetParameters();
 
     Parameters.Lock();
@@ -193,6 +228,8 @@ CPlotManager::GetDopplerDelHist(CVector < _REAL > &vecrLenIR,
                                 CVector < _REAL > &vecrDoppler,
                                 CVector < _REAL > &vecrScale)
 {
+    ViewDemand.Request();
+
     CParameter& Parameters = *pReceiver->GetParameters();
 
     /* Init output vectors */
@@ -228,6 +265,8 @@ CPlotManager::GetSNRHist(CVector < _REAL > &vecrSNR,
                          CVector < _REAL > &vecrCDAud,
                          CVector < _REAL > &vecrScale)
 {
+    ViewDemand.Request();
+
     CParameter& Parameters = *pReceiver->GetParameters();
     /* Duration of DRM frame */
     Parameters.Lock();
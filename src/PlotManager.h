@@ -34,6 +34,7 @@
 
 #include "GlobalDefinitions.h"
 #include "Parameter.h"
+#include "util/Utilities.h"
 
 /* Definitions ****************************************************************/
 
@@ -89,6 +90,10 @@ public:
 
 
 private:
+    /* Returns false if nobody looks at the histories. After a pause they
+       start over, a gap in the middle would distort the time axis */
+    bool KeepHistories();
+
     CDRMReceiver			*pReceiver;
     /* Storing parameters for plot */
     CShiftRegister<_REAL>	vecrFreqSyncValHist;
@@ -102,6 +107,8 @@ private:
     _REAL					rSumSNRHist;
     int						iCurrentCDAud;
     CMutex					MutexHist;
+    CViewDemand				ViewDemand;
+    bool					bHistPaused;
 
 };
 
@@ -37,6 +37,8 @@
 # include "sound/sound.h"
 #endif
 #include "sound/audiofilein.h"
+#include "sound/pipein.h"
+#include "sound/mmapfilein.h"
 #include "util/FileTyper.h"
 #include "IQInputFilter.h"
 #include "UpsampleFilter.h"
@@ -47,17 +49,14 @@ using namespace std;
 const static int SineTable[] = { 0, 1, 0, -1, 0 };
 const static _REAL PSDWindowGain = 0.39638; /* power gain of the Hamming window */
 
-//inline _REAL sample2real(_SAMPLE s) { return _REAL(s)/32768.0; }
-inline _REAL sample2real(_SAMPLE s) {
-    return _REAL(s);
-}
-
 CReceiveData::CReceiveData() :
 #ifdef QT_MULTIMEDIA_LIB
     pAudioInput(nullptr),
     pIODevice(nullptr),
 #endif
-    pSound(nullptr),
+    pSound(nullptr), pPipeIn(nullptr), pMmapFileIn(nullptr), eInputFormat(SMPFMT_AUTO),
+    rPipeBufferSeconds(2.0), bPipeDropOldest(false), rInputSeek(0.0),
+    bPipeStats(false), iPipeOverruns(0), iPipeUnderruns(0), iPipeBufferedMs(0),
     vecrInpData(INPUT_DATA_VECTOR_SIZE, 0.0),
     bFippedSpectrum(false), eInChanSelection(CS_MIX_CHAN), iPhase(0),spectrumAnalyser()
 {}
@@ -84,6 +83,20 @@ void CReceiveData::Stop()
         pSound->Close();
         pSound = nullptr;
     }
+    pPipeIn = nullptr;
+    pMmapFileIn = nullptr;
+    bPipeStats = false;
+}
+
+bool CReceiveData::GetPipeStats(unsigned long& iOverruns, unsigned long& iUnderruns,
+                                _REAL& rBufferedSeconds) const
+{
+    if (!bPipeStats)
+        return false;
+    iOverruns = iPipeOverruns;
+    iUnderruns = iPipeUnderruns;
+    rBufferedSeconds = _REAL(iPipeBufferedMs) / 1000.0;
+    return true;
 }
 
 void CReceiveData::Enumerate(vector<string>& names, vector<string>& descriptions, string& defaultInput)
@@ -126,16 +139,35 @@ CReceiveData::SetSoundInterface(string device)
         delete pSound;
         pSound = nullptr;
     }
-    if(FileTyper::resolve(device) != FileTyper::unrecognised) {
-        CAudioFileIn* pAudioFileIn = new CAudioFileIn();
-        pAudioFileIn->SetFileName(device);
-        int sr = pAudioFileIn->GetSampleRate();
-        if(iSampleRate!=sr) {
-            // TODO
-            cerr << "file sample rate is " << sr << endl;
-            iSampleRate = sr;
+    pPipeIn = nullptr;
+    pMmapFileIn = nullptr;
+    bPipeStats = false;
+    const bool bPipe = CPipeIn::IsPipe(device);
+    if(bPipe || FileTyper::resolve(device) != FileTyper::unrecognised) {
+        if(bPipe) {
+            /* stdin or named pipe, runs at the receiver's sample rate */
+            pPipeIn = new CPipeIn();
+            pPipeIn->SetDev(device);
+            pPipeIn->SetSampleFormat(eInputFormat);
+            pPipeIn->SetBuffering(rPipeBufferSeconds, bPipeDropOldest);
+            pSound = pPipeIn;
+        }
+        else if(OpenMmapFile(device)) {
+            /* Sample rate supported as is, read straight from the mapping */
+            pSound = pMmapFileIn;
+        }
+        else {
+            CAudioFileIn* pAudioFileIn = new CAudioFileIn();
+            pAudioFileIn->SetSampleFormat(eInputFormat);
+            pAudioFileIn->SetFileName(device);
+            int sr = pAudioFileIn->GetSampleRate();
+            if(iSampleRate!=sr) {
+                // TODO
+                cerr << "file sample rate is " << sr << endl;
+                iSampleRate = sr;
+            }
+            pSound = pAudioFileIn;
         }
-        pSound = pAudioFileIn;
 #ifdef QT_MULTIMEDIA_LIB
         if(pIODevice!=nullptr) {
             pIODevice->close();
@@ -176,12 +208,32 @@ CReceiveData::SetSoundInterface(string device)
     }
 }
 
+bool CReceiveData::OpenMmapFile(const string& device)
+{
+    CMmapFileIn* pFileIn = new CMmapFileIn();
+    pFileIn->SetSampleFormat(eInputFormat);
+    if (!pFileIn->Open(device)) {
+        delete pFileIn;
+        return false;
+    }
+    if (rInputSeek > 0.0)
+        pFileIn->Seek(rInputSeek);
+    const int sr = pFileIn->GetSampleRate();
+    if (iSampleRate != sr) {
+        cerr << "file sample rate is " << sr << endl;
+        iSampleRate = sr;
+    }
+    pMmapFileIn = pFileIn;
+    return true;
+}
+
 void CReceiveData::ProcessDataInternal(CParameter& Parameters)
 {
     int i;
 
     /* OPH: update free-running symbol counter */
     Parameters.Lock();
+    const bool bMeasurePSD = Parameters.bMeasurePSD;
 
     iFreeSymbolCounter++;
     if (iFreeSymbolCounter >= Parameters.CellMappingTable.iNumSymPerFrame * 2) /* x2 because iOutputBlockSize=iSymbolBlockSize/2 */
@@ -246,9 +298,11 @@ void CReceiveData::ProcessDataInternal(CParameter& Parameters)
             }
         } while (n>0);
 #endif
+        for (i = 0; i < vecsSoundBuffer.Size(); i++)
+            vecrSoundBuffer[i] = _REAL(vecsSoundBuffer[i]);
     }
     else if (pSound != nullptr) { // for audio files
-        bBad = pSound->Read(vecsSoundBuffer);
+        bBad = pSound->ReadReal(vecrSoundBuffer);
     }
     else {
       bBad = true;
@@ -257,7 +311,9 @@ void CReceiveData::ProcessDataInternal(CParameter& Parameters)
     bool bBad = true;
     if (pSound != nullptr)
     {
-        bBad = pSound->Read(vecsSoundBuffer);
+        /* Straight to _REAL, keeps the resolution of float and 24 bit
+           sources */
+        bBad = pSound->ReadReal(vecrSoundBuffer);
     }
 #endif
 
@@ -265,6 +321,14 @@ void CReceiveData::ProcessDataInternal(CParameter& Parameters)
     Parameters.ReceiveStatus.InterfaceI.SetStatus(bBad ? CRC_ERROR : RX_OK); /* Red light */
     Parameters.Unlock();
 
+    if (pPipeIn != nullptr)
+    {
+        iPipeOverruns = pPipeIn->GetOverruns();
+        iPipeUnderruns = pPipeIn->GetUnderruns();
+        iPipeBufferedMs = int(pPipeIn->GetBufferedSeconds() * 1000.0);
+        bPipeStats = true;
+    }
+
     if(bBad)
         return;
 
@@ -272,8 +336,8 @@ void CReceiveData::ProcessDataInternal(CParameter& Parameters)
     if (iUpscaleRatio > 1)
     {
         /* The actual upscaling, currently only 2X is supported */
-        InterpFIR_2X(2, &vecsSoundBuffer[0], vecf_ZL, vecf_YL, vecf_B);
-        InterpFIR_2X(2, &vecsSoundBuffer[1], vecf_ZR, vecf_YR, vecf_B);
+        InterpFIR_2X(2, &vecrSoundBuffer[0], vecf_ZL, vecf_YL, vecf_B);
+        InterpFIR_2X(2, &vecrSoundBuffer[1], vecf_ZR, vecf_YR, vecf_B);
 
         /* Write data to output buffer. Do not set the switch command inside
            the for-loop for efficiency reasons */
@@ -386,20 +450,20 @@ void CReceiveData::ProcessDataInternal(CParameter& Parameters)
         {
         case CS_LEFT_CHAN:
             for (i = 0; i < iOutputBlockSize; i++)
-                (*pvecOutputData)[i] = sample2real(vecsSoundBuffer[2 * i]);
+                (*pvecOutputData)[i] = vecrSoundBuffer[2 * i];
             break;
 
         case CS_RIGHT_CHAN:
             for (i = 0; i < iOutputBlockSize; i++)
-                (*pvecOutputData)[i] = sample2real(vecsSoundBuffer[2 * i + 1]);
+                (*pvecOutputData)[i] = vecrSoundBuffer[2 * i + 1];
             break;
 
         case CS_MIX_CHAN:
             for (i = 0; i < iOutputBlockSize; i++)
             {
                 /* Mix left and right channel together */
-                const _REAL rLeftChan = sample2real(vecsSoundBuffer[2 * i]);
-                const _REAL rRightChan = sample2real(vecsSoundBuffer[2 * i + 1]);
+                const _REAL rLeftChan = vecrSoundBuffer[2 * i];
+                const _REAL rRightChan = vecrSoundBuffer[2 * i + 1];
                 (*pvecOutputData)[i] = (rLeftChan + rRightChan) / 2;
             }
             break;
@@ -408,8 +472,8 @@ void CReceiveData::ProcessDataInternal(CParameter& Parameters)
             for (i = 0; i < iOutputBlockSize; i++)
             {
                 /* Subtract right channel from left */
-                const _REAL rLeftChan = sample2real(vecsSoundBuffer[2 * i]);
-                const _REAL rRightChan = sample2real(vecsSoundBuffer[2 * i + 1]);
+                const _REAL rLeftChan = vecrSoundBuffer[2 * i];
+                const _REAL rRightChan = vecrSoundBuffer[2 * i + 1];
                 (*pvecOutputData)[i] = (rLeftChan - rRightChan) / 2;
             }
             break;
@@ -419,8 +483,8 @@ void CReceiveData::ProcessDataInternal(CParameter& Parameters)
             for (i = 0; i < iOutputBlockSize; i++)
             {
                 (*pvecOutputData)[i] =
-                    HilbertFilt(sample2real(vecsSoundBuffer[2 * i]),
-                                sample2real(vecsSoundBuffer[2 * i + 1]));
+                    HilbertFilt(vecrSoundBuffer[2 * i],
+                                vecrSoundBuffer[2 * i + 1]);
             }
             break;
 
@@ -428,8 +492,8 @@ void CReceiveData::ProcessDataInternal(CParameter& Parameters)
             for (i = 0; i < iOutputBlockSize; i++)
             {
                 (*pvecOutputData)[i] =
-                    HilbertFilt(sample2real(vecsSoundBuffer[2 * i + 1]),
-                                sample2real(vecsSoundBuffer[2 * i]));
+                    HilbertFilt(vecrSoundBuffer[2 * i + 1],
+                                vecrSoundBuffer[2 * i]);
             }
             break;
 
@@ -438,8 +502,8 @@ void CReceiveData::ProcessDataInternal(CParameter& Parameters)
             {
                 /* Shift signal to vitual intermediate frequency before applying
                    the Hilbert filtering */
-                _COMPLEX cCurSig = _COMPLEX(sample2real(vecsSoundBuffer[2 * i]),
-                                            sample2real(vecsSoundBuffer[2 * i + 1]));
+                _COMPLEX cCurSig = _COMPLEX(vecrSoundBuffer[2 * i],
+                                            vecrSoundBuffer[2 * i + 1]);
 
                 cCurSig *= cCurExp;
 
@@ -457,8 +521,8 @@ void CReceiveData::ProcessDataInternal(CParameter& Parameters)
             {
                 /* Shift signal to vitual intermediate frequency before applying
                    the Hilbert filtering */
-                _COMPLEX cCurSig = _COMPLEX(sample2real(vecsSoundBuffer[2 * i + 1]),
-                                            sample2real(vecsSoundBuffer[2 * i]));
+                _COMPLEX cCurSig = _COMPLEX(vecrSoundBuffer[2 * i + 1],
+                                            vecrSoundBuffer[2 * i]);
 
                 cCurSig *= cCurExp;
 
@@ -475,8 +539,8 @@ void CReceiveData::ProcessDataInternal(CParameter& Parameters)
             for (i = 0; i < iOutputBlockSize; i++)
             {
                 iPhase = (iPhase + 1) & 3;
-                _REAL rValue = vecsSoundBuffer[2 * i]     * /*COS*/SineTable[iPhase + 1] -
-                               vecsSoundBuffer[2 * i + 1] * /*SIN*/SineTable[iPhase];
+                _REAL rValue = vecrSoundBuffer[2 * i]     * /*COS*/SineTable[iPhase + 1] -
+                               vecrSoundBuffer[2 * i + 1] * /*SIN*/SineTable[iPhase];
                 (*pvecOutputData)[i] = rValue;
             }
             break;
@@ -485,8 +549,8 @@ void CReceiveData::ProcessDataInternal(CParameter& Parameters)
             for (i = 0; i < iOutputBlockSize; i++)
             {
                 iPhase = (iPhase + 1) & 3;
-                _REAL rValue = vecsSoundBuffer[2 * i + 1] * /*COS*/SineTable[iPhase + 1] -
-                               vecsSoundBuffer[2 * i]     * /*SIN*/SineTable[iPhase];
+                _REAL rValue = vecrSoundBuffer[2 * i + 1] * /*COS*/SineTable[iPhase + 1] -
+                               vecrSoundBuffer[2 * i]     * /*SIN*/SineTable[iPhase];
                 (*pvecOutputData)[i] = rValue;
             }
             break;
@@ -507,9 +571,12 @@ void CReceiveData::ProcessDataInternal(CParameter& Parameters)
     }
 
     /* Copy data in buffer for spectrum calculation */
-    mutexInpData.Lock();
-    vecrInpData.AddEnd((*pvecOutputData), iOutputBlockSize);
-    mutexInpData.Unlock();
+    if (bMeasurePSD || ViewDemand.IsActive())
+    {
+        mutexInpData.Lock();
+        vecrInpData.AddEnd((*pvecOutputData), iOutputBlockSize);
+        mutexInpData.Unlock();
+    }
 
     /* Update level meter */
     SignalLevelMeter.Update((*pvecOutputData));
@@ -606,7 +673,10 @@ void CReceiveData::InitInternal(CParameter& Parameters)
         }
 
         /* Init buffer size for taking stereo input */
+#ifdef QT_MULTIMEDIA_LIB
         vecsSoundBuffer.Init(iOutputBlockSize * 2 / iUpscaleRatio);
+#endif
+        vecrSoundBuffer.Init(iOutputBlockSize * 2 / iUpscaleRatio);
 
         /* Init signal meter */
         SignalLevelMeter.Init(0);
@@ -636,10 +706,12 @@ void CReceiveData::InitInternal(CParameter& Parameters)
     catch (CGenErr GenErr)
     {
         pSound = nullptr;
+        pMmapFileIn = nullptr;
     }
     catch (string strError)
     {
         pSound = nullptr;
+        pMmapFileIn = nullptr;
     }
 }
 
@@ -668,7 +740,7 @@ _REAL CReceiveData::HilbertFilt(const _REAL rRe, const _REAL rIm)
     return (rSum + vecrReHist[IQ_INP_HIL_FILT_DELAY]) / 2;
 }
 
-void CReceiveData::InterpFIR_2X(const int channels, _SAMPLE* X, vector<float>& Z, vector<float>& Y, vector<float>& B)
+void CReceiveData::InterpFIR_2X(const int channels, const _REAL* X, vector<float>& Z, vector<float>& Y, vector<float>& B)
 {
     /*
         2X interpolating filter. When combined with CS_IQ_POS_SPLIT or CS_IQ_NEG_SPLIT
@@ -695,7 +767,7 @@ void CReceiveData::InterpFIR_2X(const int channels, _SAMPLE* X, vector<float>& Z
 
     /* Copy the new sample at the beginning of the history */
     for (i = 0, j = 0; i < Y_len_2; i++, j+=channels)
-        Z_beg_ptr[Y_len_2 - i - 1] = X[j];
+        Z_beg_ptr[Y_len_2 - i - 1] = float(X[j]);
 
     /* The actual lowpass filtering using FIR */
     for (i = Y_len_2-1; i >= 0; i--)
@@ -738,6 +810,7 @@ _REAL CReceiveData::ConvertFrequency(_REAL rFrequency, bool bInvert) const
 
 void CReceiveData::GetInputSpec(CVector<_REAL>& vecrData, CVector<_REAL>& vecrScale)
 {
+    ViewDemand.Request();
     spectrumAnalyser.setNegativeFrequency(eInChanSelection == CS_IQ_POS_SPLIT || eInChanSelection == CS_IQ_NEG_SPLIT);
     spectrumAnalyser.setOffsetFrequency((eInChanSelection == CS_IQ_POS_ZERO) || (eInChanSelection == CS_IQ_NEG_ZERO));
     mutexInpData.Lock();
@@ -755,6 +828,7 @@ void CReceiveData::GetInputPSD(CVector<_REAL>& vecrData, CVector<_REAL>& vecrSca
                  const int iNumAvBlocksPSD,
                  const int iPSDOverlap)
 {
+    ViewDemand.Request();
     spectrumAnalyser.setNegativeFrequency(eInChanSelection == CS_IQ_POS_SPLIT || eInChanSelection == CS_IQ_NEG_SPLIT);
     spectrumAnalyser.setOffsetFrequency((eInChanSelection == CS_IQ_POS_ZERO) || (eInChanSelection == CS_IQ_NEG_ZERO));
     mutexInpData.Lock();
@@ -31,6 +31,8 @@
 
 #include "util/Modul.h"
 #include "sound/soundinterface.h"
+#include "sound/sampleformat.h"
+#include <atomic>
 #include "util/Utilities.h"
 #include "spectrumanalyser.h"
 #ifdef QT_MULTIMEDIA_LIB
@@ -91,6 +93,46 @@ public:
         mutexInpData.Unlock();
     }
 
+    /* Sample format of raw input files, takes effect with the next
+       SetSoundInterface() */
+    void SetInputFormat(const ESampleFormat eNewFormat) {
+        eInputFormat = eNewFormat;
+    }
+    ESampleFormat GetInputFormat() const {
+        return eInputFormat;
+    }
+
+    /* Read-ahead of stdin/pipe input, takes effect with the next
+       SetSoundInterface() */
+    void SetPipeBuffering(const _REAL rNewSeconds, const bool bNewDropOldest) {
+        rPipeBufferSeconds = rNewSeconds;
+        bPipeDropOldest = bNewDropOldest;
+    }
+    _REAL GetPipeBufferSeconds() const {
+        return rPipeBufferSeconds;
+    }
+    bool GetPipeDropOldest() const {
+        return bPipeDropOldest;
+    }
+
+    /* Start position of input files in seconds, takes effect with the next
+       SetSoundInterface() */
+    void SetInputSeek(const _REAL rNewSeconds) {
+        rInputSeek = rNewSeconds;
+    }
+    _REAL GetInputSeek() const {
+        return rInputSeek;
+    }
+
+    /* The input file if it is memory mapped, nullptr otherwise */
+    class CMmapFileIn* GetMmapFileIn() {
+        return pMmapFileIn;
+    }
+
+    /* Statistics of stdin/pipe input, false for other inputs */
+    bool GetPipeStats(unsigned long& iOverruns, unsigned long& iUnderruns,
+                      _REAL& rBufferedSeconds) const;
+
     void SetSoundInterface(std::string);
     std::string GetSoundInterface() { return soundDevice; }
     void Enumerate(std::vector<string>& names, std::vector<string>& descriptions, std::string& defaultInput);
@@ -121,12 +163,29 @@ protected:
     mutable QMutex          audioDeviceMutex;  // Protect audio device pointers
 #endif
     CSoundInInterface*		pSound;
+    class CPipeIn*			pPipeIn;
+    class CMmapFileIn*		pMmapFileIn;
+#ifdef QT_MULTIMEDIA_LIB
     CVector<_SAMPLE>		vecsSoundBuffer;
+#endif
+    CVector<_REAL>			vecrSoundBuffer;
     std::string             soundDevice;
-
-    /* Access to vecrInpData buffer must be done inside a mutex */
+    ESampleFormat			eInputFormat;
+    _REAL					rPipeBufferSeconds;
+    bool					bPipeDropOldest;
+    _REAL					rInputSeek;
+
+    /* Copy of the pipe statistics, read by other threads */
+    std::atomic<bool>			bPipeStats;
+    std::atomic<unsigned long>	iPipeOverruns;
+    std::atomic<unsigned long>	iPipeUnderruns;
+    std::atomic<int>			iPipeBufferedMs;
+
+    /* Access to vecrInpData buffer must be done inside a mutex. It is only
+       kept up to date for the RSCI PSD or while the spectra are shown */
     CShiftRegister<_REAL>	vecrInpData;
     CMutex                  mutexInpData;
+    CViewDemand             ViewDemand;
 
     int                     iSampleRate;
     bool                    bFippedSpectrum;
@@ -144,6 +203,7 @@ protected:
     SpectrumAnalyser            spectrumAnalyser;
 
     _REAL HilbertFilt(const _REAL rRe, const _REAL rIm);
+    bool OpenMmapFile(const std::string& device);
 
     /* OPH: counter to count symbols within a frame in order to generate */
     /* RSCI output */
@@ -152,7 +212,7 @@ protected:
     virtual void InitInternal(CParameter& Parameters);
     virtual void ProcessDataInternal(CParameter& Parameters);
 
-    void InterpFIR_2X(const int channels, _SAMPLE* X, std::vector<float>& Z, std::vector<float>& Y, std::vector<float>& B);
+    void InterpFIR_2X(const int channels, const _REAL* X, std::vector<float>& Z, std::vector<float>& Y, std::vector<float>& B);
     void emitRSCIData(CParameter& Parameters);
 };
 
@@ -1094,13 +1094,19 @@ CDateAndTime::extract_relative(CVector < _BINARY > &vecbiData)
 		t += 24 * 60 * 60 * interval;
 		break;
 	}
-	struct tm *tmp = gmtime(&t);
-	year = tmp->tm_year;
-	month = tmp->tm_mon;
-	day = tmp->tm_mday;
-	hours = tmp->tm_hour;
-	minutes = tmp->tm_min;
-	seconds = tmp->tm_sec;
+	/* Not gmtime(), its buffer is shared by all threads */
+	struct tm tmUTC;
+#ifdef _WIN32
+	gmtime_s(&tmUTC, &t);
+#else
+	gmtime_r(&t, &tmUTC);
+#endif
+	year = tmUTC.tm_year;
+	month = tmUTC.tm_mon;
+	day = tmUTC.tm_mday;
+	hours = tmUTC.tm_hour;
+	minutes = tmUTC.tm_min;
+	seconds = tmUTC.tm_sec;
 }
 
 void
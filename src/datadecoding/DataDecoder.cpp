@@ -32,7 +32,8 @@
 #include "Experiment.h"
 #include <iostream>
 
-CDataDecoder::CDataDecoder ():iServPacketID (0), DoNotProcessData (true),
+CDataDecoder::CDataDecoder ():iServPacketID (0), iFixedService (-1),
+	DoNotProcessData (true),
 	Journaline(*new CJournaline()),
 	Experiment(*new CExperiment()),
 	iOldJournalineServiceID (0)
@@ -49,7 +50,7 @@ CDataDecoder::~CDataDecoder ()
 void
 CDataDecoder::ProcessDataInternal(CParameter & Parameters)
 {
-	int i, j;
+	int j;
 	int iPacketID;
 	int iNewContInd;
 	int iNewPacketDataSize;
@@ -64,40 +65,35 @@ CDataDecoder::ProcessDataInternal(CParameter & Parameters)
 	if (DoNotProcessData)
 		return;
 
-	/* CRC check for all packets -------------------------------------------- */
-	/* Reset bit extraction access */
-	(*pvecInputData).ResetBitAccess();
+	/* Packets are a whole number of bytes, pack the input block once and
+	   work on bytes from here on */
+	PacketStream.Pack(*pvecInputData, iInputBlockSize);
 
+	/* CRC check for all packets -------------------------------------------- */
 	for (j = 0; j < iNumDataPackets; j++)
 	{
-		/* Check the CRC of this packet */
-		CRCObject.Reset(16);
+		const _BYTE* pbyPacket = PacketStream.Data() + j * iTotalPacketSize;
 
-		/* "- 2": 16 bits for CRC at the end */
-		for (i = 0; i < iTotalPacketSize - 2; i++)
-		{
-			_BYTE b =pvecInputData->Separate(SIZEOF__BYTE);
-			CRCObject.AddByte(b);
-		}
-
-		/* Store result in vector and show CRC in multimedia window */
-		uint16_t crc = pvecInputData->Separate(16);
+		/* Check the CRC of this packet (16 bits for CRC at the end). Store
+		   result in vector and show CRC in multimedia window */
 		int iShortID = Parameters.GetCurSelDataService();
-		if (CRCObject.CheckCRC(crc))
+		if (CRCObject.CheckBlock(16, pbyPacket, size_t(iTotalPacketSize)))
 		{
 			veciCRCOk[j] = 1;	/* CRC ok */
-			Parameters.DataComponentStatus[iShortID].SetStatus(RX_OK);
+			if (iFixedService < 0)
+				Parameters.DataComponentStatus[iShortID].SetStatus(RX_OK);
 		}
 		else
 		{
 			veciCRCOk[j] = 0;	/* CRC wrong */
-			Parameters.DataComponentStatus[iShortID].SetStatus(CRC_ERROR);
+			if (iFixedService < 0)
+				Parameters.DataComponentStatus[iShortID].SetStatus(CRC_ERROR);
 		}
 	}
 
 	/* Extract packet data -------------------------------------------------- */
 	/* Reset bit extraction access */
-	(*pvecInputData).ResetBitAccess();
+	PacketStream.ResetBitAccess();
 
 	for (j = 0; j < iNumDataPackets; j++)
 	{
@@ -106,19 +102,19 @@ CDataDecoder::ProcessDataInternal(CParameter & Parameters)
 		{
 			/* Read header data --------------------------------------------- */
 			/* First flag */
-			biFirstFlag = (_BINARY) (*pvecInputData).Separate(1);
+			biFirstFlag = (_BINARY) PacketStream.Separate(1);
 
 			/* Last flag */
-			biLastFlag = (_BINARY) (*pvecInputData).Separate(1);
+			biLastFlag = (_BINARY) PacketStream.Separate(1);
 
 			/* Packet ID */
-			iPacketID = (int) (*pvecInputData).Separate(2);
+			iPacketID = (int) PacketStream.Separate(2);
 
 			/* Padded packet indicator (PPI) */
-			biPadPackInd = (_BINARY) (*pvecInputData).Separate(1);
+			biPadPackInd = (_BINARY) PacketStream.Separate(1);
 
 			/* Continuity index (CI) */
-			iNewContInd = (int) (*pvecInputData).Separate(3);
+			iNewContInd = (int) PacketStream.Separate(3);
 
 			/* Act on parameters given in header */
 			/* Continuity index: this 3-bit field shall increment by one
@@ -151,7 +147,7 @@ CDataDecoder::ProcessDataInternal(CParameter & Parameters)
 				/* Padding is present: the first byte gives the number of
 				   useful data bytes in the data field. */
 				iNewPacketDataSize =
-					(int) (*pvecInputData).Separate(SIZEOF__BYTE) *
+					(int) PacketStream.Separate(SIZEOF__BYTE) *
 					SIZEOF__BYTE;
 
 				if (iNewPacketDataSize > iMaxPacketDataSize)
@@ -194,19 +190,22 @@ CDataDecoder::ProcessDataInternal(CParameter & Parameters)
 				iNumSkipBytes = 2;
 			}
 
-			/* Add new data to data unit vector (bit-wise copying) */
+			/* Add new data to data unit vector (unpacked, the application
+			   decoders work on bits) */
 			iOldPacketDataSize = DataUnit[iPacketID].vecbiData.Size();
 
 			DataUnit[iPacketID].vecbiData.Enlarge(iNewPacketDataSize);
 
 			/* Read useful bits */
-			for (i = 0; i < iNewPacketDataSize; i++)
-				DataUnit[iPacketID].vecbiData[iOldPacketDataSize + i] =
-					(_BINARY) (*pvecInputData).Separate(1);
+			if (iNewPacketDataSize > 0)
+			{
+				PacketStream.SeparateBits(
+					&DataUnit[iPacketID].vecbiData[iOldPacketDataSize],
+					iNewPacketDataSize);
+			}
 
-			/* Read bytes which are not used */
-			for (i = 0; i < iNumSkipBytes; i++)
-				(*pvecInputData).Separate(SIZEOF__BYTE);
+			/* Skip bytes which are not used */
+			PacketStream.Skip(iNumSkipBytes * SIZEOF__BYTE);
 
 			/* Use data unit ------------------------------------------------ */
 			if (DataUnit[iPacketID].bReady)
@@ -218,7 +217,7 @@ CDataDecoder::ProcessDataInternal(CParameter & Parameters)
 
 				if(eAppType[iPacketID] == AT_NOT_SUP)
 				{
-					int iCurSelDataServ = Parameters.GetCurSelDataService();
+					int iCurSelDataServ = GetServiceIndex(Parameters);
 					// TODO int iCurDataStreamID = Parameters.Service[iCurSelDataServ].DataParam.iStreamID;
 					for (int i = 0; i <=3; i++)
 					{
@@ -273,8 +272,7 @@ CDataDecoder::ProcessDataInternal(CParameter & Parameters)
 		else
 		{
 			/* Skip incorrect packet */
-			for (i = 0; i < iTotalPacketSize; i++)
-				(*pvecInputData).Separate(SIZEOF__BYTE);
+			PacketStream.Skip(iTotalPacketSize * SIZEOF__BYTE);
 		}
 	}
 	if(iEPGService >= 0)	/* if EPG decoding is active */
@@ -345,14 +343,18 @@ CDataDecoder::InitInternal(CParameter & Parameters)
 	DoNotProcessData = false;
 
 	/* Get current selected data service */
-	iCurSelDataServ = Parameters.GetCurSelDataService();
+	iCurSelDataServ = GetServiceIndex(Parameters);
 
 	/* Get current data stream ID */
 	iCurDataStreamID =
 		Parameters.Service[iCurSelDataServ].DataParam.iStreamID;
 
-	/* Get number of total input bits (and bytes) for this module */
-	iTotalNumInputBits = Parameters.iNumDataDecoderBits;
+	/* Get number of total input bits (and bytes) for this module. A decoder
+	   for a fixed service gets the whole stream of that service */
+	if (iFixedService >= 0)
+		iTotalNumInputBits = Parameters.GetStreamLen(iCurDataStreamID) * SIZEOF__BYTE;
+	else
+		iTotalNumInputBits = Parameters.iNumDataDecoderBits;
 	iTotalNumInputBytes = iTotalNumInputBits / SIZEOF__BYTE;
 
 	/* Get the packet ID of the selected service */
@@ -441,7 +443,9 @@ CDataDecoder::InitInternal(CParameter & Parameters)
 	{
 		if ((Parameters.Service[i].DataParam.eAppDomain ==
 			 CDataParam::AD_DAB_SPEC_APP)
-			&& (Parameters.Service[i].DataParam.iUserAppIdent == 7))
+			&& (Parameters.Service[i].DataParam.iUserAppIdent == 7)
+			&& ((iFixedService < 0) ||
+				(Parameters.Service[i].DataParam.iStreamID == iCurDataStreamID)))
 		{
 			iEPGService = i;
 			iEPGPacketID = Parameters.Service[i].DataParam.iPacketID;
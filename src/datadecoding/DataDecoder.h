@@ -34,6 +34,7 @@
 #include "../util/Modul.h"
 #include "../util/CRC.h"
 #include "../util/Vector.h"
+#include "../util/BitStream.h"
 #include "DABMOT.h"
 #include "MOTSlideShow.h"
 
@@ -87,6 +88,19 @@ class CDataDecoder:public CReceiverModul < _BINARY, _BINARY >
         return AT_NOT_SUP;
     }
 
+    /* Decode the stream of the given service instead of the current
+       selection (-1: current selection). The global data status is left
+       alone in that case */
+    void SetFixedService (const int iNewService)
+    {
+		iFixedService = iNewService;
+		SetInitFlag ();
+    }
+    int GetFixedService () const
+    {
+		return iFixedService;
+    }
+
   protected:
     class CDataUnit
     {
@@ -107,7 +121,9 @@ class CDataDecoder:public CReceiverModul < _BINARY, _BINARY >
     int iNumDataPackets;
     int iMaxPacketDataSize;
     int iServPacketID;
+    int iFixedService;
     CVector < int >veciCRCOk;
+    CBitStream PacketStream;
 
     bool DoNotProcessData;
 
@@ -127,6 +143,10 @@ class CDataDecoder:public CReceiverModul < _BINARY, _BINARY >
     int iEPGPacketID;
     void DecodeEPG(const CParameter& Parameters);
 	EAppType GetAppType(const CDataParam&);
+	int GetServiceIndex(const CParameter& Parameters) const
+	{
+		return iFixedService >= 0 ? iFixedService : Parameters.GetCurSelDataService();
+	}
 
 };
 
@@ -123,8 +123,9 @@ NMLFactory::~NMLFactory()
 /// @return The (only) instance of NMLFactory
 NMLFactory *NMLFactory::Instance(void)
 {
-  if (!_instance) _instance = new NMLFactory;
-  return _instance;
+  // created once even if several decoders ask at the same time
+  static NMLFactory *instance = (_instance = new NMLFactory);
+  return instance;
 }
 
 
@@ -41,6 +41,10 @@
 #include "DrmSimulation.h"
 #include "util/Settings.h"
 #include "util/StatusBroadcast.h"
+#include "util/BatchDecoder.h"
+#include "util/BandScanner.h"
+#include "MDI/MDIHost.h"
+#include "util/Metrics.h"
 #include "Version.h"
 #include <iostream>
 
@@ -53,7 +57,47 @@ main(int argc, char **argv)
 		Settings.Load(argc, argv);
 
 		string mode = Settings.Get("command", "mode", string());
-		if (mode == "receive")
+		const int iBatchThreads = Settings.Get("command", "batch", -1);
+		if (mode == "receive" && iBatchThreads >= 0)
+		{
+			/* Offline decoding of a recording, no sound card, no console */
+			CBatchDecoder BatchDecoder(&Settings);
+			if (!BatchDecoder.Run(unsigned(iBatchThreads)))
+				exit(1);
+		}
+		else if (mode == "receive" && Settings.Get("command", "scan", string()) != "")
+		{
+			/* Look for DRM on a list of frequencies, no audio, no console */
+			CBandScanner BandScanner(&Settings);
+			if (!BandScanner.Run())
+				exit(1);
+		}
+		else if (mode == "receive" && Settings.Get("command", "mdihost", string()) != "")
+		{
+			/* Many MDI/RSCI inputs, decoded without front-end */
+#ifdef _WIN32
+	WSADATA wsaData;
+	(void)WSAStartup(MAKEWORD(2,2), &wsaData);
+#endif
+			CMDIHost Host(&Settings);
+			if (!Host.Open())
+				exit(1);
+
+			CStatusBroadcast statusBroadcast;
+			if (statusBroadcast.Start(&Host, Settings.Get("command", "status-socket", string())))
+			{
+				fprintf(stderr, "MDI host status available at: %s\n",
+						statusBroadcast.GetSocketPath().c_str());
+			}
+
+			CMetricsServer metricsServer;
+			const string strMetrics = Settings.Get("command", "metrics", string());
+			if (strMetrics != "")
+				metricsServer.Start(&Host, strMetrics);
+
+			Host.Run();
+		}
+		else if (mode == "receive")
 		{
 			CDRMSimulation DRMSimulation;
 			CDRMReceiver DRMReceiver(&Settings);
@@ -72,6 +116,12 @@ main(int argc, char **argv)
                 if (iFreqkHz != -1)
                     DRMReceiver.SetFrequency(iFreqkHz);
 
+                // Metrics for monitoring, if asked for
+                CMetricsServer metricsServer;
+                const string strMetrics = Settings.Get("command", "metrics", string());
+                if (strMetrics != "")
+                    metricsServer.Start(&DRMReceiver, strMetrics);
+
 #ifdef USE_CONSOLEIO
                 // Start status broadcast service for console mode
                 string strStatusSocket = Settings.Get("command", "status-socket", string());
@@ -97,6 +147,9 @@ main(int argc, char **argv)
 #ifdef USE_CONSOLEIO
                         eRunState = CConsoleIO::Update();
 #endif
+                        /* Replay of a recording has ended */
+                        if (DRMReceiver.GetRSIIn()->GetInputFinished())
+                            eRunState = STOPPED;
                     }
                     while (eRunState == RUNNING);
                 }
@@ -29,10 +29,16 @@
 #include "../GlobalDefinitions.h"
 
 /* The mutex need to be application wide,
-   only the execution routines are thread-safe */
-static CMutex* _mutex = nullptr;
-#define MUTEX_LOCK() _mutex->Lock()
-#define MUTEX_UNLOCK() _mutex->Unlock()
+   only the execution routines are thread-safe. Created on first use, which
+   is thread-safe, unlike a test of a pointer (several receivers of --batch
+   make plans at the same time) */
+static CMutex& FftwMutex()
+{
+	static CMutex Mutex;
+	return Mutex;
+}
+#define MUTEX_LOCK() FftwMutex().Lock()
+#define MUTEX_UNLOCK() FftwMutex().Unlock()
 
 # define PLANNER_FLAGS (FFTW_ESTIMATE | FFTW_DESTROY_INPUT)
 /* Warning: for testing purpose only */
@@ -668,9 +674,6 @@ CFftPlans::CFftPlans(const int iFftSize) :
 	FFTPlForw(nullptr), FFTPlBackw(nullptr), pFftwComplexIn(nullptr), pFftwComplexOut(nullptr),
 	bInitialized(false), bFixedSizeInit(false), fftw_n(0)
 {
-	/* Static initialization of CMutex not working on Mac OS X */
-    if (!_mutex) _mutex = new CMutex();
-
 	/* If iFftSize is non zero then proceed to initialization */
 	if (iFftSize)
 		Init(iFftSize);
@@ -36,12 +36,14 @@
 #endif
 #include <cstdlib>
 #include <cstring>
+#include <cctype>
+#include <algorithm>
 #include <string.h>
 
 using namespace std;
 
 CAudioFileIn::CAudioFileIn(): CSoundInInterface(), eFmt(fmt_other),
-    pFileReceiver(nullptr), iSampleRate(0), iRequestedSampleRate(0), iBufferSize(0),
+    eSampleFormat(SMPFMT_AUTO), eRawFormat(SMPFMT_S16), pFileReceiver(nullptr), iSampleRate(0), iRequestedSampleRate(0), iBufferSize(0),
     iFileSampleRate(0), iFileChannels(0), pacer(nullptr),
     ResampleObjL(nullptr), ResampleObjR(nullptr), buffer(nullptr)
 {
@@ -69,7 +71,28 @@ CAudioFileIn::SetFileName(const string& strFileName)
     if (ext.substr(0,2) == "IF") eFmt = fmt_raw_stereo;
     if (ext == "pcm") eFmt = fmt_raw_mono;
     if (ext == "PCM") eFmt = fmt_raw_mono;
-    switch (eFmt)
+    /* Raw formats by name, optionally followed by the sample rate in kHz,
+       e.g.: cf32, cu8_192 */
+    string extfmt = ext.substr(0, ext.find('_'));
+    for (size_t i = 0; i < extfmt.length(); i++)
+        extfmt[i] = char(tolower(extfmt[i]));
+    const ESampleFormat eExtFormat = CSampleFormat::FromString(extfmt);
+    if (eExtFormat != SMPFMT_AUTO) eFmt = fmt_raw_stereo;
+    if (eSampleFormat != SMPFMT_AUTO)
+        eRawFormat = eSampleFormat;
+    else if (eExtFormat != SMPFMT_AUTO)
+        eRawFormat = eExtFormat;
+    else
+        eRawFormat = SMPFMT_S16;
+    if (eExtFormat != SMPFMT_AUTO)
+    {
+        iFileChannels = 2;
+        if (extfmt.length() < ext.length())
+            iFileSampleRate = 1000 * atoi(ext.substr(extfmt.length() + 1).c_str());
+        else
+            iFileSampleRate = DEFAULT_SOUNDCRD_SAMPLE_RATE;
+    }
+    else switch (eFmt)
     {
     case fmt_raw_stereo:
         iFileChannels = 2;
@@ -86,6 +109,13 @@ CAudioFileIn::SetFileName(const string& strFileName)
             iFileSampleRate = DEFAULT_SOUNDCRD_SAMPLE_RATE;
         break;
     }
+    /* I/Q formats are always stereo */
+    if ((eFmt == fmt_raw_mono) && CSampleFormat::IsComplex(eRawFormat))
+        eFmt = fmt_raw_stereo;
+    if (eFmt == fmt_raw_stereo)
+        iFileChannels = 2;
+    if (iFileSampleRate <= 0)
+        iFileSampleRate = DEFAULT_SOUNDCRD_SAMPLE_RATE;
 
 #ifdef HAVE_LIBSNDFILE
     SF_INFO sfinfo;
@@ -99,7 +129,17 @@ CAudioFileIn::SetFileName(const string& strFileName)
     case fmt_raw_stereo:
         sfinfo.samplerate = iFileSampleRate;
         sfinfo.channels = iFileChannels;
-        sfinfo.format = SF_FORMAT_RAW|SF_FORMAT_PCM_16|SF_ENDIAN_LITTLE;
+        switch (eRawFormat)
+        {
+        case SMPFMT_S24:  sfinfo.format = SF_FORMAT_PCM_24; break;
+        case SMPFMT_S32:  sfinfo.format = SF_FORMAT_PCM_32; break;
+        case SMPFMT_F32:
+        case SMPFMT_CF32: sfinfo.format = SF_FORMAT_FLOAT;  break;
+        case SMPFMT_CS8:  sfinfo.format = SF_FORMAT_PCM_S8; break;
+        case SMPFMT_CU8:  sfinfo.format = SF_FORMAT_PCM_U8; break;
+        default:          sfinfo.format = SF_FORMAT_PCM_16; break;
+        }
+        sfinfo.format |= SF_FORMAT_RAW|SF_ENDIAN_LITTLE;
         pFileReceiver = (FILE*)sf_open(strInFileName.c_str(), SFM_READ, &sfinfo);
         if (pFileReceiver == nullptr)
             throw CGenErr(string("")+sf_strerror(0)+" raised on "+strInFileName);
@@ -217,7 +257,8 @@ CAudioFileIn::Init(int iNewSampleRate, int iNewBufferSize, bool bNewBlocking)
             const int iMaxInputSize = ResampleObjL->GetMaxInputSize();
             vecTempResBufIn.Init(iMaxInputSize, (_REAL) 0.0);
             vecTempResBufOut.Init(iOutBlockSize, (_REAL) 0.0);
-            buffer = new short[iMaxInputSize * 2];
+            buffer = new _REAL[iMaxInputSize * 2];
+            vecRawBuffer.resize(size_t(iMaxInputSize * 2 * CSampleFormat::GetBytesPerSample(eRawFormat)));
             if (bChanged)
             {
                 if (ResampleObjL != nullptr)
@@ -228,7 +269,8 @@ CAudioFileIn::Init(int iNewSampleRate, int iNewBufferSize, bool bNewBlocking)
         }
         else
         {
-            buffer = new short[iNewBufferSize * 2];
+            buffer = new _REAL[iNewBufferSize * 2];
+            vecRawBuffer.resize(size_t(iNewBufferSize * 2 * CSampleFormat::GetBytesPerSample(eRawFormat)));
         }
     }
 
@@ -237,6 +279,20 @@ CAudioFileIn::Init(int iNewSampleRate, int iNewBufferSize, bool bNewBlocking)
 
 bool
 CAudioFileIn::Read(CVector<short>& psData)
+{
+    if (vecrReadBuffer.Size() != psData.Size())
+        vecrReadBuffer.Init(psData.Size());
+
+    const bool bError = ReadReal(vecrReadBuffer);
+
+    for (int i = 0; i < psData.Size(); i++)
+        psData[i] = Real2Sample(vecrReadBuffer[i]);
+
+    return bError;
+}
+
+bool
+CAudioFileIn::ReadReal(CVector<_REAL>& vecrData)
 {
     if (pacer)
         pacer->wait();
@@ -244,7 +300,7 @@ CAudioFileIn::Read(CVector<short>& psData)
     if (pFileReceiver == nullptr)
         return true;
 
-    if(psData.Size() < iBufferSize)
+    if(vecrData.Size() < iBufferSize)
         return true;
 
     const int iFrames = ResampleObjL ? ResampleObjL->GetFreeInputSize() : iBufferSize/2;
@@ -260,8 +316,8 @@ CAudioFileIn::Read(CVector<short>& psData)
                 /* If end-of-file is reached, stop simulation */
                 return false;
             }
-            psData[2*i] = (short)tIn;
-            psData[2*i+1] = (short)tIn;
+            vecrData[2*i] = _REAL(tIn);
+            vecrData[2*i+1] = _REAL(tIn);
         }
         return false;
     }
@@ -274,13 +330,14 @@ CAudioFileIn::Read(CVector<short>& psData)
     {
         if (pFileReceiver == nullptr) // file was closed in a different thread. TODO make this not possible
             return true;
-        sf_count_t c = sf_readf_short((SNDFILE*)pFileReceiver, &buffer[iReadFrame * iFileChannels], iRemainingFrame);
+        /* Normalised to +-1.0 whatever the file format is */
+        sf_count_t c = sf_readf_double((SNDFILE*)pFileReceiver, &buffer[iReadFrame * iFileChannels], iRemainingFrame);
 	    if (c != sf_count_t(iRemainingFrame))
 	    {
             /* rewind */
             if (sf_error((SNDFILE*)pFileReceiver) || sf_seek((SNDFILE*)pFileReceiver, 0, SEEK_SET) == -1)
             {
-                memset(&buffer[iReadFrame * iFileChannels], 0, iRemainingFrame * iFileChannels);
+                std::fill(&buffer[iReadFrame * iFileChannels], &buffer[iFrames * iFileChannels], _REAL(0.0));
                 bError = true;
                 break;
             }
@@ -288,18 +345,20 @@ CAudioFileIn::Read(CVector<short>& psData)
         iRemainingFrame -= c;
         iReadFrame += c;
     }
+    for (i = 0; i < iReadFrame * iFileChannels; i++)
+        buffer[i] *= 32768.0;
 #else
     while (iRemainingFrame > 0)
     {
         if (pFileReceiver == nullptr) // file was closed in a different thread. TODO make this not possible
             return true;
-        size_t c = fread(&buffer[iReadFrame * iFileChannels], sizeof(short), size_t(iRemainingFrame), pFileReceiver);
+        const size_t iFrameBytes = size_t(iFileChannels * CSampleFormat::GetBytesPerSample(eRawFormat));
+        size_t c = fread(&vecRawBuffer[size_t(iReadFrame) * iFrameBytes], iFrameBytes, size_t(iRemainingFrame), pFileReceiver);
         if (c != size_t(iRemainingFrame))
         {
             /* rewind */
             if (ferror(pFileReceiver) || fseek(pFileReceiver, 0, SEEK_SET) == -1)
             {
-                memset(&buffer[iReadFrame * iFileChannels], 0, iRemainingFrame * iFileChannels);
                 bError = true;
                 break;
             }
@@ -307,6 +366,8 @@ CAudioFileIn::Read(CVector<short>& psData)
         iRemainingFrame -= c;
         iReadFrame += c;
     }
+    CSampleFormat::Convert(eRawFormat, &vecRawBuffer[0], buffer, iReadFrame * iFileChannels);
+    std::fill(&buffer[iReadFrame * iFileChannels], &buffer[iFrames * iFileChannels], _REAL(0.0));
 #endif
 
     if (ResampleObjL)
@@ -318,13 +379,13 @@ CAudioFileIn::Read(CVector<short>& psData)
                 vecTempResBufIn[i] = buffer[2*i];
             ResampleObjL->Resample(vecTempResBufIn, vecTempResBufOut);
             for (i = 0; i < iOutBlockSize; i++)
-                psData[i*2] = Real2Sample(vecTempResBufOut[i]);
+                vecrData[i*2] = vecTempResBufOut[i];
             /* Right channel*/
             for (i = 0; i < iFrames; i++)
                 vecTempResBufIn[i] = buffer[2*i+1];
             ResampleObjR->Resample(vecTempResBufIn, vecTempResBufOut);
             for (i = 0; i < iOutBlockSize; i++)
-                psData[i*2+1] = Real2Sample(vecTempResBufOut[i]);
+                vecrData[i*2+1] = vecTempResBufOut[i];
         }
         else
         {   /* Mono */
@@ -332,7 +393,7 @@ CAudioFileIn::Read(CVector<short>& psData)
                 vecTempResBufIn[i] = buffer[i];
             ResampleObjL->Resample(vecTempResBufIn, vecTempResBufOut);
             for (i = 0; i < iOutBlockSize; i++)
-                psData[i*2] = psData[i*2+1] = Real2Sample(vecTempResBufOut[i]);
+                vecrData[i*2] = vecrData[i*2+1] = vecTempResBufOut[i];
         }
     }
     else
@@ -341,14 +402,14 @@ CAudioFileIn::Read(CVector<short>& psData)
         {   /* Stereo */
             for (i = 0; i < iFrames; i++)
             {
-                psData[2*i] = buffer[2*i];
-                psData[2*i+1] = buffer[2*i+1];
+                vecrData[2*i] = buffer[2*i];
+                vecrData[2*i+1] = buffer[2*i+1];
             }
         }
         else
         {   /* Mono */
             for (i = 0; i < iFrames; i++)
-                psData[2*i] = psData[2*i+1] = buffer[i];
+                vecrData[2*i] = vecrData[2*i+1] = buffer[i];
         }
     }
 
@@ -30,6 +30,7 @@
 #define _AUDIOFILEIN
 
 #include "soundinterface.h"
+#include "sampleformat.h"
 #include "../util/Pacer.h"
 #include "../resample/caudioresample.h"
 
@@ -44,10 +45,14 @@ public:
     virtual void		SetDev(std::string sNewDevice) {sCurrentDevice = sNewDevice;}
     virtual std::string GetDev() {return sCurrentDevice;}
     virtual void		SetFileName(const std::string& strFileName);
+    /* Sample format of raw files, SMPFMT_AUTO: by file extension. Call
+       before SetFileName() */
+    virtual void		SetSampleFormat(ESampleFormat eNewFormat) {eSampleFormat = eNewFormat;}
     virtual int			GetSampleRate() {return iRequestedSampleRate;}
 
     virtual bool	Init(int iNewSampleRate, int iNewBufferSize, bool bNewBlocking);
     virtual bool 	Read(CVector<short>& psData);
+    virtual bool 	ReadReal(CVector<_REAL>& vecrData);
     virtual void 		Close();
 	virtual std::string GetVersion() { return "Dream Audio File Reader"; }
 
@@ -56,6 +61,8 @@ protected:
     CVector<_REAL>		vecTempResBufIn;
     CVector<_REAL>		vecTempResBufOut;
     enum { fmt_txt, fmt_raw_mono, fmt_raw_stereo, fmt_other } eFmt;
+    ESampleFormat		eSampleFormat;
+    ESampleFormat		eRawFormat;
     FILE*				pFileReceiver;
     int					iSampleRate;
     int					iRequestedSampleRate;
@@ -65,7 +72,9 @@ protected:
     CPacer*				pacer;
     CAudioResample*		ResampleObjL;
     CAudioResample*		ResampleObjR;
-    short*				buffer;
+    _REAL*				buffer;
+    std::vector<unsigned char>	vecRawBuffer;
+    CVector<_REAL>		vecrReadBuffer;
     int					iOutBlockSize;
     std::string				sCurrentDevice;
 };
@@ -0,0 +1,407 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Memory mapped input of raw I/Q, PCM and WAV files with random access
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "mmapfilein.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <cerrno>
+#include <algorithm>
+#ifndef _WIN32
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+#endif
+
+/* WAV format tags */
+static const int WAVE_FORMAT_PCM = 0x0001;
+static const int WAVE_FORMAT_IEEE_FLOAT = 0x0003;
+static const int WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+static std::string GetExtension(const std::string& strFileName)
+{
+    std::string ext;
+    const size_t p = strFileName.rfind('.');
+    if (p != std::string::npos)
+        ext = strFileName.substr(p + 1);
+    for (size_t i = 0; i < ext.length(); i++)
+        ext[i] = char(tolower(ext[i]));
+    return ext;
+}
+
+static uint32_t GetLE32(const unsigned char* p)
+{
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+static uint16_t GetLE16(const unsigned char* p)
+{
+    return uint16_t(p[0] | (p[1] << 8));
+}
+
+CMmapFileIn::CMmapFileIn() : CSoundInInterface(),
+    sCurrentDevice(), eSampleFormat(SMPFMT_AUTO), eFileFormat(SMPFMT_S16),
+    iFileSampleRate(0), iFileChannels(2), iFrameBytes(4),
+    pMap(nullptr), iMapSize(0), pData(nullptr), iNumFrames(0),
+    iPos(0), iStartFrame(0), iEndFrame(0),
+    bLoop(true), bRealTime(true), bEnd(false), iBufferSize(0), pacer(nullptr)
+{
+}
+
+CMmapFileIn::~CMmapFileIn()
+{
+    Close();
+}
+
+bool CMmapFileIn::Open(const std::string& strFileName)
+{
+#ifdef _WIN32
+    (void)strFileName;
+    return false;
+#else
+    const bool bRaw = ParseRaw(strFileName);
+    if (!bRaw && (GetExtension(strFileName) != "wav"))
+        return false;
+
+    const int iFd = open(strFileName.c_str(), O_RDONLY);
+    if (iFd < 0)
+        return false;
+
+    struct stat st;
+    if ((fstat(iFd, &st) != 0) || (st.st_size <= 0))
+    {
+        close(iFd);
+        return false;
+    }
+
+    iMapSize = size_t(st.st_size);
+    void* p = mmap(nullptr, iMapSize, PROT_READ, MAP_SHARED, iFd, 0);
+    /* The mapping keeps the file referenced */
+    close(iFd);
+    if (p == MAP_FAILED)
+    {
+        fprintf(stderr, "MmapFileIn: can't map %s: %s\n", strFileName.c_str(), strerror(errno));
+        iMapSize = 0;
+        return false;
+    }
+    pMap = static_cast<unsigned char*>(p);
+
+    if (!bRaw)
+    {
+        if (!ParseWave())
+        {
+            munmap(pMap, iMapSize);
+            pMap = nullptr;
+            iMapSize = 0;
+            return false;
+        }
+    }
+    else
+    {
+        pData = pMap;
+        iNumFrames = iMapSize / size_t(iFrameBytes);
+    }
+
+    /* No resampler here */
+    if ((iFileSampleRate != 24000) && (iFileSampleRate != 48000) &&
+        (iFileSampleRate != 96000) && (iFileSampleRate != 192000))
+    {
+        munmap(pMap, iMapSize);
+        pMap = nullptr;
+        iMapSize = 0;
+        return false;
+    }
+
+    madvise(pMap, iMapSize, MADV_SEQUENTIAL);
+
+    iStartFrame = 0;
+    iEndFrame = iNumFrames;
+    iPos = 0;
+    bEnd = false;
+    sCurrentDevice = strFileName;
+
+    fprintf(stderr, "MmapFileIn: %s, %s %d ch, %d Hz, %.1f s\n", strFileName.c_str(),
+            CSampleFormat::ToString(eFileFormat).c_str(), iFileChannels, iFileSampleRate,
+            double(GetDuration()));
+    return true;
+#endif
+}
+
+bool CMmapFileIn::ParseRaw(const std::string& strFileName)
+{
+    /* Same naming as CAudioFileIn: iq48, IF192, pcm, cf32, cu8_192, ... */
+    const std::string extlow = GetExtension(strFileName);
+    const std::string extfmt = extlow.substr(0, extlow.find('_'));
+    const ESampleFormat eExtFormat = CSampleFormat::FromString(extfmt);
+    int iRatePos = -1;
+
+    iFileSampleRate = DEFAULT_SOUNDCRD_SAMPLE_RATE;
+
+    if (eExtFormat != SMPFMT_AUTO)
+    {
+        iFileChannels = 2;
+        if (extfmt.length() < extlow.length())
+            iRatePos = int(extfmt.length()) + 1;
+    }
+    else if ((extlow.substr(0, 2) == "iq") || (extlow.substr(0, 2) == "if"))
+    {
+        iFileChannels = 2;
+        if (extlow.length() == 4 || extlow.length() == 5)
+            iRatePos = 2;
+    }
+    else if (extlow.substr(0, 3) == "pcm")
+    {
+        iFileChannels = 1;
+        if (extlow.length() == 5 || extlow.length() == 6)
+            iRatePos = 3;
+    }
+    else
+        return false;
+
+    if (iRatePos > 0)
+        iFileSampleRate = 1000 * atoi(extlow.substr(size_t(iRatePos)).c_str());
+
+    if (eSampleFormat != SMPFMT_AUTO)
+        eFileFormat = eSampleFormat;
+    else if (eExtFormat != SMPFMT_AUTO)
+        eFileFormat = eExtFormat;
+    else
+        eFileFormat = SMPFMT_S16;
+
+    if (CSampleFormat::IsComplex(eFileFormat))
+        iFileChannels = 2;
+
+    iFrameBytes = iFileChannels * CSampleFormat::GetBytesPerSample(eFileFormat);
+    return true;
+}
+
+bool CMmapFileIn::ParseWave()
+{
+    if ((iMapSize < 12) || memcmp(pMap, "RIFF", 4) || memcmp(pMap + 8, "WAVE", 4))
+        return false;
+
+    int iFormatTag = 0;
+    int iBits = 0;
+    bool bFormat = false;
+    size_t iOffset = 12;
+
+    while (iOffset + 8 <= iMapSize)
+    {
+        const unsigned char* pChunk = pMap + iOffset;
+        size_t iChunkSize = GetLE32(pChunk + 4);
+
+        if (!memcmp(pChunk, "fmt ", 4) && (iChunkSize >= 16) && (iOffset + 8 + iChunkSize <= iMapSize))
+        {
+            iFormatTag = GetLE16(pChunk + 8);
+            iFileChannels = GetLE16(pChunk + 10);
+            iFileSampleRate = int(GetLE32(pChunk + 12));
+            iBits = GetLE16(pChunk + 22);
+            /* The sub format GUID starts with the format tag */
+            if ((iFormatTag == WAVE_FORMAT_EXTENSIBLE) && (iChunkSize >= 40))
+                iFormatTag = GetLE16(pChunk + 32);
+            bFormat = true;
+        }
+        else if (!memcmp(pChunk, "data", 4))
+        {
+            if (!bFormat)
+                return false;
+
+            /* Recorders that were not closed properly leave the size at
+               zero or at its maximum */
+            if ((iChunkSize == 0) || (iOffset + 8 + iChunkSize > iMapSize))
+                iChunkSize = iMapSize - iOffset - 8;
+
+            if (iFormatTag == WAVE_FORMAT_PCM)
+            {
+                switch (iBits)
+                {
+                case 8:  eFileFormat = SMPFMT_CU8; break;
+                case 16: eFileFormat = SMPFMT_S16; break;
+                case 24: eFileFormat = SMPFMT_S24; break;
+                case 32: eFileFormat = SMPFMT_S32; break;
+                default: return false;
+                }
+            }
+            else if ((iFormatTag == WAVE_FORMAT_IEEE_FLOAT) && (iBits == 32))
+                eFileFormat = SMPFMT_F32;
+            else
+                return false;
+
+            if ((iFileChannels < 1) || (iFileChannels > 2))
+                return false;
+
+            iFrameBytes = iFileChannels * CSampleFormat::GetBytesPerSample(eFileFormat);
+            pData = pChunk + 8;
+            iNumFrames = iChunkSize / size_t(iFrameBytes);
+            return iNumFrames > 0;
+        }
+
+        /* Chunks are word aligned */
+        iOffset += 8 + iChunkSize + (iChunkSize & 1);
+    }
+
+    return false;
+}
+
+bool CMmapFileIn::Init(int iNewSampleRate, int iNewBufferSize, bool bNewBlocking)
+{
+    if (pacer)
+    {
+        delete pacer;
+        pacer = nullptr;
+    }
+    if (bNewBlocking && bRealTime)
+    {
+        const double interval = double(iNewBufferSize / 2) / double(iNewSampleRate);
+        pacer = new CPacer(uint64_t(1e9 * interval));
+    }
+
+    if (iNewSampleRate != iFileSampleRate)
+        fprintf(stderr, "MmapFileIn: file sample rate %d, receiver wants %d\n", iFileSampleRate, iNewSampleRate);
+
+    const bool bChanged = iBufferSize != iNewBufferSize;
+    iBufferSize = iNewBufferSize;
+    if (iFileChannels == 1)
+        vecrMonoBuffer.Init(iBufferSize / 2);
+
+    return bChanged;
+}
+
+bool CMmapFileIn::Read(CVector<short>& psData)
+{
+    if (vecrReadBuffer.Size() != psData.Size())
+        vecrReadBuffer.Init(psData.Size());
+
+    const bool bError = ReadReal(vecrReadBuffer);
+
+    for (int i = 0; i < psData.Size(); i++)
+        psData[i] = Real2Sample(vecrReadBuffer[i]);
+
+    return bError;
+}
+
+bool CMmapFileIn::ReadReal(CVector<_REAL>& vecrData)
+{
+    if (pacer)
+        pacer->wait();
+
+    if ((pData == nullptr) || (vecrData.Size() < iBufferSize))
+        return true;
+
+    const int iFrames = iBufferSize / 2;
+    int iDone = 0;
+    bool bError = false;
+
+    while (iDone < iFrames)
+    {
+        size_t iCur = iPos.load();
+        if (iCur >= iEndFrame)
+        {
+            if (!bLoop || (iEndFrame == iStartFrame))
+            {
+                std::fill(&vecrData[2 * iDone], &vecrData[0] + 2 * iFrames, _REAL(0.0));
+                bEnd = true;
+                bError = true;
+                break;
+            }
+            iCur = iStartFrame;
+        }
+
+        const int iNum = int(std::min(size_t(iFrames - iDone), iEndFrame - iCur));
+        const unsigned char* pIn = pData + iCur * size_t(iFrameBytes);
+
+        if (iFileChannels == 2)
+            CSampleFormat::Convert(eFileFormat, pIn, &vecrData[2 * iDone], 2 * iNum);
+        else
+        {
+            CSampleFormat::Convert(eFileFormat, pIn, &vecrMonoBuffer[0], iNum);
+            for (int i = 0; i < iNum; i++)
+                vecrData[2 * (iDone + i)] = vecrData[2 * (iDone + i) + 1] = vecrMonoBuffer[i];
+        }
+
+        /* A Seek() meanwhile wins */
+        size_t iExpected = iPos.load();
+        if ((iExpected == iCur) || (iExpected >= iEndFrame))
+            iPos.compare_exchange_strong(iExpected, iCur + size_t(iNum));
+        iDone += iNum;
+    }
+
+    return bError;
+}
+
+void CMmapFileIn::Close()
+{
+    if (pacer)
+    {
+        delete pacer;
+        pacer = nullptr;
+    }
+    iBufferSize = 0;
+
+    /* The receiver drops its input without deleting it */
+#ifndef _WIN32
+    if (pMap != nullptr)
+        munmap(pMap, iMapSize);
+#endif
+    pMap = nullptr;
+    iMapSize = 0;
+    pData = nullptr;
+}
+
+_REAL CMmapFileIn::GetDuration() const
+{
+    if (iFileSampleRate == 0)
+        return 0.0;
+    return _REAL(iNumFrames) / _REAL(iFileSampleRate);
+}
+
+_REAL CMmapFileIn::GetPosition() const
+{
+    if (iFileSampleRate == 0)
+        return 0.0;
+    return _REAL(iPos.load()) / _REAL(iFileSampleRate);
+}
+
+void CMmapFileIn::Seek(const _REAL rSeconds)
+{
+    size_t iNew = (rSeconds > 0.0) ? size_t(rSeconds * _REAL(iFileSampleRate)) : 0;
+    iNew = std::max(iNew, iStartFrame);
+    iNew = std::min(iNew, iEndFrame);
+    iPos = iNew;
+    bEnd = false;
+}
+
+void CMmapFileIn::SetRange(const _REAL rStart, const _REAL rEnd)
+{
+    iStartFrame = std::min(size_t(std::max(rStart, _REAL(0.0)) * _REAL(iFileSampleRate)), iNumFrames);
+    iEndFrame = (rEnd > 0.0) ? size_t(rEnd * _REAL(iFileSampleRate)) : iNumFrames;
+    iEndFrame = std::max(std::min(iEndFrame, iNumFrames), iStartFrame);
+    iPos = iStartFrame;
+    bEnd = false;
+}
@@ -0,0 +1,151 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Memory mapped input of raw I/Q, PCM and WAV files with random access
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#ifndef MMAPFILEIN_H
+#define MMAPFILEIN_H
+
+#include "soundinterface.h"
+#include "sampleformat.h"
+#include "../util/Pacer.h"
+#include <string>
+#include <atomic>
+
+/**
+ * @brief Reads a recording by mapping it into memory
+ *
+ * The samples are converted straight from the mapping, there is no read
+ * system call and no intermediate copy per block, and any position of the
+ * file can be reached in constant time. Used for raw files (iq48, cf32,
+ * cu8_192, pcm, ...) and uncompressed WAV files whose sample rate the
+ * receiver supports directly; everything else (resampling, compressed
+ * formats, text files) is left to CAudioFileIn.
+ *
+ * The readable part of the file can be limited to a range, which is what
+ * the batch decoder uses to give each of its receivers one chunk of a long
+ * recording.
+ */
+class CMmapFileIn : public CSoundInInterface
+{
+public:
+    CMmapFileIn();
+    virtual ~CMmapFileIn();
+
+    /**
+     * @brief Map a file
+     * @return false if the file can't be mapped or needs resampling, use
+     * CAudioFileIn then
+     */
+    bool				Open(const std::string& strFileName);
+
+    /**
+     * @brief Sample format of raw files, SMPFMT_AUTO: by file extension.
+     * Call before Open()
+     */
+    void				SetSampleFormat(const ESampleFormat eNewFormat) {eSampleFormat = eNewFormat;}
+
+    virtual void		Enumerate(std::vector<std::string>&, std::vector<std::string>&, std::string&) {}
+    virtual void		SetDev(std::string sNewDevice) {sCurrentDevice = sNewDevice;}
+    virtual std::string	GetDev() {return sCurrentDevice;}
+    virtual std::string	GetVersion() {return "Dream Mapped File Reader";}
+    int					GetSampleRate() const {return iFileSampleRate;}
+
+    virtual bool		Init(int iNewSampleRate, int iNewBufferSize, bool bNewBlocking);
+    virtual bool		Read(CVector<short>& psData);
+    virtual bool		ReadReal(CVector<_REAL>& vecrData);
+    virtual void		Close();
+
+    /**
+     * @brief Length of the file in seconds
+     */
+    _REAL				GetDuration() const;
+
+    /**
+     * @brief Current read position in seconds from the start of the file
+     */
+    _REAL				GetPosition() const;
+
+    /**
+     * @brief Continue reading at the given time offset, clipped to the
+     * range. Can be called while reading
+     */
+    void				Seek(const _REAL rSeconds);
+
+    /**
+     * @brief Limit reading to [rStart, rEnd) seconds, rEnd <= 0 is the end
+     * of the file. Also seeks to rStart
+     */
+    void				SetRange(const _REAL rStart, const _REAL rEnd);
+
+    /**
+     * @brief Start over at the beginning of the range at its end (default)
+     * or stop there and return silence
+     */
+    void				SetLoop(const bool bNewLoop) {bLoop = bNewLoop;}
+
+    /**
+     * @brief Read in real time when the receiver asks for blocking input
+     * (default) or as fast as possible
+     */
+    void				SetRealTime(const bool bNewRealTime) {bRealTime = bNewRealTime;}
+
+    /**
+     * @brief Check if the end of the range was reached without looping
+     */
+    bool				IsEnd() const {return bEnd;}
+
+protected:
+    bool				ParseRaw(const std::string& strFileName);
+    bool				ParseWave();
+
+    std::string			sCurrentDevice;
+    ESampleFormat		eSampleFormat;
+    ESampleFormat		eFileFormat;
+    int					iFileSampleRate;
+    int					iFileChannels;
+    int					iFrameBytes;
+
+    /* The mapping and the sample data in it */
+    unsigned char*		pMap;
+    size_t				iMapSize;
+    const unsigned char*	pData;
+    size_t				iNumFrames;
+
+    /* Positions in frames */
+    std::atomic<size_t>	iPos;
+    size_t				iStartFrame;
+    size_t				iEndFrame;
+
+    bool				bLoop;
+    bool				bRealTime;
+    std::atomic<bool>	bEnd;
+    int					iBufferSize;
+    CPacer*				pacer;
+    CVector<_REAL>		vecrReadBuffer;
+    CVector<_REAL>		vecrMonoBuffer;
+};
+
+#endif // MMAPFILEIN_H
@@ -0,0 +1,328 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Sample input from stdin or a named pipe with a read-ahead thread
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "pipein.h"
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <chrono>
+#ifdef _WIN32
+# include <io.h>
+# include <fcntl.h>
+# define STDIN_FILENO 0
+#else
+# include <unistd.h>
+# include <fcntl.h>
+# include <poll.h>
+#endif
+
+static const char STDIN_DEVICE_NAME[] = "-";
+static const char PIPE_PREFIX[] = "pipe:";
+
+/* Largest single read from the pipe */
+static const size_t MAX_CHUNK_SIZE = 65536;
+
+/* How often the reader checks for Close() while the pipe is silent */
+static const int POLL_TIMEOUT_MS = 100;
+
+CPipeIn::CPipeIn() : CSoundInInterface(),
+    sCurrentDevice(), eSampleFormat(SMPFMT_AUTO), rBufferSeconds(2.0),
+    bDropOldest(false), iFd(-1), iSampleRate(0), iBufferSize(0), iFrameBytes(4),
+    vecRing(), iWritePos(0), iReadPos(0), vecBlock(), vecrReadBuffer(),
+    ReaderThread(), bRunning(false), bEndOfStream(false),
+    iOverruns(0), iUnderruns(0)
+{
+}
+
+CPipeIn::~CPipeIn()
+{
+    Close();
+}
+
+bool CPipeIn::IsPipe(const std::string& strDevice)
+{
+    return (strDevice == STDIN_DEVICE_NAME) ||
+           (strDevice.compare(0, sizeof(PIPE_PREFIX) - 1, PIPE_PREFIX) == 0);
+}
+
+void CPipeIn::SetBuffering(const _REAL rNewSeconds, const bool bNewDropOldest)
+{
+    rBufferSeconds = rNewSeconds;
+    bDropOldest = bNewDropOldest;
+}
+
+bool CPipeIn::Init(int iNewSampleRate, int iNewBufferSize, bool)
+{
+    const bool bChanged = iSampleRate != iNewSampleRate;
+    const ESampleFormat eFormat = (eSampleFormat == SMPFMT_AUTO) ? SMPFMT_S16 : eSampleFormat;
+    const int iBytes = CSampleFormat::GetBytesPerSample(eFormat);
+
+    iSampleRate = iNewSampleRate;
+    iBufferSize = iNewBufferSize;
+    iFrameBytes = 2 * iBytes;
+    vecBlock.resize(size_t(iBufferSize * iBytes));
+
+    /* At least a few blocks, whatever is configured */
+    size_t iRingSize = size_t(rBufferSeconds * _REAL(iSampleRate)) * size_t(iFrameBytes);
+    iRingSize = std::max(iRingSize, 4 * vecBlock.size());
+
+    if (vecRing.size() != iRingSize)
+    {
+        StopReader();
+        vecRing.assign(iRingSize, 0);
+        iReadPos.store(0);
+        iWritePos.store(0);
+    }
+
+    if (iFd < 0)
+    {
+        if (sCurrentDevice == STDIN_DEVICE_NAME)
+        {
+            iFd = STDIN_FILENO;
+#ifdef _WIN32
+            _setmode(iFd, _O_BINARY);
+#endif
+        }
+        else
+        {
+            const std::string strPath = sCurrentDevice.substr(sizeof(PIPE_PREFIX) - 1);
+#ifdef _WIN32
+            iFd = _open(strPath.c_str(), _O_RDONLY | _O_BINARY);
+#else
+            /* Non blocking, so a FIFO without writer does not block here */
+            iFd = open(strPath.c_str(), O_RDONLY | O_NONBLOCK);
+#endif
+            if (iFd < 0)
+                fprintf(stderr, "PipeIn: can't open %s: %s\n", strPath.c_str(), strerror(errno));
+        }
+        bEndOfStream = false;
+    }
+
+    if (!bRunning && iFd >= 0)
+        StartReader();
+
+    return bChanged;
+}
+
+void CPipeIn::Close()
+{
+    StopReader();
+
+    if (iFd >= 0 && iFd != STDIN_FILENO)
+    {
+#ifdef _WIN32
+        _close(iFd);
+#else
+        close(iFd);
+#endif
+    }
+    iFd = -1;
+
+    vecRing.clear();
+    iReadPos.store(0);
+    iWritePos.store(0);
+    iSampleRate = 0;
+    iBufferSize = 0;
+}
+
+void CPipeIn::StartReader()
+{
+    bRunning = true;
+    ReaderThread = std::thread(&CPipeIn::ReaderLoop, this);
+}
+
+void CPipeIn::StopReader()
+{
+    if (!ReaderThread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(WaitMutex);
+        bRunning = false;
+    }
+    SpaceCond.notify_all();
+    DataCond.notify_all();
+    ReaderThread.join();
+}
+
+_REAL CPipeIn::GetBufferedSeconds() const
+{
+    if (iSampleRate == 0)
+        return 0.0;
+    return _REAL(GetFill() / size_t(iFrameBytes)) / _REAL(iSampleRate);
+}
+
+void CPipeIn::ReaderLoop()
+{
+    const size_t iRingSize = vecRing.size();
+    const bool bNamedPipe = sCurrentDevice != STDIN_DEVICE_NAME;
+    /* A chunk of at most a quarter of the ring always fits while the
+       receiver waits for a block (at most a quarter too), so waiting for
+       space can't dead lock */
+    std::vector<unsigned char> vecChunk(std::min(MAX_CHUNK_SIZE, iRingSize / 4));
+
+    while (bRunning)
+    {
+#ifndef _WIN32
+        struct pollfd pfd;
+        pfd.fd = iFd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, POLL_TIMEOUT_MS) <= 0)
+            continue;
+        const long n = long(read(iFd, &vecChunk[0], vecChunk.size()));
+#else
+        const long n = long(_read(iFd, &vecChunk[0], unsigned(vecChunk.size())));
+#endif
+        if (n < 0 && (errno == EINTR || errno == EAGAIN))
+            continue;
+
+        if (n <= 0)
+        {
+            if (bNamedPipe && n == 0)
+            {
+                /* No writer (yet), wait for the feeder to (re)connect */
+                std::this_thread::sleep_for(std::chrono::milliseconds(POLL_TIMEOUT_MS));
+                continue;
+            }
+            fprintf(stderr, "PipeIn: end of input\n");
+            bEndOfStream = true;
+            DataCond.notify_all();
+            break;
+        }
+
+        const size_t iLen = size_t(n);
+
+        /* Make room */
+        if (iRingSize - GetFill() < iLen)
+        {
+            iOverruns.fetch_add(1, std::memory_order_relaxed);
+
+            if (bDropOldest)
+            {
+                /* Whole frames only, the reader must not lose alignment */
+                size_t r = iReadPos.load(std::memory_order_acquire);
+                size_t iDrop;
+                do
+                {
+                    const size_t iFill = iWritePos.load(std::memory_order_relaxed) - r;
+                    if (iRingSize - iFill >= iLen)
+                        iDrop = 0; /* the receiver made room meanwhile */
+                    else
+                        iDrop = iLen - (iRingSize - iFill);
+                    iDrop = (iDrop + size_t(iFrameBytes) - 1) / size_t(iFrameBytes) * size_t(iFrameBytes);
+                    iDrop = std::min(iDrop, iFill);
+                } while (!iReadPos.compare_exchange_weak(r, r + iDrop, std::memory_order_acq_rel));
+            }
+            else
+            {
+                std::unique_lock<std::mutex> lock(WaitMutex);
+                while (bRunning && iRingSize - GetFill() < iLen)
+                    SpaceCond.wait_for(lock, std::chrono::milliseconds(POLL_TIMEOUT_MS));
+                if (!bRunning)
+                    break;
+            }
+        }
+
+        const size_t w = iWritePos.load(std::memory_order_relaxed);
+        const size_t iStart = w % iRingSize;
+        const size_t iFirst = std::min(iLen, iRingSize - iStart);
+        memcpy(&vecRing[iStart], &vecChunk[0], iFirst);
+        if (iFirst < iLen)
+            memcpy(&vecRing[0], &vecChunk[iFirst], iLen - iFirst);
+        iWritePos.store(w + iLen, std::memory_order_release);
+
+        DataCond.notify_one();
+    }
+}
+
+bool CPipeIn::Read(CVector<short>& psData)
+{
+    if (vecrReadBuffer.Size() != psData.Size())
+        vecrReadBuffer.Init(psData.Size());
+
+    const bool bError = ReadReal(vecrReadBuffer);
+
+    for (int i = 0; i < psData.Size(); i++)
+        psData[i] = Real2Sample(vecrReadBuffer[i]);
+
+    return bError;
+}
+
+bool CPipeIn::ReadReal(CVector<_REAL>& vecrData)
+{
+    if (vecRing.empty() || vecrData.Size() < iBufferSize)
+        return true;
+
+    const size_t iRingSize = vecRing.size();
+    const size_t iLen = vecBlock.size();
+    bool bWaited = false;
+
+    for (;;)
+    {
+        size_t r = iReadPos.load(std::memory_order_acquire);
+        const size_t w = iWritePos.load(std::memory_order_acquire);
+
+        if (w - r >= iLen)
+        {
+            const size_t iStart = r % iRingSize;
+            const size_t iFirst = std::min(iLen, iRingSize - iStart);
+            memcpy(&vecBlock[0], &vecRing[iStart], iFirst);
+            if (iFirst < iLen)
+                memcpy(&vecBlock[iFirst], &vecRing[0], iLen - iFirst);
+
+            /* Fails if the reader dropped (and maybe overwrote) this data
+               meanwhile, try again with the new oldest data */
+            if (iReadPos.compare_exchange_strong(r, r + iLen, std::memory_order_acq_rel))
+                break;
+            continue;
+        }
+
+        if (bEndOfStream || !bRunning)
+        {
+            for (int i = 0; i < iBufferSize; i++)
+                vecrData[i] = 0.0;
+            return true;
+        }
+
+        /* Waiting before the first data arrived is no underrun */
+        if (!bWaited && w > 0)
+            iUnderruns.fetch_add(1, std::memory_order_relaxed);
+        bWaited = true;
+
+        std::unique_lock<std::mutex> lock(WaitMutex);
+        DataCond.wait_for(lock, std::chrono::milliseconds(10));
+    }
+
+    SpaceCond.notify_one();
+
+    const ESampleFormat eFormat = (eSampleFormat == SMPFMT_AUTO) ? SMPFMT_S16 : eSampleFormat;
+    CSampleFormat::Convert(eFormat, &vecBlock[0], &vecrData[0], iBufferSize);
+
+    return false;
+}
@@ -0,0 +1,142 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Sample input from stdin or a named pipe with a read-ahead thread
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#ifndef PIPEIN_H
+#define PIPEIN_H
+
+#include "soundinterface.h"
+#include "sampleformat.h"
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+/**
+ * @brief Reads interleaved stereo (I/Q) samples from stdin ("-") or a named
+ * pipe ("pipe:<path>")
+ *
+ * A reader thread keeps the pipe drained into a single producer, single
+ * consumer ring of several seconds, so a slow DSP block does not back
+ * pressure the feeding SDR and a scheduling hiccup of the feeder does not
+ * stall the DSP loop.
+ *
+ * When the ring is full the reader either waits (the feeder is blocked, no
+ * data is lost) or, with drop oldest, throws away the oldest samples to
+ * make room. Both cases are counted as overruns, a block the receiver had
+ * to wait for is counted as underrun.
+ */
+class CPipeIn : public CSoundInInterface
+{
+public:
+    CPipeIn();
+    virtual ~CPipeIn();
+
+    /**
+     * @brief Check if a device name is handled by this class
+     */
+    static bool IsPipe(const std::string& strDevice);
+
+    virtual void		Enumerate(std::vector<std::string>&, std::vector<std::string>&, std::string&) {}
+    virtual void		SetDev(std::string sNewDevice) {sCurrentDevice = sNewDevice;}
+    virtual std::string	GetDev() {return sCurrentDevice;}
+    virtual std::string	GetVersion() {return "Dream Pipe Reader";}
+
+    /**
+     * @brief Sample format of the stream, SMPFMT_AUTO is s16
+     */
+    void				SetSampleFormat(const ESampleFormat eNewFormat) {eSampleFormat = eNewFormat;}
+
+    /**
+     * @brief Ring size and full ring policy, applied with the next Init()
+     */
+    void				SetBuffering(const _REAL rNewSeconds, const bool bNewDropOldest);
+
+    virtual bool		Init(int iNewSampleRate, int iNewBufferSize, bool bNewBlocking);
+    virtual bool		Read(CVector<short>& psData);
+    virtual bool		ReadReal(CVector<_REAL>& vecrData);
+    virtual void		Close();
+
+    /**
+     * @brief Number of times the ring was full
+     */
+    unsigned long		GetOverruns() const {return iOverruns.load(std::memory_order_relaxed);}
+
+    /**
+     * @brief Number of blocks the receiver had to wait for
+     */
+    unsigned long		GetUnderruns() const {return iUnderruns.load(std::memory_order_relaxed);}
+
+    /**
+     * @brief Buffered input in seconds
+     */
+    _REAL				GetBufferedSeconds() const;
+
+protected:
+    void				ReaderLoop();
+    void				StartReader();
+    void				StopReader();
+
+    /* Bytes in the ring */
+    size_t				GetFill() const
+        {return iWritePos.load(std::memory_order_acquire) - iReadPos.load(std::memory_order_acquire);}
+
+    std::string			sCurrentDevice;
+    ESampleFormat		eSampleFormat;
+    _REAL				rBufferSeconds;
+    bool				bDropOldest;
+    int					iFd;
+    int					iSampleRate;
+    int					iBufferSize;
+    int					iFrameBytes;
+
+    /* Ring of raw bytes. The positions only ever grow, the index into the
+       ring is the position modulo its size. Dropping the oldest data moves
+       the read position from the reader thread, so the read position is
+       only advanced with compare and swap */
+    std::vector<unsigned char>	vecRing;
+    std::atomic<size_t>	iWritePos;
+    std::atomic<size_t>	iReadPos;
+
+    std::vector<unsigned char>	vecBlock;
+    CVector<_REAL>		vecrReadBuffer;
+
+    std::thread			ReaderThread;
+    std::atomic<bool>	bRunning;
+    std::atomic<bool>	bEndOfStream;
+
+    /* Only used for sleeping, the ring itself is lock free */
+    std::mutex			WaitMutex;
+    std::condition_variable	DataCond;
+    std::condition_variable	SpaceCond;
+
+    std::atomic<unsigned long>	iOverruns;
+    std::atomic<unsigned long>	iUnderruns;
+};
+
+#endif // PIPEIN_H
@@ -0,0 +1,98 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Audio output to stdout, a named pipe, a Unix domain socket or a shared
+ *  memory ring
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "pipeout.h"
+#include <cstdio>
+
+static const char STDOUT_DEVICE_NAME[] = "-";
+static const char PIPE_PREFIX[] = "pipe:";
+static const char SOCKET_PREFIX[] = "unix:";
+static const char SHM_PREFIX[] = "shm:";
+
+CPipeOut::CPipeOut() : CSoundOutInterface(), sCurrentDevice(), Sink(), iSampleRate(0)
+{
+}
+
+CPipeOut::~CPipeOut()
+{
+    Close();
+}
+
+bool CPipeOut::IsPipe(const std::string& strDevice)
+{
+    return (strDevice == STDOUT_DEVICE_NAME) ||
+           (strDevice.compare(0, sizeof(PIPE_PREFIX) - 1, PIPE_PREFIX) == 0) ||
+           (strDevice.compare(0, sizeof(SOCKET_PREFIX) - 1, SOCKET_PREFIX) == 0) ||
+           (strDevice.compare(0, sizeof(SHM_PREFIX) - 1, SHM_PREFIX) == 0);
+}
+
+bool CPipeOut::Init(int iNewSampleRate, int, bool)
+{
+    const bool bChanged = iSampleRate != iNewSampleRate;
+    iSampleRate = iNewSampleRate;
+
+    if (Sink.GetTarget().empty())
+    {
+        /* The sink takes paths of named pipes without prefix */
+        std::string strTarget = sCurrentDevice;
+        if (strTarget.compare(0, sizeof(PIPE_PREFIX) - 1, PIPE_PREFIX) == 0)
+            strTarget = strTarget.substr(sizeof(PIPE_PREFIX) - 1);
+        Sink.Open(strTarget);
+    }
+    if (bChanged)
+    {
+        fprintf(stderr, "PipeOut: %s stereo %s at %d Hz\n", sCurrentDevice.c_str(),
+                CSampleFormat::ToString(Sink.GetFormat()).c_str(), iSampleRate);
+    }
+    return bChanged;
+}
+
+bool CPipeOut::Write(CVector<short>& psData)
+{
+    /* true means the block didn't make it, like a sound card underrun */
+    if (psData.Size() == 0)
+        return false;
+    return !Sink.Write(&psData[0], psData.Size());
+}
+
+bool CPipeOut::WriteAudio(CVector<_AUDIO>& vecData)
+{
+    if (vecData.Size() == 0)
+        return false;
+    return !Sink.Write(&vecData[0], vecData.Size());
+}
+
+void CPipeOut::Close()
+{
+    if (Sink.GetDropped() > 0)
+    {
+        fprintf(stderr, "PipeOut: %s dropped %lu samples\n", sCurrentDevice.c_str(),
+                Sink.GetDropped());
+    }
+    Sink.Close();
+}
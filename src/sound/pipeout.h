@@ -0,0 +1,88 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Audio output to stdout, a named pipe, a Unix domain socket or a shared
+ *  memory ring
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+
+#ifndef PIPEOUT_H
+#define PIPEOUT_H
+
+#include "soundinterface.h"
+#include "sampleformat.h"
+#include "../util/PcmSink.h"
+#include <string>
+#include <vector>
+
+/**
+ * @brief Writes the decoded audio to stdout ("-"), a named pipe
+ * ("pipe:<path>"), a Unix domain socket ("unix:<path>") or a shared memory
+ * ring ("shm:<name>") for a parent process to pick up
+ *
+ * Headless counterpart of a sound card, the output device of CWriteData.
+ * The stream is interleaved stereo at the audio sample rate, s16 or f32.
+ * f32 carries the decoded audio without clipping.
+ * Writing never blocks the receiver: blocks the consumer doesn't take in
+ * time are dropped and counted, see CPcmSink.
+ */
+class CPipeOut : public CSoundOutInterface
+{
+public:
+    CPipeOut();
+    virtual ~CPipeOut();
+
+    /**
+     * @brief Check if a device name is handled by this class
+     */
+    static bool IsPipe(const std::string& strDevice);
+
+    virtual void		Enumerate(std::vector<std::string>&, std::vector<std::string>&, std::string&) {}
+    virtual void		SetDev(std::string sNewDevice) {sCurrentDevice = sNewDevice;}
+    virtual std::string	GetDev() {return sCurrentDevice;}
+    virtual std::string	GetVersion() {return "Dream Pipe Writer";}
+
+    /**
+     * @brief Sample format of the stream, SMPFMT_S16 (default) or SMPFMT_F32
+     */
+    void				SetSampleFormat(const ESampleFormat eNewFormat) {Sink.SetFormat(eNewFormat);}
+
+    virtual bool		Init(int iNewSampleRate, int iNewBufferSize, bool bNewBlocking);
+    virtual bool		Write(CVector<short>& psData);
+    virtual bool		WriteAudio(CVector<_AUDIO>& vecData);
+    virtual void		Close();
+
+    /**
+     * @brief Number of samples dropped because the consumer was too slow
+     * or not there
+     */
+    unsigned long		GetDropped() const {return Sink.GetDropped();}
+
+protected:
+    std::string			sCurrentDevice;
+    CPcmSink			Sink;
+    int					iSampleRate;
+};
+
+#endif // PIPEOUT_H
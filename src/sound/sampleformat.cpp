@@ -0,0 +1,139 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Sample formats of raw input streams and their conversion to _REAL
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "sampleformat.h"
+#include <cstring>
+
+static const struct
+{
+    ESampleFormat   eFormat;
+    const char*     szName;
+    int             iBytes;
+} SampleFormats[] = {
+    { SMPFMT_S16,  "s16",  2 },
+    { SMPFMT_S24,  "s24",  3 },
+    { SMPFMT_S32,  "s32",  4 },
+    { SMPFMT_F32,  "f32",  4 },
+    { SMPFMT_CF32, "cf32", 4 },
+    { SMPFMT_CS8,  "cs8",  1 },
+    { SMPFMT_CU8,  "cu8",  1 }
+};
+
+static const int NUM_SAMPLE_FORMATS = int(sizeof(SampleFormats) / sizeof(SampleFormats[0]));
+
+ESampleFormat CSampleFormat::FromString(const std::string& strName)
+{
+    for (int i = 0; i < NUM_SAMPLE_FORMATS; i++)
+    {
+        if (strName == SampleFormats[i].szName)
+            return SampleFormats[i].eFormat;
+    }
+    return SMPFMT_AUTO;
+}
+
+std::string CSampleFormat::ToString(const ESampleFormat eFormat)
+{
+    for (int i = 0; i < NUM_SAMPLE_FORMATS; i++)
+    {
+        if (eFormat == SampleFormats[i].eFormat)
+            return SampleFormats[i].szName;
+    }
+    return "auto";
+}
+
+int CSampleFormat::GetBytesPerSample(const ESampleFormat eFormat)
+{
+    for (int i = 0; i < NUM_SAMPLE_FORMATS; i++)
+    {
+        if (eFormat == SampleFormats[i].eFormat)
+            return SampleFormats[i].iBytes;
+    }
+    return 2;
+}
+
+bool CSampleFormat::IsComplex(const ESampleFormat eFormat)
+{
+    return (eFormat == SMPFMT_CF32) || (eFormat == SMPFMT_CS8) || (eFormat == SMPFMT_CU8);
+}
+
+void CSampleFormat::Convert(const ESampleFormat eFormat, const unsigned char* pIn,
+                            _REAL* pOut, const int iNumSamples)
+{
+    int i;
+
+    /* Assemble the samples byte by byte, independent of the alignment of
+       the input and the byte order of the host */
+    switch (eFormat)
+    {
+    case SMPFMT_AUTO:
+    case SMPFMT_S16:
+        for (i = 0; i < iNumSamples; i++, pIn += 2)
+            pOut[i] = _REAL(int16_t(uint16_t(pIn[0] | (pIn[1] << 8))));
+        break;
+
+    case SMPFMT_S24:
+        for (i = 0; i < iNumSamples; i++, pIn += 3)
+        {
+            const int32_t iSample = int32_t(uint32_t(pIn[0] << 8) | uint32_t(pIn[1] << 16) |
+                                            (uint32_t(pIn[2]) << 24));
+            pOut[i] = _REAL(iSample) / 65536.0;
+        }
+        break;
+
+    case SMPFMT_S32:
+        for (i = 0; i < iNumSamples; i++, pIn += 4)
+        {
+            const int32_t iSample = int32_t(uint32_t(pIn[0]) | uint32_t(pIn[1] << 8) |
+                                            uint32_t(pIn[2] << 16) | (uint32_t(pIn[3]) << 24));
+            pOut[i] = _REAL(iSample) / 65536.0;
+        }
+        break;
+
+    case SMPFMT_F32:
+    case SMPFMT_CF32:
+        for (i = 0; i < iNumSamples; i++, pIn += 4)
+        {
+            const uint32_t iBits = uint32_t(pIn[0]) | uint32_t(pIn[1] << 8) |
+                                   uint32_t(pIn[2] << 16) | (uint32_t(pIn[3]) << 24);
+            float fSample;
+            memcpy(&fSample, &iBits, sizeof(fSample));
+            pOut[i] = _REAL(fSample) * 32768.0;
+        }
+        break;
+
+    case SMPFMT_CS8:
+        for (i = 0; i < iNumSamples; i++)
+            pOut[i] = _REAL(int8_t(pIn[i])) * 256.0;
+        break;
+
+    case SMPFMT_CU8:
+        /* RTL-SDR style, zero at 127.5 */
+        for (i = 0; i < iNumSamples; i++)
+            pOut[i] = (_REAL(pIn[i]) - 127.5) * 256.0;
+        break;
+    }
+}
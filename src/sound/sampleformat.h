@@ -0,0 +1,81 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Sample formats of raw input streams and their conversion to _REAL
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#ifndef SAMPLEFORMAT_H
+#define SAMPLEFORMAT_H
+
+#include "../GlobalDefinitions.h"
+#include <string>
+
+/* Little endian samples, two channels (I/Q) for the complex formats */
+enum ESampleFormat { SMPFMT_AUTO, SMPFMT_S16, SMPFMT_S24, SMPFMT_S32, SMPFMT_F32,
+                     SMPFMT_CF32, SMPFMT_CS8, SMPFMT_CU8
+                   };
+
+/**
+ * @brief Helpers for the raw sample formats produced by SDR tools
+ *
+ * Converted samples are scaled to the 16 bit range the receiver works
+ * with, so a full scale float or 8 bit input gives the same levels as a
+ * full scale 16 bit input, without losing the extra resolution.
+ */
+class CSampleFormat
+{
+public:
+    /**
+     * @brief Format from its name ("s16", "cf32", ...), SMPFMT_AUTO if
+     * unknown
+     */
+    static ESampleFormat FromString(const std::string& strName);
+
+    /**
+     * @brief Name of a format, "auto" for SMPFMT_AUTO
+     */
+    static std::string ToString(const ESampleFormat eFormat);
+
+    /**
+     * @brief Bytes per sample of one channel
+     */
+    static int GetBytesPerSample(const ESampleFormat eFormat);
+
+    /**
+     * @brief Check if the format always carries I and Q
+     */
+    static bool IsComplex(const ESampleFormat eFormat);
+
+    /**
+     * @brief Convert raw little endian samples
+     * @param eFormat Format of the input, must not be SMPFMT_AUTO
+     * @param pIn Raw input, iNumSamples * GetBytesPerSample() bytes
+     * @param pOut Output, iNumSamples values
+     * @param iNumSamples Number of samples (not frames)
+     */
+    static void Convert(const ESampleFormat eFormat, const unsigned char* pIn,
+                        _REAL* pOut, const int iNumSamples);
+};
+
+#endif // SAMPLEFORMAT_H
@@ -4,6 +4,31 @@ CSoundInInterface::~CSoundInInterface()
 {
 }
 
+bool CSoundInInterface::ReadReal(CVector<_REAL>& vecrData)
+{
+    const int iSize = vecrData.Size();
+    if (vecsReadBuffer.Size() != iSize)
+        vecsReadBuffer.Init(iSize);
+
+    const bool bBad = Read(vecsReadBuffer);
+
+    for (int i = 0; i < iSize; i++)
+        vecrData[i] = _REAL(vecsReadBuffer[i]);
+
+    return bBad;
+}
+
 CSoundOutInterface::~CSoundOutInterface()
 {
 }
+
+bool CSoundOutInterface::WriteAudio(CVector<_AUDIO>& vecData)
+{
+    const int iSize = vecData.Size();
+    if (vecsWriteBuffer.Size() != iSize)
+        vecsWriteBuffer.Init(iSize);
+
+    Audio2Sample(vecData.data(), vecsWriteBuffer.data(), iSize);
+
+    return Write(vecsWriteBuffer);
+}
@@ -43,6 +43,13 @@ public:
     virtual void     Close()=0;
 	virtual std::string	GetVersion() = 0;
 
+    /* Read interleaved stereo samples in the 16 bit range. Sources with
+       more resolution than 16 bit override this, the default converts the
+       result of Read() */
+    virtual bool ReadReal(CVector<_REAL>& vecrData);
+
+protected:
+    CVector<short>	vecsReadBuffer;
 };
 
 class CSoundOutInterface : public CSelectionInterface
@@ -55,6 +62,14 @@ public:
     virtual bool Write(CVector<short>& psData)=0;
     virtual void     Close()=0;
 	virtual std::string	GetVersion() = 0;
+
+    /* Write decoded interleaved stereo audio in the 16 bit range. Outputs
+       which take floats override this, the default clips the audio to 16
+       bit and calls Write() */
+    virtual bool WriteAudio(CVector<_AUDIO>& vecData);
+
+protected:
+    CVector<short>	vecsWriteBuffer;
 };
 
 #endif
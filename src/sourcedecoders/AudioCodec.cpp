@@ -94,6 +94,31 @@ CAudioCodec::GetDecoder(CAudioParam::EAudCod eAudioCoding, bool bCanReturnNullPt
     return bCanReturnNullPtr ? nullptr : CodecList[0]; // ie the null codec
 }
 
+CAudioCodec*
+CAudioCodec::CreateDecoder(CAudioParam::EAudCod eAudioCoding)
+{
+	/* Same order of preference as in InitCodecList() */
+	CAudioCodec* pCodec;
+#ifdef HAVE_LIBFDK_AAC
+	pCodec = new FdkAacCodec;
+	if (pCodec->CanDecode(eAudioCoding))
+		return pCodec;
+	delete pCodec;
+#endif
+	pCodec = new AacCodec;
+	if (pCodec->CanDecode(eAudioCoding))
+		return pCodec;
+	delete pCodec;
+
+	pCodec = new OpusCodec;
+	if (pCodec->CanDecode(eAudioCoding))
+		return pCodec;
+	delete pCodec;
+
+	/* Fallback to null codec */
+	return new NullCodec;
+}
+
 CAudioCodec*
 CAudioCodec::GetEncoder(CAudioParam::EAudCod eAudioCoding, bool bCanReturnNullPtr)
 {
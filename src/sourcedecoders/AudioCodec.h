@@ -72,6 +72,9 @@ public:
 	static void UnrefCodecList();
 	static CAudioCodec* GetDecoder(CAudioParam::EAudCod eAudioCoding, bool bCanReturnNullPtr=false);
 	static CAudioCodec* GetEncoder(CAudioParam::EAudCod eAudioCoding, bool bCanReturnNullPtr=false);
+	/* New decoder instance owned by the caller, for decoding several services
+	   at the same time (the instances of the codec list are shared) */
+	static CAudioCodec* CreateDecoder(CAudioParam::EAudCod eAudioCoding);
     virtual void openFile(const CParameter& Parameters);
     virtual void closeFile();
     virtual void writeFile(const std::vector<uint8_t>& audio_frame);
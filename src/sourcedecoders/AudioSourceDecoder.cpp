@@ -45,8 +45,9 @@
 /* Implementation *************************************************************/
 
 CAudioSourceDecoder::CAudioSourceDecoder()
-    :	bWriteToFile(false), TextMessage(false),
-      init_LPF(false), do_LPF(false), bUseReverbEffect(true), codec(nullptr)
+    :	bWriteToFile(false), iFixedService(-1), bPublishStatus(false), bOwnCodec(false), TextMessage(false),
+      init_LPF(false), do_LPF(false), bUseReverbEffect(true), codec(nullptr),
+      pOwnCodec(nullptr)
 {
     /* Initialize Audio Codec List */
     CAudioCodec::InitCodecList();
@@ -59,6 +60,12 @@ CAudioSourceDecoder::CAudioSourceDecoder()
 
 CAudioSourceDecoder::~CAudioSourceDecoder()
 {
+    if (pOwnCodec != nullptr)
+    {
+        pOwnCodec->DecClose();
+        delete pOwnCodec;
+    }
+
     /* Unreference Audio Codec List */
     CAudioCodec::UnrefCodecList();
 }
@@ -70,11 +77,20 @@ CAudioSourceDecoder::ProcessDataInternal(CParameter & Parameters)
 {
     bool bCurBlockOK;
     bool bGoodValues = false;
+    const bool bFixed = iFixedService >= 0;
 
-
+    /* Global audio status: the main decoder, or the fixed service decoder
+       standing in for it */
     Parameters.Lock();
-    Parameters.vecbiAudioFrameStatus.Init(0);
-    Parameters.vecbiAudioFrameStatus.ResetBitAccess();
+    const bool bPublish = !bFixed ||
+        (bPublishStatus && (iFixedService == Parameters.GetCurSelAudioService()));
+    if (bPublish)
+    {
+        if (bFixed)
+            Parameters.audiodecoder = audiodecoder;
+        Parameters.vecbiAudioFrameStatus.Init(0);
+        Parameters.vecbiAudioFrameStatus.ResetBitAccess();
+    }
     Parameters.Unlock();
 
     /* Check if something went wrong in the initialization routine */
@@ -102,10 +118,10 @@ CAudioSourceDecoder::ProcessDataInternal(CParameter & Parameters)
         return;
     }
 
-    /* Reset bit extraction access */
-    (*pvecInputData).ResetBitAccess();
+    /* Pack the audio super frame once, the parser reads whole bytes */
+    AudioSuperFrameStream.Pack(*pvecInputData, iInputBlockSize);
 
-    bGoodValues = pAudioSuperFrame->parse(*pvecInputData);
+    bGoodValues = pAudioSuperFrame->parse(AudioSuperFrameStream);
 
     /* Audio decoding ******************************************************** */
     /* Init output block size to zero, this variable is also used for
@@ -191,24 +207,37 @@ CAudioSourceDecoder::ProcessDataInternal(CParameter & Parameters)
             if (!bCodecUpdated)
             {
                 bCodecUpdated = true;
+                if (bFixed)
+                {
+                    codec->DecUpdate(FixedAudioParam);
+                }
+                else
+                {
+                    Parameters.Lock();
+                    int iCurSelAudioServ = Parameters.GetCurSelAudioService();
+                    codec->DecUpdate(Parameters.Service[unsigned(iCurSelAudioServ)].AudioParam);
+                    Parameters.Unlock();
+                }
+            }
+            /* OPH: add frame status to vector for RSCI */
+            if (bPublish)
+            {
                 Parameters.Lock();
-                int iCurSelAudioServ = Parameters.GetCurSelAudioService();
-                codec->DecUpdate(Parameters.Service[unsigned(iCurSelAudioServ)].AudioParam);
+                Parameters.vecbiAudioFrameStatus.Add(eDecError == CAudioCodec::DECODER_ERROR_OK ? 0 : 1);
                 Parameters.Unlock();
             }
-            /* OPH: add frame status to vector for RSCI */
-            Parameters.Lock();
-            Parameters.vecbiAudioFrameStatus.Add(eDecError == CAudioCodec::DECODER_ERROR_OK ? 0 : 1);
-            Parameters.Unlock();
         }
         else
         {
             /* DRM super-frame header was wrong, set flag to "bad block" */
             bCurBlockOK = false;
             /* OPH: update audio status vector for RSCI */
-            Parameters.Lock();
-            Parameters.vecbiAudioFrameStatus.Add(1);
-            Parameters.Unlock();
+            if (bPublish)
+            {
+                Parameters.Lock();
+                Parameters.vecbiAudioFrameStatus.Add(1);
+                Parameters.Unlock();
+            }
         }
 
         // This code is independent of particular audio source type and should work with all codecs
@@ -222,44 +251,25 @@ CAudioSourceDecoder::ProcessDataInternal(CParameter & Parameters)
             iNumCorDecAudio++;
         }
 
+        if (bPublish)
         {
-            double l = 0.0, r = 0.0;
-            for(int i=0; i<vecTempResBufOutCurLeft.Size(); i++) {
-                l += vecTempResBufOutCurLeft[i];
-                r += vecTempResBufOutCurRight[i];
-            }
-            //cerr << "energy after resampling and reverb left " << (l/vecTempResBufOutCurLeft.Size()) << " right " << (l/vecTempResBufOutCurRight.Size()) << endl;
+            Parameters.Lock();
+            Parameters.ReceiveStatus.SLAudio.SetStatus(status);
+            Parameters.ReceiveStatus.LLAudio.SetStatus(status);
+            Parameters.AudioComponentStatus[unsigned(Parameters.GetCurSelAudioService())].SetStatus(status);
+            Parameters.Unlock();
         }
 
-        Parameters.Lock();
-        Parameters.ReceiveStatus.SLAudio.SetStatus(status);
-        Parameters.ReceiveStatus.LLAudio.SetStatus(status);
-        Parameters.AudioComponentStatus[unsigned(Parameters.GetCurSelAudioService())].SetStatus(status);
-        Parameters.Unlock();
-
-        /* Conversion from _REAL to _SAMPLE with special function */
+        /* Interleave, the audio stays float without clipping. It is only
+           converted to _SAMPLE by the output which needs it */
         for (int i = 0; i < iResOutBlockSize; i++)
         {
-            (*pvecOutputData)[iOutputBlockSize + i * 2] = Real2Sample(vecTempResBufOutCurLeft[i]);	/* Left channel */
-            (*pvecOutputData)[iOutputBlockSize + i * 2 + 1] = Real2Sample(vecTempResBufOutCurRight[i]);	/* Right channel */
+            (*pvecOutputData)[iOutputBlockSize + i * 2] = _AUDIO(vecTempResBufOutCurLeft[i]);	/* Left channel */
+            (*pvecOutputData)[iOutputBlockSize + i * 2 + 1] = _AUDIO(vecTempResBufOutCurRight[i]);	/* Right channel */
         }
 
         /* Add new block to output block size ("* 2" for stereo output block) */
         iOutputBlockSize += iResOutBlockSize * 2;
-
-        if(iOutputBlockSize==0) {
-            //cerr << "iOutputBlockSize is zero" << endl;
-        }
-        else {
-            double d=0.0;
-            for (int i = 0; i < iOutputBlockSize; i++)
-            {
-                double n = (*pvecOutputData)[i];
-                d += n*n;
-            }
-            //cerr << "energy after converting " << iOutputBlockSize << " samples back to int " << sqrt(d/iOutputBlockSize) << endl;
-        }
-
     }
 }
 
@@ -280,6 +290,8 @@ CAudioSourceDecoder::InitInternal(CParameter & Parameters)
     /* Set audiodecoder to empty string - means "unknown" and "can't decode" to GUI */
     audiodecoder = "";
 
+    const bool bFixed = iFixedService >= 0;
+
     try
     {
         Parameters.Lock();
@@ -290,11 +302,15 @@ CAudioSourceDecoder::InitInternal(CParameter & Parameters)
         /* Init "audio was ok" flag */
         bAudioWasOK = true;
 
-         /* Get number of total input bits for this module */
-         iInputBlockSize = Parameters.iNumAudioDecoderBits;
+        /* Get number of total input bits for this module. A decoder for a
+           fixed service gets the whole stream of that service */
+        if (bFixed)
+            iInputBlockSize = Parameters.GetStreamLen(Parameters.Service[unsigned(iFixedService)].AudioParam.iStreamID) * SIZEOF__BYTE;
+        else
+            iInputBlockSize = Parameters.iNumAudioDecoderBits;
 
         /* Get current selected audio service */
-        CService& service = Parameters.Service[unsigned(Parameters.GetCurSelAudioService())];
+        CService& service = Parameters.Service[unsigned(GetServiceIndex(Parameters))];
 
         /* Get current audio coding */
         eAudioCoding = service.AudioParam.eAudioCoding;
@@ -316,7 +332,7 @@ CAudioSourceDecoder::InitInternal(CParameter & Parameters)
             bTextMessageUsed = true;
 
             /* Get a pointer to the string */
-            TextMessage.Init(&service.AudioParam.strTextMessage);
+            TextMessage.Init((bFixed && !bPublishStatus) ? &strFixedTextMessage : &service.AudioParam.strTextMessage);
 
             /* Init vector for text message bytes */
             vecbiTextMessBuf.Init(SIZEOF__BYTE * NUM_BYTES_TEXT_MESS_IN_AUD_STR);
@@ -338,12 +354,21 @@ CAudioSourceDecoder::InitInternal(CParameter & Parameters)
             pAudioSuperFrame = p;
         }
         /* Get decoder instance */
-        codec = CAudioCodec::GetDecoder(eAudioCoding);
+        if (bFixed || bOwnCodec)
+        {
+            delete pOwnCodec;
+            pOwnCodec = CAudioCodec::CreateDecoder(eAudioCoding);
+            codec = pOwnCodec;
+            if (bFixed)
+                FixedAudioParam = service.AudioParam;
+        }
+        else
+            codec = CAudioCodec::GetDecoder(eAudioCoding);
 
         if (codec->CanDecode(eAudioCoding))
             audiodecoder = codec->DecGetVersion();
 
-        if(bWriteToFile)
+        if(bWriteToFile && !bFixed)
         {
             codec->openFile(Parameters);
         }
@@ -372,7 +397,8 @@ CAudioSourceDecoder::InitInternal(CParameter & Parameters)
         }
 
         /* set string for GUI */
-        Parameters.audiodecoder = audiodecoder;
+        if (!bFixed)
+            Parameters.audiodecoder = audiodecoder;
 
         /* Set number of Audio frames for log file */
         // TODO Parameters.iNumAudioFrames = iNumAudioFrames;
@@ -401,7 +427,7 @@ CAudioSourceDecoder::InitInternal(CParameter & Parameters)
         //cerr << "output block size per channel " << iResOutBlockSize << " = samples " << iLenDecOutPerChan << " * " << Parameters.GetAudSampleRate() << " / " << iAudioSampleRate << endl;
 
         /* Additional buffers needed for resampling since we need conversation
-           between _REAL and _SAMPLE. We have to init the buffers with
+           between _REAL and _AUDIO. We have to init the buffers with
            zeros since it can happen, that we have bad CRC right at the
            start of audio blocks */
         vecTempResBufInLeft.Init(iLenDecOutPerChan, 0.0);
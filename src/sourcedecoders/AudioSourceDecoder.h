@@ -47,7 +47,7 @@
 
 /* Classes ********************************************************************/
 
-class CAudioSourceDecoder : public CReceiverModul<_BINARY, _SAMPLE>
+class CAudioSourceDecoder : public CReceiverModul<_BINARY, _AUDIO>
 {
 public:
     CAudioSourceDecoder();
@@ -73,11 +73,40 @@ public:
         return bUseReverbEffect;
     }
 
+    /* Decode the given service instead of the current selection (-1: current
+       selection). Such a decoder uses its own codec instance and does not
+       touch the global audio status, so several can run at the same time */
+    void SetFixedService(const int iNewService) {
+        iFixedService = iNewService;
+        SetInitFlag();
+    }
+    int GetFixedService() const {
+        return iFixedService;
+    }
+
+    /* Let a fixed service decoder write the text message of its service and,
+       while its service is the current selection, the global audio status.
+       Only for use while the main decoder is not running */
+    void SetPublishStatus(const bool bNewPublish) {
+        bPublishStatus = bNewPublish;
+        SetInitFlag();
+    }
+
+    /* Use an own codec instance instead of the shared one, for several
+       receivers running in the same process */
+    void SetOwnCodec(const bool bNewOwnCodec) {
+        bOwnCodec = bNewOwnCodec;
+        SetInitFlag();
+    }
+
     bool bWriteToFile;
 
 protected:
 
     /* General */
+    int iFixedService;
+    bool bPublishStatus;
+    bool bOwnCodec;
     bool DoNotProcessData;
     bool DoNotProcessAudDecoder;
     int iNumCorDecAudio;
@@ -112,9 +141,13 @@ protected:
     bool bUseReverbEffect;
 
     AudioSuperFrame* pAudioSuperFrame;
+    CBitStream AudioSuperFrameStream;
 
     CAudioParam::EAudCod eAudioCoding;
     CAudioCodec* codec;
+    CAudioCodec* pOwnCodec;
+    CAudioParam FixedAudioParam;
+    std::string strFixedTextMessage;
     int iBadBlockCount;
     std::string audiodecoder;
     bool bCanDecodeAAC;
@@ -124,6 +157,9 @@ protected:
     virtual void InitInternal(CParameter& Parameters);
     virtual void ProcessDataInternal(CParameter& Parameters);
     void CloseDecoder();
+    int GetServiceIndex(const CParameter& Parameters) const {
+        return iFixedService >= 0 ? iFixedService : Parameters.GetCurSelAudioService();
+    }
     Reverb reverb;
 };
 
@@ -118,7 +118,7 @@ public:
 					CVectorEx<_BINARY>* pvecOutputData, int &iInputBlockSize, int &iOutputBlockSize);
 };
 
-class CAudioSourceEncoderRx : public CReceiverModul<_SAMPLE, _BINARY>
+class CAudioSourceEncoderRx : public CReceiverModul<_AUDIO, _BINARY>
 {
 public:
 	CAudioSourceEncoderRx() {}
@@ -126,15 +126,19 @@ public:
 
 protected:
 	CAudioSourceEncoderImplementation AudioSourceEncoderImpl;
+	/* The encoders take 16 bit samples */
+	CVectorEx<_SAMPLE>	vecsInputData;
 
 	virtual void InitInternal(CParameter& Parameters)
 	{
 		AudioSourceEncoderImpl.InitInternalRx(Parameters, iInputBlockSize, iOutputBlockSize);
+		vecsInputData.Init(iInputBlockSize);
 	}
 
 	virtual void ProcessDataInternal(CParameter& Parameters)
 	{
-		AudioSourceEncoderImpl.ProcessDataInternal(Parameters, pvecInputData, pvecOutputData, iInputBlockSize, iOutputBlockSize);
+		Audio2Sample(pvecInputData->data(), vecsInputData.data(), iInputBlockSize);
+		AudioSourceEncoderImpl.ProcessDataInternal(Parameters, &vecsInputData, pvecOutputData, iInputBlockSize, iOutputBlockSize);
 	}
 };
 
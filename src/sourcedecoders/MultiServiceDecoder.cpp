@@ -0,0 +1,370 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Decoding of all services of the multiplex at the same time. One audio
+ *  source decoder or data decoder per MSC stream, independent of the
+ *  service selected for listening. Also used to keep the audio decoders of
+ *  all services warm for instant service switching
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "MultiServiceDecoder.h"
+#include <cstdio>
+#include <algorithm>
+
+CMultiServiceDecoder::CMultiServiceDecoder()
+    : vecStreamBuf(MAX_NUM_STREAMS), vecDecoders(MAX_NUM_STREAMS),
+      strOutputPattern(), bAllServices(false), bWarmAudio(false),
+      bStandalone(false), iOutputBufferSize(0), bDoInit(true)
+{
+}
+
+CMultiServiceDecoder::~CMultiServiceDecoder()
+{
+}
+
+void CMultiServiceDecoder::SetOutputPattern(const std::string& strNewPattern)
+{
+    strOutputPattern = strNewPattern;
+
+    /* Open the new targets with the next rescan */
+    for (size_t i = 0; i < vecDecoders.size(); i++)
+        vecDecoders[i].reset();
+    bDoInit = true;
+}
+
+void CMultiServiceDecoder::SetMode(const bool bNewAllServices, const bool bNewWarmAudio)
+{
+    if ((bAllServices == bNewAllServices) && (bWarmAudio == bNewWarmAudio))
+        return;
+
+    bAllServices = bNewAllServices;
+    bWarmAudio = bNewWarmAudio;
+
+    for (size_t i = 0; i < vecDecoders.size(); i++)
+        vecDecoders[i].reset();
+    bDoInit = true;
+}
+
+void CMultiServiceDecoder::SetStandalone(const bool bNewStandalone)
+{
+    if (bStandalone == bNewStandalone)
+        return;
+
+    bStandalone = bNewStandalone;
+
+    for (size_t i = 0; i < vecDecoders.size(); i++)
+        vecDecoders[i].reset();
+    bDoInit = true;
+}
+
+void CMultiServiceDecoder::Clear()
+{
+    for (size_t i = 0; i < vecStreamBuf.size(); i++)
+        vecStreamBuf[i].Clear();
+}
+
+void CMultiServiceDecoder::AddTasks(CParameter& Parameters,
+                                    std::vector<std::function<void()> >& vecTasks)
+{
+    if (bDoInit)
+    {
+        Rebuild(Parameters);
+        bDoInit = false;
+    }
+
+    for (size_t i = 0; i < vecDecoders.size(); i++)
+    {
+        CStreamDecoder* pDecoder = vecDecoders[i].get();
+        CSingleBuffer<_BINARY>* pInput = &vecStreamBuf[i];
+
+        if (pDecoder == nullptr)
+        {
+            /* Nobody reads this stream */
+            pInput->Clear();
+            continue;
+        }
+
+        pDecoder->bEnoughData = false;
+        vecTasks.push_back([pDecoder, pInput, &Parameters]() {
+            pDecoder->Process(Parameters, *pInput);
+        });
+    }
+}
+
+bool CMultiServiceDecoder::GetEnoughData() const
+{
+    for (size_t i = 0; i < vecDecoders.size(); i++)
+    {
+        if (vecDecoders[i] && vecDecoders[i]->bEnoughData)
+            return true;
+    }
+    return false;
+}
+
+CMultiServiceDecoder::CStreamDecoder* CMultiServiceDecoder::FindAudioDecoder(const int iService)
+{
+    for (size_t i = 0; i < vecDecoders.size(); i++)
+    {
+        if (vecDecoders[i] && vecDecoders[i]->bAudio && (vecDecoders[i]->iService == iService))
+            return vecDecoders[i].get();
+    }
+    return nullptr;
+}
+
+bool CMultiServiceDecoder::GetServiceAudio(const int iService, CBuffer<_AUDIO>& Output)
+{
+    CStreamDecoder* pDecoder = FindAudioDecoder(iService);
+    if ((pDecoder == nullptr) || pDecoder->Ring.empty() || (iOutputBufferSize == 0))
+        return false;
+
+    /* Same size the main audio decoder would use, keeps the content if
+       unchanged */
+    Output.Init(iOutputBufferSize);
+
+    CVectorEx<_AUDIO>* pvecOutput = Output.QueryWriteBuffer();
+    int iNumSamples = pvecOutput->Size() - Output.GetFillLevel();
+    if (iNumSamples > int(pDecoder->Ring.size()))
+        iNumSamples = int(pDecoder->Ring.size());
+
+    /* Whole stereo frames only */
+    iNumSamples &= ~1;
+    if (iNumSamples <= 0)
+        return false;
+
+    std::copy(pDecoder->Ring.begin(), pDecoder->Ring.begin() + iNumSamples, pvecOutput->begin());
+    pDecoder->Ring.erase(pDecoder->Ring.begin(), pDecoder->Ring.begin() + iNumSamples);
+    Output.Put(iNumSamples);
+
+    return true;
+}
+
+int CMultiServiceDecoder::GetNumCorDecAudio(const int iService)
+{
+    CStreamDecoder* pDecoder = FindAudioDecoder(iService);
+    if (pDecoder == nullptr)
+        return 0;
+    return pDecoder->pAudioDecoder->GetNumCorDecAudio();
+}
+
+CDataDecoder* CMultiServiceDecoder::GetDataDecoder(const int iService)
+{
+    for (size_t i = 0; i < vecDecoders.size(); i++)
+    {
+        if (vecDecoders[i] && !vecDecoders[i]->bAudio && (vecDecoders[i]->iService == iService))
+            return vecDecoders[i]->pDataDecoder.get();
+    }
+    return nullptr;
+}
+
+void CMultiServiceDecoder::GetOutputStatus(std::vector<COutputStatus>& vecStatus) const
+{
+    vecStatus.clear();
+    for (size_t i = 0; i < vecDecoders.size(); i++)
+    {
+        const CStreamDecoder* pDecoder = vecDecoders[i].get();
+        if ((pDecoder == nullptr) || !pDecoder->bAudio || pDecoder->Sink.GetTarget().empty())
+            continue;
+
+        COutputStatus Status;
+        Status.iService = pDecoder->iService;
+        Status.strTarget = pDecoder->Sink.GetTarget();
+        Status.bOpen = pDecoder->Sink.IsOpen();
+        Status.iDropped = pDecoder->Sink.GetDropped();
+        vecStatus.push_back(Status);
+    }
+}
+
+int CMultiServiceDecoder::GetNumDecoders() const
+{
+    int iNum = 0;
+    for (size_t i = 0; i < vecDecoders.size(); i++)
+    {
+        if (vecDecoders[i])
+            iNum++;
+    }
+    return iNum;
+}
+
+void CMultiServiceDecoder::Rebuild(CParameter& Parameters)
+{
+    Parameters.Lock();
+
+    /* Ring and output buffer: one superframe (400 ms) of stereo audio, the
+       output buffer twice that like in the audio source decoder */
+    const int iRingSize = int(_REAL(Parameters.GetAudSampleRate()) * 0.4) * 2;
+    iOutputBufferSize = bWarmAudio ? 2 * iRingSize : 0;
+
+    /* The main data decoder already takes care of this stream */
+    const int iMainDataStream = bStandalone ? STREAM_ID_NOT_USED :
+        Parameters.Service[size_t(Parameters.GetCurSelDataService())].DataParam.iStreamID;
+
+    for (int iStream = 0; iStream < MAX_NUM_STREAMS; iStream++)
+    {
+        int iService = -1;
+        bool bAudio = false;
+
+        /* An audio service has priority over a data component in the same
+           stream */
+        for (size_t i = 0; i < Parameters.Service.size(); i++)
+        {
+            const CService& service = Parameters.Service[i];
+            if (service.IsActive() && (service.eAudDataFlag == CService::SF_AUDIO) &&
+                (service.AudioParam.iStreamID == iStream))
+            {
+                iService = int(i);
+                bAudio = true;
+                break;
+            }
+        }
+
+        if ((iService < 0) && bAllServices && (iStream != iMainDataStream))
+        {
+            for (size_t i = 0; i < Parameters.Service.size(); i++)
+            {
+                const CService& service = Parameters.Service[i];
+                if (service.IsActive() && (service.DataParam.iStreamID == iStream) &&
+                    (service.DataParam.ePacketModInd == CDataParam::PM_PACKET_MODE))
+                {
+                    iService = int(i);
+                    break;
+                }
+            }
+        }
+
+        std::unique_ptr<CStreamDecoder>& pDecoder = vecDecoders[size_t(iStream)];
+
+        if (iService < 0)
+        {
+            if (pDecoder)
+                fprintf(stderr, "MultiServiceDecoder: stream %d not used any more\n", iStream);
+            pDecoder.reset();
+            continue;
+        }
+
+        CService& service = Parameters.Service[size_t(iService)];
+        const int iStreamLen = Parameters.GetStreamLen(iStream);
+
+        /* Keep decoders of unchanged services running */
+        if (pDecoder && (pDecoder->iService == iService) && (pDecoder->bAudio == bAudio) &&
+            (pDecoder->iStreamLen == iStreamLen))
+        {
+            if (bAudio ? !(pDecoder->AudioParam != service.AudioParam) :
+                         !(pDecoder->DataParam != service.DataParam))
+            {
+                pDecoder->iRingSize = bWarmAudio ? size_t(iRingSize) : 0;
+                continue;
+            }
+        }
+
+        pDecoder.reset(new CStreamDecoder);
+        pDecoder->iService = iService;
+        pDecoder->bAudio = bAudio;
+        pDecoder->iStreamLen = iStreamLen;
+        pDecoder->AudioParam = service.AudioParam;
+        pDecoder->DataParam = service.DataParam;
+
+        if (bAudio)
+        {
+            pDecoder->pAudioDecoder.reset(new CAudioSourceDecoder);
+            pDecoder->pAudioDecoder->SetFixedService(iService);
+            pDecoder->pAudioDecoder->SetPublishStatus(bWarmAudio || bStandalone);
+            pDecoder->iRingSize = bWarmAudio ? size_t(iRingSize) : 0;
+
+            if (bAllServices && !strOutputPattern.empty())
+                pDecoder->Sink.Open(GetOutputTarget(iService, service.iServiceID));
+        }
+        else
+        {
+            pDecoder->pDataDecoder.reset(new CDataDecoder);
+            pDecoder->pDataDecoder->SetFixedService(iService);
+        }
+
+        vecStreamBuf[size_t(iStream)].Clear();
+
+        fprintf(stderr, "MultiServiceDecoder: stream %d -> %s service %d (ID %X)\n",
+                iStream, bAudio ? "audio" : "data", iService, unsigned(service.iServiceID));
+    }
+
+    Parameters.Unlock();
+}
+
+std::string CMultiServiceDecoder::GetOutputTarget(const int iService,
+                                                  const uint32_t iServiceID) const
+{
+    std::string strTarget = strOutputPattern;
+    bool bReplaced = false;
+    size_t iPos;
+
+    while ((iPos = strTarget.find("%d")) != std::string::npos)
+    {
+        strTarget.replace(iPos, 2, std::to_string(iService));
+        bReplaced = true;
+    }
+
+    char chServiceID[16];
+    snprintf(chServiceID, sizeof(chServiceID), "%X", unsigned(iServiceID));
+    while ((iPos = strTarget.find("%s")) != std::string::npos)
+    {
+        strTarget.replace(iPos, 2, chServiceID);
+        bReplaced = true;
+    }
+
+    if (!bReplaced)
+        strTarget += "_" + std::to_string(iService);
+
+    return strTarget;
+}
+
+void CMultiServiceDecoder::CStreamDecoder::Process(CParameter& Parameters,
+                                                   CSingleBuffer<_BINARY>& InputBuffer)
+{
+    if (pAudioDecoder)
+    {
+        if (pAudioDecoder->ProcessData(Parameters, InputBuffer, AudioBuf))
+        {
+            bEnoughData = true;
+
+            const int iNumSamples = AudioBuf.GetFillLevel();
+            if (iNumSamples > 0)
+            {
+                CVectorEx<_AUDIO>* pvecSamples = AudioBuf.Get(iNumSamples);
+                Sink.Write(&(*pvecSamples)[0], iNumSamples);
+
+                if (iRingSize > 0)
+                {
+                    Ring.insert(Ring.end(), pvecSamples->begin(), pvecSamples->begin() + iNumSamples);
+
+                    /* Only the most recent audio is of interest */
+                    if (Ring.size() > iRingSize)
+                        Ring.erase(Ring.begin(), Ring.begin() + (Ring.size() - iRingSize));
+                }
+            }
+        }
+    }
+    else if (pDataDecoder)
+    {
+        if (pDataDecoder->WriteData(Parameters, InputBuffer))
+            bEnoughData = true;
+    }
+}
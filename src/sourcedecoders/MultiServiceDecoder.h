@@ -0,0 +1,219 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Decoding of all services of the multiplex at the same time. One audio
+ *  source decoder or data decoder per MSC stream, independent of the
+ *  service selected for listening. Also used to keep the audio decoders of
+ *  all services warm for instant service switching
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#ifndef MULTISERVICEDECODER_H
+#define MULTISERVICEDECODER_H
+
+#include "../GlobalDefinitions.h"
+#include "../Parameter.h"
+#include "../util/Buffer.h"
+#include "../util/PcmSink.h"
+#include "../datadecoding/DataDecoder.h"
+#include "AudioSourceDecoder.h"
+#include <vector>
+#include <deque>
+#include <string>
+#include <memory>
+#include <functional>
+
+/**
+ * @brief Decoders for every stream of the multiplex
+ *
+ * The MSC split feeds one input buffer per stream. Each stream carrying an
+ * audio service gets its own audio source decoder writing to its own PCM
+ * sink, each other stream carrying a packet mode data service gets its own
+ * data decoder. The stream of the selected data service is left to the
+ * receiver's main data decoder so MOT objects are not decoded twice.
+ *
+ * With warm audio, every audio decoder also keeps the last superframe of
+ * PCM in a short ring, and the receiver plays the ring of the selected
+ * service instead of running its main audio decoder. A service change then
+ * only swaps the ring being played, the codec of the new service is
+ * already open and its resampler settled.
+ *
+ * The decoders do not depend on each other and are handed out as tasks so
+ * the receiver can run them in parallel with its main decoders.
+ */
+class CMultiServiceDecoder
+{
+public:
+    CMultiServiceDecoder();
+    virtual ~CMultiServiceDecoder();
+
+    /**
+     * @brief Set the output target pattern for the audio services
+     *
+     * "%d" is replaced by the service number (0..3), "%s" by the service ID
+     * in hex. Without either, "_<service number>" is appended. An empty
+     * pattern decodes without output. See CPcmSink for the target syntax.
+     */
+    void SetOutputPattern(const std::string& strNewPattern);
+    std::string GetOutputPattern() const { return strOutputPattern; }
+
+    /**
+     * @brief Select what is decoded
+     * @param bNewAllServices Data decoders and per service audio outputs
+     * @param bNewWarmAudio PCM rings for service switching
+     */
+    void SetMode(const bool bNewAllServices, const bool bNewWarmAudio);
+
+    /**
+     * @brief Decode without a receiver's main decoders next to this one:
+     * the stream of the selected data service is decoded here as well and
+     * the audio decoder of the selected service publishes its status
+     */
+    void SetStandalone(const bool bNewStandalone);
+
+    /**
+     * @brief Rescan the services before the next block
+     */
+    void SetInitFlag() { bDoInit = true; }
+
+    /**
+     * @brief Clear all stream input buffers
+     */
+    void Clear();
+
+    /**
+     * @brief Input buffer of one MSC stream
+     */
+    CSingleBuffer<_BINARY>& GetStreamBuffer(const int iStreamID)
+        { return vecStreamBuf[size_t(iStreamID)]; }
+
+    /**
+     * @brief Input buffers of all streams, for a module writing all of them
+     */
+    std::vector<CSingleBuffer<_BINARY> >& GetStreamBuffers() { return vecStreamBuf; }
+
+    /**
+     * @brief Append one task per stream decoder
+     *
+     * The tasks must all have finished before the input buffers are fed
+     * again or the services are rescanned.
+     */
+    void AddTasks(CParameter& Parameters, std::vector<std::function<void()> >& vecTasks);
+
+    /**
+     * @brief Check if any decoder had enough input data in the last batch
+     */
+    bool GetEnoughData() const;
+
+    /**
+     * @brief Number of running stream decoders
+     */
+    int GetNumDecoders() const;
+
+    /**
+     * @brief Check if a service has a warm audio decoder (warm audio only)
+     */
+    bool HasServiceAudio(const int iService)
+        { return bWarmAudio && (FindAudioDecoder(iService) != nullptr); }
+
+    /**
+     * @brief Move the buffered PCM of an audio service to an output buffer
+     * (warm audio only). Call after the tasks have finished
+     * @return true if samples were moved
+     */
+    bool GetServiceAudio(const int iService, CBuffer<_AUDIO>& Output);
+
+    /**
+     * @brief Correctly decoded audio blocks of a service since the last call
+     */
+    int GetNumCorDecAudio(const int iService);
+
+    /**
+     * @brief Data decoder of a service, nullptr if there is none
+     */
+    CDataDecoder* GetDataDecoder(const int iService);
+
+    struct COutputStatus
+    {
+        int             iService;
+        std::string     strTarget;
+        bool            bOpen;
+        unsigned long   iDropped;
+    };
+
+    /**
+     * @brief Audio outputs of the services
+     */
+    void GetOutputStatus(std::vector<COutputStatus>& vecStatus) const;
+
+protected:
+    class CStreamDecoder
+    {
+    public:
+        CStreamDecoder() : iService(-1), bAudio(false), iStreamLen(0),
+            AudioParam(), DataParam(), pAudioDecoder(), pDataDecoder(),
+            AudioBuf(), Sink(), Ring(), iRingSize(0), bEnoughData(false) {}
+
+        void Process(CParameter& Parameters, CSingleBuffer<_BINARY>& InputBuffer);
+
+        int                                  iService;
+        bool                                 bAudio;
+        int                                  iStreamLen;
+        CAudioParam                          AudioParam;
+        CDataParam                           DataParam;
+        std::unique_ptr<CAudioSourceDecoder> pAudioDecoder;
+        std::unique_ptr<CDataDecoder>        pDataDecoder;
+        CSingleBuffer<_AUDIO>                AudioBuf;
+        CPcmSink                             Sink;
+        std::deque<_AUDIO>                   Ring;
+        size_t                               iRingSize; /* 0: no ring */
+        bool                                 bEnoughData;
+    };
+
+    /**
+     * @brief Match the stream decoders to the current services. Decoders
+     * of unchanged services keep running without a new init
+     */
+    void Rebuild(CParameter& Parameters);
+
+    /**
+     * @brief Output target of one audio service
+     */
+    std::string GetOutputTarget(const int iService, const uint32_t iServiceID) const;
+
+    /**
+     * @brief Audio decoder of a service, nullptr if there is none
+     */
+    CStreamDecoder* FindAudioDecoder(const int iService);
+
+    std::vector<CSingleBuffer<_BINARY> >            vecStreamBuf;
+    std::vector<std::unique_ptr<CStreamDecoder> >   vecDecoders;
+    std::string                                     strOutputPattern;
+    bool                                            bAllServices;
+    bool                                            bWarmAudio;
+    bool                                            bStandalone;
+    int                                             iOutputBufferSize;
+    bool                                            bDoInit;
+};
+
+#endif // MULTISERVICEDECODER_H
@@ -75,20 +75,15 @@ void CFreqSyncAcq::ProcessDataInternal(CParameter& Parameters)
 		}
 		else
 		{
-			/* Copy vector to matlib vector and calculate real-valued FFT */
+			/* Copy windowed vector to matlib vector and calculate real-valued
+			   FFT */
 			const int iStartIdx = iHistBufSize - iFrAcFFTSize;
 			for (i = 0; i < iFrAcFFTSize; i++)
-				vecrFFTInput[i] = vecrFFTHistory[i + iStartIdx];
-
-			static CMatlibVector<CReal> vecRet;
-			vecRet.Init(vecrFFTInput.GetSize(), VTY_TEMP);
-
-			for (int k = 0; k < vecrFFTInput.GetSize(); k++)
-				vecRet[k] = vecrFFTInput[k] * vecrHammingWin[k];
+				vecrFFTInput[i] = vecrFFTHistory[i + iStartIdx] * vecrHammingWin[i];
 
 			/* Calculate power spectrum (X = real(F)^2 + imag(F)^2) */
 			vecrSqMagFFTOut =
-				SqMag(rfft(vecRet, FftPlan));
+				SqMag(rfft(vecrFFTInput, FftPlan));
 
 			/* Calculate moving average for better estimate of PSD */
 			vvrPSDMovAv.Add(vecrSqMagFFTOut);
@@ -103,6 +98,7 @@ void CFreqSyncAcq::ProcessDataInternal(CParameter& Parameters)
 			{
 				/* Get PSD estimate */
 				const CRealVector vecrPSD(vvrPSDMovAv.GetAverage());
+				iNumPSDEstimates++;
 
 
 				/* -------------------------------------------------------------
@@ -173,6 +169,7 @@ fclose(pFile2);
 				/* Detect peaks --------------------------------------------- */
 				/* Get peak indices of detected peaks */
 				iNumDetPeaks = 0;
+				CReal rMaxPilCor = (CReal) 0.0;
 				for (i = iStartDCSearch; i < iEndDCSearch; i++)
 				{
 					/* Test peaks against a bound */
@@ -181,7 +178,10 @@ fclose(pFile2);
 						veciPeakIndex[iNumDetPeaks] = i;
 						iNumDetPeaks++;
 					}
+					if (vecrPSDPilCor[i] > rMaxPilCor)
+						rMaxPilCor = vecrPSDPilCor[i];
 				}
+				rPilotPeak = rMaxPilCor / rPeakBoundFiltToSig;
 
 				/* Check, if at least one peak was detected */
 				if (iNumDetPeaks > 0)
@@ -503,8 +503,15 @@ void CFreqSyncAcq::StartAcquisition()
 
 	/* Reset (or init) counters */
 	iAquisitionCounter = NUM_BLOCKS_4_FREQ_ACQU;
-	iAverageCounter = NUM_FFT_RES_AV_BLOCKS;
+	iAverageCounter = iNumPSDAverages;
+	iNumPSDEstimates = 0;
+	rPilotPeak = (_REAL) 0.0;
 
 	/* Reset FFT-history */
 	vecrFFTHistory.Reset((_REAL) 0.0);
+
+	/* With fewer spectra averaged than the moving average holds, spectra of
+	   before the start would still be part of the first estimate */
+	if ((iNumPSDAverages < NUM_FFT_RES_AV_BLOCKS) && (vvrPSDMovAv.Size() > 0))
+		vvrPSDMovAv.InitVec(NUM_FFT_RES_AV_BLOCKS, iHalfBuffer);
 }
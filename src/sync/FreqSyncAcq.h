@@ -33,6 +33,7 @@
 #include "../util/Modul.h"
 #include "../matlib/Matlib.h"
 #include "../util/Utilities.h"
+#include <algorithm>
 
 /* Definitions ****************************************************************/
 /* Bound for peak detection between filtered signal (in frequency direction) 
@@ -74,7 +75,9 @@ class CFreqSyncAcq : public CReceiverModul<_REAL, _COMPLEX>
 public:
 	CFreqSyncAcq() : 
 		veciTableFreqPilots(3), /* 3 frequency pilots */
-		bAquisition(false), bSyncInput(false),
+		bAquisition(false),
+		iNumPSDAverages(NUM_FFT_RES_AV_BLOCKS), iNumPSDEstimates(0),
+		rPilotPeak(0), bSyncInput(false),
 		rCenterFreq(0), rWinSize(0),
 		bUseRecFilter(false)
 		{}
@@ -86,6 +89,17 @@ public:
 	void StopAcquisition() {bAquisition = false;}
 	bool GetAcquisition() {return bAquisition;}
 
+	/* Number of spectra averaged before the first detection attempt. Fewer
+	   give a faster but less reliable decision, e.g. for scanning */
+	void SetNumPSDAverages(const int iNewNum)
+		{iNumPSDAverages = std::max(1, std::min(iNewNum, NUM_FFT_RES_AV_BLOCKS));}
+
+	/* Detection attempts since the start of the acquisition, and the
+	   strongest frequency pilot correlation of the last one relative to the
+	   detection bound (above 1: pilots found) */
+	int GetNumPSDEstimates() const {return iNumPSDEstimates;}
+	_REAL GetPilotPeak() const {return rPilotPeak;}
+
 	void SetRecFilter(const bool bNewF) {bUseRecFilter = bNewF;}
 	bool GetRecFilter() {return bUseRecFilter;}
 	bool GetUnlockedFrameBoundary() {return iFreeSymbolCounter==0;}
@@ -112,6 +126,9 @@ protected:
 
 	int							iAquisitionCounter;
 	int							iAverageCounter;
+	int							iNumPSDAverages;
+	int							iNumPSDEstimates;
+	_REAL						rPilotPeak;
 
 	bool					bSyncInput;
 
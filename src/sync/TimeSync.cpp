@@ -374,7 +374,8 @@ void CTimeSync::ProcessDataInternal(CParameter& Parameters)
 
 					/* Find out if we have a reliable measure
 					   (distance to next peak) */
-					if ((rMaxValRMCorr / rSecHighPeak) > THRESHOLD_RELI_MEASURE)
+					rRMReliability = rMaxValRMCorr / rSecHighPeak;
+					if (rRMReliability > THRESHOLD_RELI_MEASURE)
 					{
 						/* Reset aquisition flag for robustness mode detection */
 						bRobModAcqu = false;
@@ -517,7 +518,6 @@ fflush(pFile);
 #ifdef _DEBUG_
 /* Save estimated positions of timing (tracking) */
 static FILE* pFile = fopen("test/testtimetrack.dat", "w");
-static int iTimeTrackAbs = 0;
 iTimeTrackAbs += Parameters.iTimingOffsTrack; /* Integration */
 fprintf(pFile, "%d\n", iTimeTrackAbs);
 fflush(pFile);
@@ -855,6 +855,7 @@ void CTimeSync::StartAcquisition()
 	/* The regular acquisition flags */
 	bTimingAcqu = true;
 	bRobModAcqu = true;
+	rRMReliability = (CReal) 0.0;
 
 	/* Set the init flag so that the "rStartIndex" can be initialized with the
 	   center of the buffer and other important settings can be done */
@@ -902,9 +903,13 @@ CTimeSync::CTimeSync() : iSampleRate(0), iGrdcrrDecFact(0),
 	iLengthIntermCRes(NUM_ROBUSTNESS_MODES),
 	iPosInIntermCResBuf(NUM_ROBUSTNESS_MODES),
 	iLengthOverlap(NUM_ROBUSTNESS_MODES), iLenUsefPart(NUM_ROBUSTNESS_MODES),
-	iLenGuardInt(NUM_ROBUSTNESS_MODES), cGuardCorr(NUM_ROBUSTNESS_MODES),
+	iLenGuardInt(NUM_ROBUSTNESS_MODES), rRMReliability((CReal) 0.0),
+	cGuardCorr(NUM_ROBUSTNESS_MODES),
 	cGuardCorrBlock(NUM_ROBUSTNESS_MODES), rGuardPow(NUM_ROBUSTNESS_MODES),
 	rGuardPowBlock(NUM_ROBUSTNESS_MODES), vecrRMCorrBuffer()
+#ifdef _DEBUG_
+	, iTimeTrackAbs(0)
+#endif
 {
 }
 
@@ -98,6 +98,12 @@ public:
 	void StopTimingAcqu() {bTimingAcqu = false;}
 	void StopRMDetAcqu() {bRobModAcqu = false;}
 
+	/* Ratio of the guard-interval correlation of the strongest robustness
+	   mode to the second strongest at the last detection attempt, a mode is
+	   detected above THRESHOLD_RELI_MEASURE */
+	CReal GetRMReliability() const {return rRMReliability;}
+	bool GetRMDetected() const {return !bRobModAcqu;}
+
 protected:
 	int							iSampleRate;
 	int							iGrdcrrDecFact;
@@ -157,6 +163,7 @@ protected:
 	CVector<int>				iLengthOverlap;
 	CVector<int>				iLenUsefPart;
 	CVector<int>				iLenGuardInt;
+	CReal						rRMReliability;
 
 	CComplexVector				cGuardCorr;
 	CComplexVector				cGuardCorrBlock;
@@ -173,6 +180,10 @@ protected:
 	CReal						rNormConstFOE;
 #endif
 
+#ifdef _DEBUG_
+	int							iTimeTrackAbs;
+#endif
+
 	int			GetIndFromRMode(ERobMode eNewMode);
 	ERobMode	GetRModeFromInd(int iNewInd);
 	void		SetFilterTaps(CReal rNewOffsetNorm);
@@ -0,0 +1,368 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Scan of a list of frequencies for DRM signals
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "BandScanner.h"
+#include "Settings.h"
+#include "../DrmReceiver.h"
+#ifdef HAVE_LIBHAMLIB
+# include "Hamlib.h"
+#endif
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <sstream>
+
+/* A DRM transmission frame */
+static const _REAL DRM_FRAME_SECONDS = 0.4;
+
+/* Spectra averaged for the pilot detection. Each takes one more symbol, the
+   first needs six: eight symbols of mode B are some 210 ms */
+static const int SCAN_PSD_AVERAGES = 3;
+
+/* Width of the search window for the DC carrier around the channel [Hz], a
+   little less than the 5 kHz raster so the pilots of the next channel are
+   not taken */
+static const _REAL SCAN_WINDOW_HZ = 4000.0;
+
+/* The pilot detection gives up after this much signal anyway */
+static const _REAL MAX_DETECT_SECONDS = 1.0;
+
+/* Signal taken after the FAC is decoded, for the SNR estimate and the label */
+static const _REAL SCAN_LOCKED_SECONDS = 3 * DRM_FRAME_SECONDS;
+
+/* Calls of the receiver without reading input before the scan is given up */
+static const int MAX_STALLED_CALLS = 1000;
+
+/* Step of a range without one [kHz] */
+static const int DEFAULT_SCAN_STEP = 5;
+
+CBandScanner::CBandScanner(CSettings* pNewSettings)
+    : pSettings(pNewSettings), pReceiver(),
+#ifdef HAVE_LIBHAMLIB
+      pRig(),
+#endif
+      iCenterFrequency(-1), rInputCenter(-1.0), rSettleSeconds(0.0),
+      rDwellSeconds(3.0), strOutput(), dLastInput(-1.0), iStalledCalls(0),
+      bInputStalled(false)
+{
+}
+
+CBandScanner::~CBandScanner()
+{
+}
+
+bool CBandScanner::ParseList(const std::string& strList, std::vector<int>& veciFrequencies)
+{
+    std::istringstream ss(strList);
+    std::string strItem;
+    while (std::getline(ss, strItem, ','))
+    {
+        if (strItem.empty())
+            continue;
+
+        char* pcEnd = nullptr;
+        const long iFirst = strtol(strItem.c_str(), &pcEnd, 10);
+        long iLast = iFirst;
+        long iStep = DEFAULT_SCAN_STEP;
+        if (*pcEnd == '-')
+            iLast = strtol(pcEnd + 1, &pcEnd, 10);
+        if (*pcEnd == ':')
+            iStep = strtol(pcEnd + 1, &pcEnd, 10);
+        if ((*pcEnd != '\0') || (iFirst <= 0) || (iLast < iFirst) || (iStep <= 0))
+            return false;
+
+        for (long f = iFirst; f <= iLast; f += iStep)
+            veciFrequencies.push_back(int(f));
+    }
+    return !veciFrequencies.empty();
+}
+
+bool CBandScanner::Run()
+{
+    CSettings& s = *pSettings;
+
+    std::vector<int> veciFrequencies;
+    const std::string strList = s.Get("command", "scan", std::string());
+    if (!ParseList(strList, veciFrequencies))
+    {
+        fprintf(stderr, "BandScanner: can't read the frequency list \"%s\", e.g. 5900-6200:5,7200\n",
+                strList.c_str());
+        return false;
+    }
+
+    iCenterFrequency = s.Get("command", "scan-center", -1);
+    rDwellSeconds = s.Get("command", "scan-dwell", _REAL(3.0));
+    strOutput = s.Get("command", "scan-output", std::string());
+
+    /* The rig needs some time to tune, in the wideband input all channels
+       are there already */
+    const bool bRig = iCenterFrequency <= 0;
+    rSettleSeconds = s.Get("command", "scan-settle", bRig ? 100 : 0) / _REAL(1000.0);
+
+    if (bRig)
+    {
+#ifdef HAVE_LIBHAMLIB
+        pRig.reset(new CHamlib);
+        pRig->LoadSettings(s);
+        if (pRig->GetHamlibModelID() == 0)
+            pRig.reset();
+        if (!pRig)
+#endif
+        {
+            fprintf(stderr, "BandScanner: the scan needs a Hamlib rig (--hamlib-model) or the frequency "
+                    "of the centre of a wideband input (--scan-center)\n");
+            return false;
+        }
+    }
+
+    pReceiver.reset(new CDRMReceiver(pSettings));
+    CDRMReceiver& Receiver = *pReceiver;
+    Receiver.LoadSettings();
+
+    /* Every channel would go to the cache, and nothing is to be heard */
+    Receiver.SetFastStart(false);
+    Receiver.SetReceiverMode(RM_DRM);
+    Receiver.InitReceiverMode();
+    Receiver.GetWriteData()->MuteAudio(true);
+    Receiver.GetFreqSyncAcq()->SetNumPSDAverages(SCAN_PSD_AVERAGES);
+
+    /* Where the DC carrier of a channel tuned by the rig, or of the centre
+       of the wideband input, is in the input */
+    const _REAL rSampleRate = _REAL(Receiver.GetParameters()->GetSigSampleRate());
+    rInputCenter = Receiver.GetSearchWindowCenter();
+    if (rInputCenter < 0.0)
+        rInputCenter = rSampleRate / 4;
+
+    fprintf(stderr, "BandScanner: %u channels, %s, dwell %.1f s\n", unsigned(veciFrequencies.size()),
+            bRig ? "tuned by the rig" : "in the wideband input", double(rDwellSeconds));
+
+    std::vector<CChannel> vecFound;
+    int iNumEmpty = 0;
+    _REAL rEmptySeconds = 0.0;
+    const double dStart = Receiver.GetMetrics().GetInputSeconds();
+
+    for (size_t i = 0; (i < veciFrequencies.size()) && !bInputStalled; i++)
+    {
+        CChannel Channel;
+        Channel.iFrequency = veciFrequencies[i];
+        if (!Tune(Channel.iFrequency))
+            continue;
+
+        ScanChannel(Channel);
+        if (bInputStalled)
+            break;
+
+        if (Channel.bPilots)
+        {
+            fprintf(stderr, "BandScanner: %d kHz: %s, %.1f s\n", Channel.iFrequency,
+                    Channel.bFAC ? "DRM" : "pilots, no FAC", double(Channel.rSeconds));
+            vecFound.push_back(Channel);
+        }
+        else
+        {
+            iNumEmpty++;
+            rEmptySeconds += Channel.rSeconds;
+        }
+    }
+
+    const double dElapsed = Receiver.GetMetrics().GetInputSeconds() - dStart;
+    Receiver.CloseSoundInterfaces();
+
+    /* Decoded channels by SNR, then the ones with pilots only */
+    std::stable_sort(vecFound.begin(), vecFound.end(), [](const CChannel& a, const CChannel& b) {
+        if (a.bFAC != b.bFAC)
+            return a.bFAC;
+        return a.bFAC ? (a.rSNR > b.rSNR) : (a.rPilotPeak > b.rPilotPeak);
+    });
+    WriteResult(vecFound);
+
+    fprintf(stderr, "BandScanner: %u of %u channels with DRM in %.1f s of signal, %.0f ms (%.2f frames) "
+            "per empty channel\n", unsigned(vecFound.size()), unsigned(veciFrequencies.size()), dElapsed,
+            iNumEmpty > 0 ? 1000.0 * double(rEmptySeconds) / iNumEmpty : 0.0,
+            iNumEmpty > 0 ? double(rEmptySeconds) / iNumEmpty / double(DRM_FRAME_SECONDS) : 0.0);
+    return true;
+}
+
+bool CBandScanner::Tune(const int iFrequency)
+{
+    CDRMReceiver& Receiver = *pReceiver;
+    _REAL rDC = rInputCenter;
+
+#ifdef HAVE_LIBHAMLIB
+    if (pRig)
+    {
+        if (!pRig->SetFrequency(iFrequency))
+        {
+            fprintf(stderr, "BandScanner: %d kHz: the rig can't be tuned\n", iFrequency);
+            return false;
+        }
+    }
+    else
+#endif
+    {
+        rDC += _REAL(iFrequency - iCenterFrequency) * 1000;
+
+        const _REAL rNyquist = _REAL(Receiver.GetParameters()->GetSigSampleRate()) / 2;
+        if ((rDC - SCAN_WINDOW_HZ / 2 <= 0.0) || (rDC + SCAN_WINDOW_HZ / 2 >= rNyquist))
+        {
+            fprintf(stderr, "BandScanner: %d kHz is not in the input\n", iFrequency);
+            return false;
+        }
+    }
+
+    Receiver.SetFrequency(iFrequency);
+    Receiver.SetSearchWindow(rDC, SCAN_WINDOW_HZ);
+
+    /* What comes in while the rig is tuning is not taken */
+    if (rSettleSeconds > 0.0)
+        ProcessFor(rSettleSeconds);
+    return !bInputStalled;
+}
+
+bool CBandScanner::Step()
+{
+    pReceiver->process();
+
+    /* The input ended, or the receiver dropped it after an error */
+    const double dNow = pReceiver->GetMetrics().GetInputSeconds();
+    iStalledCalls = (dNow == dLastInput) ? iStalledCalls + 1 : 0;
+    dLastInput = dNow;
+    if (iStalledCalls > MAX_STALLED_CALLS)
+    {
+        fprintf(stderr, "BandScanner: input stalled\n");
+        bInputStalled = true;
+    }
+    return !bInputStalled;
+}
+
+bool CBandScanner::ProcessFor(const _REAL rSeconds)
+{
+    CReceiverMetrics& Metrics = pReceiver->GetMetrics();
+    const double dEnd = Metrics.GetInputSeconds() + double(rSeconds);
+
+    while (Metrics.GetInputSeconds() < dEnd)
+    {
+        if (!Step())
+            return false;
+    }
+    return true;
+}
+
+void CBandScanner::ScanChannel(CChannel& Channel)
+{
+    CDRMReceiver& Receiver = *pReceiver;
+    CReceiverMetrics& Metrics = Receiver.GetMetrics();
+    CFreqSyncAcq& FreqSyncAcq = *Receiver.GetFreqSyncAcq();
+    CTimeSync& TimeSync = *Receiver.GetTimeSync();
+    CParameter& Parameters = *Receiver.GetParameters();
+
+    Receiver.SetInStartMode();
+    const double dStart = Metrics.GetInputSeconds();
+
+    /* Pilots, or the first averaged spectrum without them. Blocks of a few
+       milliseconds, so a few calls of the receiver at a time */
+    while (FreqSyncAcq.GetAcquisition() && (FreqSyncAcq.GetNumPSDEstimates() == 0) &&
+            (Metrics.GetInputSeconds() - dStart < double(MAX_DETECT_SECONDS)))
+    {
+        if (!Step())
+            return;
+    }
+    Channel.bPilots = !FreqSyncAcq.GetAcquisition();
+    Channel.rPilotPeak = FreqSyncAcq.GetPilotPeak();
+
+    /* Only a channel with pilots gets the guard interval correlation and the
+       FAC */
+    if (Channel.bPilots)
+    {
+        while ((Receiver.GetAcquiState() != AS_WITH_SIGNAL) &&
+                (Metrics.GetInputSeconds() - dStart < double(rDwellSeconds)))
+        {
+            if (!ProcessFor(DRM_FRAME_SECONDS / 4))
+                return;
+        }
+        Channel.rRMReliability = TimeSync.GetRMReliability();
+
+        if (Receiver.GetAcquiState() == AS_WITH_SIGNAL)
+        {
+            const _REAL rLocked = std::min(SCAN_LOCKED_SECONDS,
+                                           rDwellSeconds - _REAL(Metrics.GetInputSeconds() - dStart));
+            if ((rLocked > 0.0) && !ProcessFor(rLocked))
+                return;
+
+            Channel.bFAC = Receiver.GetAcquiState() == AS_WITH_SIGNAL;
+            Channel.eRobMode = Parameters.GetWaveMode();
+            Channel.eSpecOcc = Parameters.GetSpectrumOccup();
+            Channel.rSNR = Parameters.GetSNR();
+            Channel.iServiceID = Parameters.Service[0].iServiceID;
+            Channel.strLabel = Parameters.Service[0].strLabel;
+        }
+        else if (TimeSync.GetRMDetected())
+            Channel.eRobMode = Parameters.GetWaveMode();
+    }
+
+    Channel.rSeconds = _REAL(Metrics.GetInputSeconds() - dStart);
+}
+
+void CBandScanner::WriteResult(std::vector<CChannel>& vecChannels)
+{
+    FILE* pFile = nullptr;
+    if (!strOutput.empty())
+    {
+        pFile = fopen(strOutput.c_str(), "w");
+        if (pFile == nullptr)
+            fprintf(stderr, "BandScanner: can't create %s\n", strOutput.c_str());
+        else
+            fprintf(pFile, "rank,frequency_khz,fac,robm,occupancy,snr_db,pilot_db,rm_reliability,service_id,label\n");
+    }
+
+    printf("rank  kHz     FAC mode SO  SNR dB  pilot dB  service  label\n");
+    for (size_t i = 0; i < vecChannels.size(); i++)
+    {
+        CChannel& Channel = vecChannels[i];
+        const char cMode = (Channel.eRobMode == RM_NO_MODE_DETECTED) ? '-' : char('A' + int(Channel.eRobMode));
+        const char cOcc = Channel.bFAC ? char('0' + int(Channel.eSpecOcc)) : '-';
+        const double dPilot = Channel.rPilotPeak > 0.0 ? 10.0 * log10(double(Channel.rPilotPeak)) : 0.0;
+
+        printf("%4u  %-6d  %-3s %c    %c  %6.1f  %8.1f  %06X   %s\n", unsigned(i + 1), Channel.iFrequency,
+               Channel.bFAC ? "yes" : "no", cMode, cOcc, double(Channel.rSNR), dPilot,
+               unsigned(Channel.iServiceID), Channel.strLabel.c_str());
+
+        if (pFile != nullptr)
+        {
+            std::string strLabel = Channel.strLabel;
+            for (size_t j = strLabel.find('"'); j != std::string::npos; j = strLabel.find('"', j + 2))
+                strLabel.insert(j, 1, '"');
+
+            fprintf(pFile, "%u,%d,%d,%c,%c,%.1f,%.1f,%.2f,%06X,\"%s\"\n", unsigned(i + 1), Channel.iFrequency,
+                    Channel.bFAC ? 1 : 0, cMode, cOcc, double(Channel.rSNR), dPilot,
+                    double(Channel.rRMReliability), unsigned(Channel.iServiceID), strLabel.c_str());
+        }
+    }
+
+    if (pFile != nullptr)
+        fclose(pFile);
+}
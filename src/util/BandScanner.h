@@ -0,0 +1,116 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Scan of a list of frequencies for DRM signals
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#ifndef BANDSCANNER_H
+#define BANDSCANNER_H
+
+#include "../GlobalDefinitions.h"
+#include <string>
+#include <vector>
+#include <memory>
+
+class CSettings;
+class CDRMReceiver;
+#ifdef HAVE_LIBHAMLIB
+class CHamlib;
+#endif
+
+/**
+ * @brief Finds the DRM signals on a list of frequencies
+ *
+ * Each frequency is tuned either with the Hamlib rig of the settings or,
+ * for a wideband input, by moving the search window of the frequency
+ * acquisition to where the frequency is in the input. Only the frequency
+ * acquisition runs then, with few spectra averaged: the three frequency
+ * pilots are found, or not, after some 200 ms of signal, about half a DRM
+ * frame. Only on a frequency with pilots the receiver goes on with the
+ * guard-interval correlation (robustness mode detection), time sync and the
+ * FAC, for at most the dwell time, to take the mode and the SNR.
+ *
+ * The result is a list of the channels with a DRM signal, those with a
+ * decoded FAC first by SNR, then those with pilots only by the strength of
+ * the pilots.
+ */
+class CBandScanner
+{
+public:
+    CBandScanner(CSettings* pNewSettings);
+    ~CBandScanner();
+
+    /**
+     * @brief Scan the frequencies of the settings (--scan)
+     * @return false if the scan could not be started
+     */
+    bool Run();
+
+    struct CChannel
+    {
+        CChannel() : iFrequency(0), bPilots(false), bFAC(false), rPilotPeak(0.0),
+            rRMReliability(0.0), eRobMode(RM_NO_MODE_DETECTED), eSpecOcc(SO_3),
+            rSNR(0.0), iServiceID(0), strLabel(), rSeconds(0.0) {}
+        int                     iFrequency;     /* kHz */
+        bool                    bPilots;
+        bool                    bFAC;
+        _REAL                   rPilotPeak;     /* relative to the detection bound */
+        _REAL                   rRMReliability;
+        ERobMode                eRobMode;
+        ESpecOcc                eSpecOcc;
+        _REAL                   rSNR;           /* dB */
+        uint32_t                iServiceID;
+        std::string             strLabel;
+        _REAL                   rSeconds;       /* signal spent on the channel */
+    };
+
+    /**
+     * @brief Frequencies of a list like "5900-6200:5,7200,9400-9900", kHz.
+     * Ranges without a step use 5 kHz
+     */
+    static bool ParseList(const std::string& strList, std::vector<int>& veciFrequencies);
+
+protected:
+    bool                Tune(const int iFrequency);
+    bool                Step();
+    bool                ProcessFor(const _REAL rSeconds);
+    void                ScanChannel(CChannel& Channel);
+    void                WriteResult(std::vector<CChannel>& vecChannels);
+
+    CSettings*          pSettings;
+    std::unique_ptr<CDRMReceiver> pReceiver;
+#ifdef HAVE_LIBHAMLIB
+    std::unique_ptr<CHamlib> pRig;
+#endif
+    int                 iCenterFrequency;   /* kHz, wideband input */
+    _REAL               rInputCenter;       /* Hz, where it is in the input */
+    _REAL               rSettleSeconds;
+    _REAL               rDwellSeconds;
+    std::string         strOutput;
+    double              dLastInput;
+    int                 iStalledCalls;
+    bool                bInputStalled;
+};
+
+#endif // BANDSCANNER_H
@@ -0,0 +1,318 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Offline decoding of a long recording in parallel chunks
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "BatchDecoder.h"
+#include "Settings.h"
+#include "../DrmReceiver.h"
+#include "../sound/mmapfilein.h"
+#include <cmath>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+/* A DRM transmission frame, the unit of the status lines and of the audio
+   output blocks */
+static const _REAL DRM_FRAME_SECONDS = 0.4;
+
+/* Calls of the receiver without reading input before a chunk is given up */
+static const int MAX_STALLED_CALLS = 1000;
+
+/* Receivers are created and destroyed one after the other: the shared codec
+   list and the settings are not meant for concurrent access */
+static std::mutex SetupMutex;
+
+/**
+ * @brief Audio output of a batch receiver, keeps the blocks with the input
+ * position they were produced at
+ */
+class CBatchAudioOut : public CSoundOutInterface
+{
+public:
+    CBatchAudioOut(CMmapFileIn* pNewFileIn, CBatchDecoder::CChunk* pNewChunk, const _REAL rNewKeepFrom)
+        : pFileIn(pNewFileIn), pChunk(pNewChunk), rKeepFrom(rNewKeepFrom) {}
+    virtual ~CBatchAudioOut() {}
+
+    virtual bool Init(int iSampleRate, int, bool) {
+        pChunk->iAudioSampleRate = iSampleRate;
+        return false;
+    }
+    virtual bool Write(CVector<short>& psData) {
+        const _REAL rPosition = pFileIn->GetPosition();
+        if (rPosition > rKeepFrom)
+        {
+            CBatchDecoder::CAudioBlock Block;
+            Block.rPosition = rPosition;
+            Block.vecsSamples.assign(psData.begin(), psData.end());
+            pChunk->vecAudio.push_back(std::move(Block));
+        }
+        return false;
+    }
+    virtual void Close() {}
+    virtual std::string GetVersion() {return "Dream Batch Output";}
+    virtual void Enumerate(std::vector<std::string>&, std::vector<std::string>&, std::string&) {}
+    virtual std::string GetDev() {return "batch";}
+    virtual void SetDev(std::string) {}
+
+private:
+    CMmapFileIn*            pFileIn;
+    CBatchDecoder::CChunk*  pChunk;
+    _REAL                   rKeepFrom;
+};
+
+CBatchDecoder::CBatchDecoder(CSettings* pNewSettings)
+    : pSettings(pNewSettings), strFileName(), strOutput(),
+      rChunkSeconds(60.0), rOverlapSeconds(10.0), vecChunks(), iNextChunk(0),
+      iNextToWrite(0), WaveFile(), bWaveOpen(false), pFrameFile(nullptr),
+      rLastAudioPosition(-1.0), iNumAudioBlocks(0)
+{
+}
+
+CBatchDecoder::~CBatchDecoder()
+{
+    if (bWaveOpen)
+        WaveFile.Close();
+    if (pFrameFile != nullptr)
+        fclose(pFrameFile);
+}
+
+bool CBatchDecoder::Run(unsigned iNumThreads)
+{
+    CSettings& s = *pSettings;
+
+    strFileName = s.Get("command", "fileio", std::string());
+    strOutput = s.Get("command", "batch-output", std::string("batch"));
+    rChunkSeconds = s.Get("command", "batch-chunk", _REAL(60.0));
+    rOverlapSeconds = s.Get("command", "batch-overlap", _REAL(10.0));
+
+    /* Whole frames, so all status lines are on the same grid */
+    rChunkSeconds = std::max(_REAL(1.0), std::round(rChunkSeconds / DRM_FRAME_SECONDS)) * DRM_FRAME_SECONDS;
+
+    CMmapFileIn Probe;
+    Probe.SetSampleFormat(CSampleFormat::FromString(s.Get("Receiver", "inputformat", std::string("auto"))));
+    if (strFileName.empty() || !Probe.Open(strFileName))
+    {
+        fprintf(stderr, "BatchDecoder: batch mode needs a raw or WAV input file (-f) at 24, 48, 96 or 192 kHz\n");
+        return false;
+    }
+    const _REAL rDuration = Probe.GetDuration();
+    Probe.Close();
+
+    /* Nothing but the output files of the batch */
+    s.Put("command", "rsiin", std::string());
+    s.Put("command", "rsiout", std::string());
+    s.Put("command", "rciin", std::string());
+    s.Put("command", "rciout", std::string());
+    s.Put("command", "rsirecordprofile", std::string());
+    s.Put("command", "writewav", std::string());
+    s.Put("command", "recordiq", false);
+
+    const size_t iNumChunks = size_t(std::ceil(rDuration / rChunkSeconds));
+    for (size_t i = 0; i < iNumChunks; i++)
+    {
+        std::unique_ptr<CChunk> pChunk(new CChunk);
+        pChunk->iIndex = int(i);
+        pChunk->rStart = _REAL(i) * rChunkSeconds;
+        pChunk->rEnd = std::min(rDuration, _REAL(i + 1) * rChunkSeconds);
+        vecChunks.push_back(std::move(pChunk));
+    }
+
+    pFrameFile = fopen((strOutput + ".csv").c_str(), "w");
+    if (pFrameFile == nullptr)
+    {
+        fprintf(stderr, "BatchDecoder: can't create %s.csv\n", strOutput.c_str());
+        return false;
+    }
+    fprintf(pFrameFile, "time_s,signal,robm,snr_db,fac,sdc,msc,service\n");
+
+    if (iNumThreads == 0)
+        iNumThreads = std::max(1u, std::thread::hardware_concurrency());
+    iNumThreads = unsigned(std::min(size_t(iNumThreads), iNumChunks));
+
+    fprintf(stderr, "BatchDecoder: %s, %.1f s in %u chunks of %.1f s (+%.1f s overlap), %u decoders\n",
+            strFileName.c_str(), double(rDuration), unsigned(iNumChunks), double(rChunkSeconds),
+            double(rOverlapSeconds), iNumThreads);
+
+    const std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> vecThreads;
+    for (unsigned t = 0; t < iNumThreads; t++)
+    {
+        vecThreads.push_back(std::thread([this]() {
+            size_t i;
+            while ((i = iNextChunk.fetch_add(1)) < vecChunks.size())
+            {
+                DecodeChunk(*vecChunks[i]);
+
+                std::lock_guard<std::mutex> lock(WriteMutex);
+                vecChunks[i]->bDone = true;
+                WriteDoneChunks();
+            }
+        }));
+    }
+    for (size_t t = 0; t < vecThreads.size(); t++)
+        vecThreads[t].join();
+
+    const double dElapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+    if (bWaveOpen)
+    {
+        WaveFile.Close();
+        bWaveOpen = false;
+    }
+    fclose(pFrameFile);
+    pFrameFile = nullptr;
+
+    fprintf(stderr, "BatchDecoder: %.1f s decoded in %.1f s (%.1fx real time), %.1f s of audio in %s.wav\n",
+            double(rDuration), dElapsed, dElapsed > 0.0 ? double(rDuration) / dElapsed : 0.0,
+            double(iNumAudioBlocks) * DRM_FRAME_SECONDS, strOutput.c_str());
+    return true;
+}
+
+void CBatchDecoder::DecodeChunk(CChunk& Chunk)
+{
+    std::unique_ptr<CDRMReceiver> pReceiver;
+    {
+        std::lock_guard<std::mutex> lock(SetupMutex);
+        pReceiver.reset(new CDRMReceiver(pSettings));
+        pReceiver->LoadSettings();
+
+        /* All chunks would write the same cache file */
+        pReceiver->SetFastStart(false);
+    }
+
+    CMmapFileIn* pFileIn = pReceiver->GetReceiveData()->GetMmapFileIn();
+    if (pFileIn == nullptr)
+    {
+        fprintf(stderr, "BatchDecoder: chunk %d: input is not memory mapped\n", Chunk.iIndex);
+        std::lock_guard<std::mutex> lock(SetupMutex);
+        pReceiver.reset();
+        return;
+    }
+
+    /* Start early enough to be in sync at the start of the chunk. The first
+       audio block of the chunk may already come out a little before it */
+    pFileIn->SetRange(std::max(_REAL(0.0), Chunk.rStart - rOverlapSeconds), Chunk.rEnd);
+    pFileIn->SetLoop(false);
+    pFileIn->SetRealTime(false);
+
+    pReceiver->GetAudSorceDec()->SetOwnCodec(true);
+    pReceiver->GetWriteData()->SetSoundInterface(
+        new CBatchAudioOut(pFileIn, &Chunk, Chunk.rStart - DRM_FRAME_SECONDS));
+
+    pReceiver->InitReceiverMode();
+    pReceiver->SetInStartMode();
+
+    CParameter& Parameters = *pReceiver->GetParameters();
+    _REAL rNextFrame = Chunk.rStart;
+
+    _REAL rLastPosition = -1.0;
+    int iStalled = 0;
+
+    while (!pFileIn->IsEnd())
+    {
+        pReceiver->process();
+
+        /* The receiver dropped its input after an error */
+        const _REAL rPosition = pFileIn->GetPosition();
+        iStalled = (rPosition == rLastPosition) ? iStalled + 1 : 0;
+        rLastPosition = rPosition;
+        if (iStalled > MAX_STALLED_CALLS)
+        {
+            fprintf(stderr, "BatchDecoder: chunk %d: input stalled at %.1f s\n", Chunk.iIndex, double(rPosition));
+            break;
+        }
+
+        if (rPosition <= rNextFrame)
+            continue;
+        while (rNextFrame < rPosition)
+            rNextFrame += DRM_FRAME_SECONDS;
+
+        const bool bSignal = pReceiver->GetAcquiState() == AS_WITH_SIGNAL;
+        const int iService = Parameters.GetCurSelAudioService();
+        std::string strLabel = bSignal ? Parameters.Service[size_t(iService)].strLabel : std::string();
+        for (size_t i = strLabel.find('"'); i != std::string::npos; i = strLabel.find('"', i + 2))
+            strLabel.insert(i, 1, '"');
+
+        char chLine[128];
+        snprintf(chLine, sizeof(chLine), "%.2f,%d,%d,%.1f,%d,%d,%d,", double(rPosition), bSignal ? 1 : 0,
+                 bSignal ? int(Parameters.GetWaveMode()) : -1, bSignal ? double(Parameters.GetSNR()) : 0.0,
+                 int(Parameters.ReceiveStatus.FAC.GetStatus()), int(Parameters.ReceiveStatus.SDC.GetStatus()),
+                 int(Parameters.ReceiveStatus.SLAudio.GetStatus()));
+        Chunk.vecFrames.push_back(std::string(chLine) + "\"" + strLabel + "\"");
+    }
+
+    pReceiver->CloseSoundInterfaces();
+
+    std::lock_guard<std::mutex> lock(SetupMutex);
+    pReceiver.reset();
+}
+
+void CBatchDecoder::WriteDoneChunks()
+{
+    /* In order, each chunk as soon as all chunks before it are written */
+    while ((iNextToWrite < vecChunks.size()) && vecChunks[iNextToWrite]->bDone)
+    {
+        WriteChunk(*vecChunks[iNextToWrite]);
+        vecChunks[iNextToWrite].reset();
+        iNextToWrite++;
+    }
+}
+
+void CBatchDecoder::WriteChunk(CChunk& Chunk)
+{
+    for (size_t i = 0; i < Chunk.vecFrames.size(); i++)
+        fprintf(pFrameFile, "%s\n", Chunk.vecFrames[i].c_str());
+    fflush(pFrameFile);
+
+    if (!bWaveOpen && (Chunk.iAudioSampleRate > 0))
+    {
+        WaveFile.Open(strOutput + ".wav", Chunk.iAudioSampleRate);
+        bWaveOpen = true;
+    }
+
+    /* Blocks produced less than half a block after the last block of the
+       previous chunk were already written by that chunk */
+    const _REAL rSeam = (rLastAudioPosition >= 0.0) ? rLastAudioPosition + DRM_FRAME_SECONDS / 2 : -1.0;
+    bool bSeamPassed = false;
+
+    for (size_t i = 0; i < Chunk.vecAudio.size(); i++)
+    {
+        const CAudioBlock& Block = Chunk.vecAudio[i];
+
+        if (!bSeamPassed && (Block.rPosition < rSeam))
+            continue;
+        bSeamPassed = true;
+
+        for (size_t j = 0; j + 1 < Block.vecsSamples.size(); j += 2)
+            WaveFile.AddStereoSample(Block.vecsSamples[j], Block.vecsSamples[j + 1]);
+        rLastAudioPosition = Block.rPosition;
+        iNumAudioBlocks++;
+    }
+
+    fprintf(stderr, "BatchDecoder: chunk %d (%.1f - %.1f s) done\n", Chunk.iIndex,
+            double(Chunk.rStart), double(Chunk.rEnd));
+}
@@ -0,0 +1,115 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Offline decoding of a long recording in parallel chunks
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#ifndef BATCHDECODER_H
+#define BATCHDECODER_H
+
+#include "../GlobalDefinitions.h"
+#include "AudioFile.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdio>
+
+class CSettings;
+
+/**
+ * @brief Decodes a memory mapped recording as fast as possible with several
+ * receivers at the same time
+ *
+ * The recording is split into chunks, each chunk is decoded by its own
+ * CDRMReceiver on its own thread. A receiver starts some seconds before its
+ * chunk (the overlap) to acquire the signal and fill the interleavers, the
+ * output produced during the overlap is thrown away. The audio and a status
+ * line per DRM frame of all chunks are written in order, as if the
+ * recording had been decoded by a single receiver.
+ *
+ * Audio is kept per 400 ms output block together with the input position it
+ * was produced at. Two receivers see the same block at input positions that
+ * differ by less than one input block, so at a seam the next chunk starts
+ * with the first block produced clearly after the last block of the
+ * previous chunk.
+ */
+class CBatchDecoder
+{
+public:
+    CBatchDecoder(CSettings* pNewSettings);
+    ~CBatchDecoder();
+
+    /**
+     * @brief Decode the input file of the settings (--fileio)
+     * @param iNumThreads Number of receivers running at the same time,
+     * 0 = number of cores
+     * @return false if the input can't be decoded in batch mode
+     */
+    bool Run(unsigned iNumThreads);
+
+    struct CAudioBlock
+    {
+        _REAL                   rPosition;
+        std::vector<_SAMPLE>    vecsSamples;
+    };
+
+    struct CChunk
+    {
+        CChunk() : iIndex(0), rStart(0.0), rEnd(0.0), iAudioSampleRate(0), bDone(false) {}
+        int                     iIndex;
+        _REAL                   rStart; /* seconds, without the overlap */
+        _REAL                   rEnd;
+        int                     iAudioSampleRate;
+        std::vector<CAudioBlock> vecAudio;
+        std::vector<std::string> vecFrames;
+        bool                    bDone;
+    };
+
+protected:
+    void                DecodeChunk(CChunk& Chunk);
+    void                WriteDoneChunks();
+    void                WriteChunk(CChunk& Chunk);
+
+    CSettings*          pSettings;
+    std::string         strFileName;
+    std::string         strOutput;
+    _REAL               rChunkSeconds;
+    _REAL               rOverlapSeconds;
+
+    std::vector<std::unique_ptr<CChunk> > vecChunks;
+    std::atomic<size_t> iNextChunk;
+    std::mutex          WriteMutex;
+    size_t              iNextToWrite;
+
+    /* Output */
+    CWaveFile           WaveFile;
+    bool                bWaveOpen;
+    FILE*               pFrameFile;
+    _REAL               rLastAudioPosition;
+    unsigned long       iNumAudioBlocks;
+};
+
+#endif // BATCHDECODER_H
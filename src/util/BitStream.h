@@ -0,0 +1,271 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Packed bit stream. Stores bits eight per byte (MSB first, the same bit
+ *  order as CVector<_BINARY>::Enqueue()/Separate()) and allows reading and
+ *  writing of up to 64 bits per call. Byte aligned block transfers are done
+ *  with memcpy() instead of bit-by-bit copies.
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#ifndef BITSTREAM_H
+#define BITSTREAM_H
+
+#include "../GlobalDefinitions.h"
+#include "Vector.h"
+#include <vector>
+#include <cstring>
+
+class CBitStream
+{
+public:
+	CBitStream() : vecbyData(), iNumBits(0), iReadPos(0), iWritePos(0) {}
+	explicit CBitStream(const int iNewNumBits) : CBitStream() {Init(iNewNumBits);}
+
+	/* Set length in bits, clear content and reset read/write positions */
+	void Init(const int iNewNumBits)
+	{
+		iNumBits = iNewNumBits;
+		vecbyData.assign((size_t(iNewNumBits) + SIZEOF__BYTE - 1) / SIZEOF__BYTE, 0);
+		ResetBitAccess();
+	}
+
+	void ResetBitAccess() {iReadPos = 0; iWritePos = 0;}
+
+	int Size() const {return iNumBits;}
+	int SizeBytes() const {return int(vecbyData.size());}
+	int BitsLeft() const {return iNumBits - iReadPos;}
+	int GetReadPos() const {return iReadPos;}
+	int GetWritePos() const {return iWritePos;}
+	bool IsByteAligned() const {return (iReadPos & 7) == 0;}
+
+	_BYTE* Data() {return vecbyData.data();}
+	const _BYTE* Data() const {return vecbyData.data();}
+	_BYTE operator[](const int i) const {return vecbyData[size_t(i)];}
+
+	/* Skip bits on the read side */
+	void Skip(const int iNumOfBits)
+	{
+		iReadPos += iNumOfBits;
+		if (iReadPos > iNumBits)
+			iReadPos = iNumBits;
+	}
+
+	/* Read up to 64 bits, MSB first. Error code (not enough bits): "0" */
+	uint64_t Separate(int iNumOfBits)
+	{
+		if (iNumOfBits <= 0 || iReadPos + iNumOfBits > iNumBits)
+			return 0;
+
+		uint64_t iInformation = 0;
+
+		/* Whole bytes if we are on a byte boundary */
+		if ((iReadPos & 7) == 0)
+		{
+			const _BYTE* p = &vecbyData[size_t(iReadPos >> 3)];
+			while (iNumOfBits >= SIZEOF__BYTE)
+			{
+				iInformation = (iInformation << SIZEOF__BYTE) | *p++;
+				iReadPos += SIZEOF__BYTE;
+				iNumOfBits -= SIZEOF__BYTE;
+			}
+		}
+
+		while (iNumOfBits > 0)
+		{
+			const int iBitsInByte = SIZEOF__BYTE - (iReadPos & 7);
+			const int iTake = iNumOfBits < iBitsInByte ? iNumOfBits : iBitsInByte;
+			const _BYTE byCur = vecbyData[size_t(iReadPos >> 3)];
+
+			iInformation = (iInformation << iTake) |
+				((byCur >> (iBitsInByte - iTake)) & ((1u << iTake) - 1));
+
+			iReadPos += iTake;
+			iNumOfBits -= iTake;
+		}
+		return iInformation;
+	}
+
+	/* Write up to 64 bits, MSB first. Bits beyond the end are dropped */
+	void Enqueue(const uint64_t iInformation, int iNumOfBits)
+	{
+		if (iNumOfBits <= 0 || iWritePos + iNumOfBits > iNumBits)
+			return;
+
+		if ((iWritePos & 7) == 0)
+		{
+			_BYTE* p = &vecbyData[size_t(iWritePos >> 3)];
+			while (iNumOfBits >= SIZEOF__BYTE)
+			{
+				iNumOfBits -= SIZEOF__BYTE;
+				*p++ = _BYTE(iInformation >> iNumOfBits);
+				iWritePos += SIZEOF__BYTE;
+			}
+		}
+
+		while (iNumOfBits > 0)
+		{
+			const int iBitsInByte = SIZEOF__BYTE - (iWritePos & 7);
+			const int iPut = iNumOfBits < iBitsInByte ? iNumOfBits : iBitsInByte;
+			const int iShift = iBitsInByte - iPut;
+			const unsigned int iMask = ((1u << iPut) - 1) << iShift;
+			const unsigned int iBits =
+				unsigned((iInformation >> (iNumOfBits - iPut)) << iShift) & iMask;
+			_BYTE& byCur = vecbyData[size_t(iWritePos >> 3)];
+
+			byCur = _BYTE((byCur & ~iMask) | iBits);
+
+			iWritePos += iPut;
+			iNumOfBits -= iPut;
+		}
+	}
+
+	/* Block read. Uses memcpy() if the read position is byte aligned. Error
+	   code (not enough bits): all "0" */
+	void SeparateBytes(_BYTE* pbyDest, const int iNumBytes)
+	{
+		if (iNumBytes <= 0)
+			return;
+
+		if (iReadPos + iNumBytes * SIZEOF__BYTE > iNumBits)
+		{
+			memset(pbyDest, 0, size_t(iNumBytes));
+			return;
+		}
+
+		if ((iReadPos & 7) == 0)
+		{
+			memcpy(pbyDest, &vecbyData[size_t(iReadPos >> 3)], size_t(iNumBytes));
+			iReadPos += iNumBytes * SIZEOF__BYTE;
+		}
+		else
+		{
+			for (int i = 0; i < iNumBytes; i++)
+				pbyDest[i] = _BYTE(Separate(SIZEOF__BYTE));
+		}
+	}
+
+	/* Block write. Uses memcpy() if the write position is byte aligned */
+	void EnqueueBytes(const _BYTE* pbySrc, const int iNumBytes)
+	{
+		if (iNumBytes <= 0 || iWritePos + iNumBytes * SIZEOF__BYTE > iNumBits)
+			return;
+
+		if ((iWritePos & 7) == 0)
+		{
+			memcpy(&vecbyData[size_t(iWritePos >> 3)], pbySrc, size_t(iNumBytes));
+			iWritePos += iNumBytes * SIZEOF__BYTE;
+		}
+		else
+		{
+			for (int i = 0; i < iNumBytes; i++)
+				Enqueue(pbySrc[i], SIZEOF__BYTE);
+		}
+	}
+
+	/* Room for writing iNumBytes bytes directly at the write position, which
+	   is advanced past them. nullptr if the position is not byte aligned or
+	   there is not enough room */
+	_BYTE* ReserveBytes(const int iNumBytes)
+	{
+		if (iNumBytes <= 0 || (iWritePos & 7) != 0 ||
+			iWritePos + iNumBytes * SIZEOF__BYTE > iNumBits)
+		{
+			return nullptr;
+		}
+		_BYTE* pbyDest = &vecbyData[size_t(iWritePos >> 3)];
+		iWritePos += iNumBytes * SIZEOF__BYTE;
+		return pbyDest;
+	}
+
+	/* Append everything written to another stream */
+	void EnqueueStream(const CBitStream& Src)
+	{
+		const int iNumBytes = Src.iWritePos / SIZEOF__BYTE;
+		EnqueueBytes(Src.Data(), iNumBytes);
+		for (int i = iNumBytes * SIZEOF__BYTE; i < Src.iWritePos; i++)
+			Enqueue((Src.vecbyData[size_t(i >> 3)] >> (7 - (i & 7))) & 1, 1);
+	}
+
+	/* Pack "one bit per element" data (e.g. a CVector<_BINARY>) */
+	void EnqueueBits(const _BINARY* pbiSrc, const int iNumOfBits)
+	{
+		int i = 0;
+
+		/* Byte aligned: pack straight into the buffer */
+		_BYTE* pbyDest = ReserveBytes(iNumOfBits / SIZEOF__BYTE);
+		if (pbyDest != nullptr)
+		{
+			for (; i + SIZEOF__BYTE <= iNumOfBits; i += SIZEOF__BYTE)
+			{
+				const _BINARY* p = pbiSrc + i;
+				*pbyDest++ = _BYTE(((p[0] & 1) << 7) | ((p[1] & 1) << 6) |
+					((p[2] & 1) << 5) | ((p[3] & 1) << 4) | ((p[4] & 1) << 3) |
+					((p[5] & 1) << 2) | ((p[6] & 1) << 1) | (p[7] & 1));
+			}
+		}
+
+		for (; i + SIZEOF__BYTE <= iNumOfBits; i += SIZEOF__BYTE)
+		{
+			const _BINARY* p = pbiSrc + i;
+			Enqueue(uint64_t(((p[0] & 1) << 7) | ((p[1] & 1) << 6) |
+				((p[2] & 1) << 5) | ((p[3] & 1) << 4) | ((p[4] & 1) << 3) |
+				((p[5] & 1) << 2) | ((p[6] & 1) << 1) | (p[7] & 1)), SIZEOF__BYTE);
+		}
+		for (; i < iNumOfBits; i++)
+			Enqueue(pbiSrc[i] & 1, 1);
+	}
+
+	/* Unpack to "one bit per element" data. Error code: all "0" */
+	void SeparateBits(_BINARY* pbiDest, const int iNumOfBits)
+	{
+		if (iReadPos + iNumOfBits > iNumBits)
+		{
+			for (int i = 0; i < iNumOfBits; i++)
+				pbiDest[i] = 0;
+			return;
+		}
+
+		for (int i = 0; i < iNumOfBits; i++, iReadPos++)
+		{
+			pbiDest[i] = _BINARY((vecbyData[size_t(iReadPos >> 3)] >>
+				(7 - (iReadPos & 7))) & 1);
+		}
+	}
+
+	/* Convenience: set the whole stream from a bit vector */
+	void Pack(CVector<_BINARY>& vecbiSrc, const int iNumOfBits)
+	{
+		Init(iNumOfBits);
+		if (iNumOfBits > 0)
+			EnqueueBits(&vecbiSrc[0], iNumOfBits);
+	}
+
+protected:
+	std::vector<_BYTE>	vecbyData;
+	int					iNumBits;
+	int					iReadPos;
+	int					iWritePos;
+};
+
+#endif // BITSTREAM_H
@@ -7,9 +7,11 @@
  *
  * Description:
 
- NOTE:
- This code is NOT speed optimized! We should calculate the CRC byte-wise and
- precalculate the results in a table (TODO!)
+ AddBit() works bit by bit on the shift register. Bytes are processed with
+ precalculated tables (one set per polynominal degree), larger blocks with
+ the "slice-by-8" method which handles eight bytes per table step. The
+ shift register is kept in the same form in both cases so that bit-wise and
+ byte-wise calls can be mixed.
 
  *
  ******************************************************************************
@@ -34,6 +36,65 @@
 
 
 /* Implementation *************************************************************/
+namespace
+{
+/* These polynominals are used in the DRM-standard. The bits for the highest
+   and the lowest order are implicit (see AddBit()) */
+const uint32_t DRMPolynMask[CRC_MAX_DEGREE] =
+{
+	0,												/* 1 */
+	1 << 1,											/* 2 */
+	1 << 1,											/* 3 */
+	0,
+	(1 << 1) | (1 << 2) | (1 << 4),					/* 5 */
+	(1 << 1) | (1 << 2) | (1 << 3) | (1 << 5),		/* 6 */
+	0,
+	(1 << 2) | (1 << 3) | (1 << 4),					/* 8 */
+	0, 0, 0, 0, 0, 0, 0,
+	(1 << 5) | (1 << 12)							/* 16 */
+};
+
+/* Tables for all degrees, built once on first use. The shift register is
+   handled left aligned in a 32 bit word so that one algorithm covers all
+   degrees. Table "k" gives the contribution of a byte which has "k" more
+   bytes following it in the same slice */
+class CCRCTables
+{
+public:
+	CCRCTables()
+	{
+		for (int iDeg = 1; iDeg <= CRC_MAX_DEGREE; iDeg++)
+		{
+			/* Full polynominal incl. the "+ 1" term, left aligned */
+			const uint32_t iPoly =
+				(DRMPolynMask[iDeg - 1] | 1) << (32 - iDeg);
+
+			uint32_t (*T)[256] = Table[iDeg - 1];
+
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				uint32_t iReg = i << 24;
+				for (int j = 0; j < SIZEOF__BYTE; j++)
+					iReg = (iReg & 0x80000000) ? (iReg << 1) ^ iPoly : iReg << 1;
+				T[0][i] = iReg;
+			}
+
+			for (int k = 1; k < CRC_SLICES; k++)
+				for (int i = 0; i < 256; i++)
+					T[k][i] = (T[k - 1][i] << 8) ^ T[0][T[k - 1][i] >> 24];
+		}
+	}
+
+	uint32_t Table[CRC_MAX_DEGREE][CRC_SLICES][256];
+};
+
+const CCRCTables& GetTables()
+{
+	static const CCRCTables Tables;
+	return Tables;
+}
+}
+
 void CCRC::Reset(const int iNewDegree)
 {
 	/* Build mask of bit, which was shifted out of the shift register */
@@ -42,6 +103,9 @@ void CCRC::Reset(const int iNewDegree)
 	/* Index of vector storing the polynominals for CRC calculation */
 	iDegIndex = iNewDegree - 1;
 
+	/* Tables for byte-wise processing */
+	pTable = GetTables().Table[iDegIndex];
+
 	/* Init state shift-register with ones. Set all registers to "1" with
 	   bit-wise not operation */
 	iStateShiftReg = ~uint32_t(0);
@@ -49,27 +113,58 @@ void CCRC::Reset(const int iNewDegree)
 
 void CCRC::AddByte(const _BYTE byNewInput)
 {
-	for (int i = 0; i < SIZEOF__BYTE; i++)
+	const int iAlign = 32 - (iDegIndex + 1);
+	uint32_t iReg = iStateShiftReg << iAlign;
+
+	iReg = (iReg << 8) ^ pTable[0][(iReg >> 24) ^ byNewInput];
+
+	iStateShiftReg = iReg >> iAlign;
+}
+
+void CCRC::AddBytes(const _BYTE* pbyNewInput, const size_t iNumBytes)
+{
+	const int iAlign = 32 - (iDegIndex + 1);
+	const uint32_t (*T)[256] = pTable;
+	uint32_t iReg = iStateShiftReg << iAlign;
+	size_t i = 0;
+
+	/* Eight bytes per step */
+	for (; i + CRC_SLICES <= iNumBytes; i += CRC_SLICES)
 	{
-		/* Shift bits in shift-register for transistion */
-		iStateShiftReg <<= 1;
-
-		/* Take bit, which was shifted out of the register-size and place it
-		   at the beginning (LSB)
-		   (If condition is not satisfied, implicitely a "0" is added) */
-		if ((iStateShiftReg & iBitOutPosMask) > 0)
-			iStateShiftReg |= 1;
-
-		/* Add new data bit to the LSB */
-		if ((byNewInput & (1 << (SIZEOF__BYTE - i - 1))) > 0)
-			iStateShiftReg ^= 1;
-
-		/* Add mask to shift-register if first bit is true */
-		if (iStateShiftReg & 1)
-			iStateShiftReg ^= iPolynMask[iDegIndex];
+		const _BYTE* p = pbyNewInput + i;
+		const uint32_t iHi = iReg ^ ((uint32_t(p[0]) << 24) |
+			(uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3]);
+
+		iReg = T[7][iHi >> 24] ^ T[6][(iHi >> 16) & 0xFF] ^
+			T[5][(iHi >> 8) & 0xFF] ^ T[4][iHi & 0xFF] ^
+			T[3][p[4]] ^ T[2][p[5]] ^ T[1][p[6]] ^ T[0][p[7]];
 	}
+
+	/* Remaining bytes */
+	for (; i < iNumBytes; i++)
+		iReg = (iReg << 8) ^ T[0][(iReg >> 24) ^ pbyNewInput[i]];
+
+	iStateShiftReg = iReg >> iAlign;
 }
 
+bool CCRC::CheckBlock(const int iNewDegree, const _BYTE* pbyBlock,
+					  const size_t iNumBytes)
+{
+	const size_t iNumCRCBytes = size_t(iNewDegree / SIZEOF__BYTE);
+
+	if (iNumBytes < iNumCRCBytes)
+		return false;
+
+	Reset(iNewDegree);
+	AddBytes(pbyBlock, iNumBytes - iNumCRCBytes);
+
+	/* CRC is transmitted MSB first at the end of the block */
+	uint32_t iCRC = 0;
+	for (size_t i = iNumBytes - iNumCRCBytes; i < iNumBytes; i++)
+		iCRC = (iCRC << SIZEOF__BYTE) | pbyBlock[i];
+
+	return CheckCRC(iCRC);
+}
 void CCRC::AddBit(const _BINARY biNewInput)
 {
 	/* Shift bits in shift-register for transistion */
@@ -107,14 +202,9 @@ bool CCRC::CheckCRC(const uint32_t iCRC)
 		return false;
 }
 
-CCRC::CCRC()
+CCRC::CCRC() : iDegIndex(0), iBitOutPosMask(0), iStateShiftReg(0),
+	pTable(GetTables().Table[0])
 {
-	/* These polynominals are used in the DRM-standard */
-	iPolynMask[0] = 0;
-	iPolynMask[1] = 1 << 1;
-	iPolynMask[2] = 1 << 1;
-	iPolynMask[4] = (1 << 1) | (1 << 2) | (1 << 4);
-	iPolynMask[5] = (1 << 1) | (1 << 2) | (1 << 3) | (1 << 5);
-	iPolynMask[7] = (1 << 2) | (1 << 3) | (1 << 4);
-	iPolynMask[15] = (1 << 5) | (1 << 12);
+	for (int i = 0; i < CRC_MAX_DEGREE; i++)
+		iPolynMask[i] = DRMPolynMask[i];
 }
@@ -30,6 +30,15 @@
 #define CRC_H__3B0BA660_CA63_4VASDGLJNAJ2B_23E7A0D31912__INCLUDED_
 
 #include "../GlobalDefinitions.h"
+#include <cstddef>
+
+
+/* Definitions ****************************************************************/
+/* Highest supported degree of the generator polynominal */
+#define CRC_MAX_DEGREE				16
+
+/* Number of bytes processed per table step in AddBytes() ("slice-by-8") */
+#define CRC_SLICES					8
 
 
 /* Classes ********************************************************************/
@@ -41,16 +50,24 @@ public:
 
 	void Reset(const int iNewDegree);
 	void AddByte(const _BYTE byNewInput);
+	void AddBytes(const _BYTE* pbyNewInput, const size_t iNumBytes);
 	void AddBit(const _BINARY biNewInput);
 	bool CheckCRC(const uint32_t iCRC);
 	uint32_t GetCRC();
 
+	/* Checks a complete block in one call. The CRC is expected in the last
+	   "iNewDegree / 8" bytes of the block (degrees 8 and 16) */
+	bool CheckBlock(const int iNewDegree, const _BYTE* pbyBlock,
+					const size_t iNumBytes);
+
 protected:
 	int			iDegIndex;
 	uint32_t	iBitOutPosMask;
 
-	uint32_t	iPolynMask[16];
+	uint32_t	iPolynMask[CRC_MAX_DEGREE];
 	uint32_t	iStateShiftReg;
+
+	const uint32_t (*pTable)[256];
 };
 
 
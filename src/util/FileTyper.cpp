@@ -29,6 +29,8 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <cctype>
+#include "../sound/sampleformat.h"
 
 #ifdef HAVE_LIBSNDFILE
 # include <sndfile.h>
@@ -85,6 +87,17 @@ FileTyper::type FileTyper::resolve(const string& str)
         c[2]='\0';
         if(strcmp(c, "AF")==0) return raw_af;
         if(strcmp(c, "PF")==0) return raw_pft;
+
+        /* Headerless samples, recognised by the extension */
+        size_t p = s.rfind('.');
+        if (p != string::npos)
+        {
+            string ext = s.substr(p + 1, s.find('_', p) - p - 1);
+            for (size_t i = 0; i < ext.length(); i++)
+                ext[i] = char(tolower(ext[i]));
+            if (CSampleFormat::FromString(ext) != SMPFMT_AUTO)
+                return pcm;
+        }
     }
     return unrecognised;
 }
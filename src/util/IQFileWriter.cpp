@@ -0,0 +1,412 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Background writer for I/Q and audio recordings, raw, WAV, FLAC or Opus,
+ *  with a bounded queue
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "IQFileWriter.h"
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <sys/stat.h>
+#ifdef HAVE_LIBSNDFILE
+# include <sndfile.h>
+#endif
+
+/* The FLAC encoder buffers, look at the real file size only now and then */
+static const unsigned WRITES_PER_STAT = 32;
+
+/* stdio buffer of raw and WAV files, so the disk sees few large writes */
+static const size_t FILE_BUFFER_SIZE = 1 << 20;
+
+static const size_t WAVE_HEADER_SIZE = 44;
+
+CIQFileWriter::CIQFileWriter()
+    : Queue(), vecFree(), iQueuedSamples(0), iMaxSamples(0), WriterThread(),
+      bRunning(false), pFile(nullptr), pSndFile(nullptr), vecFileBuffer(),
+      eCurrentFormat(IQ_RAW), iCurrentSampleRate(0), strCurrentName(),
+      iRawBytes(0), iWritesSinceStat(0), iDroppedAtOpen(0), iOpened(0),
+      iFileGeneration(0), bSkipSilence(false), iFileBytes(0), iDroppedBlocks(0),
+      iDroppedSamples(0)
+{
+}
+
+CIQFileWriter::~CIQFileWriter()
+{
+    if (WriterThread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            bRunning = false;
+        }
+        Cond.notify_all();
+        WriterThread.join();
+    }
+    CloseFile();
+}
+
+CIQFileWriter::EFormat CIQFileWriter::FormatFromString(const std::string& strName)
+{
+    if (strName == "flac")
+        return IQ_FLAC;
+    if (strName == "wav")
+        return IQ_WAV;
+    if (strName == "opus")
+        return IQ_OPUS;
+    return IQ_RAW;
+}
+
+std::string CIQFileWriter::FormatToString(const EFormat eFormat)
+{
+    switch (eFormat)
+    {
+    case IQ_FLAC:
+        return "flac";
+    case IQ_WAV:
+        return "wav";
+    case IQ_OPUS:
+        return "opus";
+    default:
+        return "raw";
+    }
+}
+
+bool CIQFileWriter::IsSupported(const EFormat eFormat)
+{
+    switch (eFormat)
+    {
+    case IQ_RAW:
+    case IQ_WAV:
+        return true;
+#ifdef HAVE_LIBSNDFILE
+    case IQ_FLAC:
+        return true;
+# ifdef SF_FORMAT_OPUS
+    case IQ_OPUS:
+        return true;
+# endif
+#endif
+    default:
+        return false;
+    }
+}
+
+bool CIQFileWriter::IsSupported(const EFormat eFormat, const int iSampleRate)
+{
+    if (!IsSupported(eFormat))
+        return false;
+    if (eFormat != IQ_OPUS)
+        return true;
+    return (iSampleRate == 8000) || (iSampleRate == 12000) || (iSampleRate == 16000) ||
+           (iSampleRate == 24000) || (iSampleRate == 48000);
+}
+
+std::string CIQFileWriter::GetExtension(const EFormat eFormat, const int iSampleRate)
+{
+    if (eFormat == IQ_RAW)
+        return "iq" + std::to_string(iSampleRate / 1000);
+    return FormatToString(eFormat);
+}
+
+unsigned long long CIQFileWriter::GetFileBytes() const
+{
+    /* Until the writer got to the last Open() the counter is the one of the
+       previous file */
+    if (iFileGeneration.load(std::memory_order_acquire) != iOpened)
+        return 0;
+    return iFileBytes.load(std::memory_order_relaxed);
+}
+
+void CIQFileWriter::SetQueueSize(const size_t iNewMaxSamples)
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+    iMaxSamples = iNewMaxSamples;
+    if (!bRunning)
+    {
+        bRunning = true;
+        WriterThread = std::thread(&CIQFileWriter::WriterLoop, this);
+    }
+}
+
+void CIQFileWriter::Open(const std::string& strFileName, const int iSampleRate, const EFormat eFormat)
+{
+    CItem Item;
+    Item.eCommand = CMD_OPEN;
+    Item.strFileName = strFileName;
+    Item.iSampleRate = iSampleRate;
+    Item.eFormat = eFormat;
+    Item.iGeneration = ++iOpened;
+    Push(Item);
+}
+
+void CIQFileWriter::Close()
+{
+    CItem Item;
+    Item.eCommand = CMD_CLOSE;
+    Item.iSampleRate = 0;
+    Item.eFormat = IQ_RAW;
+    Item.iGeneration = 0;
+    Push(Item);
+}
+
+void CIQFileWriter::Push(CItem& Item)
+{
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        Queue.push_back(std::move(Item));
+    }
+    Cond.notify_one();
+}
+
+bool CIQFileWriter::Write(const _SAMPLE* pData, const int iNumSamples)
+{
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+
+        if (!bRunning || (iQueuedSamples + size_t(iNumSamples) > iMaxSamples))
+        {
+            iDroppedBlocks.fetch_add(1, std::memory_order_relaxed);
+            iDroppedSamples.fetch_add((unsigned long)iNumSamples, std::memory_order_relaxed);
+            return false;
+        }
+
+        CItem Item;
+        Item.eCommand = CMD_WRITE;
+        Item.iSampleRate = 0;
+        Item.eFormat = IQ_RAW;
+        Item.iGeneration = 0;
+        if (!vecFree.empty())
+        {
+            Item.vecsData.swap(vecFree.back());
+            vecFree.pop_back();
+        }
+        Item.vecsData.assign(pData, pData + iNumSamples);
+
+        iQueuedSamples += size_t(iNumSamples);
+        Queue.push_back(std::move(Item));
+    }
+    Cond.notify_one();
+    return true;
+}
+
+void CIQFileWriter::WriterLoop()
+{
+    std::unique_lock<std::mutex> lock(Mutex);
+
+    for (;;)
+    {
+        while (bRunning && Queue.empty())
+            Cond.wait(lock);
+
+        /* Everything queued is written before stopping */
+        if (Queue.empty())
+            break;
+
+        CItem Item(std::move(Queue.front()));
+        Queue.pop_front();
+        lock.unlock();
+
+        switch (Item.eCommand)
+        {
+        case CMD_OPEN:
+            OpenFile(Item);
+            break;
+        case CMD_WRITE:
+            WriteFile(Item.vecsData);
+            break;
+        case CMD_CLOSE:
+            CloseFile();
+            break;
+        }
+
+        lock.lock();
+        if (Item.eCommand == CMD_WRITE)
+        {
+            iQueuedSamples -= Item.vecsData.size();
+            vecFree.push_back(std::move(Item.vecsData));
+        }
+    }
+}
+
+void CIQFileWriter::OpenFile(const CItem& Item)
+{
+    CloseFile();
+
+    strCurrentName = Item.strFileName;
+    eCurrentFormat = Item.eFormat;
+    iCurrentSampleRate = Item.iSampleRate;
+    iRawBytes = 0;
+    iWritesSinceStat = 0;
+    iDroppedAtOpen = GetDroppedBlocks();
+    iFileBytes.store(0, std::memory_order_relaxed);
+    iFileGeneration.store(Item.iGeneration, std::memory_order_release);
+
+#ifdef HAVE_LIBSNDFILE
+    if ((Item.eFormat == IQ_FLAC) || (Item.eFormat == IQ_OPUS))
+    {
+        if (!IsSupported(Item.eFormat, Item.iSampleRate))
+        {
+            fprintf(stderr, "IQFileWriter: can't create %s: %s does not take %d Hz\n", strCurrentName.c_str(),
+                    FormatToString(Item.eFormat).c_str(), Item.iSampleRate);
+            return;
+        }
+
+        SF_INFO sfinfo;
+        memset(&sfinfo, 0, sizeof(SF_INFO));
+        sfinfo.samplerate = Item.iSampleRate;
+        sfinfo.channels = 2;
+        sfinfo.format = SF_FORMAT_FLAC | SF_FORMAT_PCM_16;
+# ifdef SF_FORMAT_OPUS
+        if (Item.eFormat == IQ_OPUS)
+            sfinfo.format = SF_FORMAT_OGG | SF_FORMAT_OPUS;
+# endif
+        pSndFile = sf_open(strCurrentName.c_str(), SFM_WRITE, &sfinfo);
+        if (pSndFile == nullptr)
+            fprintf(stderr, "IQFileWriter: can't create %s: %s\n", strCurrentName.c_str(), sf_strerror(nullptr));
+        return;
+    }
+#endif
+
+    pFile = fopen(strCurrentName.c_str(), "wb");
+    if (pFile == nullptr)
+    {
+        fprintf(stderr, "IQFileWriter: can't create %s: %s\n", strCurrentName.c_str(), strerror(errno));
+        return;
+    }
+    vecFileBuffer.resize(FILE_BUFFER_SIZE);
+    setvbuf(pFile, &vecFileBuffer[0], _IOFBF, vecFileBuffer.size());
+
+    /* Sizes are filled in on close */
+    if (eCurrentFormat == IQ_WAV)
+        WriteWaveHeader(iCurrentSampleRate, 0);
+}
+
+void CIQFileWriter::WriteWaveHeader(const int iSampleRate, const unsigned long long iDataBytes)
+{
+    /* Stereo 16 bit PCM, little endian whatever the host is. The sizes are
+       limited to what RIFF can hold */
+    const uint32_t iData = uint32_t(std::min(iDataBytes, 0xFFFFFFFFull - WAVE_HEADER_SIZE));
+    const uint32_t iRate = uint32_t(iSampleRate);
+    const uint32_t iFields[] = { iData + uint32_t(WAVE_HEADER_SIZE) - 8, 16, iRate * 4, iData };
+    unsigned char h[WAVE_HEADER_SIZE];
+    memcpy(&h[0], "RIFF", 4);
+    memcpy(&h[8], "WAVEfmt ", 8);
+    memcpy(&h[36], "data", 4);
+    const size_t iPos[] = { 4, 16, 28, 40 };
+    for (size_t f = 0; f < 4; f++)
+    {
+        for (size_t b = 0; b < 4; b++)
+            h[iPos[f] + b] = uint8_t(iFields[f] >> (8 * b));
+    }
+    for (size_t b = 0; b < 4; b++)
+        h[24 + b] = uint8_t(iRate >> (8 * b));
+    h[20] = 1; h[21] = 0; /* PCM */
+    h[22] = 2; h[23] = 0; /* channels */
+    h[32] = 4; h[33] = 0; /* block align */
+    h[34] = 16; h[35] = 0; /* bits per sample */
+
+    if (fwrite(h, 1, sizeof(h), pFile) != sizeof(h))
+        fprintf(stderr, "IQFileWriter: write error on %s\n", strCurrentName.c_str());
+}
+
+void CIQFileWriter::WriteFile(const std::vector<_SAMPLE>& vecsData)
+{
+    if (bSkipSilence.load(std::memory_order_relaxed) &&
+        std::all_of(vecsData.begin(), vecsData.end(), [](const _SAMPLE s) { return s == 0; }))
+    {
+        return;
+    }
+
+#ifdef HAVE_LIBSNDFILE
+    if (pSndFile != nullptr)
+    {
+        sf_writef_short(static_cast<SNDFILE*>(pSndFile), &vecsData[0], sf_count_t(vecsData.size() / 2));
+        if (++iWritesSinceStat >= WRITES_PER_STAT)
+            UpdateFileBytes();
+        return;
+    }
+#endif
+    if (pFile == nullptr)
+        return;
+
+    /* Little endian on disk, whatever the host is */
+    unsigned char bytes[2 * 1024];
+    size_t i = 0;
+    while (i < vecsData.size())
+    {
+        size_t n = 0;
+        for (; (i < vecsData.size()) && (n < sizeof(bytes)); i++)
+        {
+            const uint16_t s = uint16_t(vecsData[i]);
+            bytes[n++] = uint8_t(s & 0xFF);
+            bytes[n++] = uint8_t(s >> 8);
+        }
+        if (fwrite(bytes, 1, n, pFile) != n)
+        {
+            fprintf(stderr, "IQFileWriter: write error on %s\n", strCurrentName.c_str());
+            fclose(pFile);
+            pFile = nullptr;
+            return;
+        }
+        iRawBytes += n;
+    }
+    iFileBytes.store(iRawBytes, std::memory_order_relaxed);
+}
+
+void CIQFileWriter::UpdateFileBytes()
+{
+    iWritesSinceStat = 0;
+    struct stat st;
+    if (stat(strCurrentName.c_str(), &st) == 0)
+        iFileBytes.store((unsigned long long)st.st_size, std::memory_order_relaxed);
+}
+
+void CIQFileWriter::CloseFile()
+{
+    if ((pFile == nullptr) && (pSndFile == nullptr))
+        return;
+
+    if (pFile != nullptr)
+    {
+        if (eCurrentFormat == IQ_WAV)
+        {
+            fflush(pFile);
+            if (fseek(pFile, 0, SEEK_SET) == 0)
+                WriteWaveHeader(iCurrentSampleRate, iRawBytes);
+        }
+        fclose(pFile);
+    }
+#ifdef HAVE_LIBSNDFILE
+    if (pSndFile != nullptr)
+        sf_close(static_cast<SNDFILE*>(pSndFile));
+#endif
+    pFile = nullptr;
+    pSndFile = nullptr;
+
+    const unsigned long iDropped = GetDroppedBlocks() - iDroppedAtOpen;
+    if (iDropped > 0)
+        fprintf(stderr, "IQFileWriter: %lu blocks dropped while writing %s\n", iDropped, strCurrentName.c_str());
+}
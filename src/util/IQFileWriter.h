@@ -0,0 +1,179 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Background writer for I/Q and audio recordings, raw, WAV, FLAC or Opus,
+ *  with a bounded queue
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#ifndef IQFILEWRITER_H
+#define IQFILEWRITER_H
+
+#include "../GlobalDefinitions.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+/**
+ * @brief Writes interleaved 16 bit stereo samples (I/Q or decoded audio) to
+ * files on its own thread
+ *
+ * The caller only copies its block into a queue, so a slow disk never
+ * stalls the receiver. The queue holds a limited amount of samples, blocks
+ * that don't fit any more are dropped and counted. Opening and closing of
+ * files go through the same queue, so a new file starts exactly with the
+ * first block written after Open().
+ *
+ * Files are raw little endian s16 or WAV, written through a large stdio
+ * buffer, or, if libsndfile is available, lossless FLAC, which about
+ * halves the size of a typical recording. Audio can also be written as
+ * Ogg/Opus if libsndfile was built with it.
+ */
+class CIQFileWriter
+{
+public:
+    enum EFormat { IQ_RAW, IQ_FLAC, IQ_WAV, IQ_OPUS };
+
+    CIQFileWriter();
+    ~CIQFileWriter();
+
+    /**
+     * @brief Format from its name ("raw", "flac", "wav", "opus"), IQ_RAW if
+     * unknown
+     */
+    static EFormat FormatFromString(const std::string& strName);
+    static std::string FormatToString(const EFormat eFormat);
+
+    /**
+     * @brief Check if files of this format can be written
+     */
+    static bool IsSupported(const EFormat eFormat);
+
+    /**
+     * @brief Check if files of this format can have this sample rate, Opus
+     * only takes 8, 12, 16, 24 and 48 kHz
+     */
+    static bool IsSupported(const EFormat eFormat, const int iSampleRate);
+
+    /**
+     * @brief File name extension for a format and sample rate, e.g. "iq48"
+     */
+    static std::string GetExtension(const EFormat eFormat, const int iSampleRate);
+
+    /**
+     * @brief Maximum number of queued samples, starts the writer thread
+     */
+    void SetQueueSize(const size_t iNewMaxSamples);
+
+    /**
+     * @brief Leave out blocks which are all zero, checked by the writer
+     * thread
+     */
+    void SetSkipSilence(const bool bNewSkip) { bSkipSilence.store(bNewSkip, std::memory_order_relaxed); }
+
+    /**
+     * @brief Close the current file (if any) and continue in a new one
+     */
+    void Open(const std::string& strFileName, const int iSampleRate, const EFormat eFormat);
+
+    /**
+     * @brief Close the current file after all queued blocks are written
+     */
+    void Close();
+
+    /**
+     * @brief Queue a block, never blocks
+     * @param pData Interleaved I/Q samples
+     * @param iNumSamples Number of samples (not frames)
+     * @return false if the block was dropped
+     */
+    bool Write(const _SAMPLE* pData, const int iNumSamples);
+
+    /**
+     * @brief Bytes on disk of the file of the last Open(), FLAC files are
+     * only looked at every few blocks
+     */
+    unsigned long long GetFileBytes() const;
+
+    unsigned long GetDroppedBlocks() const { return iDroppedBlocks.load(std::memory_order_relaxed); }
+    unsigned long GetDroppedSamples() const { return iDroppedSamples.load(std::memory_order_relaxed); }
+
+protected:
+    enum ECommand { CMD_OPEN, CMD_WRITE, CMD_CLOSE };
+
+    struct CItem
+    {
+        ECommand                eCommand;
+        std::string             strFileName;
+        int                     iSampleRate;
+        EFormat                 eFormat;
+        unsigned                iGeneration;
+        std::vector<_SAMPLE>    vecsData;
+    };
+
+    void                WriterLoop();
+    void                Push(CItem& Item);
+    void                OpenFile(const CItem& Item);
+    void                WriteFile(const std::vector<_SAMPLE>& vecsData);
+    void                CloseFile();
+    void                UpdateFileBytes();
+    void                WriteWaveHeader(const int iSampleRate, const unsigned long long iDataBytes);
+
+    /* Queue and buffers ready for reuse, so the receiver does not allocate
+       once the queue is warm */
+    std::deque<CItem>   Queue;
+    std::vector<std::vector<_SAMPLE> > vecFree;
+    size_t              iQueuedSamples;
+    size_t              iMaxSamples;
+    std::mutex          Mutex;
+    std::condition_variable Cond;
+    std::thread         WriterThread;
+    bool                bRunning;
+
+    /* Only used by the writer thread */
+    FILE*               pFile;
+    void*               pSndFile;
+    std::vector<char>   vecFileBuffer;
+    EFormat             eCurrentFormat;
+    int                 iCurrentSampleRate;
+    std::string         strCurrentName;
+    unsigned long long  iRawBytes;
+    unsigned            iWritesSinceStat;
+    unsigned long       iDroppedAtOpen;
+
+    /* Number of Open() calls, only used by the caller */
+    unsigned            iOpened;
+
+    std::atomic<unsigned>   iFileGeneration;
+    std::atomic<bool>       bSkipSilence;
+
+    std::atomic<unsigned long long> iFileBytes;
+    std::atomic<unsigned long>  iDroppedBlocks;
+    std::atomic<unsigned long>  iDroppedSamples;
+};
+
+#endif // IQFILEWRITER_H
@@ -0,0 +1,134 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Store of decoded MOT objects for the media socket of the status broadcast
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+
+#include "MediaStore.h"
+#include "../datadecoding/DABMOT.h"
+#include <cstdio>
+#include <algorithm>
+
+static void PutUInt(std::string& str, uint32_t iValue, int iBytes)
+{
+    for (int i = iBytes - 1; i >= 0; i--)
+        str += char((iValue >> (8 * i)) & 0xff);
+}
+
+CMediaStore::CMediaStore() : mapObjects(), listAge(), iNumBytes(0)
+{
+}
+
+std::shared_ptr<const std::string> CMediaStore::Put(int iStream, int iAppType,
+                                                    const CMOTObject& Obj, std::string& strRef)
+{
+    strRef = std::to_string(iStream) + "/" + std::to_string(iAppType) + "/" +
+             std::to_string(Obj.TransportID & 0xffff);
+
+    std::map<std::string, CEntry>::iterator it = mapObjects.find(strRef);
+    if (it != mapObjects.end())
+    {
+        if (it->second.iVersion == uint32_t(Obj.iUniqueBodyVersion))
+            return nullptr;
+        iNumBytes -= it->second.pFrame->size();
+        listAge.erase(it->second.itAge);
+        mapObjects.erase(it);
+    }
+
+    const int iSize = Obj.Body.vecData.Size();
+    std::shared_ptr<const std::string> pFrame = std::make_shared<const std::string>(
+        MakeFrame(uint32_t(iStream), uint16_t(iAppType), uint16_t(Obj.TransportID),
+                  uint32_t(Obj.iUniqueBodyVersion), Obj.strMimeType, Obj.strName,
+                  Obj.Body.vecData.data(), size_t(iSize)));
+
+    /* Make room, the new object stays even if it alone is larger */
+    while (!listAge.empty() &&
+           (mapObjects.size() >= MAX_OBJECTS || iNumBytes + pFrame->size() > MAX_BYTES))
+    {
+        std::map<std::string, CEntry>::iterator itOld = mapObjects.find(listAge.front());
+        iNumBytes -= itOld->second.pFrame->size();
+        mapObjects.erase(itOld);
+        listAge.pop_front();
+    }
+
+    CEntry& Entry = mapObjects[strRef];
+    Entry.iVersion = uint32_t(Obj.iUniqueBodyVersion);
+    Entry.pFrame = pFrame;
+    Entry.itAge = listAge.insert(listAge.end(), strRef);
+    iNumBytes += pFrame->size();
+    return pFrame;
+}
+
+std::shared_ptr<const std::string> CMediaStore::Get(const std::string& strRef) const
+{
+    std::map<std::string, CEntry>::const_iterator it = mapObjects.find(strRef);
+    if (it == mapObjects.end())
+        return nullptr;
+    return it->second.pFrame;
+}
+
+std::string CMediaStore::NotFoundFrame(const std::string& strRef)
+{
+    uint32_t iStream = 0;
+    uint16_t iAppType = 0, iTransportID = 0;
+    (void)ParseRef(strRef, iStream, iAppType, iTransportID);
+    return MakeFrame(iStream, iAppType, iTransportID, 0, "", "", nullptr, 0);
+}
+
+std::string CMediaStore::MakeFrame(uint32_t iStream, uint16_t iAppType, uint16_t iTransportID,
+                                   uint32_t iVersion, const std::string& strMime,
+                                   const std::string& strName, const uint8_t* pData, size_t iSize)
+{
+    const size_t iMimeLen = std::min(strMime.size(), size_t(255));
+    const size_t iNameLen = std::min(strName.size(), size_t(255));
+
+    std::string strFrame;
+    strFrame.reserve(MEDIA_FRAME_HEADER_LEN + 2 + iMimeLen + iNameLen + iSize);
+    strFrame += "DRMO";
+    PutUInt(strFrame, iStream, 4);
+    PutUInt(strFrame, iAppType, 2);
+    PutUInt(strFrame, iTransportID, 2);
+    PutUInt(strFrame, iVersion, 4);
+    PutUInt(strFrame, uint32_t(iSize), 4);
+    PutUInt(strFrame, uint32_t(iMimeLen), 1);
+    strFrame.append(strMime, 0, iMimeLen);
+    PutUInt(strFrame, uint32_t(iNameLen), 1);
+    strFrame.append(strName, 0, iNameLen);
+    if (iSize > 0)
+        strFrame.append(reinterpret_cast<const char*>(pData), iSize);
+    return strFrame;
+}
+
+bool CMediaStore::ParseRef(const std::string& strRef, uint32_t& iStream, uint16_t& iAppType,
+                           uint16_t& iTransportID)
+{
+    unsigned int s, a, t;
+    if (sscanf(strRef.c_str(), "%u/%u/%u", &s, &a, &t) != 3)
+        return false;
+    iStream = s;
+    iAppType = uint16_t(a);
+    iTransportID = uint16_t(t);
+    return true;
+}
@@ -0,0 +1,113 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Store of decoded MOT objects for the media socket of the status broadcast
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+
+#ifndef MEDIA_STORE_H_INCLUDED
+#define MEDIA_STORE_H_INCLUDED
+
+#include <string>
+#include <map>
+#include <list>
+#include <memory>
+#include <cstdint>
+
+class CMOTObject;
+
+/* Size of the fixed part of a media frame header */
+#define MEDIA_FRAME_HEADER_LEN  20
+
+/**
+ * @brief Decoded MOT objects (slideshow images, EPG), kept as ready to send
+ * binary frames
+ *
+ * Frame layout, all numbers in network byte order:
+ *
+ *  offset  size  field
+ *       0     4  "DRMO"
+ *       4     4  stream (0 for the receiver, the input number on an MDI host)
+ *       8     2  user application type (DAB_AT_*)
+ *      10     2  MOT transport ID
+ *      12     4  body version (iUniqueBodyVersion)
+ *      16     4  body size
+ *      20     1  length of the MIME type, then the MIME type
+ *       .     1  length of the object name, then the name
+ *       .        body
+ *
+ * An object is referenced as "<stream>/<application type>/<transport ID>".
+ * Each object is stored once, with its latest version, and shared by all
+ * clients. The oldest objects are dropped when the store is full.
+ */
+class CMediaStore
+{
+public:
+    CMediaStore();
+
+    /**
+     * @brief Store an object
+     * @param strRef Reference of the object
+     * @return Frame of the object, nullptr if this version is stored already
+     */
+    std::shared_ptr<const std::string> Put(int iStream, int iAppType, const CMOTObject& Obj,
+                                           std::string& strRef);
+
+    /**
+     * @brief Frame of a stored object, nullptr if unknown
+     */
+    std::shared_ptr<const std::string> Get(const std::string& strRef) const;
+
+    /**
+     * @brief Frame telling a client that an object isn't stored: the
+     * header of the reference with size 0 and version 0
+     */
+    static std::string NotFoundFrame(const std::string& strRef);
+
+    size_t GetNumObjects() const { return mapObjects.size(); }
+    size_t GetNumBytes() const { return iNumBytes; }
+
+protected:
+    struct CEntry
+    {
+        uint32_t                            iVersion;
+        std::shared_ptr<const std::string>  pFrame;
+        std::list<std::string>::iterator    itAge;
+    };
+
+    static std::string MakeFrame(uint32_t iStream, uint16_t iAppType, uint16_t iTransportID,
+                                 uint32_t iVersion, const std::string& strMime,
+                                 const std::string& strName, const uint8_t* pData, size_t iSize);
+    static bool ParseRef(const std::string& strRef, uint32_t& iStream, uint16_t& iAppType,
+                         uint16_t& iTransportID);
+
+    std::map<std::string, CEntry>   mapObjects;
+    std::list<std::string>          listAge;    // oldest first
+    size_t                          iNumBytes;
+
+    static const size_t             MAX_OBJECTS = 256;
+    static const size_t             MAX_BYTES = 64 * 1024 * 1024;
+};
+
+#endif // MEDIA_STORE_H_INCLUDED
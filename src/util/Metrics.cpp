@@ -0,0 +1,551 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Receiver metrics and their exposition over HTTP (Prometheus text format)
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+
+#include "Metrics.h"
+#include "../DrmReceiver.h"
+#include "../Parameter.h"
+#include "../MDI/MDIHost.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <iomanip>
+
+#ifndef _WIN32
+# include <sys/socket.h>
+# include <sys/un.h>
+# include <sys/stat.h>
+# include <netinet/in.h>
+# include <arpa/inet.h>
+# include <unistd.h>
+# include <poll.h>
+# include <time.h>
+# include <cerrno>
+#endif
+
+/* Without a frame for this long there is no signal */
+static const int64_t SIGNAL_TIMEOUT_MS = 2000;
+
+/* Limits of a request */
+static const size_t MAX_REQUEST_LEN = 8192;
+static const int REQUEST_TIMEOUT_MS = 1000;
+
+static const char* const ModuleNames[CReceiverMetrics::NUM_MODULES] =
+{
+    "input", "demodulation", "decoding", "utilization", "output"
+};
+
+static int64_t SteadyMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+CReceiverMetrics::CReceiverMetrics() : iFrames(0), iLastFrameMs(0),
+    rSNR(0.0), rMER(0.0), rWMER(0.0), rDoppler(0.0), rDelayMin(0.0), rDelayMax(0.0),
+    rSampleOffset(0.0), rDCFrequency(0.0), rIFLevel(0.0), iInputSamples(0), iInputSampleRate(0),
+    bAwaitAudio(false), bCachedStart(false), iStartSamples(0), iStartAudioOK(0)
+{
+    for (int i = 0; i < NUM_MODULES; i++)
+        iModuleNs[i] = 0;
+    for (int i = 0; i < 2; i++)
+    {
+        rTimeToAudio[i] = 0.0;
+        iNumTimeToAudio[i] = 0;
+    }
+    for (int i = 0; i < NUM_FAST_STARTS; i++)
+        iFastStarts[i] = 0;
+}
+
+void CReceiverMetrics::FrameDecoded(CParameter& Parameters)
+{
+    rSNR.store(Parameters.GetSNR(), std::memory_order_relaxed);
+    rMER.store(Parameters.rMER, std::memory_order_relaxed);
+    rWMER.store(Parameters.rWMERMSC, std::memory_order_relaxed);
+    rDoppler.store(Parameters.rRdop, std::memory_order_relaxed);
+    rDelayMin.store(Parameters.rMinDelay, std::memory_order_relaxed);
+    rDelayMax.store(Parameters.rMaxDelay, std::memory_order_relaxed);
+    rSampleOffset.store(Parameters.rResampleOffset, std::memory_order_relaxed);
+    rDCFrequency.store(Parameters.GetDCFrequency(), std::memory_order_relaxed);
+    rIFLevel.store(Parameters.GetIFSignalLevel(), std::memory_order_relaxed);
+    iLastFrameMs.store(SteadyMs(), std::memory_order_relaxed);
+    iFrames.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CReceiverMetrics::AcquisitionStarted(const unsigned long iAudioOK, const bool bCached)
+{
+    iStartSamples.store(iInputSamples.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    iStartAudioOK.store(iAudioOK, std::memory_order_relaxed);
+    bCachedStart.store(bCached, std::memory_order_relaxed);
+    bAwaitAudio.store(true, std::memory_order_relaxed);
+}
+
+double CReceiverMetrics::FirstAudio(const unsigned long iAudioOK, bool& bCached)
+{
+    if (!bAwaitAudio.load(std::memory_order_relaxed) ||
+        (iAudioOK == iStartAudioOK.load(std::memory_order_relaxed)))
+        return -1.0;
+    bAwaitAudio.store(false, std::memory_order_relaxed);
+
+    const int iRate = iInputSampleRate.load(std::memory_order_relaxed);
+    if (iRate <= 0)
+        return -1.0;
+    const double rSeconds = double(iInputSamples.load(std::memory_order_relaxed) -
+                                   iStartSamples.load(std::memory_order_relaxed)) / double(iRate);
+    bCached = bCachedStart.load(std::memory_order_relaxed);
+    const int iStart = bCached ? 1 : 0;
+    rTimeToAudio[iStart].store(rSeconds, std::memory_order_relaxed);
+    iNumTimeToAudio[iStart].fetch_add(1, std::memory_order_relaxed);
+    return rSeconds;
+}
+
+uint64_t CReceiverMetrics::ThreadCpuNs()
+{
+#if defined(CLOCK_THREAD_CPUTIME_ID) && !defined(_WIN32)
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+        return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+#endif
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/* HELP and TYPE of the metrics, in the order of the page */
+static const struct
+{
+    const char* pName;
+    const char* pType;
+    const char* pHelp;
+} MetricInfo[] =
+{
+    {"dream_frames_total", "counter", "DRM transmission frames decoded"},
+    {"dream_signal", "gauge", "1 if frames were decoded in the last 2 s"},
+    {"dream_input_blocks_total", "counter", "Blocks read from the input"},
+    {"dream_input_overruns_total", "counter", "Samples of stdin/pipe input dropped, reader too slow"},
+    {"dream_input_underruns_total", "counter", "Waits for stdin/pipe input"},
+    {"dream_fac_crc_total", "counter", "FAC blocks by CRC result"},
+    {"dream_sdc_crc_total", "counter", "SDC blocks by CRC result"},
+    {"dream_msc_packet_crc_total", "counter", "MSC data packets by CRC result"},
+    {"dream_audio_frames_total", "counter", "Audio frames, decoded or concealed"},
+    {"dream_snr_db", "gauge", "Signal to noise ratio"},
+    {"dream_mer_db", "gauge", "Modulation error ratio"},
+    {"dream_wmer_db", "gauge", "Weighted MER of the MSC cells"},
+    {"dream_doppler_hz", "gauge", "Doppler spread"},
+    {"dream_delay_min_ms", "gauge", "Start of the channel impulse response"},
+    {"dream_delay_max_ms", "gauge", "End of the channel impulse response"},
+    {"dream_sample_rate_offset_hz", "gauge", "Offset of the input sample rate"},
+    {"dream_dc_frequency_hz", "gauge", "Frequency of the DC carrier in the input"},
+    {"dream_if_level_db", "gauge", "Input signal level"},
+    {"dream_module_cpu_seconds_total", "counter", "CPU time of the decoding thread per module"},
+    {"dream_input_seconds_total", "counter", "Signal decoded, in seconds"},
+    {"dream_realtime_factor", "gauge", "Seconds of signal decoded per second of CPU time"},
+    {"dream_time_to_audio_seconds", "gauge", "Signal from the start of the last acquisition to the first audio"},
+    {"dream_fast_starts_total", "counter", "Acquisitions by use of the fast start cache"},
+};
+
+std::string CReceiverMetrics::Format(const std::vector<CSample>& vecSamples)
+{
+    std::ostringstream out;
+    out << std::setprecision(10);
+    for (size_t m = 0; m < sizeof(MetricInfo) / sizeof(MetricInfo[0]); m++)
+    {
+        bool bHeader = false;
+        for (size_t i = 0; i < vecSamples.size(); i++)
+        {
+            const CSample& Sample = vecSamples[i];
+            if (Sample.strName != MetricInfo[m].pName)
+                continue;
+            if (!bHeader)
+            {
+                out << "# HELP " << MetricInfo[m].pName << " " << MetricInfo[m].pHelp << "\n";
+                out << "# TYPE " << MetricInfo[m].pName << " " << MetricInfo[m].pType << "\n";
+                bHeader = true;
+            }
+            out << Sample.strName;
+            if (!Sample.strLabels.empty())
+                out << "{" << Sample.strLabels << "}";
+            out << " ";
+            if (std::isfinite(Sample.rValue))
+                out << Sample.rValue;
+            else
+                out << "NaN";
+            out << "\n";
+        }
+    }
+    return out.str();
+}
+
+static void AddValue(std::vector<CReceiverMetrics::CSample>& vecSamples, const char* pName,
+                     const std::string& strLabels, const std::string& strExtra, double rValue)
+{
+    CReceiverMetrics::CSample Sample;
+    Sample.strName = pName;
+    Sample.strLabels = strLabels;
+    if (!strLabels.empty() && !strExtra.empty())
+        Sample.strLabels += ",";
+    Sample.strLabels += strExtra;
+    Sample.rValue = rValue;
+    vecSamples.push_back(Sample);
+}
+
+static void AddStatus(std::vector<CReceiverMetrics::CSample>& vecSamples, const char* pName,
+                      const std::string& strLabels, unsigned long iOK, unsigned long iFailed,
+                      const char* pFailed)
+{
+    AddValue(vecSamples, pName, strLabels, "result=\"ok\"", double(iOK));
+    AddValue(vecSamples, pName, strLabels, std::string("result=\"") + pFailed + "\"", double(iFailed));
+}
+
+void CReceiverMetrics::Collect(std::vector<CSample>& vecSamples, CParameter& Parameters,
+                               const std::string& strLabels) const
+{
+    const bool bSignal = (iFrames.load(std::memory_order_relaxed) > 0) &&
+        (SteadyMs() - iLastFrameMs.load(std::memory_order_relaxed) < SIGNAL_TIMEOUT_MS);
+
+    AddValue(vecSamples, "dream_frames_total", strLabels, "", double(iFrames.load(std::memory_order_relaxed)));
+    AddValue(vecSamples, "dream_signal", strLabels, "", bSignal ? 1.0 : 0.0);
+
+    CReceiveStatus& Status = Parameters.ReceiveStatus;
+    AddStatus(vecSamples, "dream_input_blocks_total", strLabels,
+              Status.InterfaceI.GetTotalOK(), Status.InterfaceI.GetTotalFailed(), "error");
+    AddStatus(vecSamples, "dream_fac_crc_total", strLabels,
+              Status.FAC.GetTotalOK(), Status.FAC.GetTotalFailed(), "error");
+    AddStatus(vecSamples, "dream_sdc_crc_total", strLabels,
+              Status.SDC.GetTotalOK(), Status.SDC.GetTotalFailed(), "error");
+
+    unsigned long iPacketsOK = 0, iPacketsFailed = 0;
+    for (size_t i = 0; i < Parameters.DataComponentStatus.size(); i++)
+    {
+        iPacketsOK += Parameters.DataComponentStatus[i].GetTotalOK();
+        iPacketsFailed += Parameters.DataComponentStatus[i].GetTotalFailed();
+    }
+    AddStatus(vecSamples, "dream_msc_packet_crc_total", strLabels, iPacketsOK, iPacketsFailed, "error");
+    AddStatus(vecSamples, "dream_audio_frames_total", strLabels,
+              Status.SLAudio.GetTotalOK(), Status.SLAudio.GetTotalFailed(), "concealed");
+
+    /* Measurements are only current with signal */
+    if (bSignal)
+    {
+        AddValue(vecSamples, "dream_snr_db", strLabels, "", rSNR.load());
+        AddValue(vecSamples, "dream_mer_db", strLabels, "", rMER.load());
+        AddValue(vecSamples, "dream_wmer_db", strLabels, "", rWMER.load());
+        AddValue(vecSamples, "dream_doppler_hz", strLabels, "", rDoppler.load());
+        AddValue(vecSamples, "dream_delay_min_ms", strLabels, "", rDelayMin.load());
+        AddValue(vecSamples, "dream_delay_max_ms", strLabels, "", rDelayMax.load());
+        AddValue(vecSamples, "dream_sample_rate_offset_hz", strLabels, "", rSampleOffset.load());
+        AddValue(vecSamples, "dream_dc_frequency_hz", strLabels, "", rDCFrequency.load());
+        AddValue(vecSamples, "dream_if_level_db", strLabels, "", rIFLevel.load());
+    }
+
+    double rCpuSeconds = 0.0;
+    for (int i = 0; i < NUM_MODULES; i++)
+    {
+        const double rSeconds = double(iModuleNs[i].load(std::memory_order_relaxed)) * 1e-9;
+        AddValue(vecSamples, "dream_module_cpu_seconds_total", strLabels,
+                 std::string("module=\"") + ModuleNames[i] + "\"", rSeconds);
+        rCpuSeconds += rSeconds;
+    }
+
+    const int iRate = iInputSampleRate.load(std::memory_order_relaxed);
+    const double rInputSeconds = (iRate > 0) ?
+        double(iInputSamples.load(std::memory_order_relaxed)) / double(iRate) : 0.0;
+    AddValue(vecSamples, "dream_input_seconds_total", strLabels, "", rInputSeconds);
+    if (rCpuSeconds > 0.0 && rInputSeconds > 0.0)
+        AddValue(vecSamples, "dream_realtime_factor", strLabels, "", rInputSeconds / rCpuSeconds);
+
+    static const char* const StartNames[2] = { "cold", "cached" };
+    for (int i = 0; i < 2; i++)
+    {
+        if (iNumTimeToAudio[i].load(std::memory_order_relaxed) > 0)
+            AddValue(vecSamples, "dream_time_to_audio_seconds", strLabels,
+                     std::string("start=\"") + StartNames[i] + "\"", rTimeToAudio[i].load());
+    }
+
+    static const char* const FastStartNames[NUM_FAST_STARTS] =
+    {
+        "cold", "hit", "stale", "mismatch", "failed"
+    };
+    unsigned long iNumFastStarts = 0;
+    for (int i = 0; i < NUM_FAST_STARTS; i++)
+        iNumFastStarts += iFastStarts[i].load(std::memory_order_relaxed);
+    for (int i = 0; (i < NUM_FAST_STARTS) && (iNumFastStarts > 0); i++)
+        AddValue(vecSamples, "dream_fast_starts_total", strLabels,
+                 std::string("result=\"") + FastStartNames[i] + "\"",
+                 double(iFastStarts[i].load(std::memory_order_relaxed)));
+}
+
+CMetricsServer::CMetricsServer() : pDRMReceiver(nullptr), pHost(nullptr), strUnixPath(),
+    iServerFd(-1), ServerThread(), bRunning(false)
+{
+}
+
+CMetricsServer::~CMetricsServer()
+{
+    Stop();
+}
+
+bool CMetricsServer::Start(CDRMReceiver* pReceiver, const std::string& strAddress)
+{
+    if (bRunning || pReceiver == nullptr)
+        return false;
+    pDRMReceiver = pReceiver;
+    pHost = nullptr;
+    return Listen(strAddress);
+}
+
+bool CMetricsServer::Start(CMDIHost* pNewHost, const std::string& strAddress)
+{
+    if (bRunning || pNewHost == nullptr)
+        return false;
+    pDRMReceiver = nullptr;
+    pHost = pNewHost;
+    return Listen(strAddress);
+}
+
+bool CMetricsServer::Listen(const std::string& strAddress)
+{
+#ifdef _WIN32
+    (void)strAddress;
+    fprintf(stderr, "MetricsServer: Not implemented on Windows\n");
+    return false;
+#else
+    if (strAddress.compare(0, 5, "unix:") == 0)
+    {
+        strUnixPath = strAddress.substr(5);
+        struct stat st;
+        if (stat(strUnixPath.c_str(), &st) == 0)
+            unlink(strUnixPath.c_str());
+
+        iServerFd = socket(AF_UNIX, SOCK_STREAM, 0);
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, strUnixPath.c_str(), sizeof(addr.sun_path) - 1);
+        if (iServerFd < 0 || ::bind(iServerFd, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+        {
+            fprintf(stderr, "MetricsServer: can't bind to %s: %s\n", strUnixPath.c_str(), strerror(errno));
+            if (iServerFd >= 0)
+                close(iServerFd);
+            iServerFd = -1;
+            strUnixPath.clear();
+            return false;
+        }
+    }
+    else
+    {
+        /* [address:]port, only the local host unless an address is given */
+        std::string strHost = "127.0.0.1";
+        std::string strPort = strAddress;
+        const size_t iColon = strAddress.rfind(':');
+        if (iColon != std::string::npos)
+        {
+            strHost = strAddress.substr(0, iColon);
+            strPort = strAddress.substr(iColon + 1);
+        }
+
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(uint16_t(atoi(strPort.c_str())));
+        if (addr.sin_port == 0 || inet_pton(AF_INET, strHost.c_str(), &addr.sin_addr) != 1)
+        {
+            fprintf(stderr, "MetricsServer: invalid address %s\n", strAddress.c_str());
+            return false;
+        }
+
+        iServerFd = socket(AF_INET, SOCK_STREAM, 0);
+        const int iOne = 1;
+        if (iServerFd >= 0)
+            setsockopt(iServerFd, SOL_SOCKET, SO_REUSEADDR, &iOne, sizeof(iOne));
+        if (iServerFd < 0 || ::bind(iServerFd, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+        {
+            fprintf(stderr, "MetricsServer: can't bind to %s: %s\n", strAddress.c_str(), strerror(errno));
+            if (iServerFd >= 0)
+                close(iServerFd);
+            iServerFd = -1;
+            return false;
+        }
+    }
+
+    if (listen(iServerFd, 8) < 0)
+    {
+        fprintf(stderr, "MetricsServer: can't listen: %s\n", strerror(errno));
+        close(iServerFd);
+        iServerFd = -1;
+        return false;
+    }
+
+    bRunning = true;
+    ServerThread = std::thread(&CMetricsServer::ServerLoop, this);
+    fprintf(stderr, "MetricsServer: metrics on %s\n", strAddress.c_str());
+    return true;
+#endif
+}
+
+void CMetricsServer::Stop()
+{
+#ifndef _WIN32
+    if (!bRunning)
+        return;
+    bRunning = false;
+    if (ServerThread.joinable())
+        ServerThread.join();
+    close(iServerFd);
+    iServerFd = -1;
+    if (!strUnixPath.empty())
+    {
+        unlink(strUnixPath.c_str());
+        strUnixPath.clear();
+    }
+#endif
+}
+
+void CMetricsServer::ServerLoop()
+{
+#ifndef _WIN32
+    while (bRunning)
+    {
+        /* Wake up now and then to see if we shall stop */
+        struct pollfd pfd;
+        pfd.fd = iServerFd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, 500) <= 0)
+            continue;
+
+        const int fd = accept(iServerFd, nullptr, nullptr);
+        if (fd < 0)
+            continue;
+        Serve(fd);
+        close(fd);
+    }
+#endif
+}
+
+void CMetricsServer::Serve(int fd)
+{
+#ifndef _WIN32
+    /* Read the request head, only its first line matters */
+    std::string strRequest;
+    char buf[1024];
+    while (strRequest.find("\r\n\r\n") == std::string::npos &&
+           strRequest.find("\n\n") == std::string::npos)
+    {
+        struct pollfd pfd;
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, REQUEST_TIMEOUT_MS) <= 0)
+            return;
+        const ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0)
+            return;
+        strRequest.append(buf, size_t(n));
+        if (strRequest.size() > MAX_REQUEST_LEN)
+            return;
+    }
+
+    const std::string strLine = strRequest.substr(0, strRequest.find_first_of("\r\n"));
+    std::string strStatus = "200 OK";
+    std::string strBody;
+    if (strLine.compare(0, 4, "GET ") != 0 && strLine.compare(0, 5, "HEAD ") != 0)
+    {
+        strStatus = "405 Method Not Allowed";
+    }
+    else
+    {
+        const size_t iPath = strLine.find(' ') + 1;
+        const std::string strPath = strLine.substr(iPath, strLine.find(' ', iPath) - iPath);
+        if (strPath == "/metrics" || strPath == "/")
+            strBody = CollectMetrics();
+        else
+            strStatus = "404 Not Found";
+    }
+
+    std::ostringstream Response;
+    Response << "HTTP/1.0 " << strStatus << "\r\n"
+             << "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+             << "Content-Length: " << strBody.size() << "\r\n"
+             << "Connection: close\r\n\r\n";
+    if (strLine.compare(0, 5, "HEAD ") != 0)
+        Response << strBody;
+
+    const std::string strResponse = Response.str();
+    size_t iSent = 0;
+    while (iSent < strResponse.size())
+    {
+        struct pollfd pfd;
+        pfd.fd = fd;
+        pfd.events = POLLOUT;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, REQUEST_TIMEOUT_MS) <= 0)
+            return;
+        const ssize_t n = send(fd, strResponse.data() + iSent, strResponse.size() - iSent, MSG_NOSIGNAL);
+        if (n <= 0)
+            return;
+        iSent += size_t(n);
+    }
+#else
+    (void)fd;
+#endif
+}
+
+std::string CMetricsServer::CollectMetrics()
+{
+    std::vector<CReceiverMetrics::CSample> vecSamples;
+
+    if (pHost != nullptr)
+    {
+        for (size_t i = 0; i < pHost->GetNumStreams(); i++)
+        {
+            CMDIStream& Stream = pHost->GetStream(i);
+            Stream.GetMetrics().Collect(vecSamples, Stream.GetParameters(),
+                                        "stream=\"" + std::to_string(Stream.GetId()) + "\"");
+        }
+    }
+    else if (pDRMReceiver != nullptr)
+    {
+        pDRMReceiver->GetMetrics().Collect(vecSamples, *pDRMReceiver->GetParameters(), "");
+
+        unsigned long iOverruns = 0, iUnderruns = 0;
+        _REAL rBufferedSeconds = 0.0;
+        if (pDRMReceiver->GetReceiveData()->GetPipeStats(iOverruns, iUnderruns, rBufferedSeconds))
+        {
+            CReceiverMetrics::CSample Sample;
+            Sample.strName = "dream_input_overruns_total";
+            Sample.rValue = double(iOverruns);
+            vecSamples.push_back(Sample);
+            Sample.strName = "dream_input_underruns_total";
+            Sample.rValue = double(iUnderruns);
+            vecSamples.push_back(Sample);
+        }
+    }
+
+    return CReceiverMetrics::Format(vecSamples);
+}
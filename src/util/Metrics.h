@@ -0,0 +1,216 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Receiver metrics and their exposition over HTTP (Prometheus text format)
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+
+#ifndef METRICS_H_INCLUDED
+#define METRICS_H_INCLUDED
+
+#include "../GlobalDefinitions.h"
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+
+class CParameter;
+class CDRMReceiver;
+class CMDIHost;
+
+/**
+ * @brief Health and performance values of one receiver context
+ *
+ * Written by the decoding thread, read by the metrics server. Everything
+ * is an atomic, the decoding thread only stores numbers: once per frame
+ * for the measurements and around the modules for their CPU time.
+ * Formatting is left to the server. CRC counts come from the CRxStatus
+ * totals of the parameters.
+ */
+class CReceiverMetrics
+{
+public:
+    enum EModule { MOD_INPUT, MOD_DEMODULATION, MOD_DECODING, MOD_UTILIZATION, MOD_OUTPUT,
+                   NUM_MODULES };
+
+    CReceiverMetrics();
+
+    /**
+     * @brief Take the measurements of a decoded frame
+     */
+    void FrameDecoded(CParameter& Parameters);
+
+    /**
+     * @brief Add the CPU time of a module
+     * @param iStartNs ThreadCpuNs() when the module was entered
+     * @return ThreadCpuNs() now, the start of the next module
+     */
+    uint64_t AddModuleTime(const EModule eModule, const uint64_t iStartNs)
+    {
+        const uint64_t iNow = ThreadCpuNs();
+        iModuleNs[eModule].fetch_add(iNow - iStartNs, std::memory_order_relaxed);
+        return iNow;
+    }
+
+    /**
+     * @brief Count input samples at the signal sample rate
+     */
+    void AddInputSamples(const unsigned long iSamples, const int iSampleRate)
+    {
+        iInputSamples.fetch_add(iSamples, std::memory_order_relaxed);
+        iInputSampleRate.store(iSampleRate, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Input counted so far, in seconds of signal
+     */
+    double GetInputSeconds() const
+    {
+        const int iRate = iInputSampleRate.load(std::memory_order_relaxed);
+        return (iRate > 0) ? double(iInputSamples.load(std::memory_order_relaxed)) / double(iRate) : 0.0;
+    }
+
+    /* How an acquisition made use of the fast start cache */
+    enum EFastStart { FS_COLD, FS_HIT, FS_STALE, FS_MISMATCH, FS_FAILED, NUM_FAST_STARTS };
+
+    /**
+     * @brief Start of an acquisition, the time to the first audio counts
+     * from here
+     * @param iAudioOK Audio frames decoded so far
+     * @param bCached Acquisition seeded from the fast start cache
+     */
+    void AcquisitionStarted(const unsigned long iAudioOK, const bool bCached);
+
+    /**
+     * @brief Check for the first audio frame since the start of the
+     * acquisition
+     * @param bCached Set to whether the acquisition was a fast start
+     * @return Seconds of input signal it took, negative if there was none
+     * or it was counted already
+     */
+    double FirstAudio(const unsigned long iAudioOK, bool& bCached);
+
+    void AddFastStart(const EFastStart eResult)
+    {
+        iFastStarts[eResult].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief CPU time of the calling thread in ns, wall clock where there
+     * is no thread CPU clock
+     */
+    static uint64_t ThreadCpuNs();
+
+    /**
+     * @brief One value of a metric
+     */
+    struct CSample
+    {
+        std::string strName;
+        std::string strLabels;  // "name=\"value\",..." without braces
+        double      rValue;
+    };
+
+    /**
+     * @brief Add the current values
+     * @param strLabels Labels for all values, e.g. "stream=\"1\"", may be empty
+     */
+    void Collect(std::vector<CSample>& vecSamples, CParameter& Parameters,
+                 const std::string& strLabels) const;
+
+    /**
+     * @brief Prometheus text format, values of a metric grouped under its
+     * HELP and TYPE lines
+     */
+    static std::string Format(const std::vector<CSample>& vecSamples);
+
+protected:
+    std::atomic<unsigned long>  iFrames;
+    std::atomic<int64_t>        iLastFrameMs;   // steady clock
+
+    std::atomic<double>         rSNR;
+    std::atomic<double>         rMER;
+    std::atomic<double>         rWMER;
+    std::atomic<double>         rDoppler;
+    std::atomic<double>         rDelayMin;
+    std::atomic<double>         rDelayMax;
+    std::atomic<double>         rSampleOffset;
+    std::atomic<double>         rDCFrequency;
+    std::atomic<double>         rIFLevel;
+
+    std::atomic<uint64_t>       iModuleNs[NUM_MODULES];
+    std::atomic<uint64_t>       iInputSamples;
+    std::atomic<int>            iInputSampleRate;
+
+    /* Time to the first audio, in seconds of signal so it does not depend
+       on the speed of decoding, last value per start (cold, cached) */
+    std::atomic<bool>           bAwaitAudio;
+    std::atomic<bool>           bCachedStart;
+    std::atomic<uint64_t>       iStartSamples;
+    std::atomic<unsigned long>  iStartAudioOK;
+    std::atomic<double>         rTimeToAudio[2];
+    std::atomic<unsigned long>  iNumTimeToAudio[2];
+    std::atomic<unsigned long>  iFastStarts[NUM_FAST_STARTS];
+};
+
+/**
+ * @brief Minimal HTTP server for the metrics of the receiver or of the
+ * streams of an MDI host
+ *
+ * Listens on a Unix Domain Socket ("unix:<path>") or a TCP port ("<port>"
+ * or "<address>:<port>", the address defaults to 127.0.0.1). Each request
+ * is answered with the current metrics and the connection is closed.
+ * Requests are served one after the other on the server thread, which is
+ * plenty for a scraper every few seconds.
+ */
+class CMetricsServer
+{
+public:
+    CMetricsServer();
+    ~CMetricsServer();
+
+    bool Start(CDRMReceiver* pReceiver, const std::string& strAddress);
+    bool Start(CMDIHost* pNewHost, const std::string& strAddress);
+    void Stop();
+
+    /**
+     * @brief Metrics page in Prometheus text format
+     */
+    std::string CollectMetrics();
+
+protected:
+    bool Listen(const std::string& strAddress);
+    void ServerLoop();
+    void Serve(int fd);
+
+    CDRMReceiver*           pDRMReceiver;
+    CMDIHost*               pHost;
+    std::string             strUnixPath;
+    int                     iServerFd;
+    std::thread             ServerThread;
+    std::atomic<bool>       bRunning;
+};
+
+#endif // METRICS_H_INCLUDED
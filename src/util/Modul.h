@@ -1278,6 +1278,20 @@ bool CSimulationModul<TInput, TOutput, TInOut2>::
 template<class TInput>
 class CSplitModul: public CReceiverModul<TInput, TInput>
 {
+public:
+	using CReceiverModul<TInput, TInput>::ProcessData;
+
+	/* Two way split. Forget the third output of a previous three way split */
+	virtual bool ProcessData(CParameter& Parameters,
+							 CBuffer<TInput>& InputBuffer,
+							 CBuffer<TInput>& OutputBuffer,
+							 CBuffer<TInput>& OutputBuffer2)
+	{
+		this->pvecOutputData3 = nullptr;
+		return CReceiverModul<TInput, TInput>::ProcessData(Parameters,
+			InputBuffer, OutputBuffer, OutputBuffer2);
+	}
+
 protected:
 	virtual void SetInputBlockSize(CParameter& Parameters) = 0;
 
@@ -1286,6 +1300,7 @@ protected:
 		this->SetInputBlockSize(Parameters);
 		this->iOutputBlockSize = this->iInputBlockSize;
 		this->iOutputBlockSize2 = this->iInputBlockSize;
+		this->iOutputBlockSize3 = this->iInputBlockSize;
 	}
 
 	virtual void ProcessDataInternal(CParameter&)
@@ -1296,6 +1311,13 @@ protected:
 			(*this->pvecOutputData)[i] = n;
 			(*this->pvecOutputData2)[i] = n;
 		}
+
+		/* Optional third output */
+		if (this->pvecOutputData3 != nullptr)
+		{
+			for (int i = 0; i < this->iInputBlockSize; i++)
+				(*this->pvecOutputData3)[i] = (*(this->pvecInputData))[i];
+		}
 	}
 };
 
@@ -0,0 +1,436 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Non-blocking raw PCM output to a file, a named pipe, a Unix domain
+ *  socket, stdout or a shared memory ring
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "PcmSink.h"
+
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#include "../linux/pa_shm_ringbuffer.h"
+#else
+#include <io.h>
+#include <fcntl.h>
+#endif
+
+#include <cstring>
+#include <atomic>
+#include <algorithm>
+
+#ifndef MSG_NOSIGNAL
+# define MSG_NOSIGNAL 0
+#endif
+
+static const char UNIX_SOCKET_PREFIX[] = "unix:";
+static const char SHM_PREFIX[] = "shm:";
+static const char STDOUT_TARGET[] = "-";
+
+/* Data size of a shared memory ring the sink creates, about 5 s of 48 kHz
+   stereo s16. Must be a power of two */
+static const size_t SHM_RING_BYTES = 1 << 20;
+
+/* Minimum time between two attempts to reopen a pipe or socket */
+static const int RETRY_INTERVAL_MS = 1000;
+
+CPcmSink::CPcmSink()
+    : strTarget(), eType(TT_FILE), eFormat(SMPFMT_S16),
+#ifdef _WIN32
+      pFile(nullptr),
+#else
+      iFd(-1), pShm(nullptr), iShmSize(0),
+#endif
+      vecfConvert(), vecsConvert(), vecPending(), iDroppedSamples(0), LastRetry()
+{
+}
+
+CPcmSink::~CPcmSink()
+{
+    Close();
+}
+
+bool CPcmSink::Open(const std::string& strNewTarget)
+{
+    Close();
+
+    strTarget = strNewTarget;
+    if (strTarget.compare(0, sizeof(UNIX_SOCKET_PREFIX) - 1, UNIX_SOCKET_PREFIX) == 0)
+        eType = TT_SOCKET;
+    else if (strTarget.compare(0, sizeof(SHM_PREFIX) - 1, SHM_PREFIX) == 0)
+        eType = TT_SHM;
+    else if (strTarget == STDOUT_TARGET)
+        eType = TT_STDOUT;
+    else
+        eType = TT_FILE;
+    iDroppedSamples = 0;
+    LastRetry = std::chrono::steady_clock::time_point();
+
+    if (strTarget.empty())
+        return false;
+
+    if (!Reopen())
+    {
+        fprintf(stderr, "PcmSink: %s not ready yet, will retry\n", strTarget.c_str());
+        return false;
+    }
+    return true;
+}
+
+void CPcmSink::Close()
+{
+#ifdef _WIN32
+    if (pFile != nullptr)
+    {
+        if (pFile != stdout)
+            fclose(pFile);
+        pFile = nullptr;
+    }
+#else
+    if (pShm != nullptr)
+    {
+        munmap(pShm, iShmSize);
+        pShm = nullptr;
+        iShmSize = 0;
+    }
+    if (iFd >= 0)
+    {
+        if (iFd != STDOUT_FILENO)
+            close(iFd);
+        iFd = -1;
+    }
+#endif
+    vecPending.clear();
+}
+
+bool CPcmSink::IsOpen() const
+{
+#ifdef _WIN32
+    return pFile != nullptr;
+#else
+    return iFd >= 0;
+#endif
+}
+
+void CPcmSink::SetFormat(const ESampleFormat eNewFormat)
+{
+    eFormat = (eNewFormat == SMPFMT_F32) ? SMPFMT_F32 : SMPFMT_S16;
+}
+
+bool CPcmSink::Reopen()
+{
+    if (IsOpen())
+        return true;
+
+    if (strTarget.empty())
+        return false;
+
+    const std::chrono::steady_clock::time_point Now = std::chrono::steady_clock::now();
+    if (Now - LastRetry < std::chrono::milliseconds(RETRY_INTERVAL_MS))
+        return false;
+    LastRetry = Now;
+
+#ifdef _WIN32
+    /* Plain files and stdout only */
+    if (eType == TT_STDOUT)
+    {
+        _setmode(_fileno(stdout), _O_BINARY);
+        pFile = stdout;
+        return true;
+    }
+    if (eType != TT_FILE)
+        return false;
+    pFile = fopen(strTarget.c_str(), "ab");
+    return pFile != nullptr;
+#else
+    if (eType == TT_STDOUT)
+    {
+        /* A consumer which stops reading must not stall the receiver */
+        fcntl(STDOUT_FILENO, F_SETFL, fcntl(STDOUT_FILENO, F_GETFL, 0) | O_NONBLOCK);
+        iFd = STDOUT_FILENO;
+    }
+    else if (eType == TT_SHM)
+    {
+        if (!OpenShm(strTarget.substr(sizeof(SHM_PREFIX) - 1)))
+            return false;
+    }
+    else if (eType == TT_SOCKET)
+    {
+        const std::string strPath = strTarget.substr(sizeof(UNIX_SOCKET_PREFIX) - 1);
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (strPath.size() >= sizeof(addr.sun_path))
+            return false;
+        strncpy(addr.sun_path, strPath.c_str(), sizeof(addr.sun_path) - 1);
+
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0)
+            return false;
+        if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0)
+        {
+            close(fd);
+            return false;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        iFd = fd;
+    }
+    else
+    {
+        /* O_NONBLOCK makes opening a FIFO without reader fail (ENXIO)
+           instead of waiting for one */
+        iFd = open(strTarget.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_NONBLOCK, 0644);
+        if (iFd < 0)
+            return false;
+    }
+    fprintf(stderr, "PcmSink: writing to %s\n", strTarget.c_str());
+    return true;
+#endif
+}
+
+bool CPcmSink::OpenShm(const std::string& strName)
+{
+#ifdef _WIN32
+    (void)strName;
+    return false;
+#else
+    const std::string strPath = (strName.compare(0, 1, "/") == 0) ? strName : "/" + strName;
+    const int fd = shm_open(strPath.c_str(), O_RDWR | O_CREAT, 0666);
+    if (fd < 0)
+        return false;
+
+    /* Keep a ring the reader has set up already, as long as it is valid */
+    struct stat st;
+    size_t iSize = 0;
+    bool bValid = false;
+    if (fstat(fd, &st) == 0 && size_t(st.st_size) > sizeof(PaUtilShmRingBuffer))
+    {
+        iSize = size_t(st.st_size);
+        void* p = mmap(nullptr, iSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p != MAP_FAILED)
+        {
+            const PaUtilShmRingBuffer* pRing = static_cast<const PaUtilShmRingBuffer*>(p);
+            const long iBytes = pRing->bufferSize;
+            bValid = (iBytes > 0) && ((iBytes & (iBytes - 1)) == 0) &&
+                     (size_t(iBytes) + sizeof(PaUtilShmRingBuffer) <= iSize) &&
+                     (pRing->smallMask == iBytes - 1) && (pRing->bigMask == 2 * iBytes - 1);
+            if (bValid)
+                pShm = p;
+            else
+                munmap(p, iSize);
+        }
+    }
+
+    if (!bValid)
+    {
+        iSize = sizeof(PaUtilShmRingBuffer) + SHM_RING_BYTES;
+        void* p = MAP_FAILED;
+        if (ftruncate(fd, off_t(iSize)) == 0)
+            p = mmap(nullptr, iSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED)
+        {
+            close(fd);
+            return false;
+        }
+        PaUtilShmRingBuffer* pRing = static_cast<PaUtilShmRingBuffer*>(p);
+        pRing->bufferSize = long(SHM_RING_BYTES);
+        pRing->readIndex = 0;
+        pRing->writeIndex = 0;
+        pRing->bigMask = long(2 * SHM_RING_BYTES - 1);
+        pRing->smallMask = long(SHM_RING_BYTES - 1);
+        pShm = p;
+    }
+    else
+    {
+        /* Whatever an earlier writer left is stale, start empty */
+        PaUtilShmRingBuffer* pRing = static_cast<PaUtilShmRingBuffer*>(pShm);
+        pRing->writeIndex = pRing->readIndex;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    iFd = fd;
+    iShmSize = iSize;
+    return true;
+#endif
+}
+
+bool CPcmSink::WriteShm(const char* pData, size_t iLen)
+{
+#ifdef _WIN32
+    (void)pData;
+    (void)iLen;
+    return false;
+#else
+    PaUtilShmRingBuffer* pRing = static_cast<PaUtilShmRingBuffer*>(pShm);
+    volatile long* piReadIndex = &pRing->readIndex;
+    const long iWriteIndex = pRing->writeIndex;
+
+    /* Only the reader moves the read index */
+    const long iUsed = (iWriteIndex - *piReadIndex) & pRing->bigMask;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (size_t(pRing->bufferSize - iUsed) < iLen)
+        return false;
+
+    char* pBuffer = reinterpret_cast<char*>(pRing + 1);
+    const size_t iIndex = size_t(iWriteIndex & pRing->smallMask);
+    const size_t iFirst = std::min(iLen, size_t(pRing->bufferSize) - iIndex);
+    memcpy(pBuffer + iIndex, pData, iFirst);
+    memcpy(pBuffer, pData + iFirst, iLen - iFirst);
+
+    /* The data must be visible before the reader sees the new index */
+    std::atomic_thread_fence(std::memory_order_release);
+    *static_cast<volatile long*>(&pRing->writeIndex) = (iWriteIndex + long(iLen)) & pRing->bigMask;
+    return true;
+#endif
+}
+
+long CPcmSink::WriteBytes(const char* pData, size_t iLen)
+{
+#ifdef _WIN32
+    return long(fwrite(pData, 1, iLen, pFile));
+#else
+    ssize_t n;
+    if (eType == TT_SOCKET)
+        n = send(iFd, pData, iLen, MSG_NOSIGNAL);
+    else
+        n = write(iFd, pData, iLen);
+
+    if (n < 0)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+            return 0;
+        return -1;
+    }
+    return long(n);
+#endif
+}
+
+bool CPcmSink::Write(const _SAMPLE* pData, int iNumSamples)
+{
+    if (iNumSamples <= 0)
+        return true;
+
+    if (!IsOpen() && !Reopen())
+    {
+        iDroppedSamples += unsigned(iNumSamples);
+        return false;
+    }
+
+    if (eFormat == SMPFMT_F32)
+    {
+        vecfConvert.resize(size_t(iNumSamples));
+        for (int i = 0; i < iNumSamples; i++)
+            vecfConvert[size_t(i)] = float(pData[i]) * (1.0f / 32768.0f);
+        return WriteBlock(reinterpret_cast<const char*>(vecfConvert.data()),
+                          size_t(iNumSamples) * sizeof(float), iNumSamples);
+    }
+    return WriteBlock(reinterpret_cast<const char*>(pData),
+                      size_t(iNumSamples) * sizeof(_SAMPLE), iNumSamples);
+}
+
+bool CPcmSink::Write(const _AUDIO* pData, int iNumSamples)
+{
+    if (iNumSamples <= 0)
+        return true;
+
+    if (!IsOpen() && !Reopen())
+    {
+        iDroppedSamples += unsigned(iNumSamples);
+        return false;
+    }
+
+    if (eFormat == SMPFMT_F32)
+    {
+        /* Not clipped, a consumer which re-encodes gets the audio as
+           decoded */
+        vecfConvert.resize(size_t(iNumSamples));
+        for (int i = 0; i < iNumSamples; i++)
+            vecfConvert[size_t(i)] = float(pData[i]) * (1.0f / 32768.0f);
+        return WriteBlock(reinterpret_cast<const char*>(vecfConvert.data()),
+                          size_t(iNumSamples) * sizeof(float), iNumSamples);
+    }
+    vecsConvert.resize(size_t(iNumSamples));
+    Audio2Sample(pData, vecsConvert.data(), iNumSamples);
+    return WriteBlock(reinterpret_cast<const char*>(vecsConvert.data()),
+                      size_t(iNumSamples) * sizeof(_SAMPLE), iNumSamples);
+}
+
+bool CPcmSink::WriteBlock(const char* pBytes, const size_t iLen, const int iNumSamples)
+{
+#ifndef _WIN32
+    if (eType == TT_SHM)
+    {
+        if (WriteShm(pBytes, iLen))
+            return true;
+        iDroppedSamples += unsigned(iNumSamples);
+        return false;
+    }
+#endif
+
+    /* Finish the previous block first */
+    if (!vecPending.empty())
+    {
+        const long n = WriteBytes(&vecPending[0], vecPending.size());
+        if (n < 0)
+        {
+            fprintf(stderr, "PcmSink: %s closed by reader\n", strTarget.c_str());
+            Close();
+            iDroppedSamples += unsigned(iNumSamples);
+            return false;
+        }
+        vecPending.erase(vecPending.begin(), vecPending.begin() + n);
+        if (!vecPending.empty())
+        {
+            iDroppedSamples += unsigned(iNumSamples);
+            return false;
+        }
+    }
+
+    const long n = WriteBytes(pBytes, iLen);
+
+    if (n < 0)
+    {
+        fprintf(stderr, "PcmSink: %s closed by reader\n", strTarget.c_str());
+        Close();
+        iDroppedSamples += unsigned(iNumSamples);
+        return false;
+    }
+    else if (n == 0)
+    {
+        iDroppedSamples += unsigned(iNumSamples);
+        return false;
+    }
+    else if (size_t(n) < iLen)
+    {
+        vecPending.assign(pBytes + n, pBytes + iLen);
+    }
+    return true;
+}
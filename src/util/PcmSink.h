@@ -0,0 +1,159 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Non-blocking raw PCM output to a file, a named pipe, a Unix domain
+ *  socket, stdout or a shared memory ring
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#ifndef PCMSINK_H
+#define PCMSINK_H
+
+#include "../GlobalDefinitions.h"
+#include "../sound/sampleformat.h"
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <chrono>
+
+/**
+ * @brief Writes interleaved PCM samples without ever blocking the caller
+ *
+ * The target is a path to a regular file or a named pipe, "unix:<path>"
+ * to connect to a Unix domain stream socket, "-" for stdout or
+ * "shm:<name>" for a POSIX shared memory ring. Pipes and sockets whose
+ * reader is not there (yet) are retried on later writes, regular files
+ * are appended to. Data which cannot be written right away is dropped and
+ * counted.
+ *
+ * The shared memory ring has the layout of pa_shm_ringbuffer, as read by
+ * CShmSoundIn: the PaUtilShmRingBuffer header followed by the data. The
+ * sink creates it if the reader didn't. A block which doesn't fit into
+ * the free space is dropped as a whole, the reader never gets a partial
+ * block.
+ *
+ * Samples are written as 16 bit integers or, with SMPFMT_F32, as 32 bit
+ * floats in the range -1...1, both in host byte order. Decoded float audio
+ * written as floats is not clipped.
+ */
+class CPcmSink
+{
+public:
+    CPcmSink();
+    ~CPcmSink();
+
+    /**
+     * @brief Set the output target and try to open it
+     * @param strNewTarget File/FIFO path, "unix:<socket path>", "-" or
+     * "shm:<name>"
+     * @return true if the target is open now
+     */
+    bool Open(const std::string& strNewTarget);
+
+    /**
+     * @brief Close the output
+     */
+    void Close();
+
+    /**
+     * @brief Check if the output is open
+     */
+    bool IsOpen() const;
+
+    /**
+     * @brief Sample format of the output, SMPFMT_S16 (default) or
+     * SMPFMT_F32. Applies to the following writes
+     */
+    void SetFormat(const ESampleFormat eNewFormat);
+    ESampleFormat GetFormat() const { return eFormat; }
+
+    /**
+     * @brief Write samples, never blocks
+     * @param pData Interleaved samples
+     * @param iNumSamples Number of samples (not frames)
+     * @return false if (part of) the samples were dropped
+     */
+    bool Write(const _SAMPLE* pData, int iNumSamples);
+
+    /**
+     * @brief Write decoded audio, never blocks. Converted to 16 bit with
+     * clipping, as floats as they are
+     */
+    bool Write(const _AUDIO* pData, int iNumSamples);
+
+    /**
+     * @brief Output target as given to Open()
+     */
+    std::string GetTarget() const { return strTarget; }
+
+    /**
+     * @brief Number of samples dropped because the reader was too slow or
+     * not connected
+     */
+    unsigned long GetDropped() const { return iDroppedSamples; }
+
+private:
+    /**
+     * @brief (Re)open the target, rate limited for pipes and sockets
+     */
+    bool Reopen();
+
+    /**
+     * @brief Write bytes, returns the number of bytes written or -1 if the
+     * output is gone
+     */
+    long WriteBytes(const char* pData, size_t iLen);
+
+    /**
+     * @brief Create or attach to the shared memory ring
+     */
+    bool OpenShm(const std::string& strName);
+    bool WriteShm(const char* pData, size_t iLen);
+
+    /**
+     * @brief Write one converted block of iNumSamples samples
+     */
+    bool WriteBlock(const char* pBytes, const size_t iLen, const int iNumSamples);
+
+    enum ETargetType { TT_FILE, TT_SOCKET, TT_STDOUT, TT_SHM };
+
+    std::string         strTarget;
+    ETargetType         eType;
+    ESampleFormat       eFormat;
+#ifdef _WIN32
+    FILE*               pFile;
+#else
+    int                 iFd;
+    void*               pShm;
+    size_t              iShmSize;
+#endif
+    std::vector<float>  vecfConvert;
+    std::vector<_SAMPLE> vecsConvert;
+    /* Tail of a partially written block, sent first on the next write so
+       that the reader never gets out of sample alignment */
+    std::vector<char>   vecPending;
+    unsigned long       iDroppedSamples;
+    std::chrono::steady_clock::time_point LastRetry;
+};
+
+#endif // PCMSINK_H
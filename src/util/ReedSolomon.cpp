@@ -0,0 +1,326 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *	wwek
+ *
+ * Description:
+ *	Reed-Solomon code over GF(2^8), as used by the PFT layer (ETSI TS 102 821)
+ *
+ *	The decoder (Berlekamp-Massey with erasures, Chien search and Forney
+ *	algorithm) follows the structure of the well known decoder by Phil Karn
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "ReedSolomon.h"
+#include <cstring>
+
+
+/* Implementation *************************************************************/
+namespace
+{
+const int NN = RS_BLOCK_LEN;
+
+/* Zero in index form */
+const int A0 = NN;
+
+/* Exponent and logarithm tables of the field, built once on first use */
+class CGFTables
+{
+public:
+	CGFTables()
+	{
+		int iReg = 1;
+		for (int i = 0; i < NN; i++)
+		{
+			AlphaTo[i] = iReg;
+			IndexOf[iReg] = i;
+			iReg <<= 1;
+			if (iReg & 0x100)
+				iReg ^= 0x11d;
+		}
+		AlphaTo[A0] = 0;
+		IndexOf[0] = A0;
+	}
+
+	int AlphaTo[NN + 1];
+	int IndexOf[NN + 1];
+};
+
+const CGFTables& GF()
+{
+	static const CGFTables Tables;
+	return Tables;
+}
+
+inline int Modnn(int x)
+{
+	while (x >= NN)
+	{
+		x -= NN;
+		x = (x >> 8) + (x & NN);
+	}
+	return x;
+}
+}
+
+CReedSolomon::CReedSolomon(const int iNewNumRoots, const int iNewFirstRoot) :
+	iNumRoots(iNewNumRoots), iFirstRoot(iNewFirstRoot),
+	veciGenPoly(iNewNumRoots + 1), vecbyEncTable(256 * iNewNumRoots),
+	vecbySynTable(256 * iNewNumRoots)
+{
+	const CGFTables& T = GF();
+
+	/* Generator polynominal: product of (x - alpha^(iFirstRoot + i)) */
+	veciGenPoly[0] = 1;
+	for (int i = 0; i < iNumRoots; i++)
+	{
+		const int iRoot = iFirstRoot + i;
+		veciGenPoly[i + 1] = 1;
+		for (int j = i; j > 0; j--)
+		{
+			if (veciGenPoly[j] != 0)
+			{
+				veciGenPoly[j] = veciGenPoly[j - 1] ^
+					T.AlphaTo[Modnn(T.IndexOf[veciGenPoly[j]] + iRoot)];
+			}
+			else
+				veciGenPoly[j] = veciGenPoly[j - 1];
+		}
+		veciGenPoly[0] = T.AlphaTo[Modnn(T.IndexOf[veciGenPoly[0]] + iRoot)];
+	}
+	for (int i = 0; i <= iNumRoots; i++)
+		veciGenPoly[i] = T.IndexOf[veciGenPoly[i]];
+
+	/* Row "f" holds f * g(x) without the leading term, in the order the
+	   parity shift register is updated */
+	for (int f = 1; f < 256; f++)
+	{
+		const int iFb = T.IndexOf[f];
+		_BYTE* pRow = &vecbyEncTable[f * iNumRoots];
+		for (int j = 0; j < iNumRoots; j++)
+		{
+			const int iCoef = veciGenPoly[iNumRoots - 1 - j];
+			pRow[j] = (iCoef == A0) ? 0 : _BYTE(T.AlphaTo[Modnn(iFb + iCoef)]);
+		}
+	}
+
+	for (int i = 0; i < iNumRoots; i++)
+	{
+		_BYTE* pRow = &vecbySynTable[i * 256];
+		pRow[0] = 0;
+		for (int x = 1; x < 256; x++)
+			pRow[x] = _BYTE(T.AlphaTo[Modnn(T.IndexOf[x] + iFirstRoot + i)]);
+	}
+}
+
+void CReedSolomon::Encode(const _BYTE* pbyData, _BYTE* pbyParity) const
+{
+	memset(pbyParity, 0, size_t(iNumRoots));
+
+	const int iDataLen = GetDataLen();
+	for (int i = 0; i < iDataLen; i++)
+	{
+		const _BYTE byFeedback = pbyData[i] ^ pbyParity[0];
+		const _BYTE* pRow = &vecbyEncTable[byFeedback * iNumRoots];
+
+		/* Shift the register by one byte and add the feedback times g(x) */
+		for (int j = 0; j < iNumRoots - 1; j++)
+			pbyParity[j] = pbyParity[j + 1] ^ pRow[j];
+		pbyParity[iNumRoots - 1] = pRow[iNumRoots - 1];
+	}
+}
+
+int CReedSolomon::Decode(_BYTE* pbyBlock, const int* piErasures,
+						 const int iNumErasures) const
+{
+	const CGFTables& T = GF();
+	const int R = iNumRoots;
+
+	if (iNumErasures > R)
+		return -1;
+
+	/* Fixed size work space, nothing is allocated per code word */
+	int s[RS_BLOCK_LEN], lambda[RS_BLOCK_LEN + 1], b[RS_BLOCK_LEN + 1];
+	int t[RS_BLOCK_LEN + 1], omega[RS_BLOCK_LEN + 1], reg[RS_BLOCK_LEN + 1];
+	int root[RS_BLOCK_LEN], loc[RS_BLOCK_LEN];
+
+	/* Syndromes: the code word evaluated at the roots of g(x). All roots
+	   are updated per byte, so the table lookups don't wait on each other */
+	_BYTE byS[RS_BLOCK_LEN];
+	memset(byS, pbyBlock[0], size_t(R));
+	for (int j = 1; j < NN; j++)
+	{
+		const _BYTE byIn = pbyBlock[j];
+		const _BYTE* pMul = &vecbySynTable[0];
+		for (int i = 0; i < R; i++, pMul += 256)
+			byS[i] = byIn ^ pMul[byS[i]];
+	}
+	int iSynError = 0;
+	for (int i = 0; i < R; i++)
+	{
+		iSynError |= byS[i];
+		s[i] = T.IndexOf[byS[i]];
+	}
+	if (iSynError == 0)
+		return 0;
+
+	/* Erasure locator polynominal */
+	memset(lambda, 0, (R + 1) * sizeof(int));
+	lambda[0] = 1;
+	if (iNumErasures > 0)
+	{
+		lambda[1] = T.AlphaTo[Modnn(NN - 1 - piErasures[0])];
+		for (int i = 1; i < iNumErasures; i++)
+		{
+			const int u = Modnn(NN - 1 - piErasures[i]);
+			for (int j = i + 1; j > 0; j--)
+			{
+				const int tmp = T.IndexOf[lambda[j - 1]];
+				if (tmp != A0)
+					lambda[j] ^= T.AlphaTo[Modnn(u + tmp)];
+			}
+		}
+	}
+	for (int i = 0; i < R + 1; i++)
+		b[i] = T.IndexOf[lambda[i]];
+
+	/* Berlekamp-Massey: errors and erasures locator polynominal */
+	int r = iNumErasures;
+	int el = iNumErasures;
+	while (++r <= R)
+	{
+		int iDiscr = 0;
+		for (int i = 0; i < r; i++)
+		{
+			if ((lambda[i] != 0) && (s[r - i - 1] != A0))
+				iDiscr ^= T.AlphaTo[Modnn(T.IndexOf[lambda[i]] + s[r - i - 1])];
+		}
+		iDiscr = T.IndexOf[iDiscr];
+
+		if (iDiscr == A0)
+		{
+			/* B(x) <- x * B(x) */
+			memmove(&b[1], &b[0], R * sizeof(int));
+			b[0] = A0;
+		}
+		else
+		{
+			/* T(x) <- lambda(x) - discr * x * B(x) */
+			t[0] = lambda[0];
+			for (int i = 0; i < R; i++)
+			{
+				if (b[i] != A0)
+					t[i + 1] = lambda[i + 1] ^ T.AlphaTo[Modnn(iDiscr + b[i])];
+				else
+					t[i + 1] = lambda[i + 1];
+			}
+			if (2 * el <= r + iNumErasures - 1)
+			{
+				el = r + iNumErasures - el;
+				/* B(x) <- lambda(x) / discr */
+				for (int i = 0; i <= R; i++)
+				{
+					b[i] = (lambda[i] == 0) ? A0 :
+						Modnn(T.IndexOf[lambda[i]] - iDiscr + NN);
+				}
+			}
+			else
+			{
+				memmove(&b[1], &b[0], R * sizeof(int));
+				b[0] = A0;
+			}
+			memcpy(lambda, t, (R + 1) * sizeof(int));
+		}
+	}
+
+	int iDegLambda = 0;
+	for (int i = 0; i < R + 1; i++)
+	{
+		lambda[i] = T.IndexOf[lambda[i]];
+		if (lambda[i] != A0)
+			iDegLambda = i;
+	}
+
+	/* Chien search for the roots of lambda(x) */
+	for (int i = 1; i <= R; i++)
+		reg[i] = lambda[i];
+	int iCount = 0;
+	for (int i = 1, k = 0; i <= NN; i++, k = Modnn(k + 1))
+	{
+		int q = 1;
+		for (int j = iDegLambda; j > 0; j--)
+		{
+			if (reg[j] != A0)
+			{
+				reg[j] = Modnn(reg[j] + j);
+				q ^= T.AlphaTo[reg[j]];
+			}
+		}
+		if (q != 0)
+			continue;
+		root[iCount] = i;
+		loc[iCount] = k;
+		if (++iCount == iDegLambda)
+			break;
+	}
+	if (iDegLambda != iCount)
+		return -1;
+
+	/* Error evaluator omega(x) = s(x) * lambda(x) mod x^R, index form */
+	const int iDegOmega = iDegLambda - 1;
+	for (int i = 0; i <= iDegOmega; i++)
+	{
+		int tmp = 0;
+		for (int j = i; j >= 0; j--)
+		{
+			if ((s[i - j] != A0) && (lambda[j] != A0))
+				tmp ^= T.AlphaTo[Modnn(s[i - j] + lambda[j])];
+		}
+		omega[i] = T.IndexOf[tmp];
+	}
+
+	/* Forney: error values */
+	for (int j = iCount - 1; j >= 0; j--)
+	{
+		int num1 = 0;
+		for (int i = iDegOmega; i >= 0; i--)
+		{
+			if (omega[i] != A0)
+				num1 ^= T.AlphaTo[Modnn(omega[i] + i * root[j])];
+		}
+		const int num2 = T.AlphaTo[Modnn(root[j] * (iFirstRoot - 1) + NN)];
+		int den = 0;
+		/* Formal derivative of lambda: the odd terms */
+		for (int i = ((iDegLambda < R - 1) ? iDegLambda : R - 1) & ~1; i >= 0; i -= 2)
+		{
+			if (lambda[i + 1] != A0)
+				den ^= T.AlphaTo[Modnn(lambda[i + 1] + i * root[j])];
+		}
+		if (den == 0)
+			return -1;
+		if (num1 != 0)
+		{
+			pbyBlock[loc[j]] ^= _BYTE(T.AlphaTo[Modnn(T.IndexOf[num1] +
+				T.IndexOf[num2] + NN - T.IndexOf[den])]);
+		}
+	}
+
+	return iCount;
+}
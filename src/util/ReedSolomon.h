@@ -0,0 +1,83 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *	wwek
+ *
+ * Description:
+ *	Reed-Solomon code over GF(2^8), as used by the PFT layer (ETSI TS 102 821)
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#if !defined(REED_SOLOMON_H_INCLUDED)
+#define REED_SOLOMON_H_INCLUDED
+
+#include "../GlobalDefinitions.h"
+#include <vector>
+
+
+/* Definitions ****************************************************************/
+/* Length of a code word in bytes */
+#define RS_BLOCK_LEN				255
+
+
+/* Classes ********************************************************************/
+/* Systematic RS(255, 255 - iNumRoots) code with the field generator polynominal
+   x^8 + x^4 + x^3 + x^2 + 1 (0x11d). A code word is the data followed by the
+   parity bytes, the first data byte is the coefficient of the highest power.
+   This is the layout of the widely used "fec" library by Phil Karn, which the
+   PFT implementations of other EDI/RSCI tools use as well.
+
+   Multiplications are done with tables: one row per possible feedback byte for
+   the encoder and one row per root for the syndromes */
+class CReedSolomon
+{
+public:
+	CReedSolomon(const int iNewNumRoots = 48, const int iNewFirstRoot = 1);
+	virtual ~CReedSolomon() {}
+
+	int GetNumRoots() const {return iNumRoots;}
+	int GetDataLen() const {return RS_BLOCK_LEN - iNumRoots;}
+
+	/* Computes the iNumRoots parity bytes of GetDataLen() data bytes */
+	void Encode(const _BYTE* pbyData, _BYTE* pbyParity) const;
+
+	/* Corrects a code word in place. piErasures are the known bad positions
+	   (0 ... RS_BLOCK_LEN - 1), which allows up to iNumRoots erasures instead
+	   of iNumRoots / 2 errors. Returns the number of corrected bytes, or -1 if
+	   the code word can't be corrected */
+	int Decode(_BYTE* pbyBlock, const int* piErasures = nullptr,
+			   const int iNumErasures = 0) const;
+
+protected:
+	int					iNumRoots;
+	int					iFirstRoot;
+
+	/* Generator polynominal in index form, highest power first */
+	std::vector<int>	veciGenPoly;
+
+	/* Encoder: parity contribution of each feedback byte */
+	std::vector<_BYTE>	vecbyEncTable;
+
+	/* Syndromes: multiplication with alpha^(iFirstRoot + i) for each root */
+	std::vector<_BYTE>	vecbySynTable;
+};
+
+
+#endif // !defined(REED_SOLOMON_H_INCLUDED)
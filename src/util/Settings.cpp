@@ -364,6 +364,27 @@ CSettings::ParseArguments(int argc, char **argv)
 			continue;
 		}
 
+		if (GetStringArgument(argc, argv, i, "--writewav-format", "--writewav-format",
+							  strArgument))
+		{
+			Put("Receiver", "audiorecordformat", strArgument);
+			continue;
+		}
+
+		if (GetNumericArgument(argc, argv, i, "--writewav-rotate-hour", "--writewav-rotate-hour",
+							   0, 1, rArgument))
+		{
+			Put("Receiver", "audiorecordhourly", int (rArgument));
+			continue;
+		}
+
+		if (GetNumericArgument(argc, argv, i, "--writewav-rotate-service", "--writewav-rotate-service",
+							   0, 1, rArgument))
+		{
+			Put("Receiver", "audiorecordservice", int (rArgument));
+			continue;
+		}
+
 		/* Number of iterations for MLC setting ----------------------------- */
 		if (GetNumericArgument(argc, argv, i, "-i", "--mlciter", 0,
 							   MAX_NUM_MLC_IT, rArgument))
@@ -372,6 +393,61 @@ CSettings::ParseArguments(int argc, char **argv)
 			continue;
 		}
 
+		/* Concurrent FAC/SDC/MSC decoding ---------------------------------- */
+		if (GetNumericArgument(argc, argv, i, "--parallel-decode", "--parallel-decode",
+							   0, 1, rArgument))
+		{
+			Put("Receiver", "paralleldecode", int (rArgument));
+			continue;
+		}
+
+		/* Audio decoding and playout on its own thread --------------------- */
+		if (GetNumericArgument(argc, argv, i, "--audio-thread", "--audio-thread",
+							   0, 1, rArgument))
+		{
+			Put("Receiver", "audiothread", int (rArgument));
+			continue;
+		}
+
+		if (GetNumericArgument(argc, argv, i, "--audio-latency", "--audio-latency",
+							   200, 5000, rArgument))
+		{
+			Put("Receiver", "audiolatency", int (rArgument));
+			continue;
+		}
+
+		/* Decode all services of the multiplex ----------------------------- */
+		if (GetNumericArgument(argc, argv, i, "--all-services", "--all-services",
+							   0, 1, rArgument))
+		{
+			Put("Receiver", "allservices", int (rArgument));
+			continue;
+		}
+
+		/* Output of the audio services when decoding all services ---------- */
+		if (GetStringArgument(argc, argv, i, "--all-services-out", "--all-services-out",
+							  strArgument))
+		{
+			Put("Receiver", "allservicesout", strArgument);
+			continue;
+		}
+
+		/* Keep the audio decoders of all services running ------------------ */
+		if (GetNumericArgument(argc, argv, i, "--warm-services", "--warm-services",
+							   0, 1, rArgument))
+		{
+			Put("Receiver", "warmservices", int (rArgument));
+			continue;
+		}
+
+		/* Start from the cached configuration of the frequency ------------- */
+		if (GetNumericArgument(argc, argv, i, "--fast-start", "--fast-start",
+							   0, 1, rArgument))
+		{
+			Put("Receiver", "faststart", int (rArgument));
+			continue;
+		}
+
 		/* Sample rate offset start value ----------------------------------- */
 		if (GetNumericArgument(argc, argv, i, "-s", "--sampleoff",
 							   MIN_SAM_OFFS_INI, MAX_SAM_OFFS_INI,
@@ -405,6 +481,45 @@ CSettings::ParseArguments(int argc, char **argv)
 			continue;
 		}
 
+		/* Sample format of raw input files ------------------------------- */
+		if (GetStringArgument(argc, argv, i, "--input-format", "--input-format",
+							  strArgument))
+		{
+			Put("Receiver", "inputformat", strArgument);
+			continue;
+		}
+
+		/* Start position of input files ------------------------------------ */
+		if (GetNumericArgument(argc, argv, i, "--input-seek", "--input-seek",
+							   0.0, 1e7, rArgument))
+		{
+			Put("command", "inputseek", rArgument);
+			continue;
+		}
+
+		/* Read-ahead of stdin/pipe input ----------------------------------- */
+		if (GetNumericArgument(argc, argv, i, "--input-buffer", "--input-buffer",
+							   0.1, 60.0, rArgument))
+		{
+			Put("Receiver", "inputbuffer", rArgument);
+			continue;
+		}
+
+		if (GetNumericArgument(argc, argv, i, "--input-drop-oldest", "--input-drop-oldest",
+							   0, 1, rArgument))
+		{
+			Put("Receiver", "inputdropoldest", int (rArgument));
+			continue;
+		}
+
+		/* Sample format of stdout/pipe/shared memory audio output ---------- */
+		if (GetStringArgument(argc, argv, i, "--output-format", "--output-format",
+							  strArgument))
+		{
+			Put("Receiver", "outputformat", strArgument);
+			continue;
+		}
+
 		/* Output channel selection ----------------------------------------- */
 		if (GetNumericArgument(argc, argv, i, "-u", "--outchansel", 0,
 							   MAX_VAL_OUT_CHAN_SEL, rArgument))
@@ -537,6 +652,14 @@ CSettings::ParseArguments(int argc, char **argv)
 			continue;
 		}
 
+		/* Pacing of recorded RSCI input ------------------------------------ */
+		if (GetStringArgument(argc, argv, i, "--rsiin-replay", "--rsiin-replay",
+							  strArgument))
+		{
+			Put("command", "rsiinreplay", strArgument);
+			continue;
+		}
+
 		/* RSCI control out address ----------------------------------------- */
 		if (GetStringArgument(argc, argv, i, "--rciout", "--rciout",
 							  strArgument))
@@ -585,6 +708,34 @@ CSettings::ParseArguments(int argc, char **argv)
 			continue;
 		}
 
+		if (GetStringArgument(argc, argv, i, "--recordiq-format", "--recordiq-format",
+							  strArgument))
+		{
+			Put("Receiver", "iqrecordformat", strArgument);
+			continue;
+		}
+
+		if (GetNumericArgument(argc, argv, i, "--recordiq-rotate-size", "--recordiq-rotate-size",
+							   0, 1000000, rArgument))
+		{
+			Put("Receiver", "iqrecordmaxsize", int (rArgument));
+			continue;
+		}
+
+		if (GetNumericArgument(argc, argv, i, "--recordiq-rotate-time", "--recordiq-rotate-time",
+							   0, 86400 * 7, rArgument))
+		{
+			Put("Receiver", "iqrecordmaxtime", int (rArgument));
+			continue;
+		}
+
+		if (GetNumericArgument(argc, argv, i, "--recordiq-buffer", "--recordiq-buffer",
+							   1, 120, rArgument))
+		{
+			Put("Receiver", "iqrecordbuffer", int (rArgument));
+			continue;
+		}
+
 #ifdef HAVE_LIBHAMLIB
 		/* Hamlib config string --------------------------------------------- */
 		if (GetStringArgument(argc, argv, i, "-C", "--hamlib-config",
@@ -617,6 +768,104 @@ CSettings::ParseArguments(int argc, char **argv)
 			continue;
 		}
 
+		/* Batch decoding of an input file --------------------------------- */
+		if (GetNumericArgument(argc, argv, i, "--batch", "--batch",
+							   0, 256, rArgument))
+		{
+			Put("command", "batch", int (rArgument));
+			continue;
+		}
+
+		if (GetNumericArgument(argc, argv, i, "--batch-chunk", "--batch-chunk",
+							   10.0, 3600.0, rArgument))
+		{
+			Put("command", "batch-chunk", rArgument);
+			continue;
+		}
+
+		if (GetNumericArgument(argc, argv, i, "--batch-overlap", "--batch-overlap",
+							   2.0, 120.0, rArgument))
+		{
+			Put("command", "batch-overlap", rArgument);
+			continue;
+		}
+
+		if (GetStringArgument(argc, argv, i, "--batch-output", "--batch-output",
+							  strArgument))
+		{
+			Put("command", "batch-output", strArgument);
+			continue;
+		}
+
+		/* Scan of a band for DRM signals ---------------------------------- */
+		if (GetStringArgument(argc, argv, i, "--scan", "--scan",
+							  strArgument))
+		{
+			Put("command", "scan", strArgument);
+			continue;
+		}
+
+		if (GetNumericArgument(argc, argv, i, "--scan-center", "--scan-center",
+							   1, 1e8, rArgument))
+		{
+			Put("command", "scan-center", int (rArgument));
+			continue;
+		}
+
+		if (GetNumericArgument(argc, argv, i, "--scan-dwell", "--scan-dwell",
+							   0.4, 60.0, rArgument))
+		{
+			Put("command", "scan-dwell", rArgument);
+			continue;
+		}
+
+		if (GetNumericArgument(argc, argv, i, "--scan-settle", "--scan-settle",
+							   0, 10000, rArgument))
+		{
+			Put("command", "scan-settle", int (rArgument));
+			continue;
+		}
+
+		if (GetStringArgument(argc, argv, i, "--scan-output", "--scan-output",
+							  strArgument))
+		{
+			Put("command", "scan-output", strArgument);
+			continue;
+		}
+
+		/* Metrics endpoint ------------------------------------------------ */
+		if (GetStringArgument(argc, argv, i, "--metrics", "--metrics", strArgument))
+		{
+			Put("command", "metrics", strArgument);
+			continue;
+		}
+
+		/* Decoding of many MDI/RSCI inputs ------------------------------- */
+		if (GetStringArgument(argc, argv, i, "--mdi-host", "--mdi-host",
+							  strArgument))
+		{
+			const string s = Get("command", "mdihost", string());
+			if (s == "")
+				Put("command", "mdihost", strArgument);
+			else
+				Put("command", "mdihost", s+","+strArgument);
+			continue;
+		}
+
+		if (GetNumericArgument(argc, argv, i, "--mdi-host-threads", "--mdi-host-threads",
+							   0, 256, rArgument))
+		{
+			Put("command", "mdihostthreads", int (rArgument));
+			continue;
+		}
+
+		if (GetStringArgument(argc, argv, i, "--mdi-host-out", "--mdi-host-out",
+							  strArgument))
+		{
+			Put("command", "mdihostout", strArgument);
+			continue;
+		}
+
 		/* Status socket path ----------------------------------------------- */
 		if (GetStringArgument(argc, argv, i, "--status-socket", "--status-socket", strArgument))
 		{
@@ -686,12 +935,27 @@ CSettings::UsageArguments()
 		"  -t, --transmitter            DRM transmitter mode\n"
 		"  -p <b>, --flipspectrum <b>   flip input spectrum (0: off; 1: on)\n"
 		"  -i <n>, --mlciter <n>        number of MLC iterations (allowed range: 0...4 default: 1)\n"
+		"  --parallel-decode <b>        decode FAC, SDC and MSC concurrently (0: off, default; 1: on)\n"
+		"  --audio-thread <b>           decode and play the audio on its own thread with a jitter buffer\n"
+		"                               and clock drift compensation (0: off, default; 1: on)\n"
+		"  --audio-latency <n>          audio kept in that jitter buffer in ms (default 800)\n"
+		"  --all-services <b>           decode all services of the multiplex in parallel (0: off, default; 1: on)\n"
+		"  --all-services-out <s>       raw 16 bit stereo output per audio service when decoding all services,\n"
+		"                               file/FIFO path or unix:<socket path>; %d: service number, %s: service ID\n"
+		"  --warm-services <b>          keep the audio decoders of all services running for instant service\n"
+		"                               switching (0: off, default; 1: on)\n"
+		"  --fast-start <b>             start the acquisition with the mode, offsets and SDC received on the\n"
+		"                               frequency before, kept in faststart.ini in the data directory\n"
+		"                               (0: off, default; 1: on)\n"
 		"  -s <r>, --sampleoff <r>      sample rate offset initial value [Hz] (allowed range: -200.0...200.0)\n"
 		"  -m <b>, --muteaudio <b>      mute audio output (0: off; 1: on)\n"
 		"  -b <b>, --reverb <b>         audio reverberation on drop-out (0: off; 1: on)\n"
 		"  --audio-lpf <b>              anti-aliasing low-pass filter before resampling (0: off, default; 1: on)\n"
 		"  -f <s>, --fileio <s>         disable sound card, use file <s> instead\n"
 		"  -w <s>, --writewav <s>       write output to wave file\n"
+		"  --writewav-format <s>        audio file format: wav (default), flac, opus\n"
+		"  --writewav-rotate-hour <b>   start a new audio file every full hour (UTC)\n"
+		"  --writewav-rotate-service <b> start a new audio file when the service changes\n"
 		"  -S <r>, --fracwinsize <r>    freq. acqu. search window size [Hz] (-1.0: sample rate / 2 (default))\n"
 		"  -E <r>, --fracwincent <r>    freq. acqu. search window center [Hz] (-1.0: sample rate / 4 (default))\n"
 		"  -F <b>, --filter <b>         apply bandpass filter (0: off; 1: on)\n"
@@ -702,6 +966,15 @@ CSettings::UsageArguments()
 		"                               4: I / Q input positive;             5: I / Q input negative;\n"
 		"                               6: I / Q input positive (0 Hz IF);   7: I / Q input negative (0 Hz IF)\n"
 		"                               8: I / Q input positive split;       9: I / Q input negative split\n"
+		"  --input-format <s>           sample format of raw input files: auto (by extension, default), s16, s24,\n"
+		"                               s32, f32, cf32, cs8, cu8; extensions .cf32, .cu8_192 etc. select it too\n"
+		"  --input-seek <r>             start reading raw and WAV input files at this time offset [s]\n"
+		"  --input-buffer <r>           read-ahead of stdin (-I -) or named pipe (-I pipe:<path>) input in seconds\n"
+		"                               (allowed range: 0.1...60.0, default: 2.0)\n"
+		"  --input-drop-oldest <b>      drop the oldest input instead of blocking the feeder when the read-ahead\n"
+		"                               is full (0: off, default; 1: on)\n"
+		"  --output-format <s>          sample format of -O -, pipe:, unix: and shm: audio output: s16 (default),\n"
+		"                               f32; the rate is the audio sample rate (--audsrate)\n"
 		"  -u <n>, --outchansel <n>     output channel selection\n"
 		"                               0: L -> L, R -> R (default);   1: L -> L, R muted;   2: L muted, R -> R\n"
 		"                               3: mix -> L, R muted;          4: L muted, mix -> R\n"
@@ -717,19 +990,27 @@ CSettings::UsageArguments()
 		"  --mdiout <s>                 MDI out address format [IP#:]IP#:port (for Content Server)\n"
 		"  --mdiin  <s>                 MDI in address (for modulator) [[IP#:]IP:]port\n"
 		"  --rsioutprofile <s>          MDI/RSCI output profile: A|B|C|D|Q|M\n"
-		"  --rsiout <s>                 MDI/RSCI output address format [IP#:]IP#:port (prefix address with 'p' to enable the simple PFT)\n"
+		"  --rsiout <s>                 MDI/RSCI output address format [IP#:]IP#:port (prefix address with 'p' to enable the simple PFT,\n"
+		"                               with 'f' for PFT with Reed-Solomon FEC)\n"
 		"  --rsiin <s>                  MDI/RSCI input address format [[IP#:]IP#:]port\n"
+		"  --rsiin-replay <s>           pacing of pcap/.rec input: recorded (capture time, default), max (as fast as decoded)\n"
+		"                               or a speed factor like 10\n"
 		"  --rciout <s>                 RSCI Control output format IP#:port\n"
 		"  --rciin <s>                  RSCI Control input address number format [IP#:]port\n"
 		"  --rsirecordprofile <s>       RSCI recording profile: A|B|C|D|Q|M\n"
 		"  --rsirecordtype <s>          RSCI recording file type: raw|ff|pcap\n"
 		"  --recordiq <b>               enable/disable recording an I/Q file\n"
+		"  --recordiq-format <s>        I/Q file format: raw (default), wav, flac\n"
+		"  --recordiq-rotate-size <n>   start a new I/Q file every <n> MB (0: never)\n"
+		"  --recordiq-rotate-time <n>   start a new I/Q file every <n> seconds (0: never)\n"
+		"  --recordiq-buffer <n>        seconds of I/Q queued for the disk (default 5)\n"
 		"  --permissive <b>             enable decoding of bad RSCI frames (0: off; 1: on)\n"
 		"  -R <n>, --samplerate <n>     set audio and signal sound card sample rate [Hz]\n"
 		"  --audsrate <n>               set audio sound card sample rate [Hz] (allowed range: 8000...192000)\n"
 		"  --sigsrate <n>               set signal sound card sample rate [Hz] (allowed values: 24000, 48000, 96000, 192000)\n"
 		"  -I <s>, --snddevin <s>       set sound in device\n"
-		"  -O <s>, --snddevout <s>      set sound out device\n"
+		"  -O <s>, --snddevout <s>      set sound out device; - (stdout), pipe:<path>, unix:<path> or\n"
+		"                               shm:<name> stream the audio to another process without blocking\n"
 		"  -U <n>, --sigupratio <n>     set signal upscale ratio (allowed values: 1, 2)\n"
 #ifdef HAVE_LIBHAMLIB
 		"  -M <n>, --hamlib-model <n>   set Hamlib radio model ID\n"
@@ -738,6 +1019,25 @@ CSettings::UsageArguments()
 #endif
 		"  --test <n>                   if 1 then some test setup will be done\n"
 		"  --status-socket <s>          Unix domain socket path for status broadcast\n"
+		"  --metrics <s>                serve metrics (Prometheus text format) over HTTP on unix:<path>,\n"
+		"                               <port> or <address>:<port> (default address 127.0.0.1)\n"
+		"  --batch <n>                  decode the input file (-f) as fast as possible with <n> receivers in\n"
+		"                               parallel (0: one per core), write <output>.wav and <output>.csv and exit\n"
+		"  --batch-chunk <r>            length of the chunk each receiver decodes [s] (default 60)\n"
+		"  --batch-overlap <r>          seconds each receiver starts before its chunk to sync (default 10)\n"
+		"  --batch-output <s>           batch output name without extension (default batch)\n"
+		"  --scan <s>                   look for DRM on the frequencies <s> [kHz], e.g. 5900-6200:5,7200 (ranges\n"
+		"                               without step: 5 kHz), print the channels found and exit. The rig is\n"
+		"                               tuned with Hamlib, unless --scan-center is given\n"
+		"  --scan-center <n>            frequency of the centre of the search window in a wideband input [kHz],\n"
+		"                               the channels are looked for in the input without tuning\n"
+		"  --scan-dwell <r>             longest time on a channel with DRM pilots [s] (default 3)\n"
+		"  --scan-settle <n>            input not taken after tuning [ms] (default 100 with a rig, else 0)\n"
+		"  --scan-output <s>            also write the channels found to the CSV file <s>\n"
+		"  --mdi-host <s>               decode MDI/RSCI input <s> (same syntax as --rsiin) without front-end,\n"
+		"                               can be given many times, all inputs are decoded in one process\n"
+		"  --mdi-host-threads <n>       threads decoding the --mdi-host inputs (default: number of cores)\n"
+		"  --mdi-host-out <s>           audio outputs of the --mdi-host inputs, like --all-services-out, %n: input number\n"
 		"  -v, --version                display version information\n"
 		"  -h, -?, --help               this help text\n"
 		"\n"
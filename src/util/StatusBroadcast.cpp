@@ -31,6 +31,8 @@
 #include "../Parameter.h"
 #include "../tables/TableFAC.h"
 #include "../datadecoding/DataDecoder.h"
+#include "../MDI/PacketIngest.h"
+#include "../MDI/MDIHost.h"
 
 #ifndef _WIN32
 // Unix-specific headers for Unix Domain Sockets
@@ -42,6 +44,11 @@
 #include <cerrno>
 #endif
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
 #include <cstring>
 #include <map>
 #include <cstdio>
@@ -52,93 +59,167 @@
 
 CStatusBroadcast::CStatusBroadcast()
     : pDRMReceiver(nullptr)
+    , pHost(nullptr)
     , strSocketPath("")
     , iServerFd(-1)
+    , iMediaServerFd(-1)
+    , iEpollFd(-1)
+    , iWakeupFd(-1)
     , bRunning(false)
 {
 }
 
+std::atomic<int> CStatusBroadcast::iNotifyFd(-1);
+std::atomic<int> CStatusBroadcast::iNumClients(0);
+
 CStatusBroadcast::~CStatusBroadcast()
 {
     Stop();
 }
 
 bool CStatusBroadcast::Start(CDRMReceiver* pReceiver, const std::string& strCustomPath)
+{
+    if (bRunning || pReceiver == nullptr)
+        return false;
+
+    pDRMReceiver = pReceiver;
+    pHost = nullptr;
+    return Listen(strCustomPath);
+}
+
+bool CStatusBroadcast::Start(CMDIHost* pNewHost, const std::string& strCustomPath)
+{
+    if (bRunning || pNewHost == nullptr)
+        return false;
+
+    pDRMReceiver = nullptr;
+    pHost = pNewHost;
+    return Listen(strCustomPath);
+}
+
+bool CStatusBroadcast::Listen(const std::string& strCustomPath)
 {
 #ifdef _WIN32
     // Windows: Unix Domain Sockets not supported
     // TODO: Implement Windows Named Pipes or TCP socket alternative
-    (void)pReceiver;
     (void)strCustomPath;
     fprintf(stderr, "StatusBroadcast: Not implemented on Windows\n");
     return false;
 #else
     // Unix/Linux/macOS: Use Unix Domain Sockets
-    if (bRunning)
-        return false;
-
-    if (pReceiver == nullptr)
-        return false;
-
-    pDRMReceiver = pReceiver;
-
     // Use custom path if provided, otherwise generate default path
     if (!strCustomPath.empty())
         strSocketPath = strCustomPath;
     else
         strSocketPath = CreateSocketPath();
 
+    iServerFd = OpenSocket(strSocketPath);
+    if (iServerFd < 0)
+        return false;
+
+    // MOT objects are fetched from a second socket. Without it they are
+    // sent inline in the status, base64 encoded
+    strMediaSocketPath = strSocketPath + ".media";
+    iMediaServerFd = OpenSocket(strMediaSocketPath);
+    if (iMediaServerFd < 0)
+        strMediaSocketPath.clear();
+
+#ifdef __linux__
+    // Woken by Notify() and by Stop()
+    iEpollFd = epoll_create1(EPOLL_CLOEXEC);
+    iWakeupFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (iEpollFd < 0 || iWakeupFd < 0)
+    {
+        fprintf(stderr, "StatusBroadcast: epoll not available: %s\n", strerror(errno));
+        CloseEvents();
+        close(iServerFd);
+        iServerFd = -1;
+        unlink(strSocketPath.c_str());
+        if (iMediaServerFd >= 0)
+        {
+            close(iMediaServerFd);
+            iMediaServerFd = -1;
+            unlink(strMediaSocketPath.c_str());
+        }
+        return false;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = iServerFd;
+    epoll_ctl(iEpollFd, EPOLL_CTL_ADD, iServerFd, &ev);
+    ev.data.fd = iWakeupFd;
+    epoll_ctl(iEpollFd, EPOLL_CTL_ADD, iWakeupFd, &ev);
+    if (iMediaServerFd >= 0)
+    {
+        ev.data.fd = iMediaServerFd;
+        epoll_ctl(iEpollFd, EPOLL_CTL_ADD, iMediaServerFd, &ev);
+    }
+    iNotifyFd = iWakeupFd;
+#endif
+
+    // Start broadcast thread
+    bRunning = true;
+    broadcastThread = std::thread(&CStatusBroadcast::BroadcastLoop, this);
+
+    fprintf(stderr, "StatusBroadcast: Started on %s\n", strSocketPath.c_str());
+    if (iMediaServerFd >= 0)
+        fprintf(stderr, "StatusBroadcast: Media objects on %s\n", strMediaSocketPath.c_str());
+    return true;
+#endif
+}
+
+int CStatusBroadcast::OpenSocket(const std::string& strPath)
+{
+#ifdef _WIN32
+    (void)strPath;
+    return -1;
+#else
     // Remove old socket file if exists (previous unclean exit)
     struct stat st;
-    if (stat(strSocketPath.c_str(), &st) == 0)
+    if (stat(strPath.c_str(), &st) == 0)
     {
-        fprintf(stderr, "StatusBroadcast: Removing stale socket file %s\n", strSocketPath.c_str());
-        unlink(strSocketPath.c_str());
+        fprintf(stderr, "StatusBroadcast: Removing stale socket file %s\n", strPath.c_str());
+        unlink(strPath.c_str());
     }
 
     // Create Unix Domain Socket
-    iServerFd = socket(AF_UNIX, SOCK_STREAM, 0);
-    if (iServerFd < 0)
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
     {
         fprintf(stderr, "StatusBroadcast: Failed to create socket: %s\n", strerror(errno));
-        return false;
+        return -1;
     }
 
     // Set non-blocking mode
-    int flags = fcntl(iServerFd, F_GETFL, 0);
-    fcntl(iServerFd, F_SETFL, flags | O_NONBLOCK);
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
 
     // Bind socket
     struct sockaddr_un addr;
     memset(&addr, 0, sizeof(addr));
     addr.sun_family = AF_UNIX;
-    strncpy(addr.sun_path, strSocketPath.c_str(), sizeof(addr.sun_path) - 1);
+    strncpy(addr.sun_path, strPath.c_str(), sizeof(addr.sun_path) - 1);
 
-    if (::bind(iServerFd, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+    if (::bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0)
     {
         fprintf(stderr, "StatusBroadcast: Failed to bind socket to %s: %s\n",
-                strSocketPath.c_str(), strerror(errno));
-        close(iServerFd);
-        iServerFd = -1;
-        return false;
+                strPath.c_str(), strerror(errno));
+        close(fd);
+        return -1;
     }
 
     // Listen for connections
-    if (listen(iServerFd, 5) < 0)
+    if (listen(fd, 5) < 0)
     {
         fprintf(stderr, "StatusBroadcast: Failed to listen on socket: %s\n", strerror(errno));
-        close(iServerFd);
-        iServerFd = -1;
-        unlink(strSocketPath.c_str());
-        return false;
+        close(fd);
+        unlink(strPath.c_str());
+        return -1;
     }
 
-    // Start broadcast thread
-    bRunning = true;
-    broadcastThread = std::thread(&CStatusBroadcast::BroadcastLoop, this);
-
-    fprintf(stderr, "StatusBroadcast: Started on %s\n", strSocketPath.c_str());
-    return true;
+    return fd;
 #endif
 }
 
@@ -153,15 +234,25 @@ void CStatusBroadcast::Stop()
         return;
 
     bRunning = false;
+#ifdef __linux__
+    iNotifyFd = -1;
+    WakeUp();
+#endif
 
     // Wait for thread to finish
     if (broadcastThread.joinable())
         broadcastThread.join();
 
     // Close all client connections
-    for (int fd : vecClientFds)
-        close(fd);
-    vecClientFds.clear();
+    for (auto& client : mapClients)
+        close(client.first);
+    mapClients.clear();
+    iNumClients = 0;
+    vecLastSections.clear();
+
+#ifdef __linux__
+    CloseEvents();
+#endif
 
     // Close server socket
     if (iServerFd >= 0)
@@ -170,6 +261,14 @@ void CStatusBroadcast::Stop()
         iServerFd = -1;
     }
 
+    if (iMediaServerFd >= 0)
+    {
+        close(iMediaServerFd);
+        iMediaServerFd = -1;
+        unlink(strMediaSocketPath.c_str());
+        strMediaSocketPath.clear();
+    }
+
     // Remove socket file
     if (!strSocketPath.empty())
     {
@@ -188,86 +287,694 @@ void CStatusBroadcast::Stop()
 #endif
 }
 
+void CStatusBroadcast::Notify()
+{
+#ifdef __linux__
+    // Nobody listening: not even a system call
+    const int fd = iNotifyFd.load(std::memory_order_relaxed);
+    if (fd >= 0 && iNumClients.load(std::memory_order_relaxed) > 0)
+    {
+        const uint64_t iOne = 1;
+        if (write(fd, &iOne, sizeof(iOne)) < 0)
+        {
+            // Counter full (EAGAIN): a wakeup is pending anyway
+        }
+    }
+#endif
+}
+
+#ifdef __linux__
+void CStatusBroadcast::WakeUp()
+{
+    if (iWakeupFd >= 0)
+    {
+        const uint64_t iOne = 1;
+        if (write(iWakeupFd, &iOne, sizeof(iOne)) < 0)
+        {
+            // Counter full (EAGAIN): a wakeup is pending anyway
+        }
+    }
+}
+
+void CStatusBroadcast::CloseEvents()
+{
+    if (iWakeupFd >= 0)
+    {
+        close(iWakeupFd);
+        iWakeupFd = -1;
+    }
+    if (iEpollFd >= 0)
+    {
+        close(iEpollFd);
+        iEpollFd = -1;
+    }
+}
+
+void CStatusBroadcast::WatchOutput(int fd, bool bOutput)
+{
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN | EPOLLRDHUP;
+    if (bOutput)
+        ev.events |= EPOLLOUT;
+    ev.data.fd = fd;
+    epoll_ctl(iEpollFd, EPOLL_CTL_MOD, fd, &ev);
+}
+#endif
+
 void CStatusBroadcast::BroadcastLoop()
 {
 #ifdef _WIN32
     // Windows: Not implemented
     return;
+#elif defined(__linux__)
+    // Sleeps in epoll_wait until the receiver has a new frame, a client
+    // connects, sends a command or can take more data
+    struct epoll_event events[32];
+    std::chrono::steady_clock::time_point tLastUpdate = std::chrono::steady_clock::now();
+    bool bPending = false;
+
+    while (bRunning)
+    {
+        int iTimeout = -1;
+        if (!mapClients.empty())
+        {
+            const int iSinceUpdate = int(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - tLastUpdate).count());
+            const int iDue = bPending ? MIN_UPDATE_INTERVAL_MS : IDLE_UPDATE_INTERVAL_MS;
+            iTimeout = (iSinceUpdate >= iDue) ? 0 : iDue - iSinceUpdate;
+        }
+
+        const int iNum = epoll_wait(iEpollFd, events, 32, iTimeout);
+        if (iNum < 0 && errno != EINTR)
+        {
+            fprintf(stderr, "StatusBroadcast: epoll_wait failed: %s\n", strerror(errno));
+            break;
+        }
+
+        for (int i = 0; i < iNum; i++)
+        {
+            const int fd = events[i].data.fd;
+            if (fd == iServerFd)
+            {
+                if (AcceptNewClients(iServerFd, false))
+                    bPending = true;
+            }
+            else if (fd == iMediaServerFd)
+                AcceptNewClients(iMediaServerFd, true);
+            else if (fd == iWakeupFd)
+            {
+                uint64_t iCount;
+                if (read(iWakeupFd, &iCount, sizeof(iCount)) > 0)
+                    bPending = true;
+            }
+            else
+            {
+                bool bKeep = !(events[i].events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP));
+                if (bKeep && (events[i].events & EPOLLIN))
+                    bKeep = ReadFromClient(fd);
+                if (bKeep && (events[i].events & EPOLLOUT))
+                    bKeep = FlushClient(fd);
+                if (!bKeep)
+                    DropClient(fd);
+            }
+        }
+
+        if (!bRunning || mapClients.empty())
+            continue;
+
+        const std::chrono::steady_clock::time_point tNow = std::chrono::steady_clock::now();
+        const int iSinceUpdate = int(std::chrono::duration_cast<std::chrono::milliseconds>(
+            tNow - tLastUpdate).count());
+        if ((bPending && iSinceUpdate >= MIN_UPDATE_INTERVAL_MS) ||
+            iSinceUpdate >= IDLE_UPDATE_INTERVAL_MS)
+        {
+            BroadcastToClients(CollectStatusJSON());
+            PushMedia();
+            tLastUpdate = tNow;
+            bPending = false;
+        }
+    }
 #else
-    // Unix/Linux/macOS
+    // Unix without epoll: poll in fixed intervals, still send on change only
     while (bRunning)
     {
-        // Accept new client connections
-        AcceptNewClients();
+        AcceptNewClients(iServerFd, false);
+        AcceptNewClients(iMediaServerFd, true);
+
+        std::vector<int> vecFds;
+        for (auto& client : mapClients)
+            vecFds.push_back(client.first);
+        for (int fd : vecFds)
+        {
+            if (!ReadFromClient(fd) || !FlushClient(fd))
+                DropClient(fd);
+        }
 
-        // Collect status and broadcast
-        std::string strJSON = CollectStatusJSON();
-        BroadcastToClients(strJSON);
+        if (!mapClients.empty())
+        {
+            BroadcastToClients(CollectStatusJSON());
+            PushMedia();
+        }
 
-        // Sleep for update interval
         std::this_thread::sleep_for(std::chrono::milliseconds(UPDATE_INTERVAL_MS));
     }
 #endif
 }
 
-void CStatusBroadcast::AcceptNewClients()
+bool CStatusBroadcast::AcceptNewClients(int iListenFd, bool bMedia)
 {
+    bool bAccepted = false;
 #ifndef _WIN32
     // Unix/Linux/macOS only
+    if (iListenFd < 0)
+        return false;
+
     // Non-blocking accept
-    int client_fd = accept(iServerFd, nullptr, nullptr);
-    if (client_fd >= 0)
+    int client_fd;
+    while ((client_fd = accept(iListenFd, nullptr, nullptr)) >= 0)
     {
         // Set non-blocking mode for client socket
         int flags = fcntl(client_fd, F_GETFL, 0);
         fcntl(client_fd, F_SETFL, flags | O_NONBLOCK);
 
-        vecClientFds.push_back(client_fd);
-        fprintf(stderr, "StatusBroadcast: Client connected (fd=%d, total=%zu)\n",
-                client_fd, vecClientFds.size());
+#ifdef __linux__
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.fd = client_fd;
+        if (epoll_ctl(iEpollFd, EPOLL_CTL_ADD, client_fd, &ev) < 0)
+        {
+            close(client_fd);
+            continue;
+        }
+#endif
+        // The next update sends the complete status to it
+        mapClients[client_fd] = CStatusClient();
+        mapClients[client_fd].bMedia = bMedia;
+        iNumClients = int(mapClients.size());
+        bAccepted = true;
+        fprintf(stderr, "StatusBroadcast: %s client connected (fd=%d, total=%zu)\n",
+                bMedia ? "Media" : "Status", client_fd, mapClients.size());
     }
 #endif
+    return bAccepted;
 }
 
-void CStatusBroadcast::BroadcastToClients(const std::string& strJSON)
+bool CStatusBroadcast::ReadFromClient(int fd)
 {
 #ifndef _WIN32
-    // Unix/Linux/macOS only
-    if (vecClientFds.empty())
-        return;
+    CStatusClient& client = mapClients[fd];
+    char buf[256];
+    for (;;)
+    {
+        const ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n == 0)
+            return false;
+        if (n < 0)
+            return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+
+        client.strCommand.append(buf, size_t(n));
+        size_t iEnd;
+        while ((iEnd = client.strCommand.find('\n')) != std::string::npos)
+        {
+            std::string strLine = client.strCommand.substr(0, iEnd);
+            client.strCommand.erase(0, iEnd + 1);
+            if (!strLine.empty() && strLine.back() == '\r')
+                strLine.pop_back();
 
-    // Add newline for line-based parsing
-    std::string message = strJSON + "\n";
-    const char* data = message.c_str();
-    size_t len = message.size();
+            if (client.bMedia)
+            {
+                // "get <ref>": one object, "subscribe": all new objects
+                if (strLine.compare(0, 4, "get ") == 0)
+                {
+                    const std::string strRef = strLine.substr(4);
+                    CSharedMessage pFrame = MediaStore.Get(strRef);
+                    if (pFrame == nullptr)
+                        pFrame = std::make_shared<const std::string>(CMediaStore::NotFoundFrame(strRef));
+                    Enqueue(client, pFrame, true, nullptr);
+                }
+                else if (strLine == "subscribe")
+                    client.bSubscribed = true;
+                else if (strLine == "unsubscribe")
+                    client.bSubscribed = false;
+            }
+            // "deltas": only the changed sections from now on, "full": complete status
+            else if (strLine == "deltas")
+                client.bDeltas = true;
+            else if (strLine == "full")
+                client.bDeltas = false;
+        }
+        if (!client.queue.empty() && !client.bWatchOutput && !FlushClient(fd))
+            return false;
+        if (client.strCommand.size() > sizeof(buf))
+            client.strCommand.clear();
+    }
+#else
+    (void)fd;
+    return true;
+#endif
+}
 
-    // Broadcast to all clients
-    auto it = vecClientFds.begin();
-    while (it != vecClientFds.end())
+bool CStatusBroadcast::FlushClient(int fd)
+{
+#ifndef _WIN32
+    CStatusClient& client = mapClients[fd];
+    while (!client.queue.empty())
     {
-        ssize_t sent = send(*it, data, len, MSG_NOSIGNAL);
+        const std::string& strHead = *client.queue.front().pData;
+        const ssize_t sent = send(fd, strHead.data() + client.iHeadSent,
+                                  strHead.size() - client.iHeadSent, MSG_NOSIGNAL | MSG_DONTWAIT);
         if (sent < 0)
         {
-            // Client disconnected or error
-            fprintf(stderr, "StatusBroadcast: Client disconnected (fd=%d)\n", *it);
-            close(*it);
-            it = vecClientFds.erase(it);
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                return false;
+#ifdef __linux__
+            // Socket buffer full: continue when it can take more
+            if (!client.bWatchOutput)
+            {
+                WatchOutput(fd, true);
+                client.bWatchOutput = true;
+            }
+#endif
+            return true;
         }
-        else
+
+        client.iHeadSent += size_t(sent);
+        if (client.iHeadSent == strHead.size())
         {
-            ++it;
+            client.iQueuedBytes -= strHead.size();
+            client.queue.pop_front();
+            client.iHeadSent = 0;
         }
     }
+#ifdef __linux__
+    if (client.bWatchOutput)
+    {
+        WatchOutput(fd, false);
+        client.bWatchOutput = false;
+    }
+#endif
+#else
+    (void)fd;
+#endif
+    return true;
+}
+
+void CStatusBroadcast::DropClient(int fd)
+{
+#ifndef _WIN32
+    auto it = mapClients.find(fd);
+    if (it == mapClients.end())
+        return;
+    fprintf(stderr, "StatusBroadcast: Client disconnected (fd=%d, coalesced=%lu)\n",
+            fd, it->second.iCoalesced);
+#ifdef __linux__
+    epoll_ctl(iEpollFd, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+    close(fd);
+    mapClients.erase(it);
+    iNumClients = int(mapClients.size());
+#else
+    (void)fd;
 #endif
 }
 
+void CStatusBroadcast::Enqueue(CStatusClient& client, const CSharedMessage& pMessage,
+                               bool bEvent, const CSharedMessage& pSnapshot)
+{
+    if (client.queue.size() >= MAX_CLIENT_MESSAGES ||
+        client.iQueuedBytes + pMessage->size() > MAX_CLIENT_QUEUE_BYTES)
+    {
+        // Slow client: what it hasn't got yet is replaced by the current
+        // status. Only the message being sent and media objects are kept,
+        // the oldest media objects go if they alone overflow the queue.
+        // Media socket clients have no snapshot, they only lose the oldest
+        // objects, which they can fetch again.
+        std::deque<CStatusMessage> queue;
+        size_t iBytes = 0;
+        for (size_t i = 0; i < client.queue.size(); i++)
+        {
+            const bool bHead = (i == 0 && client.iHeadSent > 0);
+            if (bHead || client.queue[i].bEvent)
+            {
+                queue.push_back(client.queue[i]);
+                iBytes += client.queue[i].pData->size();
+            }
+        }
+        const size_t iLimit = (pSnapshot != nullptr) ? MAX_CLIENT_QUEUE_BYTES :
+            ((pMessage->size() < MAX_CLIENT_QUEUE_BYTES) ? MAX_CLIENT_QUEUE_BYTES - pMessage->size() : 0);
+        const size_t iDrop = (client.iHeadSent > 0) ? 1 : 0;
+        while ((iBytes > iLimit || queue.size() + 1 > MAX_CLIENT_MESSAGES) && queue.size() > iDrop)
+        {
+            iBytes -= queue[iDrop].pData->size();
+            queue.erase(queue.begin() + long(iDrop));
+        }
+        client.queue.swap(queue);
+        client.iQueuedBytes = iBytes;
+        client.iCoalesced++;
+
+        if (pSnapshot != nullptr)
+        {
+            client.queue.push_back(CStatusMessage(pSnapshot, false));
+            client.iQueuedBytes += pSnapshot->size();
+
+            // The snapshot holds everything else pMessage would have
+            if (!bEvent)
+                return;
+        }
+    }
+
+    client.queue.push_back(CStatusMessage(pMessage, bEvent));
+    client.iQueuedBytes += pMessage->size();
+}
+
+void CStatusBroadcast::BroadcastToClients(const std::string& strJSON)
+{
+    bool bStatusClients = false;
+    for (const auto& client : mapClients)
+        bStatusClients = bStatusClients || !client.second.bMedia;
+    if (!bStatusClients)
+        return;
+
+    // Compare the sections with the last update, except the time stamp
+    // and the media objects, which are sent once
+    std::vector<std::pair<std::string, std::string> > vecSections;
+    SplitSections(strJSON, vecSections);
+
+    std::ostringstream delta;
+    std::string strTimestamp;
+    bool bChanged = false;
+    bool bMedia = false;
+    for (const auto& section : vecSections)
+    {
+        if (section.first == "timestamp")
+        {
+            strTimestamp = section.second;
+            continue;
+        }
+        if (section.first == "media_content")
+            bMedia = true;
+        else
+        {
+            bool bSame = false;
+            for (const auto& last : vecLastSections)
+            {
+                if (last.first == section.first)
+                {
+                    bSame = (last.second == section.second);
+                    break;
+                }
+            }
+            if (bSame)
+                continue;
+        }
+        delta << ",\"" << section.first << "\":" << section.second;
+        bChanged = true;
+    }
+
+    std::ostringstream removed;
+    for (const auto& last : vecLastSections)
+    {
+        bool bFound = false;
+        for (const auto& section : vecSections)
+            bFound = bFound || (section.first == last.first);
+        if (!bFound)
+        {
+            removed << (removed.tellp() > 0 ? "," : "") << "\"" << last.first << "\"";
+            bChanged = true;
+        }
+    }
+
+    // Status without the media objects, for clients which lost track
+    std::string strSnapshot = "{";
+    for (size_t i = 0; i < vecSections.size(); i++)
+    {
+        if (vecSections[i].first == "media_content")
+            continue;
+        if (strSnapshot.size() > 1)
+            strSnapshot += ",";
+        strSnapshot += "\"" + vecSections[i].first + "\":" + vecSections[i].second;
+    }
+    strSnapshot += "}\n";
+    const CSharedMessage pSnapshot = std::make_shared<const std::string>(strSnapshot);
+
+    vecLastSections.clear();
+    for (const auto& section : vecSections)
+    {
+        if (section.first != "media_content")
+            vecLastSections.push_back(section);
+    }
+
+    CSharedMessage pDelta;
+    if (bChanged)
+    {
+        std::string strDelta = "{\"timestamp\":" + strTimestamp + ",\"delta\":true" + delta.str();
+        if (removed.tellp() > 0)
+            strDelta += ",\"removed\":[" + removed.str() + "]";
+        strDelta += "}\n";
+        pDelta = std::make_shared<const std::string>(strDelta);
+    }
+    const CSharedMessage pFull = std::make_shared<const std::string>(strJSON + "\n");
+
+    std::vector<int> vecFailed;
+    for (auto& client : mapClients)
+    {
+        CStatusClient& c = client.second;
+        if (c.bMedia)
+            continue;
+        if (!c.bStarted)
+        {
+            // First message: the complete status
+            Enqueue(c, pFull, bMedia, pSnapshot);
+            c.bStarted = true;
+        }
+        else if (bChanged)
+            Enqueue(c, c.bDeltas ? pDelta : pFull, bMedia, pSnapshot);
+        else
+            continue;
+
+        if (!c.bWatchOutput && !FlushClient(client.first))
+            vecFailed.push_back(client.first);
+    }
+    for (int fd : vecFailed)
+        DropClient(fd);
+}
+
+void CStatusBroadcast::PushMedia()
+{
+    if (vecNewMedia.empty())
+        return;
+
+    std::vector<int> vecFailed;
+    for (auto& client : mapClients)
+    {
+        CStatusClient& c = client.second;
+        if (!c.bSubscribed)
+            continue;
+        for (const CSharedMessage& pFrame : vecNewMedia)
+            Enqueue(c, pFrame, true, nullptr);
+        if (!c.bWatchOutput && !FlushClient(client.first))
+            vecFailed.push_back(client.first);
+    }
+    for (int fd : vecFailed)
+        DropClient(fd);
+
+    vecNewMedia.clear();
+}
+
+void CStatusBroadcast::SplitSections(const std::string& strJSON,
+                                     std::vector<std::pair<std::string, std::string> >& vecSections)
+{
+    // Top level of an object as written by CollectStatusJSON: "key":value,...
+    vecSections.clear();
+    size_t i = strJSON.find('{');
+    if (i == std::string::npos)
+        return;
+    i++;
+
+    while (i < strJSON.size())
+    {
+        const size_t iKeyStart = strJSON.find('"', i);
+        if (iKeyStart == std::string::npos)
+            return;
+        const size_t iKeyEnd = strJSON.find('"', iKeyStart + 1);
+        if (iKeyEnd == std::string::npos || iKeyEnd + 1 >= strJSON.size() || strJSON[iKeyEnd + 1] != ':')
+            return;
+
+        const size_t iValueStart = iKeyEnd + 2;
+        size_t j = iValueStart;
+        int iDepth = 0;
+        bool bString = false;
+        for (; j < strJSON.size(); j++)
+        {
+            const char c = strJSON[j];
+            if (bString)
+            {
+                if (c == '\\')
+                    j++;
+                else if (c == '"')
+                    bString = false;
+            }
+            else if (c == '"')
+                bString = true;
+            else if (c == '{' || c == '[')
+                iDepth++;
+            else if (c == '}' || c == ']')
+            {
+                if (iDepth == 0)
+                    break;
+                iDepth--;
+            }
+            else if (c == ',' && iDepth == 0)
+                break;
+        }
+
+        vecSections.push_back(std::make_pair(strJSON.substr(iKeyStart + 1, iKeyEnd - iKeyStart - 1),
+                                             strJSON.substr(iValueStart, j - iValueStart)));
+        i = j + 1;
+    }
+}
+
 std::string CStatusBroadcast::CollectStatusJSON()
 {
+    if (pHost != nullptr)
+        return CollectHostJSON();
+
     if (pDRMReceiver == nullptr)
         return "{}";
 
     CParameter& Parameters = *pDRMReceiver->GetParameters();
+    const bool signal = (pDRMReceiver->GetAcquiState() == AS_WITH_SIGNAL);
+
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(1);
+    json << "{";
+    json << "\"timestamp\":" << std::time(nullptr);
+
+    AppendReceptionJSON(json, Parameters, signal);
+
+    // Frequency parameters
+    json << ",\"frequency\":{";
+    json << "\"dc_offset_hz\":" << std::setprecision(2) << Parameters.GetDCFrequency();
+
+    _REAL rSampleOffset = Parameters.rResampleOffset;
+    _REAL rSampleRate = Parameters.GetSigSampleRate();
+    int iSampleOffsetPPM = (rSampleRate > 0) ? (int)(rSampleOffset / rSampleRate * 1e6) : 0;
+
+    json << ",\"sample_offset_hz\":" << std::setprecision(2) << rSampleOffset;
+    json << ",\"sample_offset_ppm\":" << iSampleOffsetPPM;
+    json << std::setprecision(1);
+    json << "}";
+
+    // stdin/pipe input read-ahead
+    unsigned long iOverruns = 0, iUnderruns = 0;
+    _REAL rBufferedSeconds = 0.0;
+    if (pDRMReceiver->GetReceiveData()->GetPipeStats(iOverruns, iUnderruns, rBufferedSeconds))
+    {
+        json << ",\"input\":{";
+        json << "\"overruns\":" << iOverruns << ",";
+        json << "\"underruns\":" << iUnderruns << ",";
+        json << "\"buffered_s\":" << std::setprecision(2) << rBufferedSeconds;
+        json << std::setprecision(1);
+        json << "}";
+    }
+
+    // MDI/RSCI input received by the I/O thread
+    CPacketIngestStats IngestStats;
+    if (pDRMReceiver->GetRSIIn()->GetInputStats(IngestStats))
+        AppendIngestJSON(json, IngestStats);
+
+    CDataDecoder* pDataDecoder = pDRMReceiver->GetDataDecoder();
+    AppendServicesJSON(json, Parameters, signal,
+                       [pDataDecoder](int) { return pDataDecoder; }, mapLastPushedMedia, 0);
+
+    json << "}";
+
+    return json.str();
+}
+
+std::string CStatusBroadcast::CollectHostJSON()
+{
+    const size_t iNumStreams = pHost->GetNumStreams();
+    if (vecLastPushedStreamMedia.size() != iNumStreams)
+        vecLastPushedStreamMedia.resize(iNumStreams);
+
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(1);
+    json << "{";
+    json << "\"timestamp\":" << std::time(nullptr);
+    json << ",\"streams\":[";
+
+    std::vector<CMultiServiceDecoder::COutputStatus> vecOutputs;
+    for (size_t i = 0; i < iNumStreams; i++)
+    {
+        CMDIStream& Stream = pHost->GetStream(i);
+
+        // The stream is decoded by a pool thread, hold it still while reading
+        std::lock_guard<std::mutex> Lock(Stream.GetMutex());
+        CParameter& Parameters = Stream.GetParameters();
+        const bool signal = (Parameters.ReceiveStatus.FAC.GetStatus() != NOT_PRESENT);
+
+        if (i > 0)
+            json << ",";
+        json << "{";
+        json << "\"id\":" << Stream.GetId() << ",";
+        json << "\"origin\":\"" << JsonEscape(Stream.GetOrigin()) << "\",";
+        json << "\"frames\":" << Stream.GetNumFrames();
+
+        AppendReceptionJSON(json, Parameters, signal);
+
+        CPacketIngestStats IngestStats;
+        if (Stream.GetInputStats(IngestStats))
+            AppendIngestJSON(json, IngestStats);
+
+        AppendServicesJSON(json, Parameters, signal,
+                           [&Stream](int iService) { return Stream.GetDataDecoder(iService); },
+                           vecLastPushedStreamMedia[i], Stream.GetId());
+
+        // Audio outputs of the services
+        Stream.GetOutputStatus(vecOutputs);
+        json << ",\"audio_out\":[";
+        for (size_t j = 0; j < vecOutputs.size(); j++)
+        {
+            if (j > 0)
+                json << ",";
+            json << "{";
+            json << "\"service\":" << vecOutputs[j].iService << ",";
+            json << "\"target\":\"" << JsonEscape(vecOutputs[j].strTarget) << "\",";
+            json << "\"open\":" << (vecOutputs[j].bOpen ? "true" : "false") << ",";
+            json << "\"dropped\":" << vecOutputs[j].iDropped;
+            json << "}";
+        }
+        json << "]";
 
+        json << "}";
+    }
+
+    json << "]}";
+
+    return json.str();
+}
+
+void CStatusBroadcast::AppendIngestJSON(std::ostringstream& json, const CPacketIngestStats& IngestStats)
+{
+    json << ",\"rsi_in\":{";
+    json << "\"packets\":" << IngestStats.iPackets << ",";
+    json << "\"bytes\":" << IngestStats.iBytes << ",";
+    json << "\"dropped\":" << IngestStats.iDropped << ",";
+    json << "\"packets_per_s\":" << std::setprecision(1) << IngestStats.rPacketRate << ",";
+    json << "\"packets_per_syscall\":" << std::setprecision(2)
+         << ((IngestStats.iSyscalls > 0) ? _REAL(IngestStats.iPackets) / _REAL(IngestStats.iSyscalls) : 0.0);
+    json << std::setprecision(1);
+    json << "}";
+}
+
+void CStatusBroadcast::AppendReceptionJSON(std::ostringstream& json, CParameter& Parameters,
+                                           bool signal)
+{
     // Quick snapshot of all status values
     // Reference: KiwiSDR ConsoleIO.cpp:156-296
 
@@ -284,48 +991,12 @@ std::string CStatusBroadcast::CollectStatusJSON()
 
     _REAL rIFLevel = Parameters.GetIFSignalLevel();
     _REAL rSNR = 0.0;
-    int iRobustness = -1;
-    int iBandwidth = -1;
-
-    int signal = (pDRMReceiver->GetAcquiState() == AS_WITH_SIGNAL);
-
-    // Extended parameters (only available with signal)
-    int iInterleaver = -1;
-    int iSDCMode = -1;
-    int iMSCMode = -1;
-    int iProtLevelA = -1;
-    int iProtLevelB = -1;
-    int iNumAudioServices = 0;
-    int iNumDataServices = 0;
-    _REAL rBandwidthKHz = 0.0;
 
     if (signal)
-    {
         rSNR = Parameters.GetSNR();
-        iRobustness = (int)Parameters.GetWaveMode();
-        iBandwidth = (int)Parameters.GetSpectrumOccup();
-
-        // Get extended parameters
-        iInterleaver = (int)Parameters.eSymbolInterlMode;
-        iSDCMode = (int)Parameters.eSDCCodingScheme;
-        iMSCMode = (int)Parameters.eMSCCodingScheme;
-        iProtLevelA = Parameters.MSCPrLe.iPartA;
-        iProtLevelB = Parameters.MSCPrLe.iPartB;
-        iNumAudioServices = Parameters.iNumAudioService;
-        iNumDataServices = Parameters.iNumDataService;
-
-        // Convert bandwidth index to kHz
-        rBandwidthKHz = GetBandwidthKHz(iBandwidth);
-    }
-
-    // Build JSON string (Phase 2 - Complete version)
-    std::ostringstream json;
-    json << std::fixed << std::setprecision(1);
-    json << "{";
-    json << "\"timestamp\":" << std::time(nullptr) << ",";
 
     // DRM time information (from DRM transmission)
-    json << "\"drm_time\":{";
+    json << ",\"drm_time\":{";
 
     if (Parameters.iYear == 0 && Parameters.iMonth == 0 && Parameters.iDay == 0 &&
         Parameters.iUTCHour == 0 && Parameters.iUTCMin == 0)
@@ -436,20 +1107,42 @@ std::string CStatusBroadcast::CollectStatusJSON()
         }
     }
 
-    json << "},";
+    json << "}";
+}
 
-    // Frequency parameters
-    json << "\"frequency\":{";
-    json << "\"dc_offset_hz\":" << std::setprecision(2) << Parameters.GetDCFrequency();
+void CStatusBroadcast::AppendServicesJSON(std::ostringstream& json, CParameter& Parameters, bool signal,
+                                          const std::function<CDataDecoder*(int)>& GetDataDecoder,
+                                          std::map<std::string, int>& mapLastPushed, int iStream)
+{
+    // Extended parameters (only available with signal)
+    int iRobustness = -1;
+    int iBandwidth = -1;
+    int iInterleaver = -1;
+    int iSDCMode = -1;
+    int iMSCMode = -1;
+    int iProtLevelA = -1;
+    int iProtLevelB = -1;
+    int iNumAudioServices = 0;
+    int iNumDataServices = 0;
+    _REAL rBandwidthKHz = 0.0;
 
-    _REAL rSampleOffset = Parameters.rResampleOffset;
-    _REAL rSampleRate = Parameters.GetSigSampleRate();
-    int iSampleOffsetPPM = (rSampleRate > 0) ? (int)(rSampleOffset / rSampleRate * 1e6) : 0;
+    if (signal)
+    {
+        iRobustness = (int)Parameters.GetWaveMode();
+        iBandwidth = (int)Parameters.GetSpectrumOccup();
 
-    json << ",\"sample_offset_hz\":" << std::setprecision(2) << rSampleOffset;
-    json << ",\"sample_offset_ppm\":" << iSampleOffsetPPM;
-    json << std::setprecision(1);
-    json << "}";
+        // Get extended parameters
+        iInterleaver = (int)Parameters.eSymbolInterlMode;
+        iSDCMode = (int)Parameters.eSDCCodingScheme;
+        iMSCMode = (int)Parameters.eMSCCodingScheme;
+        iProtLevelA = Parameters.MSCPrLe.iPartA;
+        iProtLevelB = Parameters.MSCPrLe.iPartB;
+        iNumAudioServices = Parameters.iNumAudioService;
+        iNumDataServices = Parameters.iNumDataService;
+
+        // Convert bandwidth index to kHz
+        rBandwidthKHz = GetBandwidthKHz(iBandwidth);
+    }
 
     if (signal)
     {
@@ -590,16 +1283,12 @@ std::string CStatusBroadcast::CollectStatusJSON()
     // Media availability detection (Program Guide, Journaline, Slideshow)
     json << ",\"media\":{";
 
-    // Get DataDecoder instance
-    CDataDecoder* pDataDecoder = pDRMReceiver->GetDataDecoder();
-
     bool bHasProgramGuide = false;
     bool bHasJournaline = false;
     bool bHasSlideshow = false;
     bool bHasMediaContent = false;
     std::ostringstream mediaContentJson;
 
-    if (pDataDecoder != nullptr)
     {
         // UNIFIED SERVICE PROCESSING: Single-pass iteration for both detection and extraction
         // ✅ Reads directly from Parameters.Service[] (works regardless of DataDecoder state)
@@ -644,7 +1333,8 @@ std::string CStatusBroadcast::CollectStatusJSON()
 
                 // STEP 2: Try to extract new content (only if MOT decoder exists and has data)
                 // ⚠️ pMOTApp may be null if DataDecoder hasn't initialized this PacketID yet
-                CMOTDABDec* pMOTApp = pDataDecoder->getApplication(iPacketID);
+                CDataDecoder* pDataDecoder = GetDataDecoder(iServiceId);
+                CMOTDABDec* pMOTApp = (pDataDecoder != nullptr) ? pDataDecoder->getApplication(iPacketID) : nullptr;
 
                 if (pMOTApp != nullptr && pMOTApp->NewObjectAvailable())
                 {
@@ -661,11 +1351,11 @@ std::string CStatusBroadcast::CollectStatusJSON()
                     time_t currentObjTime = time(nullptr);  // Use current time as timestamp
                     bool bIsNewContent = false;
 
-                    auto it = mapLastPushedMedia.find(strMediaKey);
-                    if (it == mapLastPushedMedia.end() || NewObj.iUniqueBodyVersion != it->second)
+                    auto it = mapLastPushed.find(strMediaKey);
+                    if (it == mapLastPushed.end() || NewObj.iUniqueBodyVersion != it->second)
                     {
                         bIsNewContent = true;
-                        mapLastPushedMedia[strMediaKey] = NewObj.iUniqueBodyVersion;  // Store version instead of timestamp
+                        mapLastPushed[strMediaKey] = NewObj.iUniqueBodyVersion;  // Store version instead of timestamp
                     }
 
                     // Extract content based on application type
@@ -685,9 +1375,7 @@ std::string CStatusBroadcast::CollectStatusJSON()
                                 mediaContentJson << ",\"name\":\"" << JsonEscape(NewObj.strName) << "\"";
                                 mediaContentJson << ",\"description\":\"" << JsonEscape(NewObj.strContentDescription) << "\"";
                                 mediaContentJson << ",\"size\":" << NewObj.Body.vecData.Size();
-                                // Base64 encode body data
-                                std::string base64Data = Base64Encode(pData, NewObj.Body.vecData.Size());
-                                mediaContentJson << ",\"data\":\"" << base64Data << "\"";
+                                AppendMediaData(mediaContentJson, iStream, iUserAppIdent, NewObj, pData);
                                 mediaContentJson << "}";
                                 bHasMediaContent = true;
                             }
@@ -715,9 +1403,7 @@ std::string CStatusBroadcast::CollectStatusJSON()
                                 mediaContentJson << ",\"name\":\"" << JsonEscape(NewObj.strName) << "\"";
                                 mediaContentJson << ",\"mime\":\"" << JsonEscape(NewObj.strMimeType) << "\"";
                                 mediaContentJson << ",\"size\":" << NewObj.Body.vecData.Size();
-                                // Base64 encode image data
-                                std::string base64Data = Base64Encode(pData, NewObj.Body.vecData.Size());
-                                mediaContentJson << ",\"data\":\"" << base64Data << "\"";
+                                AppendMediaData(mediaContentJson, iStream, iUserAppIdent, NewObj, pData);
                                 mediaContentJson << "}";
                                 bHasMediaContent = true;
                             }
@@ -735,6 +1421,8 @@ std::string CStatusBroadcast::CollectStatusJSON()
     json << "\"program_guide\":" << (bHasProgramGuide ? "true" : "false");
     json << ",\"journaline\":" << (bHasJournaline ? "true" : "false");
     json << ",\"slideshow\":" << (bHasSlideshow ? "true" : "false");
+    if (iMediaServerFd >= 0)
+        json << ",\"socket\":\"" << JsonEscape(strMediaSocketPath) << "\"";
     json << "}";
 
     // Append media_content section only if there's new content (ONE-TIME PUSH)
@@ -742,10 +1430,26 @@ std::string CStatusBroadcast::CollectStatusJSON()
     {
         json << ",\"media_content\":{" << mediaContentJson.str() << "}";
     }
+}
 
-    json << "}";
+void CStatusBroadcast::AppendMediaData(std::ostringstream& json, int iStream, int iAppType,
+                                       const CMOTObject& Obj, const unsigned char* pData)
+{
+    if (iMediaServerFd < 0)
+    {
+        // Base64 encode body data
+        std::string base64Data = Base64Encode(pData, Obj.Body.vecData.Size());
+        json << ",\"data\":\"" << base64Data << "\"";
+        return;
+    }
 
-    return json.str();
+    // Only a reference, the object is on the media socket
+    std::string strRef;
+    CSharedMessage pFrame = MediaStore.Put(iStream, iAppType, Obj, strRef);
+    if (pFrame != nullptr)
+        vecNewMedia.push_back(pFrame);
+    json << ",\"ref\":\"" << strRef << "\"";
+    json << ",\"version\":" << Obj.iUniqueBodyVersion;
 }
 
 std::string CStatusBroadcast::Base64Encode(const unsigned char* data, size_t len)
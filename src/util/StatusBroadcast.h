@@ -31,19 +31,48 @@
 
 #include "../GlobalDefinitions.h"
 #include "../Parameter.h"
+#include "MediaStore.h"
 #include <string>
 #include <vector>
 #include <thread>
 #include <atomic>
+#include <map>
+#include <deque>
+#include <sstream>
+#include <functional>
 
 // Forward declarations
 class CDRMReceiver;
+class CMDIHost;
+class CDataDecoder;
+class CMOTObject;
+struct CPacketIngestStats;
 
 /**
  * @brief Unix Domain Socket server for broadcasting DRM status
  *
- * Broadcasts JSON-formatted DRM receiver status to connected clients
- * every 500ms. Supports multiple concurrent clients.
+ * Broadcasts JSON-formatted DRM receiver status to connected clients.
+ * Supports multiple concurrent clients.
+ *
+ * On Linux the server thread sleeps in epoll_wait until the receiver
+ * decoded a frame (Notify()), so a change reaches the clients one frame
+ * after it was received. A status is only sent if it differs from the
+ * last one, apart from the time stamp. Without notifications the status is
+ * still checked every IDLE_UPDATE_INTERVAL_MS.
+ *
+ * A new client first gets the complete status. A client which writes the
+ * line "deltas" then gets only the changed top level sections, as
+ * {"timestamp":..,"delta":true,<sections>,"removed":[<names>]}, "full"
+ * switches back. Each client has a bounded queue. If it doesn't keep up,
+ * the queued status updates are replaced by one complete status instead
+ * of disconnecting it.
+ *
+ * MOT slideshow images and EPG objects are served on a second socket,
+ * <socket path>.media, as binary frames (see CMediaStore). The status only
+ * carries a reference and the version of a new object. A client of the
+ * media socket writes "get <ref>" for one object or "subscribe" to get all
+ * new objects as they are decoded. Without the media socket the objects
+ * are sent in the status, base64 encoded.
  */
 class CStatusBroadcast
 {
@@ -59,6 +88,14 @@ public:
      */
     bool Start(CDRMReceiver* pReceiver, const std::string& strCustomPath = "");
 
+    /**
+     * @brief Start the status broadcast service for the streams of an MDI host
+     * @param pNewHost Pointer to the MDI host, one status object per stream
+     * @param strCustomPath Custom socket path (optional)
+     * @return true if started successfully
+     */
+    bool Start(CMDIHost* pNewHost, const std::string& strCustomPath = "");
+
     /**
      * @brief Stop the status broadcast service
      */
@@ -74,7 +111,55 @@ public:
      */
     std::string GetSocketPath() const { return strSocketPath; }
 
+    /**
+     * @brief Tell the running server that the status may have changed,
+     * called by the decoding threads once per frame. Cheap when no client
+     * is connected
+     */
+    static void Notify();
+
 private:
+    // Messages are shared by all clients they are queued for
+    typedef std::shared_ptr<const std::string> CSharedMessage;
+
+    struct CStatusMessage
+    {
+        CStatusMessage(const CSharedMessage& pNewData, bool bNewEvent)
+            : pData(pNewData), bEvent(bNewEvent) {}
+
+        CSharedMessage  pData;
+        bool            bEvent;     // carries media objects, which are sent once
+    };
+
+    struct CStatusClient
+    {
+        CStatusClient() : queue(), iQueuedBytes(0), iHeadSent(0), strCommand(),
+            bDeltas(false), bStarted(false), bWatchOutput(false), bMedia(false),
+            bSubscribed(false), iCoalesced(0) {}
+
+        std::deque<CStatusMessage> queue;
+        size_t              iQueuedBytes;
+        size_t              iHeadSent;      // bytes of queue.front() already sent
+        std::string         strCommand;     // incomplete command line
+        bool                bDeltas;
+        bool                bStarted;       // got the complete status
+        bool                bWatchOutput;   // waiting for EPOLLOUT
+        bool                bMedia;         // client of the media socket
+        bool                bSubscribed;    // gets all new media objects
+        unsigned long       iCoalesced;
+    };
+
+    /**
+     * @brief Create the sockets and start the broadcast thread
+     */
+    bool Listen(const std::string& strCustomPath);
+
+    /**
+     * @brief Create a listening non-blocking Unix Domain Socket
+     * @return File descriptor, -1 on error
+     */
+    static int OpenSocket(const std::string& strPath);
+
     /**
      * @brief Main broadcast loop (runs in separate thread)
      */
@@ -82,21 +167,98 @@ private:
 
     /**
      * @brief Accept new client connections (non-blocking)
+     * @param bMedia Connections of the media socket
+     * @return true if a client connected
+     */
+    bool AcceptNewClients(int iListenFd, bool bMedia);
+
+    /**
+     * @brief Read commands of a client
+     * @return false if the client disconnected
      */
-    void AcceptNewClients();
+    bool ReadFromClient(int fd);
 
     /**
-     * @brief Broadcast JSON status to all connected clients
+     * @brief Send as much of the queue of a client as its socket takes
+     * @return false on a socket error
+     */
+    bool FlushClient(int fd);
+
+    void DropClient(int fd);
+
+    /**
+     * @brief Queue a message for a client, coalesce if the queue is full
+     * @param bEvent Message carries media objects
+     * @param pSnapshot Complete status without media, replaces the
+     * queued status updates if the client is too slow. nullptr for media
+     * socket clients, they lose the oldest objects instead
+     */
+    static void Enqueue(CStatusClient& client, const CSharedMessage& pMessage,
+                        bool bEvent, const CSharedMessage& pSnapshot);
+
+    /**
+     * @brief Send JSON status to all connected clients if it changed
      * @param strJSON JSON string to broadcast
      */
     void BroadcastToClients(const std::string& strJSON);
 
+    /**
+     * @brief Send the objects stored by the last status to the subscribed
+     * media socket clients
+     */
+    void PushMedia();
+
+    /**
+     * @brief Split a JSON object into its top level "key":value pairs
+     */
+    static void SplitSections(const std::string& strJSON,
+                              std::vector<std::pair<std::string, std::string> >& vecSections);
+
+#ifdef __linux__
+    void WakeUp();
+    void CloseEvents();
+    void WatchOutput(int fd, bool bOutput);
+#endif
+
     /**
      * @brief Collect current DRM status as JSON string
      * @return JSON string containing status information
      */
     std::string CollectStatusJSON();
 
+    /**
+     * @brief Collect the status of all streams of the MDI host
+     * @return JSON string with a "streams" array
+     */
+    std::string CollectHostJSON();
+
+    /**
+     * @brief Append drm_time, status and signal of a receiver context
+     */
+    static void AppendReceptionJSON(std::ostringstream& json, CParameter& Parameters, bool signal);
+
+    /**
+     * @brief Append the rsi_in statistics of an MDI/RSCI input
+     */
+    static void AppendIngestJSON(std::ostringstream& json, const CPacketIngestStats& IngestStats);
+
+    /**
+     * @brief Append mode, coding, services, service_list and media of a receiver context
+     * @param GetDataDecoder Data decoder of a service, may return nullptr
+     * @param mapLastPushed Media already pushed for this context
+     * @param iStream Number of the context in media references
+     */
+    void AppendServicesJSON(std::ostringstream& json, CParameter& Parameters, bool signal,
+                            const std::function<CDataDecoder*(int)>& GetDataDecoder,
+                            std::map<std::string, int>& mapLastPushed, int iStream);
+
+    /**
+     * @brief Append the body of a new MOT object: a reference into the
+     * media store, or base64 data without media socket
+     */
+    void AppendMediaData(std::ostringstream& json, int iStream, int iAppType,
+                         const CMOTObject& Obj, const unsigned char* pData);
+
     /**
      * @brief Convert ETypeRxStatus to integer
      * Reference: KiwiSDR ConsoleIO.cpp:395-403
@@ -140,17 +302,40 @@ private:
 
     // Member variables
     CDRMReceiver*           pDRMReceiver;
+    CMDIHost*               pHost;
     std::string             strSocketPath;
     int                     iServerFd;
-    std::vector<int>        vecClientFds;
+    int                     iMediaServerFd;
+    std::string             strMediaSocketPath;
+    int                     iEpollFd;
+    int                     iWakeupFd;
+    std::map<int, CStatusClient> mapClients;
+    std::vector<std::pair<std::string, std::string> > vecLastSections;
     std::thread             broadcastThread;
     std::atomic<bool>       bRunning;
 
     // Media content tracking (to avoid duplicate pushes)
     std::map<std::string, int> mapLastPushedMedia;  // key: "type_transportID", value: iUniqueBodyVersion
+    std::vector<std::map<std::string, int> > vecLastPushedStreamMedia;  // same, per MDI host stream
+    CMediaStore             MediaStore;
+    std::vector<CSharedMessage> vecNewMedia;    // stored since the last PushMedia()
+
+    // Wakeup of the running server for Notify()
+    static std::atomic<int> iNotifyFd;
+    static std::atomic<int> iNumClients;
 
-    // Update interval in milliseconds (same as KiwiSDR GUI_CONTROL_UPDATE_TIME)
+    // Update interval in milliseconds without epoll (same as KiwiSDR GUI_CONTROL_UPDATE_TIME)
     static const int        UPDATE_INTERVAL_MS = 500;
+
+    // Notifications closer together than this are sent as one update
+    static const int        MIN_UPDATE_INTERVAL_MS = 40;
+
+    // Status check without notifications (no signal, AM/FM)
+    static const int        IDLE_UPDATE_INTERVAL_MS = 1000;
+
+    // Queue limits per client
+    static const size_t     MAX_CLIENT_MESSAGES = 16;
+    static const size_t     MAX_CLIENT_QUEUE_BYTES = 4 * 1024 * 1024;
 };
 
 #endif // STATUSBROADCAST_H
@@ -28,6 +28,7 @@
 #include "Utilities.h"
 #include <sstream>
 #include <cstring>
+#include <chrono>
 #if defined(_WIN32)
 # ifdef HAVE_SETUPAPI
 #  ifndef INITGUID
@@ -60,6 +61,25 @@ CCounter::operator unsigned int()
 unsigned int CCounter::operator=(unsigned int value)
 	{ mutex.Lock(); count = value; mutex.Unlock(); return value; }
 
+/******************************************************************************\
+* Demand for plot data                                                         *
+\******************************************************************************/
+int64_t CViewDemand::NowMs()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void CViewDemand::Request()
+{
+	iLastRequestMs.store(NowMs(), std::memory_order_relaxed);
+}
+
+bool CViewDemand::IsActive() const
+{
+	return NowMs() - iLastRequestMs.load(std::memory_order_relaxed) < VIEW_DEMAND_HOLD_MS;
+}
+
 /******************************************************************************\
 * Signal level meter                                                           *
 \******************************************************************************/
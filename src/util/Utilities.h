@@ -39,6 +39,8 @@
 #include "../matlib/MatlibStdToolbox.h"
 #include <map>
 #include <iostream>
+#include <atomic>
+#include <cstdint>
 
 #ifdef HAVE_LIBHAMLIB
 # include <hamlib/rig.h>
@@ -48,6 +50,9 @@
 /* Definitions ****************************************************************/
 #define	METER_FLY_BACK					15
 
+/* Time data only needed for plots is still computed after it was last read */
+#define VIEW_DEMAND_HOLD_MS				3000
+
 /* Classes ********************************************************************/
 /* Thread safe counter ------------------------------------------------------ */
 class CCounter
@@ -67,6 +72,26 @@ private:
 };
 
 
+/* Demand for plot data ----------------------------------------------------- */
+/* Spectra and histories which are only there to be shown are computed while
+   somebody reads them. The functions handing them out call Request(), the
+   modules producing them skip the work while IsActive() is false. Readers
+   poll with a timer, so the demand simply runs out when the last one goes */
+class CViewDemand
+{
+public:
+	CViewDemand() : iLastRequestMs(INT64_MIN / 2) {}
+
+	void Request();
+	bool IsActive() const;
+
+protected:
+	static int64_t NowMs();
+
+	std::atomic<int64_t> iLastRequestMs;
+};
+
+
 /* Signal level meter ------------------------------------------------------- */
 class CSignalLevelMeter
 {
@@ -0,0 +1,186 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Small fork/join worker pool for running independent receiver modules
+ *  concurrently
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "WorkerPool.h"
+#include <cstdio>
+
+CWorkerPool::CWorkerPool()
+    : bRunning(false)
+{
+}
+
+CWorkerPool::~CWorkerPool()
+{
+    Stop();
+}
+
+bool CWorkerPool::Start(unsigned iNumThreads)
+{
+    if (bRunning)
+        return true;
+
+    if (iNumThreads == 0)
+    {
+        unsigned iCores = std::thread::hardware_concurrency();
+        iNumThreads = (iCores > 1) ? iCores - 1 : 0;
+    }
+
+    if (iNumThreads == 0)
+    {
+        fprintf(stderr, "WorkerPool: single core, tasks run sequentially\n");
+        return false;
+    }
+
+    bRunning = true;
+    for (unsigned i = 0; i < iNumThreads; i++)
+        vecThreads.emplace_back(&CWorkerPool::WorkerLoop, this);
+
+    fprintf(stderr, "WorkerPool: started %u worker threads\n", iNumThreads);
+    return true;
+}
+
+void CWorkerPool::Stop()
+{
+    if (!bRunning)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(QueueMutex);
+        bRunning = false;
+    }
+    QueueCond.notify_all();
+
+    for (size_t i = 0; i < vecThreads.size(); i++)
+    {
+        if (vecThreads[i].joinable())
+            vecThreads[i].join();
+    }
+    vecThreads.clear();
+
+    /* Jobs can only be queued by RunAll() which waits for them, so the
+       queue is empty here */
+    Queue.clear();
+}
+
+void CWorkerPool::RunAll(const std::vector<std::function<void()> >& vecTasks)
+{
+    if (vecTasks.empty())
+        return;
+
+    /* No threads: run everything here */
+    if (!bRunning || vecTasks.size() == 1)
+    {
+        for (size_t i = 0; i < vecTasks.size(); i++)
+            vecTasks[i]();
+        return;
+    }
+
+    std::shared_ptr<CBatch> pBatch = std::make_shared<CBatch>();
+    pBatch->iRemaining = int(vecTasks.size());
+
+    /* Queue all but the first task, the first one is run by the caller */
+    {
+        std::lock_guard<std::mutex> lock(QueueMutex);
+        for (size_t i = 1; i < vecTasks.size(); i++)
+        {
+            CJob Job;
+            Job.Task = vecTasks[i];
+            Job.pBatch = pBatch;
+            Queue.push_back(Job);
+        }
+    }
+    QueueCond.notify_all();
+
+    CJob First;
+    First.Task = vecTasks[0];
+    First.pBatch = pBatch;
+    RunJob(First);
+
+    /* Help with the remaining jobs instead of just waiting */
+    while (TryRunQueuedJob())
+    {
+    }
+
+    std::unique_lock<std::mutex> lock(pBatch->Mutex);
+    pBatch->Done.wait(lock, [&pBatch] { return pBatch->iRemaining == 0; });
+
+    if (pBatch->pError)
+        std::rethrow_exception(pBatch->pError);
+}
+
+void CWorkerPool::RunJob(CJob& Job)
+{
+    std::exception_ptr pError;
+    try
+    {
+        Job.Task();
+    }
+    catch (...)
+    {
+        pError = std::current_exception();
+    }
+
+    std::lock_guard<std::mutex> lock(Job.pBatch->Mutex);
+    if (pError && !Job.pBatch->pError)
+        Job.pBatch->pError = pError;
+    if (--Job.pBatch->iRemaining == 0)
+        Job.pBatch->Done.notify_all();
+}
+
+bool CWorkerPool::TryRunQueuedJob()
+{
+    CJob Job;
+    {
+        std::lock_guard<std::mutex> lock(QueueMutex);
+        if (Queue.empty())
+            return false;
+        Job = Queue.front();
+        Queue.pop_front();
+    }
+    RunJob(Job);
+    return true;
+}
+
+void CWorkerPool::WorkerLoop()
+{
+    for (;;)
+    {
+        CJob Job;
+        {
+            std::unique_lock<std::mutex> lock(QueueMutex);
+            QueueCond.wait(lock, [this] { return !bRunning || !Queue.empty(); });
+
+            if (!bRunning && Queue.empty())
+                return;
+
+            Job = Queue.front();
+            Queue.pop_front();
+        }
+        RunJob(Job);
+    }
+}
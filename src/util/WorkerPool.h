@@ -0,0 +1,125 @@
+/******************************************************************************\
+ * Copyright (c) 2025
+ *
+ * Author(s):
+ *  wwek
+ *
+ * Description:
+ *  Small fork/join worker pool for running independent receiver modules
+ *  concurrently
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+/**
+ * @brief Fixed size thread pool with a blocking "run all and join" call
+ *
+ * The calling thread takes part in the work, so a pool with N threads runs
+ * up to N+1 tasks at the same time. If the pool is not started, all tasks
+ * are run sequentially on the calling thread.
+ */
+class CWorkerPool
+{
+public:
+    CWorkerPool();
+    ~CWorkerPool();
+
+    /**
+     * @brief Start the worker threads
+     * @param iNumThreads Number of threads, 0 = number of cores - 1
+     * @return true if at least one thread is running
+     */
+    bool Start(unsigned iNumThreads = 0);
+
+    /**
+     * @brief Stop and join all worker threads
+     */
+    void Stop();
+
+    /**
+     * @brief Check if worker threads are running
+     */
+    bool IsRunning() const { return bRunning; }
+
+    /**
+     * @brief Number of worker threads (without the calling thread)
+     */
+    unsigned GetNumThreads() const { return unsigned(vecThreads.size()); }
+
+    /**
+     * @brief Run all tasks and return when every task has finished
+     *
+     * An exception thrown by a task is passed on to the caller after all
+     * other tasks of the batch have finished.
+     * @param vecTasks Tasks to run
+     */
+    void RunAll(const std::vector<std::function<void()> >& vecTasks);
+
+private:
+    struct CBatch
+    {
+        CBatch() : iRemaining(0) {}
+        std::mutex              Mutex;
+        std::condition_variable Done;
+        int                     iRemaining;
+        std::exception_ptr      pError;
+    };
+
+    struct CJob
+    {
+        std::function<void()>   Task;
+        std::shared_ptr<CBatch> pBatch;
+    };
+
+    /**
+     * @brief Worker thread main loop
+     */
+    void WorkerLoop();
+
+    /**
+     * @brief Run one job and signal its batch
+     */
+    static void RunJob(CJob& Job);
+
+    /**
+     * @brief Take one queued job if there is one (used by the caller while
+     * waiting for its batch)
+     */
+    bool TryRunQueuedJob();
+
+    std::vector<std::thread>    vecThreads;
+    std::deque<CJob>            Queue;
+    std::mutex                  QueueMutex;
+    std::condition_variable     QueueCond;
+    std::atomic<bool>           bRunning;
+};
+
+#endif // WORKERPOOL_H